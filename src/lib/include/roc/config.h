@@ -31,7 +31,14 @@ typedef enum roc_port_type {
      * If FEC is used, this type of port is used to send or receive FEC repair packets
      * containing redundant data for audio plus some FEC headers.
      */
-    ROC_PORT_AUDIO_REPAIR = 2
+    ROC_PORT_AUDIO_REPAIR = 2,
+
+    /** Network port for audio control packets.
+     * If used, this type of port is used to send or receive RTCP reports,
+     * which allow the receiver to map RTP timestamps to wall clock time and
+     * to measure losses, jitter, and round-trip time.
+     */
+    ROC_PORT_AUDIO_CONTROL = 3
 } roc_port_type;
 
 /** Network protocol. */
@@ -50,7 +57,16 @@ typedef enum roc_protocol {
     ROC_PROTO_RTP_LDPC_SOURCE = 4,
 
     /** FEC repair packet + FECFRAME LDPC-Staircase header (RFC 6816). */
-    ROC_PROTO_LDPC_REPAIR = 5
+    ROC_PROTO_LDPC_REPAIR = 5,
+
+    /** RTP source packet (RFC 3550) + sliding window RLC footer (RFC 8681 style). */
+    ROC_PROTO_RTP_RLC_SOURCE = 6,
+
+    /** FEC repair packet + sliding window RLC header (RFC 8681 style). */
+    ROC_PROTO_RLC_REPAIR = 7,
+
+    /** RTCP control packet (RFC 3550) + RTCP XR blocks (RFC 3611). */
+    ROC_PROTO_RTCP = 8
 } roc_protocol;
 
 /** Forward Error Correction code. */
@@ -77,7 +93,17 @@ typedef enum roc_fec_code {
      * Compatible with @c ROC_PROTO_RTP_LDPC_SOURCE and @c ROC_PROTO_LDPC_REPAIR
      * protocols for source and repair ports.
      */
-    ROC_FEC_LDPC_STAIRCASE = 2
+    ROC_FEC_LDPC_STAIRCASE = 2,
+
+    /** Sliding window Random Linear Codes over GF(2^8) (RFC 8681 style).
+     * Repair packets protect a moving window of recent source packets instead
+     * of a block, so losses are repaired without waiting for the block end.
+     * The block size parameters define the window length and the number of
+     * repair packets sent per window length of source packets.
+     * Compatible with @c ROC_PROTO_RTP_RLC_SOURCE and @c ROC_PROTO_RLC_REPAIR
+     * protocols for source and repair ports.
+     */
+    ROC_FEC_RLC = 3
 } roc_fec_code;
 
 /** Packet encoding. */
@@ -127,6 +153,22 @@ typedef enum roc_resampler_profile {
     ROC_RESAMPLER_LOW = 3
 } roc_resampler_profile;
 
+/** Thread scheduling policy. */
+typedef enum roc_thread_policy {
+    /** Default scheduling policy of the operating system. */
+    ROC_THREAD_POLICY_DEFAULT = 0,
+
+    /** Real-time first-in first-out scheduling.
+     * Requires appropriate privileges.
+     */
+    ROC_THREAD_POLICY_FIFO = 1,
+
+    /** Real-time round-robin scheduling.
+     * Requires appropriate privileges.
+     */
+    ROC_THREAD_POLICY_RR = 2
+} roc_thread_policy;
+
 /** Context configuration.
  * @see roc_context
  */
@@ -144,6 +186,25 @@ typedef struct roc_context_config {
      * If zero, default value is used.
      */
     unsigned int max_frame_size;
+
+    /** Scheduling policy of the network thread.
+     * If the policy can't be set, e.g. because of missing privileges, the
+     * thread runs with the default policy.
+     * If zero, default policy is used.
+     */
+    roc_thread_policy network_thread_policy;
+
+    /** Scheduling priority of the network thread.
+     * Used only with real-time policies. Clamped to the range supported by
+     * the policy.
+     */
+    int network_thread_priority;
+
+    /** CPU affinity mask of the network thread.
+     * Bit N allows the thread to run on CPU N.
+     * If zero, the thread may run on any CPU.
+     */
+    unsigned long long network_thread_cpu_mask;
 } roc_context_config;
 
 /** Sender configuration.
@@ -205,6 +266,13 @@ typedef struct roc_sender_config {
      */
     unsigned int automatic_timing;
 
+    /** Enable asynchronous processing.
+     * If non-zero, the sender write operation only copies samples to an internal
+     * ring buffer, and encoding and sending are performed by a dedicated thread.
+     * The write operation blocks only if the ring buffer is full.
+     */
+    unsigned int asynchronous_processing;
+
     /** Resampler profile to use.
      * If non-zero, the sender employs resampler if the frame sample rate differs
      * from the packet sample rate.
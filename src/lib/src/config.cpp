@@ -27,9 +27,43 @@ bool make_context_config(roc_context_config& out, const roc_context_config& in)
         out.max_frame_size = 4096;
     }
 
+    switch ((int)in.network_thread_policy) {
+    case ROC_THREAD_POLICY_DEFAULT:
+    case ROC_THREAD_POLICY_FIFO:
+    case ROC_THREAD_POLICY_RR:
+        out.network_thread_policy = in.network_thread_policy;
+        break;
+    default:
+        roc_log(LogError, "roc_config: invalid network_thread_policy");
+        return false;
+    }
+
+    out.network_thread_priority = in.network_thread_priority;
+    out.network_thread_cpu_mask = in.network_thread_cpu_mask;
+
     return true;
 }
 
+core::ThreadAttributes make_network_thread_attributes(const roc_context_config& in) {
+    core::ThreadAttributes attrs;
+
+    switch ((int)in.network_thread_policy) {
+    case ROC_THREAD_POLICY_FIFO:
+        attrs.sched_policy = core::SchedPolicy_FIFO;
+        break;
+    case ROC_THREAD_POLICY_RR:
+        attrs.sched_policy = core::SchedPolicy_RR;
+        break;
+    default:
+        break;
+    }
+
+    attrs.sched_priority = in.network_thread_priority;
+    attrs.cpu_mask = (uint64_t)in.network_thread_cpu_mask;
+
+    return attrs;
+}
+
 bool make_sender_config(pipeline::SenderConfig& out, const roc_sender_config& in) {
     if (in.frame_sample_rate != 0) {
         out.input_sample_rate = in.frame_sample_rate;
@@ -71,6 +105,7 @@ bool make_sender_config(pipeline::SenderConfig& out, const roc_sender_config& in
 
     out.interleaving = in.packet_interleaving;
     out.timing = in.automatic_timing;
+    out.threading = in.asynchronous_processing;
 
     out.resampling = (in.resampler_profile != ROC_RESAMPLER_DISABLE);
 
@@ -103,6 +138,9 @@ bool make_sender_config(pipeline::SenderConfig& out, const roc_sender_config& in
     case ROC_FEC_LDPC_STAIRCASE:
         out.fec_encoder.scheme = packet::FEC_LDPC_Staircase;
         break;
+    case ROC_FEC_RLC:
+        out.fec_encoder.scheme = packet::FEC_RLC;
+        break;
     default:
         roc_log(LogError, "roc_config: invalid fec_scheme");
         return false;
@@ -229,6 +267,9 @@ bool make_port_config(pipeline::PortConfig& out,
         case ROC_PROTO_RTP_LDPC_SOURCE:
             out.protocol = pipeline::Proto_RTP_LDPC_Source;
             break;
+        case ROC_PROTO_RTP_RLC_SOURCE:
+            out.protocol = pipeline::Proto_RTP_RLC_Source;
+            break;
         default:
             roc_log(LogError, "roc_config: invalid protocol for audio source port");
             return false;
@@ -243,12 +284,26 @@ bool make_port_config(pipeline::PortConfig& out,
         case ROC_PROTO_LDPC_REPAIR:
             out.protocol = pipeline::Proto_LDPC_Repair;
             break;
+        case ROC_PROTO_RLC_REPAIR:
+            out.protocol = pipeline::Proto_RLC_Repair;
+            break;
         default:
             roc_log(LogError, "roc_config: invalid protocol for audio repair port");
             return false;
         }
         break;
 
+    case ROC_PORT_AUDIO_CONTROL:
+        switch ((int)proto) {
+        case ROC_PROTO_RTCP:
+            out.protocol = pipeline::Proto_RTCP;
+            break;
+        default:
+            roc_log(LogError, "roc_config: invalid protocol for audio control port");
+            return false;
+        }
+        break;
+
     default:
         roc_log(LogError, "roc_config: invalid port type");
         return false;
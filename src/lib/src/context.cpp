@@ -16,7 +16,7 @@ roc_context::roc_context(const roc_context_config& cfg)
     : packet_pool(allocator, false)
     , byte_buffer_pool(allocator, cfg.max_packet_size, false)
     , sample_buffer_pool(allocator, cfg.max_frame_size / sizeof(audio::sample_t), false)
-    , trx(packet_pool, byte_buffer_pool, allocator)
+    , trx(packet_pool, byte_buffer_pool, allocator, make_network_thread_attributes(cfg))
     , counter(0) {
 }
 
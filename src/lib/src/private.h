@@ -19,6 +19,7 @@
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
 #include "roc_core/mutex.h"
+#include "roc_core/thread_attributes.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_netio/transceiver.h"
 #include "roc_packet/address.h"
@@ -33,6 +34,9 @@ roc::packet::Address& get_address(roc_address* address);
 
 bool make_context_config(roc_context_config& out, const roc_context_config& in);
 
+roc::core::ThreadAttributes
+make_network_thread_attributes(const roc_context_config& in);
+
 bool make_sender_config(roc::pipeline::SenderConfig& out, const roc_sender_config& in);
 bool make_receiver_config(roc::pipeline::ReceiverConfig& out,
                           const roc_receiver_config& in);
@@ -68,6 +72,7 @@ struct roc_sender {
 
     roc::pipeline::PortConfig source_port;
     roc::pipeline::PortConfig repair_port;
+    roc::pipeline::PortConfig control_port;
 
     roc::core::UniquePtr<roc::pipeline::Sender> sender;
     roc::packet::IWriter* writer;
@@ -19,7 +19,7 @@ void receiver_close_port(void* arg, const pipeline::PortConfig& port) {
     roc_panic_if_not(arg);
     roc_receiver* receiver = (roc_receiver*)arg;
 
-    receiver->context.trx.remove_port(port.address);
+    receiver->context.trx.remove_udp_receiver(port.address, receiver->receiver);
 }
 
 } // namespace
@@ -21,9 +21,10 @@ bool sender_init_pipeline(roc_sender* sender) {
     sender->sender.reset(
         new (sender->context.allocator) pipeline::Sender(
             sender->config, sender->source_port, *sender->writer, sender->repair_port,
-            *sender->writer, sender->codec_map, sender->format_map,
-            sender->context.packet_pool, sender->context.byte_buffer_pool,
-            sender->context.sample_buffer_pool, sender->context.allocator),
+            *sender->writer, sender->control_port, *sender->writer, sender->codec_map,
+            sender->format_map, sender->context.packet_pool,
+            sender->context.byte_buffer_pool, sender->context.sample_buffer_pool,
+            sender->context.allocator),
         sender->context.allocator);
 
     if (!sender->sender) {
@@ -94,6 +95,24 @@ bool sender_set_port(roc_sender* sender,
                 pipeline::port_to_str(port_config).c_str());
 
         return true;
+
+    case ROC_PORT_AUDIO_CONTROL:
+        if (sender->control_port.protocol != pipeline::Proto_None) {
+            roc_log(LogError, "roc_sender: audio control port is already set");
+            return false;
+        }
+
+        if (!pipeline::validate_port(sender->config.fec_encoder.scheme,
+                                     port_config.protocol, pipeline::Port_AudioControl)) {
+            return false;
+        }
+
+        sender->control_port = port_config;
+
+        roc_log(LogInfo, "roc_sender: set audio control port to %s",
+                pipeline::port_to_str(port_config).c_str());
+
+        return true;
     }
 
     roc_log(LogError, "roc_sender: invalid protocol");
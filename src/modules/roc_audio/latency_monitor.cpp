@@ -25,13 +25,14 @@ LatencyMonitor::LatencyMonitor(const packet::SortedQueue& queue,
                                const LatencyMonitorConfig& config,
                                core::nanoseconds_t target_latency,
                                size_t input_sample_rate,
-                               size_t output_sample_rate)
+                               size_t output_sample_rate,
+                               core::IClock& clock)
     : queue_(queue)
     , depacketizer_(depacketizer)
     , resampler_(resampler)
     , fe_((packet::timestamp_t)packet::timestamp_from_ns(target_latency,
                                                          input_sample_rate))
-    , rate_limiter_(LogInterval)
+    , rate_limiter_(LogInterval, clock)
     , update_interval_((packet::timestamp_t)packet::timestamp_from_ns(
           config.fe_update_interval, input_sample_rate))
     , update_pos_(0)
@@ -42,9 +43,18 @@ LatencyMonitor::LatencyMonitor(const packet::SortedQueue& queue,
     , max_latency_(packet::timestamp_from_ns(config.max_latency, input_sample_rate))
     , max_scaling_delta_(config.max_scaling_delta)
     , sample_rate_coeff_(0.f)
+    , latency_mode_(config.latency_mode)
+    , input_sample_rate_(input_sample_rate)
+    , mapping_rtp_timestamp_(0)
+    , mapping_capture_time_(0)
+    , has_mapping_(false)
+    , playback_time_(0)
+    , has_playback_time_(false)
     , valid_(false) {
     roc_log(LogDebug,
-            "latency monitor: initializing: target_latency=%lu in_rate=%lu out_rate=%lu",
+            "latency monitor: initializing: mode=%s target_latency=%lu in_rate=%lu"
+            " out_rate=%lu",
+            latency_mode_ == LatencyMode_E2E ? "e2e" : "queue",
             (unsigned long)target_latency_, (unsigned long)input_sample_rate,
             (unsigned long)output_sample_rate);
 
@@ -109,24 +119,62 @@ bool LatencyMonitor::update(packet::timestamp_t pos) {
     return true;
 }
 
+void LatencyMonitor::set_mapping(packet::timestamp_t rtp_timestamp,
+                                 core::nanoseconds_t capture_time) {
+    mapping_rtp_timestamp_ = rtp_timestamp;
+    mapping_capture_time_ = capture_time;
+    has_mapping_ = true;
+}
+
+void LatencyMonitor::reclock(core::nanoseconds_t playback_time) {
+    playback_time_ = playback_time;
+    has_playback_time_ = true;
+}
+
 bool LatencyMonitor::get_latency_(packet::timestamp_diff_t& latency) const {
+    switch (latency_mode_) {
+    case LatencyMode_Queue:
+        return get_queue_latency_(latency);
+
+    case LatencyMode_E2E:
+        return get_e2e_latency_(latency);
+    }
+
+    return false;
+}
+
+bool LatencyMonitor::get_queue_latency_(packet::timestamp_diff_t& latency) const {
     if (!depacketizer_.started()) {
         return false;
     }
 
     const packet::timestamp_t head = depacketizer_.timestamp();
 
-    packet::PacketPtr latest = queue_.latest();
-    if (!latest) {
+    packet::timestamp_t tail = 0;
+    if (!queue_.get_latest_end(tail)) {
         return false;
     }
 
-    const packet::timestamp_t tail = latest->end();
-
     latency = packet::timestamp_diff(tail, head);
     return true;
 }
 
+bool LatencyMonitor::get_e2e_latency_(packet::timestamp_diff_t& latency) const {
+    if (!depacketizer_.started() || !has_mapping_ || !has_playback_time_) {
+        return false;
+    }
+
+    const packet::timestamp_t head = depacketizer_.timestamp();
+
+    const core::nanoseconds_t capture_time = mapping_capture_time_
+        + packet::timestamp_to_ns(packet::timestamp_diff(head, mapping_rtp_timestamp_),
+                                  input_sample_rate_);
+
+    latency =
+        packet::timestamp_from_ns(playback_time_ - capture_time, input_sample_rate_);
+    return true;
+}
+
 bool LatencyMonitor::check_latency_(packet::timestamp_diff_t latency) const {
     if (latency < min_latency_) {
         roc_log(LogDebug, "latency monitor: latency out of bounds: latency=%ld min=%ld",
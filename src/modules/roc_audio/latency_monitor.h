@@ -15,6 +15,7 @@
 #include "roc_audio/depacketizer.h"
 #include "roc_audio/freq_estimator.h"
 #include "roc_audio/resampler_reader.h"
+#include "roc_core/iclock.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/rate_limiter.h"
 #include "roc_core/time.h"
@@ -24,8 +25,29 @@
 namespace roc {
 namespace audio {
 
+//! Latency measurement mode.
+enum LatencyMode {
+    //! Measure queue latency.
+    //! @remarks
+    //!  Latency is the distance between the next sample to be played and the
+    //!  last received sample. Network and playback delays are not accounted.
+    LatencyMode_Queue,
+
+    //! Measure end-to-end latency.
+    //! @remarks
+    //!  Latency is the distance between the moment when a sample was captured
+    //!  on sender and the moment when it's played on receiver. Requires RTCP
+    //!  sender reports, playback time reported by the sink, and sender and
+    //!  receiver wall clocks being synchronized, e.g. using NTP or PTP.
+    LatencyMode_E2E
+};
+
 //! Parameters for latency monitor.
 struct LatencyMonitorConfig {
+    //! Latency measurement mode.
+    //! Defines what latency is compared with target, min, and max latency.
+    LatencyMode latency_mode;
+
     //! FreqEstimator update interval, nanoseconds.
     //! How often to run FreqEstimator and update Resampler scaling.
     core::nanoseconds_t fe_update_interval;
@@ -44,7 +66,8 @@ struct LatencyMonitorConfig {
     float max_scaling_delta;
 
     LatencyMonitorConfig()
-        : fe_update_interval(5 * core::Millisecond)
+        : latency_mode(LatencyMode_Queue)
+        , fe_update_interval(5 * core::Millisecond)
         , min_latency(0)
         , max_latency(0)
         , max_scaling_delta(0.005f) {
@@ -68,13 +91,15 @@ public:
     //!  - @p target_latency defines FreqEstimator target latency, in samples
     //!  - @p input_sample_rate is the sample rate of the input packets
     //!  - @p output_sample_rate is the sample rate of the output frames
+    //!  - @p clock is used to rate-limit reports
     LatencyMonitor(const packet::SortedQueue& queue,
                    const Depacketizer& depacketizer,
                    ResamplerReader* resampler,
                    const LatencyMonitorConfig& config,
                    core::nanoseconds_t target_latency,
                    size_t input_sample_rate,
-                   size_t output_sample_rate);
+                   size_t output_sample_rate,
+                   core::IClock& clock);
 
     //! Check if the object was initialized successfully.
     bool valid() const;
@@ -84,8 +109,24 @@ public:
     //!  false if the session should be terminated.
     bool update(packet::timestamp_t time);
 
+    //! Set mapping between RTP timestamps and sender wall clock.
+    //! @remarks
+    //!  @p capture_time is wall clock time, in nanoseconds since Unix epoch,
+    //!  when the sample with @p rtp_timestamp was captured on sender. It is
+    //!  usually obtained from RTCP sender report. Used in E2E mode.
+    void set_mapping(packet::timestamp_t rtp_timestamp, core::nanoseconds_t capture_time);
+
+    //! Set playback time of the next sample.
+    //! @remarks
+    //!  @p playback_time is wall clock time, in nanoseconds since Unix epoch,
+    //!  when the next sample read from depacketizer is expected to be played.
+    //!  Used in E2E mode.
+    void reclock(core::nanoseconds_t playback_time);
+
 private:
     bool get_latency_(packet::timestamp_diff_t& latency) const;
+    bool get_queue_latency_(packet::timestamp_diff_t& latency) const;
+    bool get_e2e_latency_(packet::timestamp_diff_t& latency) const;
     bool check_latency_(packet::timestamp_diff_t latency) const;
 
     float trim_scaling_(float scaling) const;
@@ -113,6 +154,16 @@ private:
     const float max_scaling_delta_;
     float sample_rate_coeff_;
 
+    const LatencyMode latency_mode_;
+    const size_t input_sample_rate_;
+
+    packet::timestamp_t mapping_rtp_timestamp_;
+    core::nanoseconds_t mapping_capture_time_;
+    bool has_mapping_;
+
+    core::nanoseconds_t playback_time_;
+    bool has_playback_time_;
+
     bool valid_;
 };
 
@@ -24,8 +24,8 @@ ProfilingWriter::ProfilingWriter(IWriter& writer,
                                  size_t sample_rate)
     : writer_(writer)
     , rate_limiter_(LogInterval)
-    , avg_speed_(0)
-    , avg_len_(0)
+    , total_samples_(0)
+    , total_time_(0)
     , sample_rate_(sample_rate)
     , num_channels_(packet::num_channels(channels)) {
     if (num_channels_ == 0) {
@@ -43,9 +43,7 @@ void ProfilingWriter::write(Frame& frame) {
 
     const core::nanoseconds_t elapsed = write_(frame);
 
-    const double speed = (double)frame.size() / num_channels_ / elapsed * core::Second;
-
-    update_(speed);
+    update_(frame.size() / num_channels_, elapsed);
 }
 
 core::nanoseconds_t ProfilingWriter::write_(Frame& frame) {
@@ -56,13 +54,21 @@ core::nanoseconds_t ProfilingWriter::write_(Frame& frame) {
     return core::timestamp() - start;
 }
 
-void ProfilingWriter::update_(double speed) {
-    avg_len_ += 1;
-    avg_speed_ += (speed - avg_speed_) / avg_len_;
+void ProfilingWriter::update_(size_t n_samples, core::nanoseconds_t elapsed) {
+    // Total samples divided by total time, rather than the mean of per-frame
+    // speeds, so that writes which sometimes block are not overestimated.
+    total_samples_ += n_samples;
+    total_time_ += elapsed;
+
+    if (total_time_ <= 0) {
+        return;
+    }
 
     if (rate_limiter_.allow()) {
+        const double speed = total_samples_ / total_time_ * core::Second;
+
         roc_log(LogDebug, "profiling writer: %lu sample/sec (%.2f sec/sec)",
-                (unsigned long)avg_speed_, avg_speed_ / sample_rate_);
+                (unsigned long)speed, speed / sample_rate_);
     }
 }
 
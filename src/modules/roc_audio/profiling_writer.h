@@ -32,14 +32,14 @@ public:
 
 private:
     core::nanoseconds_t write_(Frame& frame);
-    void update_(double speed);
+    void update_(size_t n_samples, core::nanoseconds_t elapsed);
 
     IWriter& writer_;
 
     core::RateLimiter rate_limiter_;
 
-    double avg_speed_;
-    double avg_len_;
+    double total_samples_;
+    double total_time_;
 
     const size_t sample_rate_;
     const size_t num_channels_;
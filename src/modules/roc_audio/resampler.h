@@ -14,9 +14,10 @@
 
 #include "roc_audio/frame.h"
 #include "roc_audio/ireader.h"
+#include "roc_audio/sinc_table.h"
 #include "roc_audio/units.h"
-#include "roc_core/array.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/shared_ptr.h"
 #include "roc_core/slice.h"
 #include "roc_core/stddefs.h"
 #include "roc_packet/units.h"
@@ -45,14 +46,21 @@ struct ResamplerConfig {
 };
 
 //! Resamples audio stream with non-integer dynamically changing factor.
+//! @remarks
+//!  Sinc table is obtained from SincTableCache and is shared with other
+//!  resamplers with the same window parameters.
 class Resampler : public core::NonCopyable<> {
 public:
     //! Initialize.
-    Resampler(core::IAllocator& allocator,
-              const ResamplerConfig& config,
+    Resampler(const ResamplerConfig& config,
               packet::channel_mask_t channels,
               size_t frame_size);
 
+    //! Destroy.
+    //! @remarks
+    //!  Releases sinc table to SincTableCache.
+    ~Resampler();
+
     //! Check if object is successfully constructed.
     bool valid() const;
 
@@ -94,7 +102,7 @@ private:
 
     bool check_config_() const;
 
-    bool fill_sinc_();
+    bool init_sinc_();
     sample_t sinc_(fixedpoint_t x, float fract_x);
 
     sample_t* prev_frame_;
@@ -114,7 +122,7 @@ private:
     const size_t window_interp_;
     const size_t window_interp_bits_;
 
-    core::Array<sample_t> sinc_table_;
+    core::SharedPtr<SincTable> sinc_table_;
     const sample_t* sinc_table_ptr_;
 
     // half window len in Q8.24 in terms of input signal
@@ -17,11 +17,10 @@ namespace audio {
 
 ResamplerWriter::ResamplerWriter(IWriter& writer,
                                  core::BufferPool<sample_t>& buffer_pool,
-                                 core::IAllocator& allocator,
                                  const ResamplerConfig& config,
                                  packet::channel_mask_t channels,
                                  size_t frame_size)
-    : resampler_(allocator, config, channels, frame_size)
+    : resampler_(config, channels, frame_size)
     , writer_(writer)
     , frame_pos_(0)
     , frame_size_(frame_size)
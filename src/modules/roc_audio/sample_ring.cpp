@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/sample_ring.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace audio {
+
+SampleRing::SampleRing(core::IAllocator& allocator, size_t capacity)
+    : buff_(allocator)
+    , write_pos_(0)
+    , read_pos_(0)
+    , valid_(false) {
+    if (capacity == 0) {
+        roc_log(LogError, "sample ring: capacity should be > 0");
+        return;
+    }
+
+    if (!buff_.resize(capacity)) {
+        roc_log(LogError, "sample ring: can't allocate buffer: capacity=%lu",
+                (unsigned long)capacity);
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool SampleRing::valid() const {
+    return valid_;
+}
+
+size_t SampleRing::capacity() const {
+    return buff_.size();
+}
+
+size_t SampleRing::readable() const {
+    return (size_t)(long)size_;
+}
+
+size_t SampleRing::writable() const {
+    return buff_.size() - readable();
+}
+
+size_t SampleRing::write(const sample_t* samples, size_t n_samples) {
+    roc_panic_if(!valid_);
+
+    if (n_samples > writable()) {
+        n_samples = writable();
+    }
+
+    for (size_t n = 0; n < n_samples; n++) {
+        buff_[write_pos_] = samples[n];
+        if (++write_pos_ == buff_.size()) {
+            write_pos_ = 0;
+        }
+    }
+
+    // publishes written samples to the consumer; implies a full barrier
+    size_ += (long)n_samples;
+
+    return n_samples;
+}
+
+size_t SampleRing::read(sample_t* samples, size_t n_samples) {
+    roc_panic_if(!valid_);
+
+    if (n_samples > readable()) {
+        n_samples = readable();
+    }
+
+    for (size_t n = 0; n < n_samples; n++) {
+        samples[n] = buff_[read_pos_];
+        if (++read_pos_ == buff_.size()) {
+            read_pos_ = 0;
+        }
+    }
+
+    // releases read samples to the producer; implies a full barrier
+    size_ -= (long)n_samples;
+
+    return n_samples;
+}
+
+} // namespace audio
+} // namespace roc
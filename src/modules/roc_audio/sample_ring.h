@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/sample_ring.h
+//! @brief Sample ring buffer.
+
+#ifndef ROC_AUDIO_SAMPLE_RING_H_
+#define ROC_AUDIO_SAMPLE_RING_H_
+
+#include "roc_audio/units.h"
+#include "roc_core/array.h"
+#include "roc_core/atomic.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+//! Sample ring buffer.
+//! @remarks
+//!  Lock-free single-producer single-consumer ring. write() may be called
+//!  from one thread and read() from another thread concurrently without
+//!  any locks. Neither of them ever blocks.
+class SampleRing : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  @p capacity defines the maximum number of samples in ring.
+    SampleRing(core::IAllocator& allocator, size_t capacity);
+
+    //! Check if the ring was successfully constructed.
+    bool valid() const;
+
+    //! Get maximum number of samples in ring.
+    size_t capacity() const;
+
+    //! Get number of samples that may be read.
+    size_t readable() const;
+
+    //! Get number of samples that may be written.
+    size_t writable() const;
+
+    //! Write samples.
+    //! @returns
+    //!  number of samples written, which is less than @p n_samples if the
+    //!  ring is full.
+    size_t write(const sample_t* samples, size_t n_samples);
+
+    //! Read samples.
+    //! @returns
+    //!  number of samples read, which is less than @p n_samples if the
+    //!  ring is empty.
+    size_t read(sample_t* samples, size_t n_samples);
+
+private:
+    core::Array<sample_t> buff_;
+
+    // number of samples in ring; written by both sides
+    core::Atomic size_;
+
+    // positions owned by producer and consumer, respectively
+    size_t write_pos_;
+    size_t read_pos_;
+
+    bool valid_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_SAMPLE_RING_H_
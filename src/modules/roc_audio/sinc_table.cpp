@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/sinc_table.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace audio {
+
+SincTable::SincTable(core::IAllocator& allocator,
+                     size_t window_size,
+                     size_t window_interp)
+    : allocator_(allocator)
+    , window_size_(window_size)
+    , window_interp_(window_interp)
+    , table_(allocator)
+    , valid_(false) {
+    if (!fill_()) {
+        return;
+    }
+
+    roc_log(LogDebug, "sinc table: initializing: window_size=%lu window_interp=%lu",
+            (unsigned long)window_size_, (unsigned long)window_interp_);
+
+    valid_ = true;
+}
+
+bool SincTable::valid() const {
+    return valid_;
+}
+
+size_t SincTable::window_size() const {
+    return window_size_;
+}
+
+size_t SincTable::window_interp() const {
+    return window_interp_;
+}
+
+const sample_t* SincTable::data() const {
+    roc_panic_if(!valid_);
+
+    return &table_[0];
+}
+
+size_t SincTable::size() const {
+    return table_.size();
+}
+
+void SincTable::destroy() {
+    allocator_.destroy(*this);
+}
+
+bool SincTable::fill_() {
+    if (!table_.resize(window_size_ * window_interp_ + 2)) {
+        roc_log(LogError, "sinc table: can't allocate table");
+        return false;
+    }
+
+    const double sinc_step = 1.0 / (double)window_interp_;
+    double sinc_t = sinc_step;
+
+    table_[0] = 1.0f;
+    for (size_t i = 1; i < table_.size(); ++i) {
+        const double window = 0.54
+            - 0.46
+                * std::cos(2 * M_PI
+                           * ((double)(i - 1) / 2.0 / (double)table_.size() + 0.5));
+        table_[i] = (float)(std::sin(M_PI * sinc_t) / M_PI / sinc_t * window);
+        sinc_t += sinc_step;
+    }
+    table_[table_.size() - 2] = 0;
+    table_[table_.size() - 1] = 0;
+
+    return true;
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/sinc_table.h
+//! @brief Sinc table.
+
+#ifndef ROC_AUDIO_SINC_TABLE_H_
+#define ROC_AUDIO_SINC_TABLE_H_
+
+#include "roc_audio/units.h"
+#include "roc_core/array.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/list_node.h"
+#include "roc_core/refcnt.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+//! Sinc table.
+//! @remarks
+//!  Windowed sinc function sampled on the positive half-plane, used by
+//!  resampler. The table is immutable after construction, so it may be
+//!  shared between resamplers in different threads.
+class SincTable : public core::RefCnt<SincTable>, public core::ListNode {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p window_size is the number of zero crossings on the half-plane
+    //!  - @p window_interp is the number of table points per zero crossing
+    SincTable(core::IAllocator& allocator, size_t window_size, size_t window_interp);
+
+    //! Check if the table was successfully constructed.
+    bool valid() const;
+
+    //! Get window size.
+    size_t window_size() const;
+
+    //! Get window interpolation.
+    size_t window_interp() const;
+
+    //! Get table data.
+    const sample_t* data() const;
+
+    //! Get number of points in table.
+    size_t size() const;
+
+private:
+    friend class core::RefCnt<SincTable>;
+
+    void destroy();
+
+    bool fill_();
+
+    core::IAllocator& allocator_;
+
+    const size_t window_size_;
+    const size_t window_interp_;
+
+    core::Array<sample_t> table_;
+    bool valid_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_SINC_TABLE_H_
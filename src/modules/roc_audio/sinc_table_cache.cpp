@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/sinc_table_cache.h"
+#include "roc_core/log.h"
+
+namespace roc {
+namespace audio {
+
+SincTableCache::SincTableCache() {
+}
+
+core::SharedPtr<SincTable> SincTableCache::get(size_t window_size,
+                                               size_t window_interp) {
+    core::Mutex::Lock lock(mutex_);
+
+    core::SharedPtr<SincTable> table;
+
+    for (table = tables_.front(); table; table = tables_.nextof(*table)) {
+        if (table->window_size() == window_size
+            && table->window_interp() == window_interp) {
+            return table;
+        }
+    }
+
+    table = new (allocator_) SincTable(allocator_, window_size, window_interp);
+    if (!table || !table->valid()) {
+        roc_log(LogError, "sinc table cache: can't create table");
+        return NULL;
+    }
+
+    tables_.push_back(*table);
+
+    return table;
+}
+
+void SincTableCache::release(core::SharedPtr<SincTable>& table) {
+    if (!table) {
+        return;
+    }
+
+    core::Mutex::Lock lock(mutex_);
+
+    SincTable& released = *table;
+    table.reset();
+
+    // if the cache holds the only reference, nobody else can reach the table,
+    // and new references are taken from the cache only under the lock
+    if (released.getref() == 1) {
+        roc_log(LogDebug,
+                "sinc table cache: removing table: window_size=%lu window_interp=%lu",
+                (unsigned long)released.window_size(),
+                (unsigned long)released.window_interp());
+
+        tables_.remove(released);
+    }
+}
+
+size_t SincTableCache::size() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return tables_.size();
+}
+
+} // namespace audio
+} // namespace roc
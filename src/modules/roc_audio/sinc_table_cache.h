@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/sinc_table_cache.h
+//! @brief Sinc table cache.
+
+#ifndef ROC_AUDIO_SINC_TABLE_CACHE_H_
+#define ROC_AUDIO_SINC_TABLE_CACHE_H_
+
+#include "roc_audio/sinc_table.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/list.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_core/singleton.h"
+
+namespace roc {
+namespace audio {
+
+//! Sinc table cache.
+//! @remarks
+//!  Process-wide cache of sinc tables, keyed by window size and window
+//!  interpolation. A table is computed when it's requested for the first
+//!  time and is then shared by all resamplers with the same parameters.
+//!  A table is removed from cache when its last user releases it.
+class SincTableCache : public core::NonCopyable<> {
+public:
+    //! Get instance.
+    static SincTableCache& instance() {
+        return core::Singleton<SincTableCache>::instance();
+    }
+
+    //! Get sinc table for given parameters.
+    //! @returns
+    //!  shared table, or NULL if the table can't be allocated.
+    //! @remarks
+    //!  Thread-safe.
+    core::SharedPtr<SincTable> get(size_t window_size, size_t window_interp);
+
+    //! Release sinc table obtained from get().
+    //! @remarks
+    //!  Resets @p table and removes the table from cache if there are no
+    //!  other references to it. Thread-safe.
+    void release(core::SharedPtr<SincTable>& table);
+
+    //! Get number of cached tables.
+    size_t size() const;
+
+private:
+    friend class core::Singleton<SincTableCache>;
+
+    SincTableCache();
+
+    core::HeapAllocator allocator_;
+    core::List<SincTable> tables_;
+    core::Mutex mutex_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_SINC_TABLE_CACHE_H_
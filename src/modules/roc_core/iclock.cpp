@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/iclock.h"
+
+namespace roc {
+namespace core {
+
+IClock::~IClock() {
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/iclock.h
+//! @brief Clock interface.
+
+#ifndef ROC_CORE_ICLOCK_H_
+#define ROC_CORE_ICLOCK_H_
+
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+//! Clock interface.
+//! @remarks
+//!  Allows to replace system time with virtual time, e.g. to run the
+//!  pipeline in simulation faster than real time.
+class IClock {
+public:
+    virtual ~IClock();
+
+    //! Get current monotonic time in nanoseconds.
+    virtual nanoseconds_t now() = 0;
+
+    //! Get current wall clock time in nanoseconds since Unix epoch.
+    virtual nanoseconds_t now_unix() = 0;
+
+    //! Sleep until the specified monotonic time point.
+    virtual void sleep_until(nanoseconds_t time) = 0;
+
+    //! Busy-wait until the specified monotonic time point.
+    virtual void spin_until(nanoseconds_t time) = 0;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_ICLOCK_H_
@@ -12,7 +12,9 @@
 #ifndef ROC_CORE_RATE_LIMITER_H_
 #define ROC_CORE_RATE_LIMITER_H_
 
+#include "roc_core/iclock.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/system_clock.h"
 #include "roc_core/ticker.h"
 
 namespace roc {
@@ -24,10 +26,11 @@ public:
     //! Initialize rate limiter.
     //! @remarks
     //!  @p period is tick duration in nanoseconds.
-    explicit RateLimiter(nanoseconds_t period)
+    //!  @p clock is used to get current time.
+    explicit RateLimiter(nanoseconds_t period, IClock& clock = SystemClock::instance())
         : period_(Ticker::Ticks(period))
         , pos_(0)
-        , ticker_(Second / Nanosecond) {
+        , ticker_(Second / Nanosecond, 0, clock) {
         if (period <= 0) {
             roc_panic("rate limiter: expected positive period, got %ld", (long)period);
         }
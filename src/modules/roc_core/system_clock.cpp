@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/system_clock.h"
+
+namespace roc {
+namespace core {
+
+SystemClock::SystemClock() {
+}
+
+nanoseconds_t SystemClock::now() {
+    return timestamp();
+}
+
+nanoseconds_t SystemClock::now_unix() {
+    return timestamp_unix();
+}
+
+void SystemClock::sleep_until(nanoseconds_t time) {
+    core::sleep_until(time);
+}
+
+void SystemClock::spin_until(nanoseconds_t time) {
+    while (timestamp() < time) {
+    }
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/system_clock.h
+//! @brief System clock.
+
+#ifndef ROC_CORE_SYSTEM_CLOCK_H_
+#define ROC_CORE_SYSTEM_CLOCK_H_
+
+#include "roc_core/iclock.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/singleton.h"
+
+namespace roc {
+namespace core {
+
+//! System clock.
+//! @remarks
+//!  Forwards to timestamp(), timestamp_unix() and sleep_until().
+class SystemClock : public IClock, public NonCopyable<> {
+public:
+    //! Get instance.
+    static SystemClock& instance() {
+        return Singleton<SystemClock>::instance();
+    }
+
+    //! Get current monotonic time in nanoseconds.
+    virtual nanoseconds_t now();
+
+    //! Get current wall clock time in nanoseconds since Unix epoch.
+    virtual nanoseconds_t now_unix();
+
+    //! Sleep until the specified monotonic time point.
+    virtual void sleep_until(nanoseconds_t time);
+
+    //! Busy-wait until the specified monotonic time point.
+    virtual void spin_until(nanoseconds_t time);
+
+private:
+    friend class Singleton<SystemClock>;
+
+    SystemClock();
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_SYSTEM_CLOCK_H_
@@ -53,6 +53,25 @@ public:
         return __sync_sub_and_fetch(&value_, 1);
     }
 
+    //! Atomic addition.
+    long operator+=(long v) {
+        return __sync_add_and_fetch(&value_, v);
+    }
+
+    //! Atomic subtraction.
+    long operator-=(long v) {
+        return __sync_sub_and_fetch(&value_, v);
+    }
+
+    //! Atomic compare-and-swap.
+    //! @remarks
+    //!  Sets value to @p desired if it's equal to @p expected.
+    //! @returns
+    //!  true if the value was updated.
+    bool compare_exchange(long expected, long desired) {
+        return __sync_bool_compare_and_swap(&value_, expected, desired);
+    }
+
 private:
     mutable long value_;
 };
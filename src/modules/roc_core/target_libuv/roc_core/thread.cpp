@@ -17,6 +17,7 @@ namespace core {
 Thread::Thread()
     : started_(0)
     , joinable_(0) {
+    name_[0] = '\0';
 }
 
 Thread::~Thread() {
@@ -29,6 +30,22 @@ bool Thread::joinable() const {
     return joinable_;
 }
 
+void Thread::set_attributes(const ThreadAttributes& attrs) {
+    Mutex::Lock lock(mutex_);
+
+    if (started_) {
+        roc_panic("thread: can't set attributes after starting thread");
+    }
+
+    attrs_ = attrs;
+
+    if (attrs.name) {
+        strncpy(name_, attrs.name, sizeof(name_) - 1);
+        name_[sizeof(name_) - 1] = '\0';
+        attrs_.name = name_;
+    }
+}
+
 bool Thread::start() {
     Mutex::Lock lock(mutex_);
 
@@ -65,7 +82,11 @@ void Thread::join() {
 }
 
 void Thread::thread_runner_(void* ptr) {
-    static_cast<Thread*>(ptr)->run();
+    Thread& self = *static_cast<Thread*>(ptr);
+
+    apply_thread_attributes(self.attrs_);
+
+    self.run();
 }
 
 } // namespace core
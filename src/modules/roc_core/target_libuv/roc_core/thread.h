@@ -17,6 +17,7 @@
 #include "roc_core/atomic.h"
 #include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/thread_attributes.h"
 
 namespace roc {
 namespace core {
@@ -29,6 +30,13 @@ public:
     //!  true if start() was called and join() was not called yet.
     bool joinable() const;
 
+    //! Set attributes for the thread.
+    //! @remarks
+    //!  Should be called before start(). The attributes are applied by the
+    //!  new thread before executing run(). If some of them can't be applied,
+    //!  the thread still runs without them.
+    void set_attributes(const ThreadAttributes& attrs);
+
     //! Start thread.
     //! @remarks
     //!  Executes run() in new thread.
@@ -55,6 +63,9 @@ private:
     int started_;
     Atomic joinable_;
 
+    ThreadAttributes attrs_;
+    char name_[ThreadAttributes::MaxNameLen + 1];
+
     Mutex mutex_;
 };
 
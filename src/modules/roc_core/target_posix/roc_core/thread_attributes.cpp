@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/thread_attributes.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+bool set_name(const char* name) {
+    char buf[ThreadAttributes::MaxNameLen + 1] = {};
+    strncpy(buf, name, sizeof(buf) - 1);
+
+#if defined(__GLIBC__) || defined(__ANDROID__)
+    if (int err = pthread_setname_np(pthread_self(), buf)) {
+        roc_log(LogError, "thread: can't set name: pthread_setname_np(): %s",
+                errno_to_str(err).c_str());
+        return false;
+    }
+    return true;
+#elif defined(__APPLE__)
+    if (int err = pthread_setname_np(buf)) {
+        roc_log(LogError, "thread: can't set name: pthread_setname_np(): %s",
+                errno_to_str(err).c_str());
+        return false;
+    }
+    return true;
+#else
+    roc_log(LogInfo, "thread: can't set name: not supported on this platform");
+    return false;
+#endif
+}
+
+bool set_affinity(uint64_t cpu_mask) {
+#if defined(CPU_SET) && !defined(__ANDROID__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+
+    for (size_t n = 0; n < 64 && n < CPU_SETSIZE; n++) {
+        if (cpu_mask & (uint64_t(1) << n)) {
+            CPU_SET(n, &cpus);
+        }
+    }
+
+    if (int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus)) {
+        roc_log(LogError,
+                "thread: can't set cpu affinity, continuing without it:"
+                " pthread_setaffinity_np(): %s",
+                errno_to_str(err).c_str());
+        return false;
+    }
+    return true;
+#else
+    (void)cpu_mask;
+    roc_log(LogInfo, "thread: can't set cpu affinity: not supported on this platform");
+    return false;
+#endif
+}
+
+bool set_scheduling(SchedPolicy sched_policy, int sched_priority) {
+    int policy = SCHED_OTHER;
+
+    switch (sched_policy) {
+    case SchedPolicy_FIFO:
+        policy = SCHED_FIFO;
+        break;
+    case SchedPolicy_RR:
+        policy = SCHED_RR;
+        break;
+    case SchedPolicy_Default:
+        return true;
+    }
+
+    const int min_priority = sched_get_priority_min(policy);
+    const int max_priority = sched_get_priority_max(policy);
+
+    sched_param param;
+    memset(&param, 0, sizeof(param));
+
+    param.sched_priority = sched_priority;
+    if (param.sched_priority < min_priority) {
+        param.sched_priority = min_priority;
+    }
+    if (param.sched_priority > max_priority) {
+        param.sched_priority = max_priority;
+    }
+
+    if (int err = pthread_setschedparam(pthread_self(), policy, &param)) {
+        roc_log(LogError,
+                "thread: can't set real-time scheduling, continuing with default"
+                " policy: pthread_setschedparam(): %s",
+                errno_to_str(err).c_str());
+        return false;
+    }
+
+    roc_log(LogDebug, "thread: set real-time scheduling: policy=%s priority=%d",
+            policy == SCHED_FIFO ? "fifo" : "rr", param.sched_priority);
+
+    return true;
+}
+
+} // namespace
+
+bool apply_thread_attributes(const ThreadAttributes& attrs) {
+    bool ok = true;
+
+    if (attrs.name && *attrs.name) {
+        ok = set_name(attrs.name) && ok;
+    }
+
+    if (attrs.cpu_mask != 0) {
+        ok = set_affinity(attrs.cpu_mask) && ok;
+    }
+
+    if (attrs.sched_policy != SchedPolicy_Default) {
+        ok = set_scheduling(attrs.sched_policy, attrs.sched_priority) && ok;
+    }
+
+    return ok;
+}
+
+} // namespace core
+} // namespace roc
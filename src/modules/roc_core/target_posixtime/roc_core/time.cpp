@@ -36,6 +36,24 @@ nanoseconds_t timestamp() {
 }
 #endif // defined(CLOCK_MONOTONIC)
 
+#if defined(CLOCK_REALTIME)
+nanoseconds_t timestamp_unix() {
+    timespec ts;
+    if (clock_gettime(CLOCK_REALTIME, &ts) == -1) {
+        roc_panic("time: clock_gettime(CLOCK_REALTIME): %s", errno_to_str().c_str());
+    }
+    return nanoseconds_t(ts.tv_sec) * 1000000000 + nanoseconds_t(ts.tv_nsec);
+}
+#else  // !defined(CLOCK_REALTIME)
+nanoseconds_t timestamp_unix() {
+    struct timeval tv;
+    if (gettimeofday(&tv, NULL) == -1) {
+        roc_panic("time: gettimeofday(): %s", errno_to_str().c_str());
+    }
+    return nanoseconds_t(tv.tv_sec) * 1000000000 + nanoseconds_t(tv.tv_usec) * 1000;
+}
+#endif // defined(CLOCK_REALTIME)
+
 #if defined(CLOCK_MONOTONIC)
 void sleep_for(nanoseconds_t ns) {
     timespec ts;
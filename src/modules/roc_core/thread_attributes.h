@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/thread_attributes.h
+//! @brief Thread attributes.
+
+#ifndef ROC_CORE_THREAD_ATTRIBUTES_H_
+#define ROC_CORE_THREAD_ATTRIBUTES_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Thread scheduling policy.
+enum SchedPolicy {
+    //! Keep default policy.
+    SchedPolicy_Default,
+
+    //! Real-time first-in first-out policy.
+    SchedPolicy_FIFO,
+
+    //! Real-time round-robin policy.
+    SchedPolicy_RR
+};
+
+//! Thread attributes.
+struct ThreadAttributes {
+    //! Maximum length of thread name.
+    enum { MaxNameLen = 15 };
+
+    //! Thread name.
+    //! @remarks
+    //!  Truncated to MaxNameLen characters. If NULL, the name is not set.
+    const char* name;
+
+    //! Scheduling policy.
+    SchedPolicy sched_policy;
+
+    //! Scheduling priority.
+    //! @remarks
+    //!  Used only with real-time policies. Clamped to the range supported
+    //!  by the policy.
+    int sched_priority;
+
+    //! CPU affinity mask.
+    //! @remarks
+    //!  Bit N allows the thread to run on CPU N. Zero means no restriction.
+    uint64_t cpu_mask;
+
+    ThreadAttributes()
+        : name(NULL)
+        , sched_policy(SchedPolicy_Default)
+        , sched_priority(0)
+        , cpu_mask(0) {
+    }
+};
+
+//! Apply attributes to the calling thread.
+//! @remarks
+//!  Attributes that can't be applied, e.g. because of missing privileges or
+//!  platform support, are reported to log and skipped.
+//! @returns
+//!  false if some of the attributes were not applied.
+bool apply_thread_attributes(const ThreadAttributes& attrs);
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_THREAD_ATTRIBUTES_H_
@@ -12,14 +12,22 @@
 #ifndef ROC_CORE_TICKER_H_
 #define ROC_CORE_TICKER_H_
 
+#include "roc_core/iclock.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/panic.h"
+#include "roc_core/system_clock.h"
 #include "roc_core/time.h"
+#include "roc_core/time_histogram.h"
 
 namespace roc {
 namespace core {
 
 //! Ticker.
+//! @remarks
+//!  By default, wait() just sleeps until the deadline, and the wakeup may be
+//!  late because of timer slack and scheduling jitter. If spin margin is set,
+//!  wait() sleeps until the deadline minus the margin and then busy-waits on
+//!  the monotonic clock until the deadline, trading CPU time for precision.
 class Ticker : public NonCopyable<> {
 public:
     //! Number of ticks.
@@ -28,10 +36,21 @@ public:
     //! Initialize.
     //! @remarks
     //!  @p freq defines the number of ticks per second.
-    explicit Ticker(Ticks freq)
-        : ratio_(double(freq) / Second)
+    //!  @p spin_margin defines how long before the deadline wait() switches
+    //!  from sleeping to busy-waiting; zero disables busy-waiting.
+    //!  @p clock is used to get current time and to wait.
+    explicit Ticker(Ticks freq,
+                    nanoseconds_t spin_margin = 0,
+                    IClock& clock = SystemClock::instance())
+        : clock_(clock)
+        , ratio_(double(freq) / Second)
+        , spin_margin_(spin_margin)
         , start_(0)
         , started_(false) {
+        if (spin_margin < 0) {
+            roc_panic("ticker: expected non-negative spin margin, got %ld",
+                      (long)spin_margin);
+        }
     }
 
     //! Start ticker.
@@ -39,7 +58,7 @@ public:
         if (started_) {
             roc_panic("ticker: can't start ticker twice");
         }
-        start_ = timestamp();
+        start_ = clock_.now();
         started_ = true;
     }
 
@@ -50,23 +69,49 @@ public:
             start();
             return 0;
         } else {
-            return Ticks(double(timestamp() - start_) * ratio_);
+            return Ticks(double(clock_.now() - start_) * ratio_);
         }
     }
 
     //! Wait until the given number of ticks elapses since start.
     //! If ticker is not started yet, it is started automatically.
+    //! The difference between the actual wakeup time and the deadline is
+    //! added to wakeup errors histogram.
     void wait(Ticks ticks) {
         if (!started_) {
             start();
         }
-        sleep_until(start_ + nanoseconds_t(ticks / ratio_));
+
+        const nanoseconds_t deadline = start_ + nanoseconds_t(ticks / ratio_);
+
+        if (clock_.now() >= deadline) {
+            return;
+        }
+
+        if (spin_margin_ != 0) {
+            clock_.sleep_until(deadline - spin_margin_);
+            clock_.spin_until(deadline);
+        } else {
+            clock_.sleep_until(deadline);
+        }
+
+        wakeup_errors_.add(clock_.now() - deadline);
+    }
+
+    //! Get histogram of differences between wakeup times and deadlines.
+    //! @remarks
+    //!  Only waits that actually had to wait are counted.
+    const TimeHistogram& wakeup_errors() const {
+        return wakeup_errors_;
     }
 
 private:
+    IClock& clock_;
     const double ratio_;
+    const nanoseconds_t spin_margin_;
     nanoseconds_t start_;
     bool started_;
+    TimeHistogram wakeup_errors_;
 };
 
 } // namespace core
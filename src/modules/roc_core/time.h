@@ -41,6 +41,12 @@ const nanoseconds_t Hour = 60 * Minute;
 //! Get current timestamp in nanoseconds.
 nanoseconds_t timestamp();
 
+//! Get current wall clock time in nanoseconds since Unix epoch.
+//! @remarks
+//!  Unlike timestamp(), may jump when system time is adjusted. Should be used
+//!  only when the time is exchanged with other hosts, e.g. in RTCP reports.
+nanoseconds_t timestamp_unix();
+
 //! Sleep until the specified absolute time point has been reached.
 //! @remarks
 //!  @p timestamp specifies absolute time point in nanoseconds.
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/time_histogram.h
+//! @brief Time histogram.
+
+#ifndef ROC_CORE_TIME_HISTOGRAM_H_
+#define ROC_CORE_TIME_HISTOGRAM_H_
+
+#include "roc_core/log.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+//! Histogram of time intervals.
+//! @remarks
+//!  Buckets have logarithmic bounds. Bucket i counts intervals less than
+//!  2^i microseconds and not less than the bound of the previous bucket.
+//!  The last bucket counts all larger intervals.
+class TimeHistogram : public NonCopyable<> {
+public:
+    //! Number of buckets.
+    enum { NumBuckets = 12 };
+
+    //! Initialize.
+    TimeHistogram()
+        : total_(0)
+        , max_(0) {
+        for (size_t n = 0; n < NumBuckets; n++) {
+            buckets_[n] = 0;
+        }
+    }
+
+    //! Add interval.
+    //! @remarks
+    //!  Negative intervals are counted as zero.
+    void add(nanoseconds_t interval) {
+        if (interval < 0) {
+            interval = 0;
+        }
+
+        size_t n = 0;
+        while (n < NumBuckets - 1 && interval >= upper_bound(n)) {
+            n++;
+        }
+
+        buckets_[n]++;
+        total_++;
+
+        if (interval > max_) {
+            max_ = interval;
+        }
+    }
+
+    //! Get exclusive upper bound of bucket.
+    //! @remarks
+    //!  The last bucket has no upper bound, and zero is returned for it.
+    static nanoseconds_t upper_bound(size_t bucket) {
+        if (bucket >= NumBuckets) {
+            roc_panic("time histogram: bucket out of range: bucket=%lu",
+                      (unsigned long)bucket);
+        }
+        if (bucket == NumBuckets - 1) {
+            return 0;
+        }
+        return (nanoseconds_t(1) << bucket) * Microsecond;
+    }
+
+    //! Get number of intervals in bucket.
+    size_t count(size_t bucket) const {
+        if (bucket >= NumBuckets) {
+            roc_panic("time histogram: bucket out of range: bucket=%lu",
+                      (unsigned long)bucket);
+        }
+        return buckets_[bucket];
+    }
+
+    //! Get total number of intervals.
+    size_t total() const {
+        return total_;
+    }
+
+    //! Get maximum interval.
+    nanoseconds_t max() const {
+        return max_;
+    }
+
+    //! Print histogram to log.
+    //! @remarks
+    //!  Prints one line with summary and one line per non-empty bucket.
+    void log(LogLevel level, const char* name) const {
+        if (total_ == 0) {
+            return;
+        }
+
+        roc_log(level, "%s: total=%lu max=%.3fms", name, (unsigned long)total_,
+                (double)max_ / Millisecond);
+
+        for (size_t n = 0; n < NumBuckets; n++) {
+            if (buckets_[n] == 0) {
+                continue;
+            }
+            if (n == NumBuckets - 1) {
+                roc_log(level, "%s:  >=%ldus %lu", name,
+                        (long)(upper_bound(n - 1) / Microsecond),
+                        (unsigned long)buckets_[n]);
+            } else {
+                roc_log(level, "%s:  <%ldus %lu", name,
+                        (long)(upper_bound(n) / Microsecond),
+                        (unsigned long)buckets_[n]);
+            }
+        }
+    }
+
+private:
+    size_t buckets_[NumBuckets];
+    size_t total_;
+    nanoseconds_t max_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_TIME_HISTOGRAM_H_
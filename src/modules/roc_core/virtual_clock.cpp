@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/virtual_clock.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace core {
+
+VirtualClock::VirtualClock(nanoseconds_t unix_epoch)
+    : unix_epoch_(unix_epoch)
+    , time_(0) {
+}
+
+void VirtualClock::advance(nanoseconds_t duration) {
+    if (duration < 0) {
+        roc_panic("virtual clock: expected non-negative duration, got %ld",
+                  (long)duration);
+    }
+
+    Mutex::Lock lock(mutex_);
+    time_ += duration;
+}
+
+nanoseconds_t VirtualClock::now() {
+    Mutex::Lock lock(mutex_);
+    return time_;
+}
+
+nanoseconds_t VirtualClock::now_unix() {
+    Mutex::Lock lock(mutex_);
+    return unix_epoch_ + time_;
+}
+
+void VirtualClock::sleep_until(nanoseconds_t time) {
+    Mutex::Lock lock(mutex_);
+    if (time > time_) {
+        time_ = time;
+    }
+}
+
+void VirtualClock::spin_until(nanoseconds_t time) {
+    sleep_until(time);
+}
+
+} // namespace core
+} // namespace roc
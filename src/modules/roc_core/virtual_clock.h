@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/virtual_clock.h
+//! @brief Virtual clock.
+
+#ifndef ROC_CORE_VIRTUAL_CLOCK_H_
+#define ROC_CORE_VIRTUAL_CLOCK_H_
+
+#include "roc_core/iclock.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+
+namespace roc {
+namespace core {
+
+//! Virtual clock.
+//! @remarks
+//!  Time advances only when advance() is called or when somebody sleeps or
+//!  spins on the clock, in which case the time jumps to the requested time
+//!  point immediately. Thus, code that waits on this clock runs as fast as
+//!  possible, but observes a consistent timeline.
+class VirtualClock : public IClock, public NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  @p unix_epoch defines wall clock time corresponding to zero
+    //!  monotonic time.
+    explicit VirtualClock(nanoseconds_t unix_epoch = 0);
+
+    //! Advance time by given duration.
+    void advance(nanoseconds_t duration);
+
+    //! Get current monotonic time in nanoseconds.
+    virtual nanoseconds_t now();
+
+    //! Get current wall clock time in nanoseconds since Unix epoch.
+    virtual nanoseconds_t now_unix();
+
+    //! Advance time to the specified time point, if it's in future.
+    virtual void sleep_until(nanoseconds_t time);
+
+    //! Advance time to the specified time point, if it's in future.
+    virtual void spin_until(nanoseconds_t time);
+
+private:
+    const nanoseconds_t unix_epoch_;
+    nanoseconds_t time_;
+    Mutex mutex_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_VIRTUAL_CLOCK_H_
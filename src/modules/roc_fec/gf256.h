@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/gf256.h
+//! @brief GF(2^8) arithmetic.
+
+#ifndef ROC_FEC_GF256_H_
+#define ROC_FEC_GF256_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace fec {
+
+//! Multiply two elements of GF(2^8).
+uint8_t gf256_mul(uint8_t a, uint8_t b);
+
+//! Get multiplicative inverse of non-zero element of GF(2^8).
+uint8_t gf256_inv(uint8_t a);
+
+//! Multiply every byte of @p dst by @p coef.
+void gf256_mul_region(uint8_t* dst, uint8_t coef, size_t size);
+
+//! Add @p src multiplied by @p coef to @p dst.
+//! @remarks
+//!  Computes dst[i] = dst[i] + coef * src[i], where addition is XOR.
+void gf256_mul_add_region(uint8_t* dst, const uint8_t* src, uint8_t coef, size_t size);
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_GF256_H_
@@ -260,6 +260,152 @@ public:
     }
 };
 
+//! RLC Source FEC Payload ID.
+//!
+//! @remarks
+//!  Source packets of sliding window scheme are identified by a sequential
+//!  encoding symbol ID, which can wrap. There are no source blocks.
+//!
+//! @code
+//!    0                   1
+//!    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |   Encoding Symbol ID (ESI)    |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+class ROC_ATTR_PACKED RLC_Source_PayloadID {
+private:
+    //! Encoding symbol ID.
+    uint16_t esi_;
+
+public:
+    //! Get FEC scheme to which these packets belong to.
+    static packet::FECScheme fec_scheme() {
+        return packet::FEC_RLC;
+    }
+
+    //! Clear header.
+    void clear() {
+        memset(this, 0, sizeof(*this));
+    }
+
+    //! Get source block number.
+    uint16_t sbn() const {
+        return 0;
+    }
+
+    //! Set source block number.
+    void set_sbn(uint16_t) {
+    }
+
+    //! Get encoding symbol ID.
+    uint16_t esi() const {
+        return core::ntoh16(esi_);
+    }
+
+    //! Set encoding symbol ID.
+    void set_esi(uint16_t val) {
+        esi_ = core::hton16(val);
+    }
+
+    //! Get source block length.
+    uint16_t k() const {
+        return 0;
+    }
+
+    //! Set source block length.
+    void set_k(uint16_t) {
+    }
+
+    //! Get number encoding symbols.
+    uint16_t n() const {
+        return 0;
+    }
+
+    //! Set number encoding symbols.
+    void set_n(uint16_t) {
+    }
+};
+
+//! RLC Repair FEC Payload ID.
+//!
+//! @remarks
+//!  Repair packet protects an encoding window of NSS source packets starting
+//!  from FSS_ESI. Repair_Key seeds the coding coefficients. The fields are
+//!  mapped to packet::FEC as follows: repair key to encoding_symbol_id,
+//!  FSS_ESI to source_block_number, NSS to source_block_length.
+//!
+//! @code
+//!    0                   1                   2                   3
+//!    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |       Repair_Key              | Number of Source Symbols (NSS)|
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |   First Source Symbol ESI     |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+class ROC_ATTR_PACKED RLC_Repair_PayloadID {
+private:
+    //! Repair key.
+    uint16_t key_;
+
+    //! Number of source symbols in encoding window.
+    uint16_t nss_;
+
+    //! ESI of first source symbol in encoding window.
+    uint16_t fss_esi_;
+
+public:
+    //! Get FEC scheme to which these packets belong to.
+    static packet::FECScheme fec_scheme() {
+        return packet::FEC_RLC;
+    }
+
+    //! Clear header.
+    void clear() {
+        memset(this, 0, sizeof(*this));
+    }
+
+    //! Get first source symbol ESI.
+    uint16_t sbn() const {
+        return core::ntoh16(fss_esi_);
+    }
+
+    //! Set first source symbol ESI.
+    void set_sbn(uint16_t val) {
+        fss_esi_ = core::hton16(val);
+    }
+
+    //! Get repair key.
+    uint16_t esi() const {
+        return core::ntoh16(key_);
+    }
+
+    //! Set repair key.
+    void set_esi(uint16_t val) {
+        key_ = core::hton16(val);
+    }
+
+    //! Get number of source symbols in encoding window.
+    uint16_t k() const {
+        return core::ntoh16(nss_);
+    }
+
+    //! Set number of source symbols in encoding window.
+    void set_k(uint16_t val) {
+        nss_ = core::hton16(val);
+    }
+
+    //! Get number encoding symbols.
+    uint16_t n() const {
+        return 0;
+    }
+
+    //! Set number encoding symbols.
+    void set_n(uint16_t) {
+    }
+};
+
 } // namespace fec
 } // namespace roc
 
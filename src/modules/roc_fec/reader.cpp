@@ -9,6 +9,7 @@
 #include "roc_fec/reader.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
 #include "roc_packet/fec_scheme_to_str.h"
 
 namespace roc {
@@ -21,16 +22,21 @@ Reader::Reader(const ReaderConfig& config,
                packet::IReader& repair_reader,
                packet::IParser& parser,
                packet::PacketPool& packet_pool,
-               core::IAllocator& allocator)
+               core::IAllocator& allocator,
+               RepairPool* repair_pool)
     : decoder_(decoder)
     , source_reader_(source_reader)
     , repair_reader_(repair_reader)
     , parser_(parser)
     , packet_pool_(packet_pool)
-    , source_queue_(0)
+    , source_queue_(0, config.queue_ring_size, allocator)
     , repair_queue_(0)
     , source_block_(allocator)
     , repair_block_(allocator)
+    , allocator_(allocator)
+    , repair_pool_(repair_pool)
+    , blocks_(allocator)
+    , cur_block_(NULL)
     , valid_(false)
     , alive_(true)
     , started_(false)
@@ -43,10 +49,40 @@ Reader::Reader(const ReaderConfig& config,
     , payload_resized_(false)
     , n_packets_(0)
     , max_sbn_jump_(config.max_sbn_jump)
+    , max_lookahead_(std::min(config.max_lookahead, config.max_sbn_jump))
     , fec_scheme_(fec_scheme) {
+    if (!source_queue_.valid()) {
+        return;
+    }
+
+    if (repair_pool_ && max_lookahead_ != 0) {
+        // one more block is used by the current block until it's repaired
+        const size_t n_blocks = max_lookahead_ + 1;
+
+        if (!blocks_.grow(n_blocks)) {
+            return;
+        }
+
+        for (size_t n = 0; n < n_blocks; n++) {
+            Block* block = new (allocator_) Block(allocator_);
+            if (!block) {
+                roc_log(LogError, "fec reader: can't allocate block");
+                return;
+            }
+            blocks_.push_back(block);
+        }
+    }
+
     valid_ = true;
 }
 
+Reader::~Reader() {
+    for (size_t n = 0; n < blocks_.size(); n++) {
+        release_block_(*blocks_[n]);
+        allocator_.destroy(*blocks_[n]);
+    }
+}
+
 bool Reader::valid() const {
     return valid_;
 }
@@ -118,6 +154,7 @@ packet::PacketPtr Reader::get_first_packet_() {
 
 packet::PacketPtr Reader::get_next_packet_() {
     fill_block_();
+    lookahead_();
 
     packet::PacketPtr pp = source_block_[next_packet_];
 
@@ -127,6 +164,7 @@ packet::PacketPtr Reader::get_next_packet_() {
         }
 
         if (!pp) {
+            take_repaired_();
             try_repair_();
 
             size_t pos;
@@ -137,7 +175,7 @@ packet::PacketPtr Reader::get_next_packet_() {
             }
 
             if (pos == source_block_.size()) {
-                if (source_queue_.size() == 0) {
+                if (source_queue_.size() == 0 && !has_packets_ahead_()) {
                     return NULL;
                 }
             } else {
@@ -177,7 +215,9 @@ void Reader::next_block_() {
 
     can_repair_ = false;
 
+    enter_block_();
     fill_block_();
+    lookahead_();
 }
 
 void Reader::try_repair_() {
@@ -235,6 +275,289 @@ void Reader::try_repair_() {
     can_repair_ = false;
 }
 
+void Reader::lookahead_() {
+    if (blocks_.size() == 0 || !alive_) {
+        return;
+    }
+
+    // take packets of the following blocks until a packet which can't be
+    // taken in advance; it stays in the queue until its block becomes current
+    for (;;) {
+        packet::PacketPtr pp = source_queue_.head();
+        if (!pp || !take_ahead_(pp, true)) {
+            break;
+        }
+        (void)source_queue_.read();
+    }
+
+    for (;;) {
+        packet::PacketPtr pp = repair_queue_.head();
+        if (!pp || !take_ahead_(pp, false)) {
+            break;
+        }
+        (void)repair_queue_.read();
+    }
+
+    submit_blocks_();
+}
+
+bool Reader::take_ahead_(const packet::PacketPtr& pp, bool is_source) {
+    const packet::FEC& fec = *pp->fec();
+
+    const packet::blknum_diff_t blk_dist =
+        packet::blknum_diff(fec.source_block_number, cur_sbn_);
+
+    if (blk_dist <= 0 || (size_t)blk_dist > max_lookahead_) {
+        return false;
+    }
+
+    if (is_source ? !validate_incoming_source_packet_(pp)
+                  : !validate_incoming_repair_packet_(pp)) {
+        return false;
+    }
+
+    if (fec.source_block_length > decoder_.max_block_length()
+        || fec.block_length > decoder_.max_block_length()) {
+        return false;
+    }
+
+    Block* block = find_block_(fec.source_block_number);
+
+    if (!block) {
+        for (size_t n = 0; n < blocks_.size(); n++) {
+            if (!blocks_[n]->used) {
+                block = blocks_[n];
+                break;
+            }
+        }
+        if (!block) {
+            return false;
+        }
+        if (!block->job.source.resize(fec.source_block_length)) {
+            return false;
+        }
+        block->sbn = fec.source_block_number;
+        block->job.payload_size = fec.payload.size();
+        block->used = true;
+    }
+
+    if (block->submitted) {
+        return false;
+    }
+
+    if (fec.source_block_length != block->job.source.size()
+        || fec.payload.size() != block->job.payload_size) {
+        return false;
+    }
+
+    if (fec.block_length != 0) {
+        if (block->block_length == 0) {
+            if (!block->job.repair.resize(fec.block_length - fec.source_block_length)) {
+                return false;
+            }
+            block->block_length = fec.block_length;
+        } else if (fec.block_length != block->block_length) {
+            return false;
+        }
+    }
+
+    if (is_source) {
+        const size_t p_num = fec.encoding_symbol_id;
+
+        if (!block->job.source[p_num]) {
+            block->job.source[p_num] = pp;
+            block->n_source++;
+        }
+    } else {
+        if (block->block_length == 0) {
+            return false;
+        }
+
+        const size_t p_num = fec.encoding_symbol_id - fec.source_block_length;
+
+        if (!block->job.repair[p_num]) {
+            block->job.repair[p_num] = pp;
+            block->n_repair++;
+        }
+    }
+
+    return true;
+}
+
+Reader::Block* Reader::find_block_(packet::blknum_t sbn) {
+    for (size_t n = 0; n < blocks_.size(); n++) {
+        if (blocks_[n]->used && blocks_[n]->sbn == sbn) {
+            return blocks_[n];
+        }
+    }
+    return NULL;
+}
+
+bool Reader::has_packets_ahead_() const {
+    for (size_t n = 0; n < blocks_.size(); n++) {
+        const Block& block = *blocks_[n];
+
+        if (block.used && block.n_source != 0 && packet::blknum_lt(cur_sbn_, block.sbn)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Reader::submit_blocks_() {
+    // a block is complete when packets of a later block have arrived
+    packet::blknum_t latest_sbn = cur_sbn_;
+
+    if (packet::PacketPtr pp = source_queue_.tail()) {
+        if (packet::blknum_lt(latest_sbn, pp->fec()->source_block_number)) {
+            latest_sbn = pp->fec()->source_block_number;
+        }
+    }
+
+    if (packet::PacketPtr pp = repair_queue_.tail()) {
+        if (packet::blknum_lt(latest_sbn, pp->fec()->source_block_number)) {
+            latest_sbn = pp->fec()->source_block_number;
+        }
+    }
+
+    for (size_t n = 0; n < blocks_.size(); n++) {
+        const Block& block = *blocks_[n];
+
+        if (block.used && packet::blknum_lt(latest_sbn, block.sbn)) {
+            latest_sbn = block.sbn;
+        }
+    }
+
+    for (size_t n = 0; n < blocks_.size(); n++) {
+        Block& block = *blocks_[n];
+
+        if (!block.used || block.submitted) {
+            continue;
+        }
+
+        if (!packet::blknum_lt(block.sbn, latest_sbn)) {
+            continue;
+        }
+
+        const size_t sblen = block.job.source.size();
+
+        // no losses or not enough packets to repair anything
+        if (block.n_source == sblen || block.n_source + block.n_repair < sblen) {
+            continue;
+        }
+
+        roc_log(LogTrace,
+                "fec reader: submitting block to repair pool:"
+                " sbn=%lu n_source=%lu n_repair=%lu",
+                (unsigned long)block.sbn, (unsigned long)block.n_source,
+                (unsigned long)block.n_repair);
+
+        repair_pool_->submit(block.job);
+        block.submitted = true;
+    }
+}
+
+void Reader::enter_block_() {
+    for (size_t n = 0; n < blocks_.size(); n++) {
+        if (blocks_[n]->used && packet::blknum_lt(blocks_[n]->sbn, cur_sbn_)) {
+            release_block_(*blocks_[n]);
+        }
+    }
+
+    Block* block = find_block_(cur_sbn_);
+    if (!block) {
+        return;
+    }
+
+    for (size_t n = 0; n < block->job.source.size(); n++) {
+        if (block->job.source[n]) {
+            (void)add_source_packet_(block->job.source[n]);
+        }
+    }
+
+    for (size_t n = 0; n < block->job.repair.size(); n++) {
+        if (block->job.repair[n]) {
+            (void)add_repair_packet_(block->job.repair[n]);
+        }
+    }
+
+    if (block->submitted) {
+        // repair pool already has these packets; repair the block in this
+        // thread only if more packets arrive
+        can_repair_ = false;
+        cur_block_ = block;
+    } else {
+        release_block_(*block);
+    }
+}
+
+void Reader::take_repaired_() {
+    if (!cur_block_) {
+        return;
+    }
+
+    Block& block = *cur_block_;
+
+    if (repair_pool_->cancel(block.job)) {
+        // no free workers yet, repair the block in this thread
+        block.submitted = false;
+        can_repair_ = true;
+        release_block_(block);
+        return;
+    }
+
+    repair_pool_->wait(block.job);
+
+    if (source_block_.size() != block.job.source.size()
+        || payload_size_ != block.job.payload_size) {
+        can_repair_ = true;
+        release_block_(block);
+        return;
+    }
+
+    unsigned n_repaired = 0;
+
+    for (size_t n = 0; n < source_block_.size(); n++) {
+        if (source_block_[n] || !block.job.repaired[n]) {
+            continue;
+        }
+
+        packet::PacketPtr pp = parse_repaired_packet_(block.job.repaired[n]);
+        if (!pp) {
+            continue;
+        }
+
+        source_block_[n] = pp;
+        n_repaired++;
+    }
+
+    roc_log(LogTrace, "fec reader: took repaired block from repair pool: sbn=%lu n=%u",
+            (unsigned long)cur_sbn_, n_repaired);
+
+    release_block_(block);
+}
+
+void Reader::release_block_(Block& block) {
+    if (block.submitted && !repair_pool_->cancel(block.job)) {
+        repair_pool_->wait(block.job);
+    }
+
+    if (!block.job.source.resize(0) || !block.job.repair.resize(0)
+        || !block.job.repaired.resize(0)) {
+        roc_panic("fec reader: can't resize block");
+    }
+
+    block.block_length = 0;
+    block.n_source = 0;
+    block.n_repair = 0;
+    block.used = false;
+    block.submitted = false;
+
+    if (cur_block_ == &block) {
+        cur_block_ = NULL;
+    }
+}
+
 packet::PacketPtr Reader::parse_repaired_packet_(const core::Slice<uint8_t>& buffer) {
     packet::PacketPtr pp = new (packet_pool_) packet::Packet(packet_pool_);
     if (!pp) {
@@ -317,28 +640,12 @@ void Reader::fill_source_block_() {
         // should not happen: we have handled preceding and following blocks above
         roc_panic_if_not(fec.source_block_number == cur_sbn_);
 
-        if (!process_source_packet_(pp)) {
-            roc_log(LogTrace,
-                    "fec reader: dropping source packet from current block:"
-                    " esi=%lu sblen=%lu blen=%lu payload_size=%lu",
-                    (unsigned long)fec.encoding_symbol_id,
-                    (unsigned long)fec.source_block_length,
-                    (unsigned long)fec.block_length, (unsigned long)fec.payload.size());
+        if (!add_source_packet_(pp)) {
             n_dropped++;
             continue;
         }
 
-        // should not happen: we have handled validation and block size above
-        roc_panic_if_not(fec.source_block_length == source_block_.size());
-        roc_panic_if_not(fec.encoding_symbol_id < source_block_.size());
-
-        const size_t p_num = fec.encoding_symbol_id;
-
-        if (!source_block_[p_num]) {
-            can_repair_ = true;
-            source_block_[p_num] = pp;
-            n_added++;
-        }
+        n_added++;
     }
 
     if (n_dropped != 0 || n_fetched != n_added) {
@@ -381,30 +688,12 @@ void Reader::fill_repair_block_() {
         // should not happen: we have handled preceding and following blocks above
         roc_panic_if(fec.source_block_number != cur_sbn_);
 
-        if (!process_repair_packet_(pp)) {
-            roc_log(LogTrace,
-                    "fec reader: dropping repair packet from current block:"
-                    " esi=%lu sblen=%lu blen=%lu payload_size=%lu",
-                    (unsigned long)fec.encoding_symbol_id,
-                    (unsigned long)fec.source_block_length,
-                    (unsigned long)fec.block_length, (unsigned long)fec.payload.size());
+        if (!add_repair_packet_(pp)) {
             n_dropped++;
             continue;
         }
 
-        // should not happen: we have handled validation and block size above
-        roc_panic_if_not(fec.source_block_length == source_block_.size());
-        roc_panic_if_not(fec.encoding_symbol_id >= source_block_.size());
-        roc_panic_if_not(fec.encoding_symbol_id
-                         < source_block_.size() + repair_block_.size());
-
-        const size_t p_num = fec.encoding_symbol_id - fec.source_block_length;
-
-        if (!repair_block_[p_num]) {
-            can_repair_ = true;
-            repair_block_[p_num] = pp;
-            n_added++;
-        }
+        n_added++;
     }
 
     if (n_dropped != 0 || n_fetched != n_added) {
@@ -413,6 +702,62 @@ void Reader::fill_repair_block_() {
     }
 }
 
+bool Reader::add_source_packet_(const packet::PacketPtr& pp) {
+    const packet::FEC& fec = *pp->fec();
+
+    if (!process_source_packet_(pp)) {
+        roc_log(LogTrace,
+                "fec reader: dropping source packet from current block:"
+                " esi=%lu sblen=%lu blen=%lu payload_size=%lu",
+                (unsigned long)fec.encoding_symbol_id,
+                (unsigned long)fec.source_block_length, (unsigned long)fec.block_length,
+                (unsigned long)fec.payload.size());
+        return false;
+    }
+
+    // should not happen: we have handled validation and block size above
+    roc_panic_if_not(fec.source_block_length == source_block_.size());
+    roc_panic_if_not(fec.encoding_symbol_id < source_block_.size());
+
+    const size_t p_num = fec.encoding_symbol_id;
+
+    if (!source_block_[p_num]) {
+        can_repair_ = true;
+        source_block_[p_num] = pp;
+    }
+
+    return true;
+}
+
+bool Reader::add_repair_packet_(const packet::PacketPtr& pp) {
+    const packet::FEC& fec = *pp->fec();
+
+    if (!process_repair_packet_(pp)) {
+        roc_log(LogTrace,
+                "fec reader: dropping repair packet from current block:"
+                " esi=%lu sblen=%lu blen=%lu payload_size=%lu",
+                (unsigned long)fec.encoding_symbol_id,
+                (unsigned long)fec.source_block_length, (unsigned long)fec.block_length,
+                (unsigned long)fec.payload.size());
+        return false;
+    }
+
+    // should not happen: we have handled validation and block size above
+    roc_panic_if_not(fec.source_block_length == source_block_.size());
+    roc_panic_if_not(fec.encoding_symbol_id >= source_block_.size());
+    roc_panic_if_not(fec.encoding_symbol_id
+                     < source_block_.size() + repair_block_.size());
+
+    const size_t p_num = fec.encoding_symbol_id - fec.source_block_length;
+
+    if (!repair_block_[p_num]) {
+        can_repair_ = true;
+        repair_block_[p_num] = pp;
+    }
+
+    return true;
+}
+
 bool Reader::process_source_packet_(const packet::PacketPtr& pp) {
     const packet::FEC& fec = *pp->fec();
 
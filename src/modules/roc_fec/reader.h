@@ -17,6 +17,7 @@
 #include "roc_core/noncopyable.h"
 #include "roc_core/slice.h"
 #include "roc_fec/iblock_decoder.h"
+#include "roc_fec/repair_pool.h"
 #include "roc_packet/iparser.h"
 #include "roc_packet/ireader.h"
 #include "roc_packet/packet.h"
@@ -31,12 +32,34 @@ struct ReaderConfig {
     //! Maximum allowed source block number jump.
     size_t max_sbn_jump;
 
+    //! Maximum allowed source packet ESI jump.
+    //! Used by sliding window schemes which have no source blocks.
+    size_t max_esi_jump;
+
+    //! Maximum number of blocks following the current one which may be
+    //! repaired ahead of time. Used only if a repair pool is provided.
+    size_t max_lookahead;
+
+    //! Number of seqnums covered by the source packet queue ring.
+    //! Not used by sliding window schemes, which keep source packets in a
+    //! window indexed by ESI.
+    size_t queue_ring_size;
+
     ReaderConfig()
-        : max_sbn_jump(100) {
+        : max_sbn_jump(100)
+        , max_esi_jump(2000)
+        , max_lookahead(8)
+        , queue_ring_size(256) {
     }
 };
 
 //! FEC reader.
+//! @remarks
+//!  If a repair pool is provided, packets of the blocks following the current
+//!  one are taken from the queues in advance. Every such block with losses is
+//!  submitted to the pool as soon as a packet from a later block arrives, so
+//!  that several blocks queued after a stall are repaired concurrently. When
+//!  the reader reaches the block, restored packets are taken from the pool.
 class Reader : public packet::IReader, public core::NonCopyable<> {
 public:
     //! Initialize.
@@ -48,6 +71,7 @@ public:
     //!  - @p repair_reader specifies input queue with FEC packets;
     //!  - @p parser specifies packet parser for restored packets.
     //!  - @p allocator is used to initialize a packet array
+    //!  - @p repair_pool is used to repair following blocks; may be NULL
     Reader(const ReaderConfig& config,
            packet::FECScheme fec_scheme,
            IBlockDecoder& decoder,
@@ -55,7 +79,11 @@ public:
            packet::IReader& repair_reader,
            packet::IParser& parser,
            packet::PacketPool& packet_pool,
-           core::IAllocator& allocator);
+           core::IAllocator& allocator,
+           RepairPool* repair_pool = NULL);
+
+    //! Cancel or wait for blocks submitted to repair pool.
+    ~Reader();
 
     //! Check if object is successfully constructed.
     bool valid() const;
@@ -72,6 +100,30 @@ public:
     virtual packet::PacketPtr read();
 
 private:
+    // Block following the current one, with packets taken in advance.
+    struct Block {
+        RepairJob job;
+
+        packet::blknum_t sbn;
+        size_t block_length;
+
+        size_t n_source;
+        size_t n_repair;
+
+        bool used;
+        bool submitted;
+
+        explicit Block(core::IAllocator& allocator)
+            : job(allocator)
+            , sbn(0)
+            , block_length(0)
+            , n_source(0)
+            , n_repair(0)
+            , used(false)
+            , submitted(false) {
+        }
+    };
+
     packet::PacketPtr read_();
 
     packet::PacketPtr get_first_packet_();
@@ -80,6 +132,15 @@ private:
     void next_block_();
     void try_repair_();
 
+    void lookahead_();
+    bool take_ahead_(const packet::PacketPtr&, bool is_source);
+    Block* find_block_(packet::blknum_t sbn);
+    bool has_packets_ahead_() const;
+    void submit_blocks_();
+    void enter_block_();
+    void take_repaired_();
+    void release_block_(Block& block);
+
     packet::PacketPtr parse_repaired_packet_(const core::Slice<uint8_t>& buffer);
 
     void fetch_packets_();
@@ -88,6 +149,9 @@ private:
     void fill_source_block_();
     void fill_repair_block_();
 
+    bool add_source_packet_(const packet::PacketPtr&);
+    bool add_repair_packet_(const packet::PacketPtr&);
+
     bool process_source_packet_(const packet::PacketPtr&);
     bool process_repair_packet_(const packet::PacketPtr&);
 
@@ -120,6 +184,12 @@ private:
     core::Array<packet::PacketPtr> source_block_;
     core::Array<packet::PacketPtr> repair_block_;
 
+    core::IAllocator& allocator_;
+
+    RepairPool* repair_pool_;
+    core::Array<Block*> blocks_;
+    Block* cur_block_;
+
     bool valid_;
 
     bool alive_;
@@ -138,6 +208,7 @@ private:
     unsigned n_packets_;
 
     const size_t max_sbn_jump_;
+    const size_t max_lookahead_;
     const packet::FECScheme fec_scheme_;
 };
 
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/repair_pool.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace fec {
+
+RepairJob::RepairJob(core::IAllocator& allocator)
+    : source(allocator)
+    , repair(allocator)
+    , repaired(allocator)
+    , payload_size(0)
+    , state_(Idle) {
+}
+
+RepairPool::RepairPool(core::IAllocator& allocator)
+    : allocator_(allocator)
+    , workers_(allocator)
+    , submit_cond_(mutex_)
+    , done_cond_(mutex_)
+    , stop_(false) {
+}
+
+RepairPool::~RepairPool() {
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        if (queue_.size() != 0) {
+            roc_panic("repair pool: destroying pool with queued jobs");
+        }
+
+        stop_ = true;
+        submit_cond_.broadcast();
+    }
+
+    for (size_t n = 0; n < workers_.size(); n++) {
+        if (workers_[n]->joinable()) {
+            workers_[n]->join();
+        }
+        allocator_.destroy(*workers_[n]);
+    }
+}
+
+bool RepairPool::add_worker(IBlockDecoder* decoder) {
+    roc_panic_if(!decoder);
+
+    Worker* worker = new (allocator_) Worker(*this, decoder);
+    if (!worker) {
+        roc_log(LogError, "repair pool: can't allocate worker");
+        allocator_.destroy(*decoder);
+        return false;
+    }
+
+    if (!workers_.grow(workers_.size() + 1)) {
+        roc_log(LogError, "repair pool: can't allocate workers");
+        allocator_.destroy(*worker);
+        return false;
+    }
+
+    workers_.push_back(worker);
+
+    core::ThreadAttributes attrs;
+    attrs.name = "roc-fec-repair";
+    worker->set_attributes(attrs);
+
+    if (!worker->start()) {
+        roc_log(LogError, "repair pool: can't start worker thread");
+        return false;
+    }
+
+    return true;
+}
+
+size_t RepairPool::num_workers() const {
+    return workers_.size();
+}
+
+void RepairPool::submit(RepairJob& job) {
+    if (!job.repaired.resize(0) || !job.repaired.resize(job.source.size())) {
+        roc_panic("repair pool: can't resize job");
+    }
+
+    core::Mutex::Lock lock(mutex_);
+
+    if (job.state_ == RepairJob::Queued || job.state_ == RepairJob::Running) {
+        roc_panic("repair pool: job is already submitted");
+    }
+
+    job.state_ = RepairJob::Queued;
+    queue_.push_back(job);
+
+    submit_cond_.broadcast();
+}
+
+bool RepairPool::cancel(RepairJob& job) {
+    core::Mutex::Lock lock(mutex_);
+
+    if (job.state_ != RepairJob::Queued) {
+        return false;
+    }
+
+    queue_.remove(job);
+    job.state_ = RepairJob::Idle;
+
+    return true;
+}
+
+void RepairPool::wait(RepairJob& job) {
+    core::Mutex::Lock lock(mutex_);
+
+    while (job.state_ == RepairJob::Queued || job.state_ == RepairJob::Running) {
+        done_cond_.wait();
+    }
+}
+
+RepairJob* RepairPool::take_() {
+    core::Mutex::Lock lock(mutex_);
+
+    while (!queue_.front() && !stop_) {
+        submit_cond_.wait();
+    }
+
+    if (stop_) {
+        return NULL;
+    }
+
+    RepairJob* job = queue_.front();
+    queue_.remove(*job);
+    job->state_ = RepairJob::Running;
+
+    return job;
+}
+
+void RepairPool::finish_(RepairJob& job) {
+    core::Mutex::Lock lock(mutex_);
+
+    job.state_ = RepairJob::Done;
+    done_cond_.broadcast();
+}
+
+RepairPool::Worker::Worker(RepairPool& pool, IBlockDecoder* decoder)
+    : pool_(pool)
+    , decoder_(decoder) {
+}
+
+RepairPool::Worker::~Worker() {
+    pool_.allocator_.destroy(*decoder_);
+}
+
+void RepairPool::Worker::run() {
+    while (RepairJob* job = pool_.take_()) {
+        repair_(*job);
+        pool_.finish_(*job);
+    }
+}
+
+void RepairPool::Worker::repair_(RepairJob& job) {
+    const size_t sblen = job.source.size();
+    const size_t rblen = job.repair.size();
+
+    if (!decoder_->begin(sblen, rblen, job.payload_size)) {
+        roc_log(LogDebug,
+                "repair pool: can't begin decoder block:"
+                " sbl=%lu rbl=%lu payload_size=%lu",
+                (unsigned long)sblen, (unsigned long)rblen,
+                (unsigned long)job.payload_size);
+        return;
+    }
+
+    for (size_t n = 0; n < sblen; n++) {
+        if (job.source[n]) {
+            decoder_->set(n, job.source[n]->fec()->payload);
+        }
+    }
+
+    for (size_t n = 0; n < rblen; n++) {
+        if (job.repair[n]) {
+            decoder_->set(sblen + n, job.repair[n]->fec()->payload);
+        }
+    }
+
+    for (size_t n = 0; n < sblen; n++) {
+        if (!job.source[n]) {
+            job.repaired[n] = decoder_->repair(n);
+        }
+    }
+
+    decoder_->end();
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/repair_pool.h
+//! @brief Pool of FEC block repair threads.
+
+#ifndef ROC_FEC_REPAIR_POOL_H_
+#define ROC_FEC_REPAIR_POOL_H_
+
+#include "roc_core/array.h"
+#include "roc_core/cond.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/list.h"
+#include "roc_core/list_node.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_core/thread.h"
+#include "roc_fec/iblock_decoder.h"
+#include "roc_packet/packet.h"
+
+namespace roc {
+namespace fec {
+
+//! FEC block repair job.
+//! @remarks
+//!  Holds packets of a single block. The owner fills source and repair
+//!  packets and submits the job to RepairPool. The pool fills restored
+//!  buffers for lost source packets. The owner should not modify the job
+//!  until it is done or cancelled.
+class RepairJob : public core::ListNode {
+public:
+    //! Initialize.
+    explicit RepairJob(core::IAllocator& allocator);
+
+    //! Source packets of the block, NULL for lost packets.
+    core::Array<packet::PacketPtr> source;
+
+    //! Repair packets of the block, NULL for lost packets.
+    core::Array<packet::PacketPtr> repair;
+
+    //! Restored buffers for source packets, filled by RepairPool.
+    core::Array<core::Slice<uint8_t> > repaired;
+
+    //! Payload size of every packet of the block.
+    size_t payload_size;
+
+private:
+    friend class RepairPool;
+
+    enum State { Idle, Queued, Running, Done };
+
+    State state_;
+};
+
+//! Pool of FEC block repair threads.
+//! @remarks
+//!  Repairs submitted blocks concurrently. Every worker thread owns its own
+//!  block decoder, so every block being repaired has a dedicated decoder.
+//!  May be shared by several readers.
+class RepairPool : public core::NonCopyable<> {
+public:
+    //! Initialize empty pool.
+    explicit RepairPool(core::IAllocator& allocator);
+
+    //! Stop worker threads and destroy their decoders.
+    //! @pre
+    //!  All submitted jobs should be done or cancelled.
+    ~RepairPool();
+
+    //! Add worker thread.
+    //! @remarks
+    //!  Takes ownership of @p decoder, which should be allocated using the
+    //!  pool allocator, and starts a new thread using it.
+    //! @returns
+    //!  false if the thread can't be allocated or started.
+    bool add_worker(IBlockDecoder* decoder);
+
+    //! Get number of worker threads.
+    size_t num_workers() const;
+
+    //! Submit job.
+    //! @remarks
+    //!  Resizes job.repaired to the number of source packets and queues
+    //!  the job. It is processed by the first free worker.
+    void submit(RepairJob& job);
+
+    //! Cancel job if it was not taken by a worker yet.
+    //! @returns
+    //!  true if the job was removed from the queue, or false if it is being
+    //!  processed or is already done.
+    bool cancel(RepairJob& job);
+
+    //! Wait until job is done.
+    //! @remarks
+    //!  Returns immediately if the job is not submitted.
+    void wait(RepairJob& job);
+
+private:
+    class Worker : public core::Thread {
+    public:
+        Worker(RepairPool& pool, IBlockDecoder* decoder);
+        ~Worker();
+
+    private:
+        virtual void run();
+
+        void repair_(RepairJob& job);
+
+        RepairPool& pool_;
+        IBlockDecoder* decoder_;
+    };
+
+    friend class Worker;
+
+    RepairJob* take_();
+    void finish_(RepairJob& job);
+
+    core::IAllocator& allocator_;
+
+    core::Array<Worker*> workers_;
+
+    core::List<RepairJob, core::NoOwnership> queue_;
+
+    core::Mutex mutex_;
+    core::Cond submit_cond_;
+    core::Cond done_cond_;
+
+    bool stop_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_REPAIR_POOL_H_
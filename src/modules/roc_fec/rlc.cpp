@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/rlc.h"
+
+namespace roc {
+namespace fec {
+
+uint8_t rlc_coefficient(uint16_t repair_key, size_t index) {
+    // 32-bit integer hash (finalizer from MurmurHash3) of key and index.
+    uint32_t h = ((uint32_t)repair_key << 16) ^ (uint32_t)(index & 0xffff);
+
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+
+    // zero coefficient would exclude the symbol from the linear combination
+    const uint8_t coef = (uint8_t)(h & 0xff);
+    return coef != 0 ? coef : (uint8_t)((h >> 8) | 1);
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/rlc.h
+//! @brief Random Linear Codes helpers.
+
+#ifndef ROC_FEC_RLC_H_
+#define ROC_FEC_RLC_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace fec {
+
+//! Maximum number of source symbols in RLC encoding window.
+const size_t RLCMaxWindowLength = 256;
+
+//! Get RLC coding coefficient.
+//!
+//! @remarks
+//!  Returns a pseudo-random non-zero element of GF(2^8) for the source symbol
+//!  at position @p index of the encoding window of the repair symbol identified
+//!  by @p repair_key. Encoder and decoder should obtain the same coefficients.
+uint8_t rlc_coefficient(uint16_t repair_key, size_t index);
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_RLC_H_
@@ -0,0 +1,668 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/sliding_reader.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_fec/gf256.h"
+#include "roc_fec/rlc.h"
+#include "roc_packet/fec_scheme_to_str.h"
+
+namespace roc {
+namespace fec {
+
+SlidingReader::SlidingReader(const ReaderConfig& config,
+                             packet::FECScheme fec_scheme,
+                             packet::IReader& source_reader,
+                             packet::IReader& repair_reader,
+                             packet::IParser& parser,
+                             packet::PacketPool& packet_pool,
+                             core::BufferPool<uint8_t>& buffer_pool,
+                             core::IAllocator& allocator)
+    : source_reader_(source_reader)
+    , repair_reader_(repair_reader)
+    , parser_(parser)
+    , packet_pool_(packet_pool)
+    , buffer_pool_(buffer_pool)
+    , source_window_(allocator)
+    , repair_packets_(allocator)
+    , matrix_(allocator)
+    , equations_(allocator)
+    , equation_packets_(allocator)
+    , pivots_(allocator)
+    , valid_(false)
+    , alive_(true)
+    , started_(false)
+    , can_repair_(false)
+    , next_esi_(0)
+    , max_esi_(0)
+    , payload_size_(0)
+    , n_packets_(0)
+    , n_restored_(0)
+    , max_esi_jump_(config.max_esi_jump)
+    , fec_scheme_(fec_scheme) {
+    if (!source_window_.resize(WindowCapacity)) {
+        roc_log(LogError, "fec sliding reader: can't allocate source window");
+        return;
+    }
+    if (!repair_packets_.grow(MaxRepairPackets)) {
+        roc_log(LogError, "fec sliding reader: can't allocate repair window");
+        return;
+    }
+    if (!matrix_.resize(MaxRepairPackets * WindowCapacity)
+        || !equations_.resize(MaxRepairPackets)
+        || !equation_packets_.resize(MaxRepairPackets)
+        || !pivots_.resize(MaxRepairPackets)) {
+        roc_log(LogError, "fec sliding reader: can't allocate decoding matrix");
+        return;
+    }
+    valid_ = true;
+}
+
+bool SlidingReader::valid() const {
+    return valid_;
+}
+
+bool SlidingReader::started() const {
+    return started_;
+}
+
+bool SlidingReader::alive() const {
+    return alive_;
+}
+
+packet::PacketPtr SlidingReader::read() {
+    roc_panic_if_not(valid());
+    if (!alive_) {
+        return NULL;
+    }
+    packet::PacketPtr pp = read_();
+    if (pp) {
+        n_packets_++;
+    }
+    // check if alive_ has changed
+    return (alive_ ? pp : NULL);
+}
+
+packet::PacketPtr SlidingReader::read_() {
+    fetch_packets_();
+
+    if (!started_) {
+        return NULL;
+    }
+
+    return get_next_packet_();
+}
+
+packet::PacketPtr SlidingReader::get_next_packet_() {
+    packet::PacketPtr pp = source_packet_(next_esi_);
+
+    if (!pp) {
+        try_repair_();
+        pp = source_packet_(next_esi_);
+    }
+
+    if (!pp) {
+        while (!pp && packet::blknum_lt(next_esi_, max_esi_)) {
+            roc_log(LogTrace, "fec sliding reader: skipping lost packet: esi=%lu",
+                    (unsigned long)next_esi_);
+            advance_();
+            pp = source_packet_(next_esi_);
+        }
+        if (!pp) {
+            return NULL;
+        }
+    }
+
+    advance_();
+
+    return pp;
+}
+
+packet::PacketPtr SlidingReader::source_packet_(packet::blknum_t esi) const {
+    if (!in_window_(esi)) {
+        return NULL;
+    }
+    return source_window_[esi & (WindowCapacity - 1)];
+}
+
+bool SlidingReader::in_window_(packet::blknum_t esi) const {
+    const packet::blknum_diff_t dist = packet::blknum_diff(esi, next_esi_);
+    return dist >= -(WindowCapacity / 2) && dist < (WindowCapacity / 2);
+}
+
+void SlidingReader::advance_() {
+    // the slot of the oldest packet becomes the slot of the newest one
+    source_window_[(next_esi_ + WindowCapacity / 2) & (WindowCapacity - 1)] = NULL;
+    next_esi_++;
+
+    // stored repair packets may cover the new next packet
+    can_repair_ = true;
+}
+
+void SlidingReader::restart_(packet::blknum_t esi) {
+    roc_log(LogDebug,
+            "fec sliding reader: source packet is too far ahead, restarting:"
+            " next_esi=%lu pkt_esi=%lu",
+            (unsigned long)next_esi_, (unsigned long)esi);
+
+    for (size_t n = 0; n < source_window_.size(); n++) {
+        source_window_[n] = NULL;
+    }
+    repair_packets_.resize(0);
+
+    next_esi_ = esi;
+    max_esi_ = esi;
+}
+
+void SlidingReader::fetch_packets_() {
+    for (;;) {
+        if (packet::PacketPtr pp = source_reader_.read()) {
+            if (!validate_fec_packet_(pp)) {
+                return;
+            }
+            store_source_packet_(pp);
+        } else {
+            break;
+        }
+    }
+
+    for (;;) {
+        if (packet::PacketPtr pp = repair_reader_.read()) {
+            if (!validate_fec_packet_(pp)) {
+                return;
+            }
+            store_repair_packet_(pp);
+        } else {
+            break;
+        }
+    }
+}
+
+void SlidingReader::store_source_packet_(const packet::PacketPtr& pp) {
+    const packet::FEC& fec = *pp->fec();
+    const packet::blknum_t esi = (packet::blknum_t)fec.encoding_symbol_id;
+
+    if (fec.payload.size() == 0) {
+        roc_log(LogTrace, "fec sliding reader: dropping source packet: empty payload");
+        return;
+    }
+
+    if (!started_) {
+        roc_log(LogDebug,
+                "fec sliding reader: got first source packet, start decoding: esi=%lu",
+                (unsigned long)esi);
+
+        started_ = true;
+        next_esi_ = esi;
+        max_esi_ = esi;
+    }
+
+    if (!validate_esi_jump_(esi)) {
+        return;
+    }
+
+    if (!in_window_(esi)) {
+        if (packet::blknum_lt(esi, next_esi_)) {
+            roc_log(LogTrace,
+                    "fec sliding reader: dropping source packet out of window:"
+                    " next_esi=%lu pkt_esi=%lu",
+                    (unsigned long)next_esi_, (unsigned long)esi);
+            return;
+        }
+        restart_(esi);
+    }
+
+    packet::PacketPtr& slot = source_window_[esi & (WindowCapacity - 1)];
+    if (slot) {
+        return;
+    }
+
+    slot = pp;
+
+    if (packet::blknum_lt(max_esi_, esi)) {
+        max_esi_ = esi;
+    }
+
+    can_repair_ = true;
+}
+
+void SlidingReader::store_repair_packet_(const packet::PacketPtr& pp) {
+    const packet::FEC& fec = *pp->fec();
+
+    if (!started_) {
+        return;
+    }
+
+    if (fec.source_block_length == 0 || fec.source_block_length > RLCMaxWindowLength
+        || fec.payload.size() == 0) {
+        roc_log(LogTrace,
+                "fec sliding reader: dropping invalid repair packet:"
+                " nss=%lu payload_size=%lu",
+                (unsigned long)fec.source_block_length,
+                (unsigned long)fec.payload.size());
+        return;
+    }
+
+    const packet::blknum_t first_esi = fec.source_block_number;
+    const packet::blknum_t last_esi =
+        packet::blknum_t(first_esi + fec.source_block_length - 1);
+
+    if (!validate_esi_jump_(last_esi)) {
+        return;
+    }
+
+    if (packet::blknum_lt(last_esi, next_esi_)) {
+        roc_log(LogTrace,
+                "fec sliding reader: dropping repair packet from previous window:"
+                " next_esi=%lu fss_esi=%lu nss=%lu",
+                (unsigned long)next_esi_, (unsigned long)first_esi,
+                (unsigned long)fec.source_block_length);
+        return;
+    }
+
+    if (!in_window_(first_esi) || !in_window_(last_esi)) {
+        roc_log(LogTrace,
+                "fec sliding reader: dropping repair packet out of window:"
+                " next_esi=%lu fss_esi=%lu nss=%lu",
+                (unsigned long)next_esi_, (unsigned long)first_esi,
+                (unsigned long)fec.source_block_length);
+        return;
+    }
+
+    if (repair_packets_.size() == repair_packets_.max_size()) {
+        for (size_t n = 1; n < repair_packets_.size(); n++) {
+            repair_packets_[n - 1] = repair_packets_[n];
+        }
+        repair_packets_.resize(repair_packets_.size() - 1);
+    }
+
+    repair_packets_.push_back(pp);
+    can_repair_ = true;
+}
+
+void SlidingReader::drop_old_repair_packets_() {
+    size_t n_kept = 0;
+
+    for (size_t n = 0; n < repair_packets_.size(); n++) {
+        const packet::FEC& fec = *repair_packets_[n]->fec();
+
+        const packet::blknum_t last_esi =
+            packet::blknum_t(fec.source_block_number + fec.source_block_length - 1);
+
+        if (packet::blknum_lt(last_esi, next_esi_)) {
+            continue;
+        }
+
+        if (n_kept != n) {
+            repair_packets_[n_kept] = repair_packets_[n];
+        }
+        n_kept++;
+    }
+
+    repair_packets_.resize(n_kept);
+}
+
+void SlidingReader::try_repair_() {
+    if (!can_repair_) {
+        return;
+    }
+
+    can_repair_ = false;
+
+    drop_old_repair_packets_();
+
+    if (repair_packets_.size() == 0) {
+        return;
+    }
+
+    if (!select_payload_size_()) {
+        return;
+    }
+
+    packet::blknum_t first_esi = next_esi_;
+    packet::blknum_t end_esi = next_esi_;
+
+    for (size_t n = 0; n < repair_packets_.size(); n++) {
+        const packet::FEC& fec = *repair_packets_[n]->fec();
+
+        if (fec.payload.size() != payload_size_) {
+            continue;
+        }
+
+        const packet::blknum_t fss_esi = fec.source_block_number;
+        const packet::blknum_t ess_esi =
+            packet::blknum_t(fec.source_block_number + fec.source_block_length);
+
+        if (packet::blknum_lt(fss_esi, first_esi)) {
+            first_esi = fss_esi;
+        }
+        if (packet::blknum_lt(end_esi, ess_esi)) {
+            end_esi = ess_esi;
+        }
+    }
+
+    if (packet::blknum_lt(next_esi_, first_esi)
+        || !packet::blknum_lt(next_esi_, end_esi)) {
+        return;
+    }
+
+    const size_t n_cols = (size_t)packet::blknum_diff(end_esi, first_esi);
+    const size_t max_rows = repair_packets_.size();
+
+    // should not happen: repair packets are kept only within source window
+    roc_panic_if_not(n_cols <= WindowCapacity);
+    roc_panic_if_not(max_rows <= MaxRepairPackets);
+
+    memset(&matrix_[0], 0, max_rows * n_cols);
+
+    const size_t n_rows = setup_equations_(first_esi, n_cols);
+
+    if (n_rows != 0) {
+        const size_t rank = solve_equations_(n_rows, n_cols);
+        restore_packets_(first_esi, rank, n_cols);
+    }
+
+    release_equations_(n_rows);
+}
+
+bool SlidingReader::select_payload_size_() {
+    for (size_t n = 0; n < repair_packets_.size(); n++) {
+        const packet::FEC& fec = *repair_packets_[n]->fec();
+
+        const packet::blknum_t ess_esi =
+            packet::blknum_t(fec.source_block_number + fec.source_block_length);
+
+        if (!packet::blknum_lt(next_esi_, fec.source_block_number)
+            && packet::blknum_lt(next_esi_, ess_esi)) {
+            payload_size_ = fec.payload.size();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+size_t SlidingReader::setup_equations_(packet::blknum_t first_esi, size_t n_cols) {
+    const size_t next_col = (size_t)packet::blknum_diff(next_esi_, first_esi);
+
+    uint8_t* matrix = &matrix_[0];
+
+    size_t n_rows = 0;
+    bool covers_next = false;
+
+    for (size_t n = 0; n < repair_packets_.size(); n++) {
+        const packet::FEC& fec = *repair_packets_[n]->fec();
+
+        if (fec.payload.size() != payload_size_) {
+            continue;
+        }
+
+        uint8_t* row = matrix + n_rows * n_cols;
+        bool has_unknowns = false;
+
+        for (size_t i = 0; i < fec.source_block_length; i++) {
+            const packet::blknum_t esi = packet::blknum_t(fec.source_block_number + i);
+
+            packet::PacketPtr sp = source_packet_(esi);
+
+            if (sp && sp->fec()->payload.size() == payload_size_) {
+                continue;
+            }
+
+            const size_t col = (size_t)packet::blknum_diff(esi, first_esi);
+            row[col] = rlc_coefficient((uint16_t)fec.encoding_symbol_id, i);
+            has_unknowns = true;
+            if (col == next_col) {
+                covers_next = true;
+            }
+        }
+
+        if (!has_unknowns) {
+            continue;
+        }
+
+        // payload is loaded later, if the row takes part in elimination
+        equation_packets_[n_rows] = n;
+        equations_[n_rows] = core::Slice<uint8_t>();
+        n_rows++;
+    }
+
+    if (!covers_next) {
+        return 0;
+    }
+
+    return n_rows;
+}
+
+bool SlidingReader::load_equation_(size_t row) {
+    if (equations_[row]) {
+        return true;
+    }
+
+    const packet::FEC& fec = *repair_packets_[equation_packets_[row]]->fec();
+
+    core::Slice<uint8_t> buffer = new (buffer_pool_) core::Buffer<uint8_t>(buffer_pool_);
+    if (!buffer) {
+        roc_log(LogError, "fec sliding reader: can't allocate buffer");
+        return false;
+    }
+
+    if (buffer.capacity() < payload_size_) {
+        roc_log(LogError,
+                "fec sliding reader: buffer too small for payload:"
+                " capacity=%lu payload_size=%lu",
+                (unsigned long)buffer.capacity(), (unsigned long)payload_size_);
+        return false;
+    }
+
+    buffer.resize(payload_size_);
+    memcpy(buffer.data(), fec.payload.data(), payload_size_);
+
+    // subtract known source packets, leaving only unknowns of the row
+    for (size_t i = 0; i < fec.source_block_length; i++) {
+        const packet::blknum_t esi = packet::blknum_t(fec.source_block_number + i);
+
+        packet::PacketPtr sp = source_packet_(esi);
+
+        if (sp && sp->fec()->payload.size() == payload_size_) {
+            gf256_mul_add_region(buffer.data(), sp->fec()->payload.data(),
+                                 rlc_coefficient((uint16_t)fec.encoding_symbol_id, i),
+                                 payload_size_);
+        }
+    }
+
+    equations_[row] = buffer;
+
+    return true;
+}
+
+size_t SlidingReader::solve_equations_(size_t n_rows, size_t n_cols) {
+    uint8_t* matrix = &matrix_[0];
+
+    size_t rank = 0;
+
+    // Reduce matrix to reduced row echelon form (Gauss-Jordan elimination).
+    for (size_t col = 0; col < n_cols && rank < n_rows; col++) {
+        size_t sel = rank;
+        while (sel < n_rows && matrix[sel * n_cols + col] == 0) {
+            sel++;
+        }
+
+        if (sel == n_rows) {
+            continue;
+        }
+
+        if (!load_equation_(sel)) {
+            break;
+        }
+
+        uint8_t* prow = matrix + rank * n_cols;
+
+        if (sel != rank) {
+            uint8_t* srow = matrix + sel * n_cols;
+            for (size_t c = col; c < n_cols; c++) {
+                const uint8_t tmp = prow[c];
+                prow[c] = srow[c];
+                srow[c] = tmp;
+            }
+
+            const core::Slice<uint8_t> tmp = equations_[rank];
+            equations_[rank] = equations_[sel];
+            equations_[sel] = tmp;
+
+            const size_t tmp_packet = equation_packets_[rank];
+            equation_packets_[rank] = equation_packets_[sel];
+            equation_packets_[sel] = tmp_packet;
+        }
+
+        const uint8_t inv = gf256_inv(prow[col]);
+
+        gf256_mul_region(prow + col, inv, n_cols - col);
+        gf256_mul_region(equations_[rank].data(), inv, payload_size_);
+
+        for (size_t r = 0; r < n_rows; r++) {
+            if (r == rank) {
+                continue;
+            }
+
+            uint8_t* row = matrix + r * n_cols;
+
+            const uint8_t factor = row[col];
+            if (factor == 0) {
+                continue;
+            }
+
+            if (!load_equation_(r)) {
+                return rank;
+            }
+
+            gf256_mul_add_region(row + col, prow + col, factor, n_cols - col);
+            gf256_mul_add_region(equations_[r].data(), equations_[rank].data(), factor,
+                                 payload_size_);
+        }
+
+        pivots_[rank++] = col;
+    }
+
+    return rank;
+}
+
+void SlidingReader::restore_packets_(packet::blknum_t first_esi,
+                                     size_t n_rows,
+                                     size_t n_cols) {
+    const uint8_t* matrix = &matrix_[0];
+
+    for (size_t r = 0; r < n_rows; r++) {
+        const uint8_t* row = matrix + r * n_cols;
+        const size_t col = pivots_[r];
+
+        // unknown is determined if it's the only one left in its equation
+        bool determined = true;
+        for (size_t c = col + 1; c < n_cols; c++) {
+            if (row[c] != 0) {
+                determined = false;
+                break;
+            }
+        }
+
+        if (!determined) {
+            continue;
+        }
+
+        const packet::blknum_t esi = packet::blknum_t(first_esi + col);
+
+        if (source_packet_(esi)) {
+            continue;
+        }
+
+        packet::PacketPtr pp = parse_repaired_packet_(equations_[r], esi);
+        if (!pp) {
+            continue;
+        }
+
+        roc_log(LogTrace, "fec sliding reader: restored packet: esi=%lu next_esi=%lu",
+                (unsigned long)esi, (unsigned long)next_esi_);
+
+        source_window_[esi & (WindowCapacity - 1)] = pp;
+        n_restored_++;
+    }
+}
+
+void SlidingReader::release_equations_(size_t n_rows) {
+    for (size_t n = 0; n < n_rows; n++) {
+        equations_[n] = core::Slice<uint8_t>();
+    }
+}
+
+packet::PacketPtr
+SlidingReader::parse_repaired_packet_(const core::Slice<uint8_t>& buffer,
+                                      packet::blknum_t esi) {
+    packet::PacketPtr pp = new (packet_pool_) packet::Packet(packet_pool_);
+    if (!pp) {
+        roc_log(LogError, "fec sliding reader: can't allocate packet");
+        return NULL;
+    }
+
+    if (!parser_.parse(*pp, buffer)) {
+        roc_log(LogDebug, "fec sliding reader: can't parse repaired packet");
+        return NULL;
+    }
+
+    pp->set_data(buffer);
+    pp->add_flags(packet::Packet::FlagFEC | packet::Packet::FlagRestored);
+
+    packet::FEC& fec = *pp->fec();
+
+    fec.fec_scheme = fec_scheme_;
+    fec.encoding_symbol_id = esi;
+    fec.payload = buffer;
+
+    return pp;
+}
+
+bool SlidingReader::validate_fec_packet_(const packet::PacketPtr& pp) {
+    const packet::FEC* fec = pp->fec();
+
+    if (!fec) {
+        roc_panic("fec sliding reader: unexpected non-fec packet");
+    }
+
+    if (fec->fec_scheme != fec_scheme_) {
+        roc_log(LogDebug,
+                "fec sliding reader: unexpected packet fec scheme, shutting down:"
+                " packet_scheme=%s session_scheme=%s",
+                packet::fec_scheme_to_str(fec->fec_scheme),
+                packet::fec_scheme_to_str(fec_scheme_));
+        return (alive_ = false);
+    }
+
+    return true;
+}
+
+bool SlidingReader::validate_esi_jump_(packet::blknum_t esi) {
+    packet::blknum_diff_t dist = packet::blknum_diff(esi, next_esi_);
+
+    if (dist < 0) {
+        dist = -dist;
+    }
+
+    if ((size_t)dist > max_esi_jump_) {
+        roc_log(LogDebug,
+                "fec sliding reader: too long source esi jump, shutting down:"
+                " next_esi=%lu pkt_esi=%lu dist=%lu max=%lu",
+                (unsigned long)next_esi_, (unsigned long)esi, (unsigned long)dist,
+                (unsigned long)max_esi_jump_);
+        return (alive_ = false);
+    }
+
+    return true;
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/sliding_reader.h
+//! @brief Sliding window FEC reader.
+
+#ifndef ROC_FEC_SLIDING_READER_H_
+#define ROC_FEC_SLIDING_READER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_fec/reader.h"
+#include "roc_packet/iparser.h"
+#include "roc_packet/ireader.h"
+#include "roc_packet/packet.h"
+#include "roc_packet/packet_pool.h"
+
+namespace roc {
+namespace fec {
+
+//! Sliding window FEC reader.
+//!
+//! @remarks
+//!  Keeps recently received and returned source packets and repair packets
+//!  which encoding windows are not yet passed. When the next source packet
+//!  is missing, solves the linear system formed by the stored repair packets
+//!  and restores every source packet which can be determined. Unlike block
+//!  reader, it doesn't need to wait for the end of the block.
+//!
+//!  Decoding starts from the first received source packet. Source packets
+//!  preceding it, e.g. when the very first packet of the stream is lost, are
+//!  not restored.
+class SlidingReader : public packet::IReader, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p config contains FEC reader parameters;
+    //!  - @p source_reader specifies input queue with data packets;
+    //!  - @p repair_reader specifies input queue with FEC packets;
+    //!  - @p parser specifies packet parser for restored packets;
+    //!  - @p packet_pool is used to allocate restored packets;
+    //!  - @p buffer_pool is used to allocate buffers for restored packets;
+    //!  - @p allocator is used to initialize packet arrays and decoding matrix.
+    SlidingReader(const ReaderConfig& config,
+                  packet::FECScheme fec_scheme,
+                  packet::IReader& source_reader,
+                  packet::IReader& repair_reader,
+                  packet::IParser& parser,
+                  packet::PacketPool& packet_pool,
+                  core::BufferPool<uint8_t>& buffer_pool,
+                  core::IAllocator& allocator);
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Did reader receive first source packet?
+    bool started() const;
+
+    //! Is reader alive?
+    bool alive() const;
+
+    //! Read packet.
+    //! @remarks
+    //!  When a packet loss is detected, try to restore it from repair packets.
+    virtual packet::PacketPtr read();
+
+private:
+    // Number of source packets kept around the next packet to be returned.
+    // Should be a power of two dividing ESI range and at least twice larger
+    // than the maximum encoding window.
+    enum { WindowCapacity = 1024 };
+
+    // Maximum number of stored repair packets.
+    enum { MaxRepairPackets = 256 };
+
+    packet::PacketPtr read_();
+    packet::PacketPtr get_next_packet_();
+
+    packet::PacketPtr source_packet_(packet::blknum_t esi) const;
+    bool in_window_(packet::blknum_t esi) const;
+    void advance_();
+    void restart_(packet::blknum_t esi);
+
+    void fetch_packets_();
+    void store_source_packet_(const packet::PacketPtr&);
+    void store_repair_packet_(const packet::PacketPtr&);
+    void drop_old_repair_packets_();
+
+    void try_repair_();
+    bool select_payload_size_();
+    size_t setup_equations_(packet::blknum_t first_esi, size_t n_cols);
+    bool load_equation_(size_t row);
+    size_t solve_equations_(size_t n_rows, size_t n_cols);
+    void restore_packets_(packet::blknum_t first_esi, size_t n_rows, size_t n_cols);
+    void release_equations_(size_t n_rows);
+
+    packet::PacketPtr parse_repaired_packet_(const core::Slice<uint8_t>& buffer,
+                                             packet::blknum_t esi);
+
+    bool validate_fec_packet_(const packet::PacketPtr&);
+    bool validate_esi_jump_(packet::blknum_t esi);
+
+    packet::IReader& source_reader_;
+    packet::IReader& repair_reader_;
+    packet::IParser& parser_;
+    packet::PacketPool& packet_pool_;
+    core::BufferPool<uint8_t>& buffer_pool_;
+
+    core::Array<packet::PacketPtr> source_window_;
+    core::Array<packet::PacketPtr> repair_packets_;
+
+    // Sized for MaxRepairPackets rows and WindowCapacity columns. Payload of
+    // a row is loaded only when the row takes part in elimination.
+    core::Array<uint8_t> matrix_;
+    core::Array<core::Slice<uint8_t> > equations_;
+    core::Array<size_t> equation_packets_;
+    core::Array<size_t> pivots_;
+
+    bool valid_;
+
+    bool alive_;
+    bool started_;
+    bool can_repair_;
+
+    packet::blknum_t next_esi_;
+    packet::blknum_t max_esi_;
+
+    size_t payload_size_;
+
+    unsigned n_packets_;
+    unsigned n_restored_;
+
+    const size_t max_esi_jump_;
+    const packet::FECScheme fec_scheme_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_SLIDING_READER_H_
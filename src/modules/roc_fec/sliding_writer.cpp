@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/sliding_writer.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/random.h"
+#include "roc_fec/gf256.h"
+#include "roc_fec/rlc.h"
+#include "roc_packet/fec_scheme_to_str.h"
+
+namespace roc {
+namespace fec {
+
+SlidingWriter::SlidingWriter(const WriterConfig& config,
+                             packet::FECScheme fec_scheme,
+                             packet::IWriter& writer,
+                             packet::IComposer& source_composer,
+                             packet::IComposer& repair_composer,
+                             packet::PacketPool& packet_pool,
+                             core::BufferPool<uint8_t>& buffer_pool,
+                             core::IAllocator& allocator)
+    : writer_(writer)
+    , source_composer_(source_composer)
+    , repair_composer_(repair_composer)
+    , packet_pool_(packet_pool)
+    , buffer_pool_(buffer_pool)
+    , window_(allocator)
+    , window_len_(config.n_source_packets)
+    , n_repair_(config.n_repair_packets)
+    , window_size_(0)
+    , window_pos_(0)
+    , payload_size_(0)
+    , repair_credit_(0)
+    , cur_esi_((packet::blknum_t)core::random(packet::blknum_t(-1)))
+    , cur_repair_key_((uint16_t)core::random(uint16_t(-1)))
+    , fec_scheme_(fec_scheme)
+    , valid_(false)
+    , alive_(true) {
+    if (window_len_ == 0 || window_len_ > RLCMaxWindowLength) {
+        roc_log(LogError,
+                "fec sliding writer: invalid window length: window_len=%lu max=%lu",
+                (unsigned long)window_len_, (unsigned long)RLCMaxWindowLength);
+        return;
+    }
+
+    if (!window_.resize(window_len_)) {
+        roc_log(LogError, "fec sliding writer: can't allocate window: window_len=%lu",
+                (unsigned long)window_len_);
+        return;
+    }
+
+    roc_log(LogDebug, "fec sliding writer: initializing: window_len=%lu n_repair=%lu",
+            (unsigned long)window_len_, (unsigned long)n_repair_);
+
+    valid_ = true;
+}
+
+bool SlidingWriter::valid() const {
+    return valid_;
+}
+
+bool SlidingWriter::alive() const {
+    return alive_;
+}
+
+void SlidingWriter::write(const packet::PacketPtr& pp) {
+    roc_panic_if_not(valid());
+    roc_panic_if_not(pp);
+
+    if (!alive_) {
+        return;
+    }
+
+    validate_fec_packet_(pp);
+
+    if (pp->fec()->payload.size() != payload_size_) {
+        if (!reset_window_(pp->fec()->payload.size())) {
+            return;
+        }
+    }
+
+    write_source_packet_(pp);
+
+    repair_credit_ += n_repair_;
+
+    while (repair_credit_ >= window_len_) {
+        repair_credit_ -= window_len_;
+        write_repair_packet_();
+    }
+}
+
+bool SlidingWriter::reset_window_(size_t payload_size) {
+    if (payload_size == 0) {
+        roc_log(LogError, "fec sliding writer: payload size can't be zero");
+        return (alive_ = false);
+    }
+
+    roc_log(LogDebug,
+            "fec sliding writer: reset window: esi=%lu old_size=%lu new_size=%lu",
+            (unsigned long)cur_esi_, (unsigned long)payload_size_,
+            (unsigned long)payload_size);
+
+    for (size_t n = 0; n < window_.size(); n++) {
+        window_[n] = NULL;
+    }
+
+    window_size_ = 0;
+    window_pos_ = 0;
+    payload_size_ = payload_size;
+
+    return true;
+}
+
+void SlidingWriter::write_source_packet_(const packet::PacketPtr& pp) {
+    packet::FEC& fec = *pp->fec();
+
+    fec.encoding_symbol_id = cur_esi_;
+    fec.source_block_number = 0;
+    fec.source_block_length = 0;
+    fec.block_length = 0;
+
+    pp->add_flags(packet::Packet::FlagComposed);
+
+    if (!source_composer_.compose(*pp)) {
+        roc_panic("fec sliding writer: can't compose source packet");
+    }
+
+    window_[window_pos_] = pp;
+    window_pos_ = (window_pos_ + 1) % window_len_;
+
+    if (window_size_ < window_len_) {
+        window_size_++;
+    }
+
+    cur_esi_++;
+
+    writer_.write(pp);
+}
+
+void SlidingWriter::write_repair_packet_() {
+    packet::PacketPtr rp = make_repair_packet_();
+    if (!rp) {
+        return;
+    }
+
+    const packet::blknum_t fss_esi = packet::blknum_t(cur_esi_ - window_size_);
+
+    encode_repair_packet_(*rp, fss_esi);
+
+    packet::FEC& fec = *rp->fec();
+
+    fec.encoding_symbol_id = cur_repair_key_;
+    fec.source_block_number = fss_esi;
+    fec.source_block_length = window_size_;
+    fec.block_length = 0;
+
+    rp->add_flags(packet::Packet::FlagComposed);
+
+    if (!repair_composer_.compose(*rp)) {
+        roc_panic("fec sliding writer: can't compose repair packet");
+    }
+
+    cur_repair_key_++;
+
+    writer_.write(rp);
+}
+
+packet::PacketPtr SlidingWriter::make_repair_packet_() {
+    packet::PacketPtr packet = new (packet_pool_) packet::Packet(packet_pool_);
+    if (!packet) {
+        roc_log(LogError, "fec sliding writer: can't allocate packet");
+        return NULL;
+    }
+
+    core::Slice<uint8_t> data = new (buffer_pool_) core::Buffer<uint8_t>(buffer_pool_);
+    if (!data) {
+        roc_log(LogError, "fec sliding writer: can't allocate buffer");
+        return NULL;
+    }
+
+    if (!repair_composer_.prepare(*packet, data, payload_size_)) {
+        roc_log(LogError, "fec sliding writer: can't prepare packet");
+        return NULL;
+    }
+
+    if (!packet->fec()) {
+        roc_log(LogError, "fec sliding writer: unexpected non-fec packet");
+        return NULL;
+    }
+
+    packet->set_data(data);
+
+    validate_fec_packet_(packet);
+
+    return packet;
+}
+
+void SlidingWriter::encode_repair_packet_(packet::Packet& rp, packet::blknum_t fss_esi) {
+    uint8_t* repair_data = rp.fec()->payload.data();
+
+    memset(repair_data, 0, payload_size_);
+
+    const size_t first_pos = (window_pos_ + window_len_ - window_size_) % window_len_;
+
+    for (size_t n = 0; n < window_size_; n++) {
+        const packet::Packet& sp = *window_[(first_pos + n) % window_len_];
+
+        roc_panic_if(sp.fec()->encoding_symbol_id != packet::blknum_t(fss_esi + n));
+        roc_panic_if(sp.fec()->payload.size() != payload_size_);
+
+        gf256_mul_add_region(repair_data, sp.fec()->payload.data(),
+                             rlc_coefficient(cur_repair_key_, n), payload_size_);
+    }
+}
+
+void SlidingWriter::validate_fec_packet_(const packet::PacketPtr& pp) {
+    const packet::FEC* fec = pp->fec();
+
+    if (!fec) {
+        roc_panic("fec sliding writer: unexpected non-fec packet");
+    }
+
+    if (fec->fec_scheme != fec_scheme_) {
+        roc_panic("fec sliding writer: unexpected packet fec scheme:"
+                  " packet_scheme=%s session_scheme=%s",
+                  packet::fec_scheme_to_str(fec->fec_scheme),
+                  packet::fec_scheme_to_str(fec_scheme_));
+    }
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/sliding_writer.h
+//! @brief Sliding window FEC writer.
+
+#ifndef ROC_FEC_SLIDING_WRITER_H_
+#define ROC_FEC_SLIDING_WRITER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_fec/writer.h"
+#include "roc_packet/icomposer.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet.h"
+#include "roc_packet/packet_pool.h"
+
+namespace roc {
+namespace fec {
+
+//! Sliding window FEC writer.
+//!
+//! @remarks
+//!  Every repair packet is a random linear combination of the last
+//!  n_source_packets source packets (the encoding window). The writer
+//!  generates n_repair_packets repair packets per n_source_packets source
+//!  packets, spreading them evenly between source packets instead of
+//!  sending them in bursts at block boundaries.
+class SlidingWriter : public packet::IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p config defines encoding window length and repair packet rate
+    //!  - @p writer is used to write source and repair packets
+    //!  - @p source_composer is used to format source packets
+    //!  - @p repair_composer is used to format repair packets
+    //!  - @p packet_pool is used to allocate repair packets
+    //!  - @p buffer_pool is used to allocate buffers for repair packets
+    //!  - @p allocator is used to initialize a packet array
+    SlidingWriter(const WriterConfig& config,
+                  packet::FECScheme fec_scheme,
+                  packet::IWriter& writer,
+                  packet::IComposer& source_composer,
+                  packet::IComposer& repair_composer,
+                  packet::PacketPool& packet_pool,
+                  core::BufferPool<uint8_t>& buffer_pool,
+                  core::IAllocator& allocator);
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Check if writer is still working.
+    bool alive() const;
+
+    //! Write packet.
+    //! @remarks
+    //!  - writes the given source packet to the output writer
+    //!  - generates repair packets and also writes them to the output writer
+    virtual void write(const packet::PacketPtr&);
+
+private:
+    bool reset_window_(size_t payload_size);
+
+    void write_source_packet_(const packet::PacketPtr&);
+    void write_repair_packet_();
+    packet::PacketPtr make_repair_packet_();
+    void encode_repair_packet_(packet::Packet&, packet::blknum_t fss_esi);
+
+    void validate_fec_packet_(const packet::PacketPtr&);
+
+    packet::IWriter& writer_;
+
+    packet::IComposer& source_composer_;
+    packet::IComposer& repair_composer_;
+
+    packet::PacketPool& packet_pool_;
+    core::BufferPool<uint8_t>& buffer_pool_;
+
+    core::Array<packet::PacketPtr> window_;
+
+    const size_t window_len_;
+    const size_t n_repair_;
+
+    size_t window_size_;
+    size_t window_pos_;
+
+    size_t payload_size_;
+    size_t repair_credit_;
+
+    packet::blknum_t cur_esi_;
+    uint16_t cur_repair_key_;
+
+    const packet::FECScheme fec_scheme_;
+
+    bool valid_;
+    bool alive_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_SLIDING_WRITER_H_
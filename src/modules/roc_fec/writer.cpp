@@ -35,7 +35,8 @@ Writer::Writer(const WriterConfig& config,
     , repair_composer_(repair_composer)
     , packet_pool_(packet_pool)
     , buffer_pool_(buffer_pool)
-    , repair_block_(allocator)
+    , repair_ring_(allocator)
+    , repair_batch_(allocator)
     , first_packet_(true)
     , cur_sbn_((packet::blknum_t)core::random(packet::blknum_t(-1)))
     , cur_block_repair_sn_((packet::seqnum_t)core::random(packet::seqnum_t(-1)))
@@ -147,9 +148,10 @@ bool Writer::begin_block_(const packet::PacketPtr& pp) {
 }
 
 void Writer::end_block_() {
-    make_repair_packets_();
-    encode_repair_packets_();
-    compose_repair_packets_();
+    prepare_repair_packets_();
+
+    encoder_.fill();
+
     write_repair_packets_();
 
     encoder_.end();
@@ -167,12 +169,22 @@ bool Writer::apply_sizes_(size_t sblen, size_t rblen, size_t payload_size) {
         return (alive_ = false);
     }
 
-    if (repair_block_.size() != rblen) {
-        if (!repair_block_.resize(rblen)) {
+    if (repair_ring_.size() != rblen) {
+        if (!repair_ring_.resize(rblen)) {
             roc_log(LogError,
                     "fec writer: can't allocate repair block memory, shutting down:"
                     " cur_rbl=%lu new_rbl=%lu",
-                    (unsigned long)repair_block_.size(), (unsigned long)rblen);
+                    (unsigned long)repair_ring_.size(), (unsigned long)rblen);
+            return (alive_ = false);
+        }
+    }
+
+    if (repair_batch_.size() != rblen) {
+        if (!repair_batch_.resize(rblen)) {
+            roc_log(LogError,
+                    "fec writer: can't allocate repair batch memory, shutting down:"
+                    " cur_rbl=%lu new_rbl=%lu",
+                    (unsigned long)repair_batch_.size(), (unsigned long)rblen);
             return (alive_ = false);
         }
     }
@@ -197,84 +209,102 @@ void Writer::write_source_packet_(const packet::PacketPtr& pp) {
     writer_.write(pp);
 }
 
-void Writer::make_repair_packets_() {
+void Writer::prepare_repair_packets_() {
     for (size_t i = 0; i < cur_rblen_; i++) {
-        packet::PacketPtr rp = make_repair_packet_((packet::seqnum_t)i);
-        if (!rp) {
+        RepairSlot& slot = repair_ring_[i];
+
+        if (!make_repair_packet_(slot)) {
             continue;
         }
-        repair_block_[i] = rp;
+
+        fill_packet_fec_fields_(slot.packet, (packet::seqnum_t)(cur_sblen_ + i));
+        encoder_.set(cur_sblen_ + i, slot.packet->fec()->payload);
     }
 }
 
-packet::PacketPtr Writer::make_repair_packet_(packet::seqnum_t pack_n) {
+bool Writer::make_repair_packet_(RepairSlot& slot) {
     packet::PacketPtr packet = new (packet_pool_) packet::Packet(packet_pool_);
     if (!packet) {
         roc_log(LogError, "fec writer: can't allocate packet");
-        return NULL;
+        return false;
     }
 
-    core::Slice<uint8_t> data = new (buffer_pool_) core::Buffer<uint8_t>(buffer_pool_);
-    if (!data) {
-        roc_log(LogError, "fec writer: can't allocate buffer");
-        return NULL;
+    if (!acquire_repair_buffer_(slot)) {
+        return false;
     }
 
+    core::Slice<uint8_t> data = slot.data;
+
     if (!repair_composer_.align(data, 0, encoder_.alignment())) {
         roc_log(LogError, "fec writer: can't align packet buffer");
-        return NULL;
+        return false;
     }
 
     if (!repair_composer_.prepare(*packet, data, cur_payload_size_)) {
         roc_log(LogError, "fec writer: can't prepare packet");
-        return NULL;
+        return false;
     }
 
     if (!packet->fec()) {
         roc_log(LogError, "fec writer: unexpected non-fec packet");
-        return NULL;
+        return false;
     }
 
     packet->set_data(data);
 
     validate_fec_packet_(packet);
-    fill_packet_fec_fields_(packet, (packet::seqnum_t)cur_sblen_ + pack_n);
 
-    return packet;
+    slot.packet = packet;
+
+    return true;
 }
 
-void Writer::encode_repair_packets_() {
-    for (size_t i = 0; i < cur_rblen_; i++) {
-        packet::PacketPtr rp = repair_block_[i];
-        if (rp) {
-            encoder_.set(cur_sblen_ + i, rp->fec()->payload);
-        }
+bool Writer::acquire_repair_buffer_(RepairSlot& slot) {
+    // reuse buffer if the previous repair packet was released by the pipeline
+    if (slot.buffer && slot.buffer->getref() == 1) {
+        return true;
     }
-    encoder_.fill();
+
+    slot.data = core::Slice<uint8_t>();
+    slot.buffer = new (buffer_pool_) core::Buffer<uint8_t>(buffer_pool_);
+
+    if (!slot.buffer) {
+        roc_log(LogError, "fec writer: can't allocate buffer");
+        return false;
+    }
+
+    slot.data = slot.buffer;
+
+    return true;
 }
 
-void Writer::compose_repair_packets_() {
+void Writer::write_repair_packets_() {
+    size_t n_packets = 0;
+
     for (size_t i = 0; i < cur_rblen_; i++) {
-        packet::PacketPtr rp = repair_block_[i];
-        if (!rp) {
+        RepairSlot& slot = repair_ring_[i];
+        if (!slot.packet) {
             continue;
         }
 
-        rp->add_flags(packet::Packet::FlagComposed);
+        slot.packet->add_flags(packet::Packet::FlagComposed);
 
-        if (!repair_composer_.compose(*rp)) {
+        if (!repair_composer_.compose(*slot.packet)) {
             roc_panic("fec writer: can't compose repair packet");
         }
+
+        repair_batch_[n_packets++] = slot.packet;
+        slot.packet = NULL;
     }
-}
 
-void Writer::write_repair_packets_() {
-    for (size_t i = 0; i < cur_rblen_; i++) {
-        packet::PacketPtr rp = repair_block_[i];
-        if (rp) {
-            writer_.write(repair_block_[i]);
-            repair_block_[i] = NULL;
-        }
+    if (n_packets == 0) {
+        return;
+    }
+
+    writer_.write_batch(&repair_batch_[0], n_packets);
+
+    for (size_t i = 0; i < n_packets; i++) {
+        repair_batch_[i] = NULL;
     }
 }
 
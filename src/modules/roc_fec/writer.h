@@ -29,9 +29,12 @@ namespace fec {
 //! FEC writer parameters.
 struct WriterConfig {
     //! Number of data packets in block.
+    //! For sliding window schemes, length of the encoding window.
     size_t n_source_packets;
 
     //! Number of FEC packets in block.
+    //! For sliding window schemes, number of repair packets generated
+    //! per n_source_packets source packets.
     size_t n_repair_packets;
 
     WriterConfig()
@@ -41,6 +44,12 @@ struct WriterConfig {
 };
 
 //! FEC writer.
+//!
+//! @remarks
+//!  Buffers of repair packets are kept in a ring of n_repair_packets slots.
+//!  When a block ends and the buffer from a slot was already released by the
+//!  pipeline, it's reused for the new repair packet instead of allocating a
+//!  new one.
 class Writer : public packet::IWriter, public core::NonCopyable<> {
 public:
     //! Initialize.
@@ -86,11 +95,25 @@ private:
 
     bool apply_sizes_(size_t sblen, size_t rblen, size_t payload_size);
 
+    struct RepairSlot {
+        // repair packet of the current block
+        packet::PacketPtr packet;
+
+        // whole buffer of the repair packet, owned by the ring
+        core::Slice<uint8_t> data;
+
+        // same buffer, used to check if it's still referenced by the pipeline
+        core::Buffer<uint8_t>* buffer;
+
+        RepairSlot()
+            : buffer(NULL) {
+        }
+    };
+
     void write_source_packet_(const packet::PacketPtr&);
-    void make_repair_packets_();
-    packet::PacketPtr make_repair_packet_(packet::seqnum_t n);
-    void encode_repair_packets_();
-    void compose_repair_packets_();
+    void prepare_repair_packets_();
+    bool make_repair_packet_(RepairSlot&);
+    bool acquire_repair_buffer_(RepairSlot&);
     void write_repair_packets_();
     void fill_packet_fec_fields_(const packet::PacketPtr& packet, packet::seqnum_t n);
 
@@ -114,7 +137,8 @@ private:
     packet::PacketPool& packet_pool_;
     core::BufferPool<uint8_t>& buffer_pool_;
 
-    core::Array<packet::PacketPtr> repair_block_;
+    core::Array<RepairSlot> repair_ring_;
+    core::Array<packet::PacketPtr> repair_batch_;
 
     bool first_packet_;
 
@@ -18,6 +18,10 @@ BasicPort::BasicPort(core::IAllocator& allocator)
 BasicPort::~BasicPort() {
 }
 
+bool BasicPort::shared() const {
+    return false;
+}
+
 void BasicPort::destroy() {
     allocator_.destroy(*this);
 }
@@ -44,6 +44,12 @@ public:
     //!  Should be called from the event loop thread.
     virtual void async_close() = 0;
 
+    //! Check if the port may be shared by several receivers.
+    //!
+    //! @remarks
+    //!  Only UDP receiver ports may be shared. Returns false by default.
+    virtual bool shared() const;
+
 private:
     friend class core::RefCnt<BasicPort>;
 
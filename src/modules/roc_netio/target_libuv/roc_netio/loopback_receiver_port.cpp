@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_netio/loopback_receiver_port.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_packet/address_to_str.h"
+
+namespace roc {
+namespace netio {
+
+LoopbackReceiverPort::LoopbackReceiverPort(ICloseHandler& close_handler,
+                                           const packet::Address& address,
+                                           uv_loop_t& event_loop,
+                                           LoopbackRouter& router,
+                                           packet::IWriter& writer,
+                                           core::IAllocator& allocator)
+    : BasicPort(allocator)
+    , close_handler_(close_handler)
+    , loop_(event_loop)
+    , handle_initialized_(false)
+    , address_(address)
+    , router_(router)
+    , writer_(writer)
+    , bound_(false)
+    , closed_(false) {
+}
+
+LoopbackReceiverPort::~LoopbackReceiverPort() {
+    if (handle_initialized_ || bound_) {
+        roc_panic(
+            "loopback receiver: receiver was not fully closed before calling destructor");
+    }
+}
+
+const packet::Address& LoopbackReceiverPort::address() const {
+    return address_;
+}
+
+bool LoopbackReceiverPort::open() {
+    if (int err = uv_idle_init(&loop_, &handle_)) {
+        roc_log(LogError, "loopback receiver: uv_idle_init(): [%s] %s",
+                uv_err_name(err), uv_strerror(err));
+        return false;
+    }
+
+    handle_.data = this;
+    handle_initialized_ = true;
+
+    if (address_.port() <= 0) {
+        roc_log(LogError, "loopback receiver: can't bind to %s: port should be set",
+                packet::address_to_str(address_).c_str());
+        return false;
+    }
+
+    if (!router_.add_route(address_, writer_)) {
+        roc_log(LogError, "loopback receiver: can't bind to %s",
+                packet::address_to_str(address_).c_str());
+        return false;
+    }
+
+    bound_ = true;
+
+    roc_log(LogInfo, "loopback receiver: opened port %s",
+            packet::address_to_str(address_).c_str());
+
+    return true;
+}
+
+void LoopbackReceiverPort::async_close() {
+    if (bound_) {
+        router_.remove_route(address_);
+        bound_ = false;
+    }
+
+    if (closed_) {
+        return;
+    }
+
+    if (!handle_initialized_) {
+        closed_ = true;
+        close_handler_.handle_closed(*this);
+
+        return;
+    }
+
+    if (!uv_is_closing((uv_handle_t*)&handle_)) {
+        roc_log(LogInfo, "loopback receiver: closing port %s",
+                packet::address_to_str(address_).c_str());
+
+        uv_close((uv_handle_t*)&handle_, close_cb_);
+    }
+}
+
+void LoopbackReceiverPort::close_cb_(uv_handle_t* handle) {
+    roc_panic_if_not(handle);
+
+    LoopbackReceiverPort& self = *(LoopbackReceiverPort*)handle->data;
+
+    self.handle_initialized_ = false;
+
+    roc_log(LogInfo, "loopback receiver: closed port %s",
+            packet::address_to_str(self.address_).c_str());
+
+    self.closed_ = true;
+    self.close_handler_.handle_closed(self);
+}
+
+} // namespace netio
+} // namespace roc
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_libuv/roc_netio/loopback_receiver_port.h
+//! @brief Loopback receiver.
+
+#ifndef ROC_NETIO_LOOPBACK_RECEIVER_PORT_H_
+#define ROC_NETIO_LOOPBACK_RECEIVER_PORT_H_
+
+#include <uv.h>
+
+#include "roc_core/iallocator.h"
+#include "roc_netio/basic_port.h"
+#include "roc_netio/iclose_handler.h"
+#include "roc_netio/loopback_router.h"
+#include "roc_packet/address.h"
+#include "roc_packet/iwriter.h"
+
+namespace roc {
+namespace netio {
+
+//! Loopback receiver.
+//! @remarks
+//!  Binds a writer to an address in the loopback router. Packets written to
+//!  a loopback sender with this destination address are passed to the writer
+//!  as is, in the sender thread, without copying and without syscalls.
+class LoopbackReceiverPort : public BasicPort {
+public:
+    //! Initialize.
+    LoopbackReceiverPort(ICloseHandler& close_handler,
+                         const packet::Address& address,
+                         uv_loop_t& event_loop,
+                         LoopbackRouter& router,
+                         packet::IWriter& writer,
+                         core::IAllocator& allocator);
+
+    //! Destroy.
+    ~LoopbackReceiverPort();
+
+    //! Get bind address.
+    virtual const packet::Address& address() const;
+
+    //! Open receiver.
+    virtual bool open();
+
+    //! Asynchronously close receiver.
+    virtual void async_close();
+
+private:
+    static void close_cb_(uv_handle_t* handle);
+
+    ICloseHandler& close_handler_;
+
+    uv_loop_t& loop_;
+
+    // Never started, used only to report closing from the event loop.
+    uv_idle_t handle_;
+    bool handle_initialized_;
+
+    packet::Address address_;
+
+    LoopbackRouter& router_;
+    packet::IWriter& writer_;
+
+    bool bound_;
+    bool closed_;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_LOOPBACK_RECEIVER_PORT_H_
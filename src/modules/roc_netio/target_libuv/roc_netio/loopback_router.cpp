@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_netio/loopback_router.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_packet/address_to_str.h"
+
+namespace roc {
+namespace netio {
+
+LoopbackRouter::LoopbackRouter(core::IAllocator& allocator)
+    : routes_(allocator) {
+}
+
+bool LoopbackRouter::add_route(const packet::Address& address,
+                               packet::IWriter& writer) {
+    core::Mutex::Lock lock(mutex_);
+
+    for (size_t n = 0; n < routes_.size(); n++) {
+        if (routes_[n].address == address) {
+            roc_log(LogError, "loopback router: address %s is already bound",
+                    packet::address_to_str(address).c_str());
+            return false;
+        }
+    }
+
+    if (routes_.size() == routes_.max_size()) {
+        const size_t max_size =
+            routes_.max_size() ? routes_.max_size() * 2 : (size_t)MinRoutes;
+
+        if (!routes_.grow(max_size)) {
+            return false;
+        }
+    }
+
+    Route route;
+    route.address = address;
+    route.writer = &writer;
+
+    routes_.push_back(route);
+
+    return true;
+}
+
+void LoopbackRouter::remove_route(const packet::Address& address) {
+    core::Mutex::Lock lock(mutex_);
+
+    for (size_t n = 0; n < routes_.size(); n++) {
+        if (routes_[n].address != address) {
+            continue;
+        }
+
+        routes_[n] = routes_.back();
+
+        if (!routes_.resize(routes_.size() - 1)) {
+            roc_panic("loopback router: can't shrink routes");
+        }
+
+        return;
+    }
+}
+
+void LoopbackRouter::route(const packet::PacketPtr& packet) {
+    core::Mutex::Lock lock(mutex_);
+
+    const packet::Address& dst_addr = packet->udp()->dst_addr;
+
+    for (size_t n = 0; n < routes_.size(); n++) {
+        if (routes_[n].address == dst_addr) {
+            routes_[n].writer->write(packet);
+            return;
+        }
+    }
+
+    roc_log(LogTrace, "loopback router: dropping packet to unbound address %s",
+            packet::address_to_str(dst_addr).c_str());
+}
+
+} // namespace netio
+} // namespace roc
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_libuv/roc_netio/loopback_router.h
+//! @brief Loopback router.
+
+#ifndef ROC_NETIO_LOOPBACK_ROUTER_H_
+#define ROC_NETIO_LOOPBACK_ROUTER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_packet/address.h"
+#include "roc_packet/iwriter.h"
+
+namespace roc {
+namespace netio {
+
+//! Loopback router.
+//! @remarks
+//!  Maps loopback receiver addresses to writers and passes packets written
+//!  by loopback senders directly to the writer bound to the packet destination
+//!  address, in the caller thread.
+class LoopbackRouter : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit LoopbackRouter(core::IAllocator& allocator);
+
+    //! Bind writer to address.
+    //! @returns
+    //!  false if the address is already bound or allocation failed.
+    bool add_route(const packet::Address& address, packet::IWriter& writer);
+
+    //! Unbind address.
+    //! @remarks
+    //!  After this call returns, the writer is not used anymore.
+    void remove_route(const packet::Address& address);
+
+    //! Pass packet to the writer bound to its destination address.
+    //! @remarks
+    //!  May be called from any thread. Packets for unbound addresses are
+    //!  dropped, like UDP datagrams sent to a port nobody listens on.
+    void route(const packet::PacketPtr& packet);
+
+private:
+    struct Route {
+        packet::Address address;
+        packet::IWriter* writer;
+
+        Route()
+            : writer(NULL) {
+        }
+    };
+
+    enum { MinRoutes = 8 };
+
+    core::Array<Route> routes_;
+    core::Mutex mutex_;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_LOOPBACK_ROUTER_H_
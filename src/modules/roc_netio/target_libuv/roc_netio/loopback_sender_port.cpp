@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_netio/loopback_sender_port.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_packet/address_to_str.h"
+
+namespace roc {
+namespace netio {
+
+LoopbackSenderPort::LoopbackSenderPort(ICloseHandler& close_handler,
+                                       const packet::Address& address,
+                                       uv_loop_t& event_loop,
+                                       LoopbackRouter& router,
+                                       core::IAllocator& allocator)
+    : BasicPort(allocator)
+    , close_handler_(close_handler)
+    , loop_(event_loop)
+    , handle_initialized_(false)
+    , address_(address)
+    , router_(router)
+    , closed_(false) {
+}
+
+LoopbackSenderPort::~LoopbackSenderPort() {
+    if (handle_initialized_) {
+        roc_panic(
+            "loopback sender: sender was not fully closed before calling destructor");
+    }
+}
+
+const packet::Address& LoopbackSenderPort::address() const {
+    return address_;
+}
+
+bool LoopbackSenderPort::open() {
+    if (int err = uv_idle_init(&loop_, &handle_)) {
+        roc_log(LogError, "loopback sender: uv_idle_init(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    handle_.data = this;
+    handle_initialized_ = true;
+
+    roc_log(LogInfo, "loopback sender: opened port %s",
+            packet::address_to_str(address_).c_str());
+
+    return true;
+}
+
+void LoopbackSenderPort::async_close() {
+    if (closed_) {
+        return;
+    }
+
+    if (!handle_initialized_) {
+        closed_ = true;
+        close_handler_.handle_closed(*this);
+
+        return;
+    }
+
+    if (!uv_is_closing((uv_handle_t*)&handle_)) {
+        roc_log(LogInfo, "loopback sender: closing port %s",
+                packet::address_to_str(address_).c_str());
+
+        uv_close((uv_handle_t*)&handle_, close_cb_);
+    }
+}
+
+void LoopbackSenderPort::write(const packet::PacketPtr& pp) {
+    if (!pp) {
+        roc_panic("loopback sender: unexpected null packet");
+    }
+
+    if (!pp->udp()) {
+        roc_panic("loopback sender: unexpected non-udp packet");
+    }
+
+    pp->udp()->src_addr = address_;
+
+    router_.route(pp);
+}
+
+void LoopbackSenderPort::close_cb_(uv_handle_t* handle) {
+    roc_panic_if_not(handle);
+
+    LoopbackSenderPort& self = *(LoopbackSenderPort*)handle->data;
+
+    self.handle_initialized_ = false;
+
+    roc_log(LogInfo, "loopback sender: closed port %s",
+            packet::address_to_str(self.address_).c_str());
+
+    self.closed_ = true;
+    self.close_handler_.handle_closed(self);
+}
+
+} // namespace netio
+} // namespace roc
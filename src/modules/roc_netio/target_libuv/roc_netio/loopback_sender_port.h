@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_libuv/roc_netio/loopback_sender_port.h
+//! @brief Loopback sender.
+
+#ifndef ROC_NETIO_LOOPBACK_SENDER_PORT_H_
+#define ROC_NETIO_LOOPBACK_SENDER_PORT_H_
+
+#include <uv.h>
+
+#include "roc_core/iallocator.h"
+#include "roc_netio/basic_port.h"
+#include "roc_netio/iclose_handler.h"
+#include "roc_netio/loopback_router.h"
+#include "roc_packet/address.h"
+#include "roc_packet/iwriter.h"
+
+namespace roc {
+namespace netio {
+
+//! Loopback sender.
+class LoopbackSenderPort : public BasicPort, public packet::IWriter {
+public:
+    //! Initialize.
+    LoopbackSenderPort(ICloseHandler& close_handler,
+                       const packet::Address& address,
+                       uv_loop_t& event_loop,
+                       LoopbackRouter& router,
+                       core::IAllocator& allocator);
+
+    //! Destroy.
+    ~LoopbackSenderPort();
+
+    //! Get bind address.
+    virtual const packet::Address& address() const;
+
+    //! Open sender.
+    virtual bool open();
+
+    //! Asynchronously close sender.
+    virtual void async_close();
+
+    //! Write packet.
+    //! @remarks
+    //!  May be called from any thread. Sets packet source address to the
+    //!  bind address and passes the packet to the loopback receiver bound to
+    //!  its destination address, in the caller thread. Send time is ignored.
+    virtual void write(const packet::PacketPtr&);
+
+private:
+    static void close_cb_(uv_handle_t* handle);
+
+    ICloseHandler& close_handler_;
+
+    uv_loop_t& loop_;
+
+    // Never started, used only to report closing from the event loop.
+    uv_idle_t handle_;
+    bool handle_initialized_;
+
+    packet::Address address_;
+
+    LoopbackRouter& router_;
+
+    bool closed_;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_LOOPBACK_SENDER_PORT_H_
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_netio/shm_receiver_port.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_packet/address_to_str.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+// How long the reader thread sleeps before rechecking stop flag.
+const core::nanoseconds_t WaitTimeout = 100 * core::Millisecond;
+
+} // namespace
+
+ShmReceiverPort::ShmReceiverPort(ICloseHandler& close_handler,
+                                 const packet::Address& address,
+                                 uv_loop_t& event_loop,
+                                 packet::PacketPool& packet_pool,
+                                 core::BufferPool<uint8_t>& buffer_pool,
+                                 packet::IWriter& writer,
+                                 core::IAllocator& allocator)
+    : BasicPort(allocator)
+    , close_handler_(close_handler)
+    , loop_(event_loop)
+    , handle_initialized_(false)
+    , address_(address)
+    , packet_pool_(packet_pool)
+    , buffer_pool_(buffer_pool)
+    , writer_(writer)
+    , started_(false)
+    , closed_(false) {
+}
+
+ShmReceiverPort::~ShmReceiverPort() {
+    if (handle_initialized_ || started_) {
+        roc_panic(
+            "shm receiver: receiver was not fully closed before calling destructor");
+    }
+}
+
+const packet::Address& ShmReceiverPort::address() const {
+    return address_;
+}
+
+bool ShmReceiverPort::open() {
+    if (int err = uv_idle_init(&loop_, &handle_)) {
+        roc_log(LogError, "shm receiver: uv_idle_init(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    handle_.data = this;
+    handle_initialized_ = true;
+
+    if (address_.port() <= 0) {
+        roc_log(LogError, "shm receiver: can't bind to %s: port should be set",
+                packet::address_to_str(address_).c_str());
+        return false;
+    }
+
+    char name[ShmRing::MaxNameLen];
+    if (!ShmRing::make_name(address_, name, sizeof(name))) {
+        roc_log(LogError, "shm receiver: can't build segment name for %s",
+                packet::address_to_str(address_).c_str());
+        return false;
+    }
+
+    if (!ring_.create(name, ShmRing::DefaultNumSlots, buffer_pool_.buffer_size())) {
+        roc_log(LogError, "shm receiver: can't create segment for %s",
+                packet::address_to_str(address_).c_str());
+        return false;
+    }
+
+    if (!Thread::start()) {
+        roc_log(LogError, "shm receiver: can't start thread");
+        return false;
+    }
+    started_ = true;
+
+    roc_log(LogInfo, "shm receiver: opened port %s",
+            packet::address_to_str(address_).c_str());
+
+    return true;
+}
+
+void ShmReceiverPort::async_close() {
+    if (started_) {
+        stop_ = true;
+        ring_.wake();
+
+        Thread::join();
+        started_ = false;
+    }
+
+    if (closed_) {
+        return;
+    }
+
+    if (!handle_initialized_) {
+        closed_ = true;
+        close_handler_.handle_closed(*this);
+
+        return;
+    }
+
+    if (!uv_is_closing((uv_handle_t*)&handle_)) {
+        roc_log(LogInfo, "shm receiver: closing port %s",
+                packet::address_to_str(address_).c_str());
+
+        uv_close((uv_handle_t*)&handle_, close_cb_);
+    }
+}
+
+void ShmReceiverPort::close_cb_(uv_handle_t* handle) {
+    roc_panic_if_not(handle);
+
+    ShmReceiverPort& self = *(ShmReceiverPort*)handle->data;
+
+    self.handle_initialized_ = false;
+
+    roc_log(LogInfo, "shm receiver: closed port %s",
+            packet::address_to_str(self.address_).c_str());
+
+    self.closed_ = true;
+    self.close_handler_.handle_closed(self);
+}
+
+void ShmReceiverPort::run() {
+    roc_log(LogDebug, "shm receiver: starting thread");
+
+    while (!stop_) {
+        if (!read_packet_()) {
+            ring_.wait(WaitTimeout);
+        }
+    }
+
+    roc_log(LogDebug, "shm receiver: finishing thread");
+}
+
+bool ShmReceiverPort::read_packet_() {
+    if (!ring_.readable()) {
+        return false;
+    }
+
+    core::SharedPtr<core::Buffer<uint8_t> > bp =
+        new (buffer_pool_) core::Buffer<uint8_t>(buffer_pool_);
+
+    if (!bp) {
+        roc_log(LogError, "shm receiver: can't allocate buffer");
+        return false;
+    }
+
+    packet::Address src_addr;
+    size_t size = 0;
+
+    if (!ring_.read(src_addr, bp->data(), size)) {
+        return false;
+    }
+
+    packet::PacketPtr pp = new (packet_pool_) packet::Packet(packet_pool_);
+    if (!pp) {
+        roc_log(LogError, "shm receiver: can't allocate packet");
+        return true;
+    }
+
+    pp->add_flags(packet::Packet::FlagUDP);
+
+    pp->udp()->src_addr = src_addr;
+    pp->udp()->dst_addr = address_;
+
+    pp->set_data(core::Slice<uint8_t>(*bp, 0, size));
+
+    writer_.write(pp);
+
+    return true;
+}
+
+} // namespace netio
+} // namespace roc
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_libuv/roc_netio/shm_receiver_port.h
+//! @brief Shared memory receiver.
+
+#ifndef ROC_NETIO_SHM_RECEIVER_PORT_H_
+#define ROC_NETIO_SHM_RECEIVER_PORT_H_
+
+#include <uv.h>
+
+#include "roc_core/atomic.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/thread.h"
+#include "roc_netio/basic_port.h"
+#include "roc_netio/iclose_handler.h"
+#include "roc_netio/shm_ring.h"
+#include "roc_packet/address.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet_pool.h"
+
+namespace roc {
+namespace netio {
+
+//! Shared memory receiver.
+//! @remarks
+//!  Creates a shared memory ring named after the bind address and reads
+//!  packets written to it by shared memory senders of other processes on
+//!  the same host. Packets are read on a dedicated thread, which sleeps
+//!  only when the ring is empty.
+class ShmReceiverPort : public BasicPort, private core::Thread {
+public:
+    //! Initialize.
+    ShmReceiverPort(ICloseHandler& close_handler,
+                    const packet::Address& address,
+                    uv_loop_t& event_loop,
+                    packet::PacketPool& packet_pool,
+                    core::BufferPool<uint8_t>& buffer_pool,
+                    packet::IWriter& writer,
+                    core::IAllocator& allocator);
+
+    //! Destroy.
+    ~ShmReceiverPort();
+
+    //! Get bind address.
+    virtual const packet::Address& address() const;
+
+    //! Open receiver.
+    virtual bool open();
+
+    //! Asynchronously close receiver.
+    virtual void async_close();
+
+private:
+    static void close_cb_(uv_handle_t* handle);
+
+    virtual void run();
+
+    bool read_packet_();
+
+    ICloseHandler& close_handler_;
+
+    uv_loop_t& loop_;
+
+    // Never started, used only to report closing from the event loop.
+    uv_idle_t handle_;
+    bool handle_initialized_;
+
+    packet::Address address_;
+
+    packet::PacketPool& packet_pool_;
+    core::BufferPool<uint8_t>& buffer_pool_;
+    packet::IWriter& writer_;
+
+    ShmRing ring_;
+
+    core::Atomic stop_;
+    bool started_;
+    bool closed_;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_SHM_RECEIVER_PORT_H_
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_netio/shm_sender_port.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_packet/address_to_str.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+// How often to retry attaching to a receiver which is not started yet.
+const core::nanoseconds_t AttachRetryInterval = 100 * core::Millisecond;
+
+// How often to check if an attached receiver was restarted.
+const core::nanoseconds_t StaleCheckInterval = 500 * core::Millisecond;
+
+} // namespace
+
+ShmSenderPort::ShmSenderPort(ICloseHandler& close_handler,
+                             const packet::Address& address,
+                             uv_loop_t& event_loop,
+                             core::IAllocator& allocator)
+    : BasicPort(allocator)
+    , close_handler_(close_handler)
+    , loop_(event_loop)
+    , handle_initialized_(false)
+    , address_(address)
+    , allocator_(allocator)
+    , rings_(allocator)
+    , stopped_(true)
+    , closed_(false) {
+}
+
+ShmSenderPort::~ShmSenderPort() {
+    if (handle_initialized_) {
+        roc_panic("shm sender: sender was not fully closed before calling destructor");
+    }
+
+    close_rings_();
+}
+
+const packet::Address& ShmSenderPort::address() const {
+    return address_;
+}
+
+bool ShmSenderPort::open() {
+    if (int err = uv_idle_init(&loop_, &handle_)) {
+        roc_log(LogError, "shm sender: uv_idle_init(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    handle_.data = this;
+    handle_initialized_ = true;
+
+    if (!rings_.grow(MaxRings)) {
+        roc_log(LogError, "shm sender: can't allocate rings");
+        return false;
+    }
+
+    roc_log(LogInfo, "shm sender: opened port %s",
+            packet::address_to_str(address_).c_str());
+
+    stopped_ = false;
+
+    return true;
+}
+
+void ShmSenderPort::async_close() {
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        stopped_ = true;
+        close_rings_();
+    }
+
+    if (closed_) {
+        return;
+    }
+
+    if (!handle_initialized_) {
+        closed_ = true;
+        close_handler_.handle_closed(*this);
+
+        return;
+    }
+
+    if (!uv_is_closing((uv_handle_t*)&handle_)) {
+        roc_log(LogInfo, "shm sender: closing port %s",
+                packet::address_to_str(address_).c_str());
+
+        uv_close((uv_handle_t*)&handle_, close_cb_);
+    }
+}
+
+void ShmSenderPort::write(const packet::PacketPtr& pp) {
+    if (!pp) {
+        roc_panic("shm sender: unexpected null packet");
+    }
+
+    if (!pp->udp()) {
+        roc_panic("shm sender: unexpected non-udp packet");
+    }
+
+    if (!pp->data()) {
+        roc_panic("shm sender: unexpected packet w/o data");
+    }
+
+    core::Mutex::Lock lock(mutex_);
+
+    if (stopped_) {
+        return;
+    }
+
+    ShmRing* ring = find_ring_(pp->udp()->dst_addr);
+    if (!ring) {
+        return;
+    }
+
+    if (!ring->write(address_, pp->data().data(), pp->data().size())) {
+        roc_log(LogTrace, "shm sender: dropping packet: ring is full or packet is large");
+    }
+}
+
+void ShmSenderPort::close_cb_(uv_handle_t* handle) {
+    roc_panic_if_not(handle);
+
+    ShmSenderPort& self = *(ShmSenderPort*)handle->data;
+
+    self.handle_initialized_ = false;
+
+    roc_log(LogInfo, "shm sender: closed port %s",
+            packet::address_to_str(self.address_).c_str());
+
+    self.closed_ = true;
+    self.close_handler_.handle_closed(self);
+}
+
+ShmRing* ShmSenderPort::find_ring_(const packet::Address& address) {
+    Ring* entry = find_entry_(address);
+    if (!entry) {
+        return NULL;
+    }
+
+    const core::nanoseconds_t now = core::timestamp();
+
+    if (entry->ring) {
+        if (entry->ring->closed()) {
+            roc_log(LogDebug, "shm sender: receiver %s closed its segment, detaching",
+                    packet::address_to_str(address).c_str());
+            detach_(*entry);
+        } else if (now >= entry->check_time) {
+            entry->check_time = now + StaleCheckInterval;
+
+            if (entry->ring->stale()) {
+                roc_log(LogDebug, "shm sender: receiver %s was restarted, detaching",
+                        packet::address_to_str(address).c_str());
+                detach_(*entry);
+            }
+        }
+
+        if (entry->ring) {
+            return entry->ring;
+        }
+    }
+
+    if (now < entry->check_time) {
+        return NULL;
+    }
+
+    char name[ShmRing::MaxNameLen];
+    if (!ShmRing::make_name(address, name, sizeof(name))) {
+        return NULL;
+    }
+
+    ShmRing* ring = new (allocator_) ShmRing;
+    if (!ring) {
+        roc_log(LogError, "shm sender: can't allocate ring");
+        return NULL;
+    }
+
+    if (!ring->attach(name)) {
+        // receiver is not started yet
+        allocator_.destroy(*ring);
+        entry->check_time = now + AttachRetryInterval;
+        return NULL;
+    }
+
+    roc_log(LogDebug, "shm sender: attached to receiver %s",
+            packet::address_to_str(address).c_str());
+
+    entry->ring = ring;
+    entry->check_time = now + StaleCheckInterval;
+
+    return ring;
+}
+
+ShmSenderPort::Ring* ShmSenderPort::find_entry_(const packet::Address& address) {
+    for (size_t n = 0; n < rings_.size(); n++) {
+        if (rings_[n].address == address) {
+            return &rings_[n];
+        }
+    }
+
+    if (rings_.size() == rings_.max_size()) {
+        roc_log(LogDebug, "shm sender: too many destinations, dropping packet to %s",
+                packet::address_to_str(address).c_str());
+        return NULL;
+    }
+
+    Ring entry;
+    entry.address = address;
+
+    rings_.push_back(entry);
+
+    return &rings_.back();
+}
+
+void ShmSenderPort::detach_(Ring& entry) {
+    allocator_.destroy(*entry.ring);
+
+    entry.ring = NULL;
+    entry.check_time = 0;
+}
+
+void ShmSenderPort::close_rings_() {
+    for (size_t n = 0; n < rings_.size(); n++) {
+        if (rings_[n].ring) {
+            allocator_.destroy(*rings_[n].ring);
+        }
+    }
+
+    if (!rings_.resize(0)) {
+        roc_panic("shm sender: can't shrink rings");
+    }
+}
+
+} // namespace netio
+} // namespace roc
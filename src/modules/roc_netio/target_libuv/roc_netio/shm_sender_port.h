@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_libuv/roc_netio/shm_sender_port.h
+//! @brief Shared memory sender.
+
+#ifndef ROC_NETIO_SHM_SENDER_PORT_H_
+#define ROC_NETIO_SHM_SENDER_PORT_H_
+
+#include <uv.h>
+
+#include "roc_core/array.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/mutex.h"
+#include "roc_core/time.h"
+#include "roc_netio/basic_port.h"
+#include "roc_netio/iclose_handler.h"
+#include "roc_netio/shm_ring.h"
+#include "roc_packet/address.h"
+#include "roc_packet/iwriter.h"
+
+namespace roc {
+namespace netio {
+
+//! Shared memory sender.
+class ShmSenderPort : public BasicPort, public packet::IWriter {
+public:
+    //! Initialize.
+    ShmSenderPort(ICloseHandler& close_handler,
+                  const packet::Address& address,
+                  uv_loop_t& event_loop,
+                  core::IAllocator& allocator);
+
+    //! Destroy.
+    ~ShmSenderPort();
+
+    //! Get bind address.
+    virtual const packet::Address& address() const;
+
+    //! Open sender.
+    virtual bool open();
+
+    //! Asynchronously close sender.
+    virtual void async_close();
+
+    //! Write packet.
+    //! @remarks
+    //!  May be called from any thread. Copies the packet to the shared memory
+    //!  ring of the receiver bound to the packet destination address, in the
+    //!  caller thread. Rings are attached on first use and reattached if the
+    //!  receiver is restarted, even after a crash. If there is no such receiver
+    //!  or its ring is full, the packet is dropped. Send time is ignored.
+    virtual void write(const packet::PacketPtr&);
+
+private:
+    enum { MaxRings = 8 };
+
+    struct Ring {
+        packet::Address address;
+        ShmRing* ring;
+
+        // When to retry attaching if ring is null, or when to check if the
+        // ring became stale otherwise.
+        core::nanoseconds_t check_time;
+
+        Ring()
+            : ring(NULL)
+            , check_time(0) {
+        }
+    };
+
+    static void close_cb_(uv_handle_t* handle);
+
+    ShmRing* find_ring_(const packet::Address& address);
+    Ring* find_entry_(const packet::Address& address);
+    void detach_(Ring& entry);
+    void close_rings_();
+
+    ICloseHandler& close_handler_;
+
+    uv_loop_t& loop_;
+
+    // Never started, used only to report closing from the event loop.
+    uv_idle_t handle_;
+    bool handle_initialized_;
+
+    packet::Address address_;
+
+    core::IAllocator& allocator_;
+
+    core::Array<Ring> rings_;
+    core::Mutex mutex_;
+
+    bool stopped_;
+    bool closed_;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_SHM_SENDER_PORT_H_
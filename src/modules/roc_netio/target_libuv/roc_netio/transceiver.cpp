@@ -17,10 +17,14 @@ namespace netio {
 
 Transceiver::Transceiver(packet::PacketPool& packet_pool,
                          core::BufferPool<uint8_t>& buffer_pool,
-                         core::IAllocator& allocator)
+                         core::IAllocator& allocator,
+                         const core::ThreadAttributes& thread_attrs,
+                         core::IClock& clock)
     : packet_pool_(packet_pool)
     , buffer_pool_(buffer_pool)
     , allocator_(allocator)
+    , clock_(clock)
+    , loopback_router_(allocator)
     , started_(false)
     , loop_initialized_(false)
     , stop_sem_initialized_(false)
@@ -49,6 +53,12 @@ Transceiver::Transceiver(packet::PacketPool& packet_pool,
     task_sem_.data = this;
     task_sem_initialized_ = true;
 
+    core::ThreadAttributes attrs = thread_attrs;
+    if (!attrs.name) {
+        attrs.name = "roc_netio";
+    }
+    Thread::set_attributes(attrs);
+
     started_ = Thread::start();
 }
 
@@ -138,6 +148,92 @@ packet::IWriter* Transceiver::add_udp_sender(packet::Address& bind_address) {
     return task.writer;
 }
 
+bool Transceiver::add_loopback_receiver(packet::Address& bind_address,
+                                        packet::IWriter& writer) {
+    if (!valid()) {
+        roc_panic("transceiver: can't use invalid transceiver");
+    }
+
+    Task task;
+    task.fn = &Transceiver::add_loopback_receiver_;
+    task.address = &bind_address;
+    task.writer = &writer;
+
+    run_task_(task);
+
+    if (!task.result) {
+        if (task.port) {
+            wait_port_closed_(*task.port);
+        }
+    }
+
+    return task.result;
+}
+
+packet::IWriter* Transceiver::add_loopback_sender(packet::Address& bind_address) {
+    if (!valid()) {
+        roc_panic("transceiver: can't use invalid transceiver");
+    }
+
+    Task task;
+    task.fn = &Transceiver::add_loopback_sender_;
+    task.address = &bind_address;
+    task.writer = NULL;
+
+    run_task_(task);
+
+    if (!task.result) {
+        if (task.port) {
+            wait_port_closed_(*task.port);
+        }
+    }
+
+    return task.writer;
+}
+
+bool Transceiver::add_shm_receiver(packet::Address& bind_address,
+                                   packet::IWriter& writer) {
+    if (!valid()) {
+        roc_panic("transceiver: can't use invalid transceiver");
+    }
+
+    Task task;
+    task.fn = &Transceiver::add_shm_receiver_;
+    task.address = &bind_address;
+    task.writer = &writer;
+
+    run_task_(task);
+
+    if (!task.result) {
+        if (task.port) {
+            wait_port_closed_(*task.port);
+        }
+    }
+
+    return task.result;
+}
+
+packet::IWriter* Transceiver::add_shm_sender(packet::Address& bind_address) {
+    if (!valid()) {
+        roc_panic("transceiver: can't use invalid transceiver");
+    }
+
+    Task task;
+    task.fn = &Transceiver::add_shm_sender_;
+    task.address = &bind_address;
+    task.writer = NULL;
+
+    run_task_(task);
+
+    if (!task.result) {
+        if (task.port) {
+            wait_port_closed_(*task.port);
+        }
+    }
+
+    return task.writer;
+}
+
 void Transceiver::remove_port(packet::Address bind_address) {
     if (!valid()) {
         roc_panic("transceiver: can't use invalid transceiver");
@@ -159,6 +255,29 @@ void Transceiver::remove_port(packet::Address bind_address) {
     }
 }
 
+void Transceiver::remove_udp_receiver(packet::Address bind_address,
+                                      packet::IWriter& writer) {
+    if (!valid()) {
+        roc_panic("transceiver: can't use invalid transceiver");
+    }
+
+    Task task;
+    task.fn = &Transceiver::remove_udp_receiver_;
+    task.address = &bind_address;
+    task.writer = &writer;
+
+    run_task_(task);
+
+    if (!task.result) {
+        roc_panic("transceiver: can't remove receiver %s: unknown port or writer",
+                  packet::address_to_str(bind_address).c_str());
+    }
+
+    if (task.port) {
+        wait_port_closed_(*task.port);
+    }
+}
+
 void Transceiver::handle_closed(BasicPort& port) {
     core::Mutex::Lock lock(mutex_);
 
@@ -257,9 +376,26 @@ void Transceiver::process_tasks_() {
 }
 
 bool Transceiver::add_udp_receiver_(Task& task) {
-    core::SharedPtr<BasicPort> rp =
-        new (allocator_) UDPReceiverPort(*this, *task.address, loop_, *task.writer,
-                                         packet_pool_, buffer_pool_, allocator_);
+    if (UDPReceiverPort* sp = find_shared_port_(*task.address)) {
+        if (!sp->add_writer(*task.writer)) {
+            roc_log(LogError, "transceiver: can't add port %s: can't subscribe writer",
+                    packet::address_to_str(*task.address).c_str());
+
+            return false;
+        }
+
+        roc_log(LogDebug, "transceiver: sharing port %s: n_writers=%lu",
+                packet::address_to_str(*task.address).c_str(),
+                (unsigned long)sp->num_writers());
+
+        *task.address = sp->address();
+
+        return true;
+    }
+
+    core::SharedPtr<UDPReceiverPort> rp =
+        new (allocator_) UDPReceiverPort(*this, *task.address, loop_, packet_pool_,
+                                         buffer_pool_, allocator_);
 
     if (!rp) {
         roc_log(LogError, "transceiver: can't add port %s: can't allocate receiver",
@@ -270,6 +406,16 @@ bool Transceiver::add_udp_receiver_(Task& task) {
 
     task.port = rp.get();
 
+    if (!rp->add_writer(*task.writer)) {
+        roc_log(LogError, "transceiver: can't add port %s: can't subscribe writer",
+                packet::address_to_str(*task.address).c_str());
+
+        closing_ports_.push_back(*rp);
+        rp->async_close();
+
+        return false;
+    }
+
     if (!rp->open()) {
         roc_log(LogError, "transceiver: can't add port %s: can't start receiver",
                 packet::address_to_str(*task.address).c_str());
@@ -288,7 +434,7 @@ bool Transceiver::add_udp_receiver_(Task& task) {
 
 bool Transceiver::add_udp_sender_(Task& task) {
     core::SharedPtr<UDPSenderPort> sp =
-        new (allocator_) UDPSenderPort(*this, *task.address, loop_, allocator_);
+        new (allocator_) UDPSenderPort(*this, *task.address, loop_, clock_, allocator_);
     if (!sp) {
         roc_log(LogError, "transceiver: can't add port %s: can't allocate sender",
                 packet::address_to_str(*task.address).c_str());
@@ -316,6 +462,122 @@ bool Transceiver::add_udp_sender_(Task& task) {
     return true;
 }
 
+bool Transceiver::add_loopback_receiver_(Task& task) {
+    core::SharedPtr<LoopbackReceiverPort> rp = new (allocator_) LoopbackReceiverPort(
+        *this, *task.address, loop_, loopback_router_, *task.writer, allocator_);
+    if (!rp) {
+        roc_log(LogError,
+                "transceiver: can't add port %s: can't allocate loopback receiver",
+                packet::address_to_str(*task.address).c_str());
+
+        return false;
+    }
+
+    task.port = rp.get();
+
+    if (!rp->open()) {
+        roc_log(LogError,
+                "transceiver: can't add port %s: can't start loopback receiver",
+                packet::address_to_str(*task.address).c_str());
+
+        closing_ports_.push_back(*rp);
+        rp->async_close();
+
+        return false;
+    }
+
+    open_ports_.push_back(*rp);
+
+    return true;
+}
+
+bool Transceiver::add_loopback_sender_(Task& task) {
+    core::SharedPtr<LoopbackSenderPort> sp = new (allocator_)
+        LoopbackSenderPort(*this, *task.address, loop_, loopback_router_, allocator_);
+    if (!sp) {
+        roc_log(LogError,
+                "transceiver: can't add port %s: can't allocate loopback sender",
+                packet::address_to_str(*task.address).c_str());
+
+        return false;
+    }
+
+    task.port = sp.get();
+
+    if (!sp->open()) {
+        roc_log(LogError, "transceiver: can't add port %s: can't start loopback sender",
+                packet::address_to_str(*task.address).c_str());
+
+        closing_ports_.push_back(*sp);
+        sp->async_close();
+
+        return false;
+    }
+
+    task.writer = sp.get();
+
+    open_ports_.push_back(*sp);
+
+    return true;
+}
+
+bool Transceiver::add_shm_receiver_(Task& task) {
+    core::SharedPtr<ShmReceiverPort> rp =
+        new (allocator_) ShmReceiverPort(*this, *task.address, loop_, packet_pool_,
+                                         buffer_pool_, *task.writer, allocator_);
+    if (!rp) {
+        roc_log(LogError, "transceiver: can't add port %s: can't allocate shm receiver",
+                packet::address_to_str(*task.address).c_str());
+
+        return false;
+    }
+
+    task.port = rp.get();
+
+    if (!rp->open()) {
+        roc_log(LogError, "transceiver: can't add port %s: can't start shm receiver",
+                packet::address_to_str(*task.address).c_str());
+
+        closing_ports_.push_back(*rp);
+        rp->async_close();
+
+        return false;
+    }
+
+    open_ports_.push_back(*rp);
+
+    return true;
+}
+
+bool Transceiver::add_shm_sender_(Task& task) {
+    core::SharedPtr<ShmSenderPort> sp =
+        new (allocator_) ShmSenderPort(*this, *task.address, loop_, allocator_);
+    if (!sp) {
+        roc_log(LogError, "transceiver: can't add port %s: can't allocate shm sender",
+                packet::address_to_str(*task.address).c_str());
+
+        return false;
+    }
+
+    task.port = sp.get();
+
+    if (!sp->open()) {
+        roc_log(LogError, "transceiver: can't add port %s: can't start shm sender",
+                packet::address_to_str(*task.address).c_str());
+
+        closing_ports_.push_back(*sp);
+        sp->async_close();
+
+        return false;
+    }
+
+    task.writer = sp.get();
+
+    open_ports_.push_back(*sp);
+
+    return true;
+}
+
 bool Transceiver::remove_port_(Task& task) {
     roc_log(LogDebug, "transceiver: removing port %s",
             packet::address_to_str(*task.address).c_str());
@@ -325,11 +587,8 @@ bool Transceiver::remove_port_(Task& task) {
         core::SharedPtr<BasicPort> next = open_ports_.nextof(*curr);
 
         if (curr->address() == *task.address) {
-            open_ports_.remove(*curr);
-            closing_ports_.push_back(*curr);
-
             task.port = curr.get();
-            curr->async_close();
+            async_close_port_(*curr);
 
             return true;
         }
@@ -340,6 +599,75 @@ bool Transceiver::remove_port_(Task& task) {
     return false;
 }
 
+bool Transceiver::remove_udp_receiver_(Task& task) {
+    roc_log(LogDebug, "transceiver: removing receiver %s",
+            packet::address_to_str(*task.address).c_str());
+
+    for (core::SharedPtr<BasicPort> curr = open_ports_.front(); curr;
+         curr = open_ports_.nextof(*curr)) {
+        if (curr->address() != *task.address) {
+            continue;
+        }
+
+        if (!curr->shared()) {
+            task.port = curr.get();
+            async_close_port_(*curr);
+
+            return true;
+        }
+
+        UDPReceiverPort& rp = static_cast<UDPReceiverPort&>(*curr);
+
+        if (!rp.remove_writer(*task.writer)) {
+            continue;
+        }
+
+        if (rp.num_writers() == 0) {
+            task.port = curr.get();
+            async_close_port_(*curr);
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+UDPReceiverPort* Transceiver::find_shared_port_(const packet::Address& address) {
+    if (address.port() == 0) {
+        return NULL;
+    }
+
+    for (core::SharedPtr<BasicPort> curr = open_ports_.front(); curr;
+         curr = open_ports_.nextof(*curr)) {
+        if (!curr->shared() || curr->address() != address) {
+            continue;
+        }
+
+        // address comparison doesn't take multicast interface into account
+        char curr_iface[128] = {};
+        curr->address().get_miface(curr_iface, sizeof(curr_iface));
+
+        char iface[128] = {};
+        address.get_miface(iface, sizeof(iface));
+
+        if (strcmp(curr_iface, iface) != 0) {
+            continue;
+        }
+
+        return static_cast<UDPReceiverPort*>(curr.get());
+    }
+
+    return NULL;
+}
+
+void Transceiver::async_close_port_(BasicPort& port) {
+    open_ports_.remove(port);
+    closing_ports_.push_back(port);
+
+    port.async_close();
+}
+
 void Transceiver::wait_port_closed_(const BasicPort& port) {
     core::Mutex::Lock lock(mutex_);
 
@@ -17,12 +17,20 @@
 #include "roc_core/buffer_pool.h"
 #include "roc_core/cond.h"
 #include "roc_core/iallocator.h"
+#include "roc_core/iclock.h"
 #include "roc_core/list.h"
 #include "roc_core/list_node.h"
 #include "roc_core/mutex.h"
+#include "roc_core/system_clock.h"
 #include "roc_core/thread.h"
+#include "roc_core/thread_attributes.h"
 #include "roc_netio/basic_port.h"
 #include "roc_netio/iclose_handler.h"
+#include "roc_netio/loopback_receiver_port.h"
+#include "roc_netio/loopback_router.h"
+#include "roc_netio/loopback_sender_port.h"
+#include "roc_netio/shm_receiver_port.h"
+#include "roc_netio/shm_sender_port.h"
 #include "roc_netio/udp_receiver_port.h"
 #include "roc_netio/udp_sender_port.h"
 #include "roc_packet/address.h"
@@ -39,9 +47,16 @@ public:
     //!
     //! @remarks
     //!  Start background thread if the object was successfully constructed.
+    //!  @p thread_attrs are applied to the background thread; if the name is
+    //!  not set, a default one is used. @p clock is used to check packet send
+    //!  time and should be the same clock that the sender pipeline uses to set
+    //!  it; it should advance in real time, since it's used for event loop
+    //!  timers.
     Transceiver(packet::PacketPool& packet_pool,
                 core::BufferPool<uint8_t>& buffer_pool,
-                core::IAllocator& allocator);
+                core::IAllocator& allocator,
+                const core::ThreadAttributes& thread_attrs = core::ThreadAttributes(),
+                core::IClock& clock = core::SystemClock::instance());
 
     //! Destroy. Stop all receivers and senders.
     //!
@@ -65,6 +80,12 @@ public:
     //! interfaces. If port is zero, a random free port is selected and written
     //! back to @p bind_address.
     //!
+    //! If IP is a multicast group, the receiver joins the group, using the
+    //! multicast interface of @p bind_address, if it's set. If there is already
+    //! a receiver for the same group, port, and interface, no new socket is
+    //! created; instead, @p writer is subscribed to the existing receiver, and
+    //! every received packet is passed to all subscribed writers.
+    //!
     //! @returns
     //!  true on success or false if error occurred
     bool add_udp_receiver(packet::Address& bind_address, packet::IWriter& writer);
@@ -83,9 +104,71 @@ public:
     //!  a new packet writer on success or null if error occurred
     packet::IWriter* add_udp_sender(packet::Address& bind_address);
 
+    //! Add loopback receiver port.
+    //!
+    //! Binds @p writer to @p bind_address in this transceiver. Packets written
+    //! to loopback senders of the same transceiver with this destination address
+    //! are passed to @p writer as is, without copying and without syscalls.
+    //! Writer will be called from the thread that writes to the loopback sender.
+    //! It should not block.
+    //!
+    //! The port of @p bind_address should be non-zero.
+    //!
+    //! @returns
+    //!  true on success or false if error occurred
+    bool add_loopback_receiver(packet::Address& bind_address, packet::IWriter& writer);
+
+    //! Add loopback sender port.
+    //!
+    //! Returns a writer that passes packets to the loopback receiver of this
+    //! transceiver bound to the packet destination address. Packet source
+    //! address is set to @p bind_address. Writer may be called from any thread.
+    //! Packet send time is ignored.
+    //!
+    //! @returns
+    //!  a new packet writer on success or null if error occurred
+    packet::IWriter* add_loopback_sender(packet::Address& bind_address);
+
+    //! Add shared memory receiver port.
+    //!
+    //! Creates a shared memory ring named after @p bind_address. Shared memory
+    //! senders of any process on this host pass packets with this destination
+    //! address through the ring instead of sockets. The receiver will pass
+    //! packets to @p writer. Writer will be called from a dedicated thread of
+    //! the port. It should not block.
+    //!
+    //! The port of @p bind_address should be non-zero. Maximum packet size is
+    //! defined by the buffer pool of the transceiver.
+    //!
+    //! @returns
+    //!  true on success or false if error occurred
+    bool add_shm_receiver(packet::Address& bind_address, packet::IWriter& writer);
+
+    //! Add shared memory sender port.
+    //!
+    //! Returns a writer that copies packets to the shared memory ring of the
+    //! receiver bound to the packet destination address. Packet source address
+    //! is set to @p bind_address. Writer may be called from any thread. It will
+    //! not block the caller. Packet send time is ignored.
+    //!
+    //! @returns
+    //!  a new packet writer on success or null if error occurred
+    packet::IWriter* add_shm_sender(packet::Address& bind_address);
+
     //! Remove sender or receiver port. Wait until port will be removed.
+    //!
+    //! @remarks
+    //!  If the port is a receiver shared by several writers, it's removed
+    //!  for all of them.
     void remove_port(packet::Address bind_address);
 
+    //! Remove writer from UDP receiver port.
+    //!
+    //! Unsubscribes @p writer from the receiver bound to @p bind_address. If
+    //! there are no more subscribed writers, removes the port and waits until
+    //! it will be removed.
+    void remove_udp_receiver(packet::Address bind_address, packet::IWriter& writer);
+
 private:
     struct Task : core::ListNode {
         bool (Transceiver::*fn)(Task&);
@@ -122,13 +205,26 @@ private:
     bool add_udp_receiver_(Task&);
     bool add_udp_sender_(Task&);
 
+    bool add_loopback_receiver_(Task&);
+    bool add_loopback_sender_(Task&);
+
+    bool add_shm_receiver_(Task&);
+    bool add_shm_sender_(Task&);
+
     bool remove_port_(Task&);
+    bool remove_udp_receiver_(Task&);
+
+    UDPReceiverPort* find_shared_port_(const packet::Address& address);
+    void async_close_port_(BasicPort& port);
     void wait_port_closed_(const BasicPort& port);
     bool port_is_closing_(const BasicPort& port);
 
     packet::PacketPool& packet_pool_;
     core::BufferPool<uint8_t>& buffer_pool_;
     core::IAllocator& allocator_;
+    core::IClock& clock_;
+
+    LoopbackRouter loopback_router_;
 
     bool started_;
 
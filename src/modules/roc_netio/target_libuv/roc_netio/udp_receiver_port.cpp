@@ -18,7 +18,6 @@ namespace netio {
 UDPReceiverPort::UDPReceiverPort(ICloseHandler& close_handler,
                                  const packet::Address& address,
                                  uv_loop_t& event_loop,
-                                 packet::IWriter& writer,
                                  packet::PacketPool& packet_pool,
                                  core::BufferPool<uint8_t>& buffer_pool,
                                  core::IAllocator& allocator)
@@ -26,17 +25,22 @@ UDPReceiverPort::UDPReceiverPort(ICloseHandler& close_handler,
     , close_handler_(close_handler)
     , loop_(event_loop)
     , handle_initialized_(false)
+    , flush_initialized_(false)
     , recv_started_(false)
+    , group_joined_(false)
     , closed_(false)
     , address_(address)
-    , writer_(writer)
+    , writers_(allocator)
+    , batch_size_(0)
+    , copies_(allocator)
+    , n_copies_(allocator)
     , packet_pool_(packet_pool)
     , buffer_pool_(buffer_pool)
     , packet_counter_(0) {
 }
 
 UDPReceiverPort::~UDPReceiverPort() {
-    if (handle_initialized_) {
+    if (handle_initialized_ || flush_initialized_) {
         roc_panic(
             "udp receiver: receiver was not fully closed before calling destructor");
     }
@@ -47,6 +51,15 @@ const packet::Address& UDPReceiverPort::address() const {
 }
 
 bool UDPReceiverPort::open() {
+    if (int err = uv_check_init(&loop_, &flush_handle_)) {
+        roc_log(LogError, "udp receiver: uv_check_init(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    flush_handle_.data = this;
+    flush_initialized_ = true;
+
     if (int err = uv_udp_init(&loop_, &handle_)) {
         roc_log(LogError, "udp receiver: uv_udp_init(): [%s] %s", uv_err_name(err),
                 uv_strerror(err));
@@ -89,6 +102,18 @@ bool UDPReceiverPort::open() {
         return false;
     }
 
+    if (address_.multicast()) {
+        if (!join_group_()) {
+            return false;
+        }
+    }
+
+    if (int err = uv_check_start(&flush_handle_, flush_cb_)) {
+        roc_log(LogError, "udp receiver: uv_check_start(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
     if (int err = uv_udp_recv_start(&handle_, alloc_cb_, recv_cb_)) {
         roc_log(LogError, "udp receiver: uv_udp_recv_start(): [%s] %s", uv_err_name(err),
                 uv_strerror(err));
@@ -108,7 +133,7 @@ void UDPReceiverPort::async_close() {
         return; // handle_closed() was already called
     }
 
-    if (!handle_initialized_) {
+    if (!handle_initialized_ && !flush_initialized_) {
         closed_ = true;
         close_handler_.handle_closed(*this);
 
@@ -127,9 +152,177 @@ void UDPReceiverPort::async_close() {
         recv_started_ = false;
     }
 
-    if (!uv_is_closing((uv_handle_t*)&handle_)) {
+    if (group_joined_) {
+        leave_group_();
+    }
+
+    for (size_t n = 0; n < batch_size_; n++) {
+        batch_[n].reset();
+    }
+    batch_size_ = 0;
+
+    if (handle_initialized_ && !uv_is_closing((uv_handle_t*)&handle_)) {
         uv_close((uv_handle_t*)&handle_, close_cb_);
     }
+
+    if (flush_initialized_ && !uv_is_closing((uv_handle_t*)&flush_handle_)) {
+        uv_close((uv_handle_t*)&flush_handle_, close_cb_);
+    }
+}
+
+bool UDPReceiverPort::shared() const {
+    return address_.multicast();
+}
+
+bool UDPReceiverPort::add_writer(packet::IWriter& writer) {
+    for (size_t n = 0; n < writers_.size(); n++) {
+        if (writers_[n] == &writer) {
+            roc_panic("udp receiver: writer is already subscribed");
+        }
+    }
+
+    if (!writers_.grow(writers_.size() + 1)
+        || !copies_.resize((writers_.size() + 1) * MaxBatch)
+        || !n_copies_.resize(writers_.size() + 1)) {
+        roc_log(LogError, "udp receiver: can't allocate writer");
+        return false;
+    }
+
+    writers_.push_back(&writer);
+
+    return true;
+}
+
+bool UDPReceiverPort::remove_writer(packet::IWriter& writer) {
+    for (size_t n = 0; n < writers_.size(); n++) {
+        if (writers_[n] != &writer) {
+            continue;
+        }
+
+        for (size_t i = n + 1; i < writers_.size(); i++) {
+            writers_[i - 1] = writers_[i];
+        }
+
+        if (!writers_.resize(writers_.size() - 1)
+            || !copies_.resize(writers_.size() * MaxBatch)
+            || !n_copies_.resize(writers_.size())) {
+            roc_panic("udp receiver: can't shrink writers array");
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+size_t UDPReceiverPort::num_writers() const {
+    return writers_.size();
+}
+
+bool UDPReceiverPort::join_group_() {
+    char group[128];
+    if (!address_.get_ip(group, sizeof(group))) {
+        roc_log(LogError, "udp receiver: can't format multicast group address");
+        return false;
+    }
+
+    char iface[128];
+    if (address_.has_miface()) {
+        if (!address_.get_miface(iface, sizeof(iface))) {
+            roc_log(LogError, "udp receiver: can't format multicast interface address");
+            return false;
+        }
+    }
+
+    if (int err = uv_udp_set_membership(&handle_, group,
+                                        address_.has_miface() ? iface : NULL,
+                                        UV_JOIN_GROUP)) {
+        roc_log(LogError, "udp receiver: uv_udp_set_membership(): [%s] %s",
+                uv_err_name(err), uv_strerror(err));
+        return false;
+    }
+
+    roc_log(LogDebug, "udp receiver: joined multicast group: group=%s iface=%s", group,
+            address_.has_miface() ? iface : "default");
+
+    group_joined_ = true;
+
+    return true;
+}
+
+void UDPReceiverPort::leave_group_() {
+    group_joined_ = false;
+
+    char group[128];
+    if (!address_.get_ip(group, sizeof(group))) {
+        return;
+    }
+
+    char iface[128];
+    if (address_.has_miface()) {
+        if (!address_.get_miface(iface, sizeof(iface))) {
+            return;
+        }
+    }
+
+    if (int err = uv_udp_set_membership(&handle_, group,
+                                        address_.has_miface() ? iface : NULL,
+                                        UV_LEAVE_GROUP)) {
+        roc_log(LogError, "udp receiver: uv_udp_set_membership(): [%s] %s",
+                uv_err_name(err), uv_strerror(err));
+    }
+}
+
+void UDPReceiverPort::add_packet_(const packet::PacketPtr& pp) {
+    batch_[batch_size_++] = pp;
+
+    if (batch_size_ == MaxBatch) {
+        flush_packets_();
+    }
+}
+
+void UDPReceiverPort::flush_packets_() {
+    if (batch_size_ == 0) {
+        return;
+    }
+
+    const size_t n_writers = writers_.size();
+
+    if (n_writers == 1) {
+        writers_[0]->write_batch(batch_, batch_size_);
+    } else if (n_writers > 1) {
+        // make all copies before the first write, since writers may parse
+        // and modify headers of their packets
+        for (size_t w = 0; w < n_writers; w++) {
+            size_t n_copies = 0;
+
+            for (size_t n = 0; n < batch_size_; n++) {
+                packet::PacketPtr pp = w == 0 ? batch_[n] : batch_[n]->clone();
+                if (!pp) {
+                    roc_log(LogError, "udp receiver: can't allocate packet");
+                    continue;
+                }
+                copies_[w * MaxBatch + n_copies++] = pp;
+            }
+
+            n_copies_[w] = n_copies;
+        }
+
+        for (size_t w = 0; w < n_writers; w++) {
+            if (n_copies_[w] != 0) {
+                writers_[w]->write_batch(&copies_[w * MaxBatch], n_copies_[w]);
+            }
+
+            for (size_t n = 0; n < n_copies_[w]; n++) {
+                copies_[w * MaxBatch + n].reset();
+            }
+        }
+    }
+
+    for (size_t n = 0; n < batch_size_; n++) {
+        batch_[n].reset();
+    }
+    batch_size_ = 0;
 }
 
 void UDPReceiverPort::close_cb_(uv_handle_t* handle) {
@@ -137,7 +330,15 @@ void UDPReceiverPort::close_cb_(uv_handle_t* handle) {
 
     UDPReceiverPort& self = *(UDPReceiverPort*)handle->data;
 
-    self.handle_initialized_ = false;
+    if (handle == (uv_handle_t*)&self.handle_) {
+        self.handle_initialized_ = false;
+    } else {
+        self.flush_initialized_ = false;
+    }
+
+    if (self.handle_initialized_ || self.flush_initialized_) {
+        return;
+    }
 
     roc_log(LogInfo, "udp receiver: closed port %s",
             packet::address_to_str(self.address_).c_str());
@@ -146,6 +347,14 @@ void UDPReceiverPort::close_cb_(uv_handle_t* handle) {
     self.close_handler_.handle_closed(self);
 }
 
+void UDPReceiverPort::flush_cb_(uv_check_t* handle) {
+    roc_panic_if_not(handle);
+
+    UDPReceiverPort& self = *(UDPReceiverPort*)handle->data;
+
+    self.flush_packets_();
+}
+
 void UDPReceiverPort::alloc_cb_(uv_handle_t* handle, size_t size, uv_buf_t* buf) {
     roc_panic_if_not(handle);
     roc_panic_if_not(buf);
@@ -260,7 +469,7 @@ void UDPReceiverPort::recv_cb_(uv_udp_t* handle,
 
     pp->set_data(core::Slice<uint8_t>(*bp, 0, (size_t)nread));
 
-    self.writer_.write(pp);
+    self.add_packet_(pp);
 }
 
 } // namespace netio
@@ -14,6 +14,7 @@
 
 #include <uv.h>
 
+#include "roc_core/array.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/list.h"
@@ -29,13 +30,22 @@ namespace roc {
 namespace netio {
 
 //! UDP receiver.
+//! @remarks
+//!  Packets received during one event loop iteration are passed to writers
+//!  as a batch, after the loop finishes polling for I/O.
+//!
+//!  Received packets are passed to every subscribed writer. If there are
+//!  several writers, the first one gets the received packet and the rest
+//!  get its shallow copies. All copies are made before the packet is passed
+//!  to the first writer, so every writer gets its own unparsed headers and
+//!  may parse them independently. The data buffer is shared by all copies
+//!  without copy-on-write, since it's never modified on the receiving side.
 class UDPReceiverPort : public BasicPort {
 public:
     //! Initialize.
     UDPReceiverPort(ICloseHandler& close_handler,
                     const packet::Address&,
                     uv_loop_t& event_loop,
-                    packet::IWriter& writer,
                     packet::PacketPool& packet_pool,
                     core::BufferPool<uint8_t>& buffer_pool,
                     core::IAllocator& allocator);
@@ -52,8 +62,29 @@ public:
     //! Asynchronously close receiver.
     virtual void async_close();
 
+    //! Check if the port can be shared by several writers.
+    //! @remarks
+    //!  Returns true for multicast addresses.
+    virtual bool shared() const;
+
+    //! Subscribe writer to received packets.
+    //! @returns
+    //!  false if allocation failed.
+    bool add_writer(packet::IWriter& writer);
+
+    //! Unsubscribe writer from received packets.
+    //! @returns
+    //!  false if the writer was not subscribed.
+    bool remove_writer(packet::IWriter& writer);
+
+    //! Get number of subscribed writers.
+    size_t num_writers() const;
+
 private:
+    enum { MaxBatch = 32 };
+
     static void close_cb_(uv_handle_t* handle);
+    static void flush_cb_(uv_check_t* handle);
     static void alloc_cb_(uv_handle_t* handle, size_t size, uv_buf_t* buf);
     static void recv_cb_(uv_udp_t* handle,
                          ssize_t nread,
@@ -61,6 +92,12 @@ private:
                          const sockaddr* addr,
                          unsigned flags);
 
+    bool join_group_();
+    void leave_group_();
+
+    void add_packet_(const packet::PacketPtr& pp);
+    void flush_packets_();
+
     ICloseHandler& close_handler_;
 
     uv_loop_t& loop_;
@@ -68,11 +105,23 @@ private:
     uv_udp_t handle_;
     bool handle_initialized_;
 
+    uv_check_t flush_handle_;
+    bool flush_initialized_;
+
     bool recv_started_;
+    bool group_joined_;
     bool closed_;
 
     packet::Address address_;
-    packet::IWriter& writer_;
+
+    core::Array<packet::IWriter*> writers_;
+
+    packet::PacketPtr batch_[MaxBatch];
+    size_t batch_size_;
+
+    // Copies of batch for every writer, MaxBatch slots per writer.
+    core::Array<packet::PacketPtr> copies_;
+    core::Array<size_t> n_copies_;
 
     packet::PacketPool& packet_pool_;
     core::BufferPool<uint8_t>& buffer_pool_;
@@ -18,13 +18,17 @@ namespace netio {
 UDPSenderPort::UDPSenderPort(ICloseHandler& close_handler,
                              const packet::Address& address,
                              uv_loop_t& event_loop,
+                             core::IClock& clock,
                              core::IAllocator& allocator)
     : BasicPort(allocator)
     , close_handler_(close_handler)
     , loop_(event_loop)
+    , clock_(clock)
     , write_sem_initialized_(false)
+    , timer_initialized_(false)
     , handle_initialized_(false)
     , address_(address)
+    , request_pool_(allocator, sizeof(SendRequest), false)
     , pending_(0)
     , stopped_(true)
     , closed_(false)
@@ -32,7 +36,7 @@ UDPSenderPort::UDPSenderPort(ICloseHandler& close_handler,
 }
 
 UDPSenderPort::~UDPSenderPort() {
-    if (handle_initialized_ || write_sem_initialized_) {
+    if (handle_initialized_ || write_sem_initialized_ || timer_initialized_) {
         roc_panic("udp sender: sender was not fully closed before calling destructor");
     }
 }
@@ -51,6 +55,15 @@ bool UDPSenderPort::open() {
     write_sem_.data = this;
     write_sem_initialized_ = true;
 
+    if (int err = uv_timer_init(&loop_, &timer_)) {
+        roc_log(LogError, "udp sender: uv_timer_init(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    timer_.data = this;
+    timer_initialized_ = true;
+
     if (int err = uv_udp_init(&loop_, &handle_)) {
         roc_log(LogError, "udp sender: uv_udp_init(): [%s] %s", uv_err_name(err),
                 uv_strerror(err));
@@ -111,16 +124,32 @@ void UDPSenderPort::async_close() {
 }
 
 void UDPSenderPort::write(const packet::PacketPtr& pp) {
-    if (!pp) {
-        roc_panic("udp sender: unexpected null packet");
+    check_packet_(pp);
+
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        if (stopped_) {
+            return;
+        }
+
+        enqueue_(pp);
+        ++pending_;
     }
 
-    if (!pp->udp()) {
-        roc_panic("udp sender: unexpected non-udp packet");
+    if (int err = uv_async_send(&write_sem_)) {
+        roc_panic("udp sender: uv_async_send(): [%s] %s", uv_err_name(err),
+                  uv_strerror(err));
     }
+}
 
-    if (!pp->data()) {
-        roc_panic("udp sender: unexpected packet w/o data");
+void UDPSenderPort::write_batch(const packet::PacketPtr* packets, size_t n_packets) {
+    if (n_packets == 0) {
+        return;
+    }
+
+    for (size_t n = 0; n < n_packets; n++) {
+        check_packet_(packets[n]);
     }
 
     {
@@ -130,8 +159,10 @@ void UDPSenderPort::write(const packet::PacketPtr& pp) {
             return;
         }
 
-        list_.push_back(*pp);
-        ++pending_;
+        for (size_t n = 0; n < n_packets; n++) {
+            enqueue_(packets[n]);
+        }
+        pending_ += n_packets;
     }
 
     if (int err = uv_async_send(&write_sem_)) {
@@ -147,11 +178,14 @@ void UDPSenderPort::close_cb_(uv_handle_t* handle) {
 
     if (handle == (uv_handle_t*)&self.handle_) {
         self.handle_initialized_ = false;
+    } else if (handle == (uv_handle_t*)&self.timer_) {
+        self.timer_initialized_ = false;
     } else {
         self.write_sem_initialized_ = false;
     }
 
-    if (self.handle_initialized_ || self.write_sem_initialized_) {
+    if (self.handle_initialized_ || self.write_sem_initialized_
+        || self.timer_initialized_) {
         return;
     }
 
@@ -167,30 +201,80 @@ void UDPSenderPort::write_sem_cb_(uv_async_t* handle) {
 
     UDPSenderPort& self = *(UDPSenderPort*)handle->data;
 
-    while (packet::PacketPtr pp = self.read_()) {
-        packet::UDP& udp = *pp->udp();
+    self.send_packets_();
+}
 
-        self.packet_counter_++;
+void UDPSenderPort::timer_cb_(uv_timer_t* handle) {
+    roc_panic_if_not(handle);
 
-        roc_log(LogTrace, "udp sender: sending packet: num=%u src=%s dst=%s sz=%ld",
-                self.packet_counter_, packet::address_to_str(self.address_).c_str(),
-                packet::address_to_str(udp.dst_addr).c_str(), (long)pp->data().size());
+    UDPSenderPort& self = *(UDPSenderPort*)handle->data;
+
+    self.send_packets_();
+}
+
+void UDPSenderPort::enqueue_(const packet::PacketPtr& pp) {
+    // packets without send time don't wait behind delayed ones
+    if (pp->udp()->send_time != 0) {
+        paced_list_.push_back(*pp);
+    } else {
+        list_.push_back(*pp);
+    }
+}
 
-        uv_buf_t buf;
-        buf.base = (char*)pp->data().data();
-        buf.len = pp->data().size();
+void UDPSenderPort::send_packets_() {
+    core::nanoseconds_t send_time = 0;
 
-        udp.request.data = &self;
+    while (packet::PacketPtr pp = read_(clock_.now(), send_time)) {
+        send_packet_(pp);
+    }
 
-        if (int err = uv_udp_send(&udp.request, &self.handle_, &buf, 1,
-                                  udp.dst_addr.saddr(), send_cb_)) {
-            roc_log(LogError, "udp sender: uv_udp_send(): [%s] %s", uv_err_name(err),
-                    uv_strerror(err));
-            continue;
-        }
+    if (send_time == 0) {
+        return;
+    }
+
+    // libuv timers have millisecond resolution, so we round the timeout up
+    // to avoid spinning; the packet is sent at most one millisecond late
+    const core::nanoseconds_t timeout = send_time - clock_.now();
+    const uint64_t timeout_ms =
+        timeout > 0 ? uint64_t((timeout + core::Millisecond - 1) / core::Millisecond) : 0;
 
-        // will be decremented in send_cb_()
-        pp->incref();
+    if (int err = uv_timer_start(&timer_, timer_cb_, timeout_ms, 0)) {
+        roc_panic("udp sender: uv_timer_start(): [%s] %s", uv_err_name(err),
+                  uv_strerror(err));
+    }
+}
+
+void UDPSenderPort::send_packet_(const packet::PacketPtr& pp) {
+    packet::UDP& udp = *pp->udp();
+
+    packet_counter_++;
+
+    roc_log(LogTrace, "udp sender: sending packet: num=%u src=%s dst=%s sz=%ld",
+            packet_counter_, packet::address_to_str(address_).c_str(),
+            packet::address_to_str(udp.dst_addr).c_str(), (long)pp->data().size());
+
+    // will be destroyed in send_cb_()
+    SendRequest* req = new (request_pool_) SendRequest;
+    if (!req) {
+        roc_log(LogError, "udp sender: can't allocate send request");
+        finish_send_();
+        return;
+    }
+
+    req->request.data = this;
+    req->packet = pp;
+
+    uv_buf_t buf;
+    buf.base = (char*)pp->data().data();
+    buf.len = pp->data().size();
+
+    if (int err = uv_udp_send(&req->request, &handle_, &buf, 1, udp.dst_addr.saddr(),
+                              send_cb_)) {
+        roc_log(LogError, "udp sender: uv_udp_send(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        request_pool_.destroy(*req);
+        finish_send_();
+        return;
     }
 }
 
@@ -199,15 +283,12 @@ void UDPSenderPort::send_cb_(uv_udp_send_t* req, int status) {
 
     UDPSenderPort& self = *(UDPSenderPort*)req->data;
 
-    packet::PacketPtr pp =
-        packet::Packet::container_of(ROC_CONTAINER_OF(req, packet::UDP, request));
+    SendRequest* send_req = ROC_CONTAINER_OF(req, SendRequest, request);
 
-    // one reference for incref() called from write_sem_cb_()
-    // one reference for the shared pointer above
-    roc_panic_if(pp->getref() < 2);
+    packet::PacketPtr pp = send_req->packet;
 
-    // decrement reference counter incremented in async_cb_()
-    pp->decref();
+    // allocated in send_packet_()
+    self.request_pool_.destroy(*send_req);
 
     if (status < 0) {
         roc_log(LogError,
@@ -218,23 +299,54 @@ void UDPSenderPort::send_cb_(uv_udp_send_t* req, int status) {
                 (long)pp->data().size(), uv_err_name(status), uv_strerror(status));
     }
 
-    core::Mutex::Lock lock(self.mutex_);
+    self.finish_send_();
+}
+
+void UDPSenderPort::finish_send_() {
+    core::Mutex::Lock lock(mutex_);
+
+    --pending_;
+
+    if (stopped_ && pending_ == 0) {
+        close_();
+    }
+}
+
+void UDPSenderPort::check_packet_(const packet::PacketPtr& pp) {
+    if (!pp) {
+        roc_panic("udp sender: unexpected null packet");
+    }
 
-    --self.pending_;
+    if (!pp->udp()) {
+        roc_panic("udp sender: unexpected non-udp packet");
+    }
 
-    if (self.stopped_ && self.pending_ == 0) {
-        self.close_();
+    if (!pp->data()) {
+        roc_panic("udp sender: unexpected packet w/o data");
     }
 }
 
-packet::PacketPtr UDPSenderPort::read_() {
+packet::PacketPtr UDPSenderPort::read_(core::nanoseconds_t now,
+                                       core::nanoseconds_t& send_time) {
     core::Mutex::Lock lock(mutex_);
 
-    packet::PacketPtr pp = list_.front();
-    if (pp) {
+    if (packet::PacketPtr pp = list_.front()) {
         list_.remove(*pp);
+        return pp;
+    }
+
+    packet::PacketPtr pp = paced_list_.front();
+    if (!pp) {
+        return NULL;
     }
 
+    if (pp->udp()->send_time > now) {
+        send_time = pp->udp()->send_time;
+        return NULL;
+    }
+
+    paced_list_.remove(*pp);
+
     return pp;
 }
 
@@ -243,7 +355,7 @@ void UDPSenderPort::close_() {
         return; // handle_closed() was already called
     }
 
-    if (!handle_initialized_ && !write_sem_initialized_) {
+    if (!handle_initialized_ && !write_sem_initialized_ && !timer_initialized_) {
         closed_ = true;
         close_handler_.handle_closed(*this);
 
@@ -260,6 +372,10 @@ void UDPSenderPort::close_() {
     if (write_sem_initialized_ && !uv_is_closing((uv_handle_t*)&write_sem_)) {
         uv_close((uv_handle_t*)&write_sem_, close_cb_);
     }
+
+    if (timer_initialized_ && !uv_is_closing((uv_handle_t*)&timer_)) {
+        uv_close((uv_handle_t*)&timer_, close_cb_);
+    }
 }
 
 } // namespace netio
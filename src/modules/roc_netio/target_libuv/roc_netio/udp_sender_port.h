@@ -15,8 +15,11 @@
 #include <uv.h>
 
 #include "roc_core/iallocator.h"
+#include "roc_core/iclock.h"
 #include "roc_core/mutex.h"
+#include "roc_core/pool.h"
 #include "roc_core/refcnt.h"
+#include "roc_core/time.h"
 #include "roc_netio/basic_port.h"
 #include "roc_netio/iclose_handler.h"
 #include "roc_packet/address.h"
@@ -29,9 +32,12 @@ namespace netio {
 class UDPSenderPort : public BasicPort, public packet::IWriter {
 public:
     //! Initialize.
+    //! @remarks
+    //!  Packet send time is compared with the time of @p clock.
     UDPSenderPort(ICloseHandler& close_handler,
                   const packet::Address&,
                   uv_loop_t& event_loop,
+                  core::IClock& clock,
                   core::IAllocator& allocator);
 
     //! Destroy.
@@ -48,32 +54,63 @@ public:
 
     //! Write packet.
     //! @remarks
-    //!  May be called from any thread.
+    //!  May be called from any thread. If the packet has non-zero send time,
+    //!  it is sent not earlier than that time. Packets with zero send time
+    //!  are sent immediately, even if there are delayed packets before them.
+    //!  Packets of each kind are sent in the same order as they were written.
     virtual void write(const packet::PacketPtr&);
 
+    //! Write multiple packets.
+    //! @remarks
+    //!  May be called from any thread. Packets are enqueued under a single
+    //!  lock and the event loop is woken up once.
+    virtual void write_batch(const packet::PacketPtr* packets, size_t n_packets);
+
 private:
+    // Sender request state, exists while the packet is being sent.
+    struct SendRequest {
+        uv_udp_send_t request;
+        packet::PacketPtr packet;
+    };
+
     static void close_cb_(uv_handle_t* handle);
     static void write_sem_cb_(uv_async_t* handle);
+    static void timer_cb_(uv_timer_t* handle);
     static void send_cb_(uv_udp_send_t* req, int status);
 
-    packet::PacketPtr read_();
+    static void check_packet_(const packet::PacketPtr&);
+
+    void enqueue_(const packet::PacketPtr& pp);
+
+    void send_packets_();
+    void send_packet_(const packet::PacketPtr& pp);
+    void finish_send_();
+
+    packet::PacketPtr read_(core::nanoseconds_t now, core::nanoseconds_t& send_time);
     void close_();
 
     ICloseHandler& close_handler_;
 
     uv_loop_t& loop_;
+    core::IClock& clock_;
 
     uv_async_t write_sem_;
     bool write_sem_initialized_;
 
+    uv_timer_t timer_;
+    bool timer_initialized_;
+
     uv_udp_t handle_;
     bool handle_initialized_;
 
     packet::Address address_;
 
     core::List<packet::Packet> list_;
+    core::List<packet::Packet> paced_list_;
     core::Mutex mutex_;
 
+    core::Pool<SendRequest> request_pool_;
+
     size_t pending_;
     bool stopped_;
     bool closed_;
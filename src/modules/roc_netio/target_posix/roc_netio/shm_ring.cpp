@@ -0,0 +1,568 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "roc_core/atomic.h"
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_netio/shm_ring.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+const uint32_t Magic = 0x52434d53; // "RCMS"
+const uint32_t Version = 1;
+
+const size_t Alignment = 64;
+
+// How long a slot claimed by a writer may stay unpublished before the reader
+// skips it. Should be much larger than the time needed to copy a packet.
+const core::nanoseconds_t StaleSlotTimeout = core::Second;
+
+size_t align_up(size_t size) {
+    return (size + Alignment - 1) / Alignment * Alignment;
+}
+
+// Sequence number of a slot skipped by the reader at given position. It never
+// equals a position, so no writer can claim the slot until the writer that
+// claimed it at this position finds that it was skipped and releases it.
+long skipped_seq(long pos) {
+    return -pos - 1;
+}
+
+} // namespace
+
+struct ShmRing::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t n_slots;
+    uint32_t slot_size;
+
+    // Number of slots claimed by writers.
+    core::Atomic write_pos;
+
+    // Number of slots consumed by reader.
+    core::Atomic read_pos;
+
+    // Set while reader sleeps or is about to sleep.
+    core::Atomic reader_waiting;
+
+    // Set when reader unmaps the segment.
+    core::Atomic closed;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+};
+
+struct ShmRing::Slot {
+    // Equals to position when the slot is free for writing at this position,
+    // position + 1 when the packet at this position is published, and
+    // skipped_seq(position) when the reader skipped the unpublished slot.
+    core::Atomic seq;
+
+    uint32_t size;
+    sockaddr_storage src_addr;
+};
+
+ShmRing::ShmRing()
+    : owner_(false)
+    , dev_(0)
+    , ino_(0)
+    , n_slots_(0)
+    , slot_size_(0)
+    , stuck_pos_(0)
+    , stuck_time_(0)
+    , mem_(NULL)
+    , mem_size_(0)
+    , header_(NULL)
+    , slots_(NULL)
+    , slot_stride_(0) {
+    name_[0] = '\0';
+}
+
+ShmRing::~ShmRing() {
+    if (owner_ && header_) {
+        header_->closed = true;
+
+        pthread_cond_destroy(&header_->cond);
+        pthread_mutex_destroy(&header_->mutex);
+    }
+
+    unmap_();
+
+    if (owner_) {
+        if (shm_unlink(name_) == -1) {
+            roc_log(LogError, "shm ring: shm_unlink(): %s", core::errno_to_str().c_str());
+        }
+    }
+}
+
+bool ShmRing::make_name(const packet::Address& address, char* buf, size_t bufsz) {
+    char ip[48] = {};
+    if (!address.get_ip(ip, sizeof(ip))) {
+        return false;
+    }
+
+    // shared memory names can't contain slashes, and colons are not portable
+    for (char* p = ip; *p; p++) {
+        if (*p == ':') {
+            *p = '_';
+        }
+    }
+
+    const int ret = snprintf(buf, bufsz, "/roc-%s-%d", ip, address.port());
+
+    return ret > 0 && (size_t)ret < bufsz;
+}
+
+bool ShmRing::create(const char* name, size_t n_slots, size_t slot_size) {
+    roc_panic_if(valid());
+
+    if (n_slots == 0 || slot_size == 0) {
+        roc_log(LogError, "shm ring: invalid size: n_slots=%lu slot_size=%lu",
+                (unsigned long)n_slots, (unsigned long)slot_size);
+        return false;
+    }
+
+    if (strlen(name) >= sizeof(name_)) {
+        roc_log(LogError, "shm ring: name is too long: %s", name);
+        return false;
+    }
+    strcpy(name_, name);
+
+    // remove stale segment left by a crashed reader
+    shm_unlink(name_);
+
+    int fd = shm_open(name_, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1) {
+        roc_log(LogError, "shm ring: shm_open(%s): %s", name_,
+                core::errno_to_str().c_str());
+        return false;
+    }
+
+    owner_ = true;
+
+    const size_t stride = align_up(sizeof(Slot) + slot_size);
+    const size_t size = align_up(sizeof(Header)) + n_slots * stride;
+
+    if (ftruncate(fd, (off_t)size) == -1) {
+        roc_log(LogError, "shm ring: ftruncate(): %s", core::errno_to_str().c_str());
+        close(fd);
+        return false;
+    }
+
+    const bool ok = map_(fd, size);
+    close(fd);
+
+    if (!ok) {
+        return false;
+    }
+
+    Header& hdr = *header_;
+
+    hdr.n_slots = (uint32_t)n_slots;
+    hdr.slot_size = (uint32_t)slot_size;
+
+    new (&hdr.write_pos) core::Atomic(0);
+    new (&hdr.read_pos) core::Atomic(0);
+    new (&hdr.reader_waiting) core::Atomic(0);
+    new (&hdr.closed) core::Atomic(0);
+
+    pthread_mutexattr_t mutex_attr;
+    pthread_mutexattr_init(&mutex_attr);
+    int err = pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED);
+    if (err == 0) {
+        err = pthread_mutex_init(&hdr.mutex, &mutex_attr);
+    }
+    pthread_mutexattr_destroy(&mutex_attr);
+
+    if (err != 0) {
+        roc_log(LogError, "shm ring: can't init process-shared mutex: %s",
+                core::errno_to_str(err).c_str());
+        unmap_();
+        return false;
+    }
+
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    err = pthread_condattr_setpshared(&cond_attr, PTHREAD_PROCESS_SHARED);
+    if (err == 0) {
+        err = pthread_cond_init(&hdr.cond, &cond_attr);
+    }
+    pthread_condattr_destroy(&cond_attr);
+
+    if (err != 0) {
+        roc_log(LogError, "shm ring: can't init process-shared cond: %s",
+                core::errno_to_str(err).c_str());
+        pthread_mutex_destroy(&hdr.mutex);
+        unmap_();
+        return false;
+    }
+
+    slot_stride_ = stride;
+
+    n_slots_ = n_slots;
+    slot_size_ = slot_size;
+
+    for (size_t n = 0; n < n_slots; n++) {
+        new (&slot_((long)n).seq) core::Atomic((long)n);
+    }
+
+    hdr.version = Version;
+
+    // writers check magic last, after the segment is fully initialized
+    __sync_synchronize();
+    hdr.magic = Magic;
+
+    roc_log(LogDebug, "shm ring: created segment %s: n_slots=%lu slot_size=%lu size=%lu",
+            name_, (unsigned long)n_slots, (unsigned long)slot_size,
+            (unsigned long)size);
+
+    return true;
+}
+
+bool ShmRing::attach(const char* name) {
+    roc_panic_if(valid());
+
+    if (strlen(name) >= sizeof(name_)) {
+        roc_log(LogError, "shm ring: name is too long: %s", name);
+        return false;
+    }
+    strcpy(name_, name);
+
+    int fd = shm_open(name_, O_RDWR, 0);
+    if (fd == -1) {
+        roc_log(LogDebug, "shm ring: shm_open(%s): %s", name_,
+                core::errno_to_str().c_str());
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        roc_log(LogError, "shm ring: fstat(): %s", core::errno_to_str().c_str());
+        close(fd);
+        return false;
+    }
+
+    const size_t size = (size_t)st.st_size;
+
+    dev_ = st.st_dev;
+    ino_ = st.st_ino;
+
+    if (size < sizeof(Header)) {
+        roc_log(LogDebug, "shm ring: segment %s is not initialized yet", name_);
+        close(fd);
+        return false;
+    }
+
+    const bool ok = map_(fd, size);
+    close(fd);
+
+    if (!ok) {
+        return false;
+    }
+
+    const Header& hdr = *header_;
+
+    __sync_synchronize();
+
+    if (hdr.magic != Magic || hdr.version != Version) {
+        roc_log(LogDebug, "shm ring: segment %s is not initialized or incompatible",
+                name_);
+        unmap_();
+        return false;
+    }
+
+    n_slots_ = hdr.n_slots;
+    slot_size_ = hdr.slot_size;
+
+    slot_stride_ = align_up(sizeof(Slot) + slot_size_);
+
+    if (n_slots_ == 0 || align_up(sizeof(Header)) + n_slots_ * slot_stride_ > size) {
+        roc_log(LogError, "shm ring: segment %s is truncated", name_);
+        unmap_();
+        return false;
+    }
+
+    roc_log(LogDebug, "shm ring: attached segment %s: n_slots=%lu slot_size=%lu", name_,
+            (unsigned long)hdr.n_slots, (unsigned long)hdr.slot_size);
+
+    return true;
+}
+
+bool ShmRing::valid() const {
+    return header_;
+}
+
+bool ShmRing::closed() const {
+    roc_panic_if(!valid());
+
+    return header_->closed;
+}
+
+bool ShmRing::stale() const {
+    roc_panic_if(!valid());
+
+    int fd = shm_open(name_, O_RDONLY, 0);
+    if (fd == -1) {
+        if (errno == ENOENT) {
+            return true;
+        }
+        roc_log(LogError, "shm ring: shm_open(%s): %s", name_,
+                core::errno_to_str().c_str());
+        return false;
+    }
+
+    struct stat st;
+    const bool ok = (fstat(fd, &st) == 0);
+    close(fd);
+
+    if (!ok) {
+        roc_log(LogError, "shm ring: fstat(): %s", core::errno_to_str().c_str());
+        return false;
+    }
+
+    // reader creates a new segment on restart, even if it didn't unlink the
+    // old one, e.g. because it crashed
+    return st.st_dev != dev_ || st.st_ino != ino_;
+}
+
+size_t ShmRing::slot_size() const {
+    roc_panic_if(!valid());
+
+    return slot_size_;
+}
+
+bool ShmRing::write(const packet::Address& src_addr, const uint8_t* data, size_t size) {
+    roc_panic_if(!valid());
+
+    Header& hdr = *header_;
+
+    if (size > slot_size_) {
+        return false;
+    }
+
+    long pos;
+    Slot* slot;
+
+    for (;;) {
+        pos = hdr.write_pos;
+        slot = &slot_(pos);
+
+        const long dif = (long)slot->seq - pos;
+
+        if (dif == 0) {
+            if (hdr.write_pos.compare_exchange(pos, pos + 1)) {
+                break;
+            }
+        } else if (dif < 0) {
+            // slot at this position still holds unread packet
+            return false;
+        }
+        // otherwise another writer claimed the slot, retry
+    }
+
+    slot->size = (uint32_t)size;
+    memcpy(&slot->src_addr, src_addr.saddr(), src_addr.slen());
+    memcpy((uint8_t*)slot + sizeof(Slot), data, size);
+
+    // publish packet; full barrier
+    // fails if the reader decided that we're dead and skipped the slot
+    if (!slot->seq.compare_exchange(pos, pos + 1)) {
+        // nobody could claim the skipped slot, so the data we've just copied
+        // didn't overwrite anyone's packet; release slot for pos + n_slots
+        if (!slot->seq.compare_exchange(skipped_seq(pos), pos + (long)n_slots_)) {
+            roc_log(LogDebug, "shm ring: unexpected slot state: pos=%ld", pos);
+        }
+        return false;
+    }
+
+    if (hdr.reader_waiting) {
+        pthread_mutex_lock(&hdr.mutex);
+        pthread_cond_signal(&hdr.cond);
+        pthread_mutex_unlock(&hdr.mutex);
+    }
+
+    return true;
+}
+
+bool ShmRing::readable() {
+    roc_panic_if(!valid());
+
+    return next_slot_();
+}
+
+bool ShmRing::read(packet::Address& src_addr, uint8_t* data, size_t& size) {
+    roc_panic_if(!valid());
+
+    Header& hdr = *header_;
+
+    while (Slot* slot = next_slot_()) {
+        const size_t slot_size = slot->size;
+
+        const bool ok = (slot_size <= slot_size_);
+
+        if (ok) {
+            size = slot_size;
+            memcpy(data, (const uint8_t*)slot + sizeof(Slot), size);
+
+            if (!src_addr.set_saddr((const sockaddr*)&slot->src_addr)) {
+                roc_log(LogDebug, "shm ring: invalid source address in slot");
+            }
+        } else {
+            roc_log(LogDebug,
+                    "shm ring: dropping packet with invalid size: size=%lu max=%lu",
+                    (unsigned long)slot_size, (unsigned long)slot_size_);
+        }
+
+        // release slot for position pos + n_slots; full barrier
+        slot->seq += (long)n_slots_ - 1;
+
+        ++hdr.read_pos;
+
+        if (ok) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ShmRing::wait(core::nanoseconds_t timeout) {
+    roc_panic_if(!valid());
+
+    Header& hdr = *header_;
+
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    const core::nanoseconds_t deadline =
+        core::nanoseconds_t(ts.tv_sec) * core::Second + ts.tv_nsec + timeout;
+
+    ts.tv_sec = time_t(deadline / core::Second);
+    ts.tv_nsec = long(deadline % core::Second);
+
+    pthread_mutex_lock(&hdr.mutex);
+
+    hdr.reader_waiting = true;
+
+    const long pos = hdr.read_pos;
+    if ((long)slot_(pos).seq != pos + 1) {
+        pthread_cond_timedwait(&hdr.cond, &hdr.mutex, &ts);
+    }
+
+    hdr.reader_waiting = false;
+
+    pthread_mutex_unlock(&hdr.mutex);
+}
+
+void ShmRing::wake() {
+    roc_panic_if(!valid());
+
+    pthread_mutex_lock(&header_->mutex);
+    pthread_cond_signal(&header_->cond);
+    pthread_mutex_unlock(&header_->mutex);
+}
+
+bool ShmRing::map_(int fd, size_t size) {
+    void* mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED) {
+        roc_log(LogError, "shm ring: mmap(): %s", core::errno_to_str().c_str());
+        return false;
+    }
+
+    mem_ = mem;
+    mem_size_ = size;
+
+    header_ = (Header*)mem;
+    slots_ = (uint8_t*)mem + align_up(sizeof(Header));
+
+    return true;
+}
+
+void ShmRing::unmap_() {
+    if (!mem_) {
+        return;
+    }
+
+    if (munmap(mem_, mem_size_) == -1) {
+        roc_log(LogError, "shm ring: munmap(): %s", core::errno_to_str().c_str());
+    }
+
+    mem_ = NULL;
+    mem_size_ = 0;
+
+    header_ = NULL;
+    slots_ = NULL;
+}
+
+ShmRing::Slot* ShmRing::next_slot_() {
+    Header& hdr = *header_;
+
+    for (;;) {
+        const long pos = hdr.read_pos;
+        Slot& slot = slot_(pos);
+
+        const long seq = slot.seq;
+
+        if (seq == pos + 1) {
+            stuck_time_ = 0;
+            return &slot;
+        }
+
+        if (seq != pos || (long)hdr.write_pos == pos) {
+            // ring is empty
+            stuck_time_ = 0;
+            return NULL;
+        }
+
+        // slot is claimed by a writer, but not published yet
+        const core::nanoseconds_t now = core::timestamp();
+
+        if (stuck_time_ == 0 || stuck_pos_ != pos) {
+            stuck_pos_ = pos;
+            stuck_time_ = now;
+            return NULL;
+        }
+
+        if (now - stuck_time_ < StaleSlotTimeout) {
+            return NULL;
+        }
+
+        // skip slot without reading it; it's released by the writer that
+        // claimed it, not here, since that writer may still be copying data
+        if (!slot.seq.compare_exchange(pos, skipped_seq(pos))) {
+            // published just now
+            continue;
+        }
+
+        roc_log(LogDebug, "shm ring: skipping slot not published by writer: pos=%ld",
+                pos);
+
+        ++hdr.read_pos;
+        stuck_time_ = 0;
+    }
+}
+
+ShmRing::Slot& ShmRing::slot_(long pos) const {
+    return *(Slot*)(slots_ + size_t(pos % (long)n_slots_) * slot_stride_);
+}
+
+} // namespace netio
+} // namespace roc
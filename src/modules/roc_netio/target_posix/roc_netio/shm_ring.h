@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_posix/roc_netio/shm_ring.h
+//! @brief Shared memory packet ring.
+
+#ifndef ROC_NETIO_SHM_RING_H_
+#define ROC_NETIO_SHM_RING_H_
+
+#include <sys/types.h>
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_packet/address.h"
+
+namespace roc {
+namespace netio {
+
+//! Shared memory packet ring.
+//! @remarks
+//!  Bounded ring of packet slots in a POSIX shared memory segment. The ring
+//!  is created by a single reader process and attached by any number of
+//!  writer processes.
+//!
+//!  Every slot has a sequence number that tells whether it's free or holds
+//!  a published packet. Writers claim slots with compare-and-swap on the
+//!  write position and never block: if the ring is full, the packet is
+//!  dropped. The reader consumes slots in order without locks.
+//!
+//!  The reader may sleep on a process-shared condition variable when the
+//!  ring is empty. Writers signal it only if the reader is actually sleeping,
+//!  so in steady state neither side makes syscalls.
+//!
+//!  The reader doesn't trust the contents of the segment: packet sizes are
+//!  checked against its own slot size, and a slot claimed by a writer that
+//!  didn't publish it for too long, e.g. because the writer was descheduled
+//!  or crashed, is skipped. The skipped slot can't be claimed again until
+//!  the writer that claimed it finds that it was skipped and releases it, so
+//!  a late writer never overwrites a packet of another writer. If that
+//!  writer has crashed, the slot is never released, and after one more lap
+//!  writers see the ring as full until the reader is restarted.
+class ShmRing : public core::NonCopyable<> {
+public:
+    enum {
+        //! Default number of slots.
+        DefaultNumSlots = 512,
+
+        //! Maximum length of segment name.
+        MaxNameLen = 64
+    };
+
+    //! Initialize empty ring.
+    ShmRing();
+
+    //! Unmap segment.
+    //! @remarks
+    //!  If the segment was created by this object, it's also unlinked.
+    ~ShmRing();
+
+    //! Build segment name for given address.
+    //! @returns
+    //!  false if the address is invalid.
+    static bool make_name(const packet::Address& address, char* buf, size_t bufsz);
+
+    //! Create and map a new segment.
+    //! @remarks
+    //!  Should be called by the reader. If a stale segment with the same
+    //!  name exists, it is replaced.
+    bool create(const char* name, size_t n_slots, size_t slot_size);
+
+    //! Map an existing segment.
+    //! @remarks
+    //!  Should be called by a writer.
+    bool attach(const char* name);
+
+    //! Check if the segment is mapped.
+    bool valid() const;
+
+    //! Check if the reader has closed the segment.
+    //! @remarks
+    //!  Writers should detach from a closed segment; if the reader is
+    //!  restarted, it creates a new segment with the same name.
+    bool closed() const;
+
+    //! Check if the segment was removed or replaced by a new one.
+    //! @remarks
+    //!  Should be called by a writer. Unlike closed(), also detects that the
+    //!  reader crashed and was restarted. Makes syscalls, so it should not be
+    //!  called for every packet.
+    bool stale() const;
+
+    //! Get maximum packet size.
+    size_t slot_size() const;
+
+    //! Write packet to the ring.
+    //! @remarks
+    //!  May be called concurrently from several threads and processes.
+    //! @returns
+    //!  false if the ring is full or the packet is larger than slot size.
+    bool write(const packet::Address& src_addr, const uint8_t* data, size_t size);
+
+    //! Check if there is a packet to read.
+    //! @remarks
+    //!  Should be called only by the reader.
+    bool readable();
+
+    //! Read packet from the ring.
+    //! @remarks
+    //!  Should be called only by the reader. @p data should have room for at
+    //!  least slot_size() bytes. Packets with invalid size are dropped.
+    //! @returns
+    //!  false if the ring is empty.
+    bool read(packet::Address& src_addr, uint8_t* data, size_t& size);
+
+    //! Wait until the ring becomes non-empty.
+    //! @remarks
+    //!  Should be called only by the reader. Returns after @p timeout even
+    //!  if the ring is still empty, or earlier if wake() was called.
+    void wait(core::nanoseconds_t timeout);
+
+    //! Wake up the reader sleeping in wait().
+    void wake();
+
+private:
+    struct Header;
+    struct Slot;
+
+    bool map_(int fd, size_t size);
+    void unmap_();
+
+    Slot* next_slot_();
+    Slot& slot_(long pos) const;
+
+    char name_[MaxNameLen];
+    bool owner_;
+
+    dev_t dev_;
+    ino_t ino_;
+
+    // Copied from header, so that writers can't change them under the reader.
+    size_t n_slots_;
+    size_t slot_size_;
+
+    // Position and time when the reader found an unpublished slot.
+    long stuck_pos_;
+    core::nanoseconds_t stuck_time_;
+
+    void* mem_;
+    size_t mem_size_;
+
+    Header* header_;
+    uint8_t* slots_;
+    size_t slot_stride_;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_SHM_RING_H_
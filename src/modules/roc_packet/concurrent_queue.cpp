@@ -40,5 +40,22 @@ void ConcurrentQueue::write(const PacketPtr& packet) {
     cond_.broadcast();
 }
 
+void ConcurrentQueue::write_batch(const PacketPtr* packets, size_t n_packets) {
+    if (n_packets == 0) {
+        return;
+    }
+
+    core::Mutex::Lock lock(mutex_);
+
+    for (size_t n = 0; n < n_packets; n++) {
+        if (!packets[n]) {
+            roc_panic("concurrent queue: packet is null");
+        }
+        list_.push_back(*packets[n]);
+    }
+
+    cond_.broadcast();
+}
+
 } // namespace packet
 } // namespace roc
@@ -39,6 +39,11 @@ public:
     //!  Adds packet to the end of the queue.
     virtual void write(const PacketPtr& packet);
 
+    //! Add multiple packets to the queue.
+    //! @remarks
+    //!  Adds packets to the end of the queue under a single lock.
+    virtual void write_batch(const PacketPtr* packets, size_t n_packets);
+
 private:
     core::Mutex mutex_;
     core::Cond cond_;
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/conv_interleaver.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { BatchSize = 64 };
+
+} // namespace
+
+ConvInterleaver::ConvInterleaver(IWriter& writer,
+                                 core::IAllocator& allocator,
+                                 size_t max_delay)
+    : writer_(writer)
+    , num_branches_(1)
+    , max_delay_(0)
+    , slots_(allocator)
+    , batch_(allocator)
+    , batch_size_(0)
+    , pos_(0)
+    , valid_(false) {
+    while (num_branches_ * (num_branches_ + 1) <= max_delay) {
+        num_branches_++;
+    }
+
+    max_delay_ = (num_branches_ - 1) * num_branches_;
+
+    roc_log(LogDebug, "conv interleaver: initializing: branches=%lu max_delay=%lu",
+            (unsigned long)num_branches_, (unsigned long)max_delay_);
+
+    if (!slots_.resize(max_delay_ + 1)) {
+        return;
+    }
+    if (!batch_.resize(BatchSize)) {
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool ConvInterleaver::valid() const {
+    return valid_;
+}
+
+void ConvInterleaver::write(const PacketPtr& packet) {
+    roc_panic_if_not(valid());
+
+    put_(packet);
+    send_batch_();
+}
+
+void ConvInterleaver::write_batch(const PacketPtr* packets, size_t n_packets) {
+    roc_panic_if_not(valid());
+
+    for (size_t n = 0; n < n_packets; n++) {
+        // one put_() adds at most one packet to the batch
+        if (batch_size_ == BatchSize) {
+            send_batch_();
+        }
+        put_(packets[n]);
+    }
+
+    send_batch_();
+}
+
+void ConvInterleaver::flush() {
+    roc_panic_if_not(valid());
+
+    for (size_t n = 0; n < slots_.size(); n++) {
+        PacketPtr& slot = slots_[(pos_ + n) % slots_.size()];
+        if (!slot) {
+            continue;
+        }
+        if (batch_size_ == BatchSize) {
+            send_batch_();
+        }
+        batch_[batch_size_++] = slot;
+        slot = NULL;
+    }
+
+    send_batch_();
+
+    pos_ = 0;
+}
+
+size_t ConvInterleaver::num_branches() const {
+    return num_branches_;
+}
+
+size_t ConvInterleaver::max_delay() const {
+    return max_delay_;
+}
+
+void ConvInterleaver::put_(const PacketPtr& packet) {
+    const size_t delay = (pos_ % num_branches_) * num_branches_;
+
+    PacketPtr& in_slot = slots_[(pos_ + delay) % slots_.size()];
+    roc_panic_if(in_slot);
+    in_slot = packet;
+
+    PacketPtr& out_slot = slots_[pos_ % slots_.size()];
+    if (out_slot) {
+        batch_[batch_size_++] = out_slot;
+        out_slot = NULL;
+    }
+
+    pos_++;
+}
+
+void ConvInterleaver::send_batch_() {
+    if (batch_size_ == 0) {
+        return;
+    }
+
+    writer_.write_batch(&batch_[0], batch_size_);
+
+    for (size_t n = 0; n < batch_size_; n++) {
+        batch_[n] = NULL;
+    }
+
+    batch_size_ = 0;
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/conv_interleaver.h
+//! @brief Convolutional interleaver with bounded delay.
+
+#ifndef ROC_PACKET_CONV_INTERLEAVER_H_
+#define ROC_PACKET_CONV_INTERLEAVER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet.h"
+
+namespace roc {
+namespace packet {
+
+//! Convolutional interleaver.
+//! @remarks
+//!  Distributes packets between B branches in round-robin order. Packets of
+//!  the branch k are delayed by k * B packets, so that packets of the branch
+//!  zero are sent immediately, and packets sent one after another are at least
+//!  B - 1 packets apart in the original order. Hence, a burst of consecutive
+//!  lost packets is spread over a range of packets about B times longer, which
+//!  usually spans multiple FEC blocks.
+//!
+//!  Unlike Interleaver, the added delay is bounded by (B - 1) * B packets
+//!  regardless of FEC block size. All memory is allocated in constructor.
+class ConvInterleaver : public IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p writer is used to send reordered packets
+    //!  - @p allocator is used to allocate the delay line
+    //!  - @p max_delay defines maximum delay added to a packet, in packets;
+    //!    the number of branches is the largest B such that (B - 1) * B
+    //!    does not exceed @p max_delay
+    ConvInterleaver(IWriter& writer, core::IAllocator& allocator, size_t max_delay);
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Write next packet.
+    //! @remarks
+    //!  Sends at most one packet to output writer.
+    virtual void write(const PacketPtr& packet);
+
+    //! Write multiple packets.
+    //! @remarks
+    //!  Same as calling write() for every packet, but packets that become ready
+    //!  are sent to output writer in batches.
+    virtual void write_batch(const PacketPtr* packets, size_t n_packets);
+
+    //! Send all buffered packets to output writer.
+    void flush();
+
+    //! Get number of branches.
+    size_t num_branches() const;
+
+    //! Get maximum delay added to a packet, in packets.
+    size_t max_delay() const;
+
+private:
+    void put_(const PacketPtr& packet);
+    void send_batch_();
+
+    IWriter& writer_;
+
+    size_t num_branches_;
+    size_t max_delay_;
+
+    // Delay line, indexed by output position modulo its size.
+    core::Array<PacketPtr> slots_;
+
+    // Packets ready to be sent to output writer.
+    core::Array<PacketPtr> batch_;
+    size_t batch_size_;
+
+    // Number of packets written since last flush.
+    size_t pos_;
+
+    bool valid_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_CONV_INTERLEAVER_H_
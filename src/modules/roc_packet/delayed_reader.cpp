@@ -23,6 +23,23 @@ DelayedReader::DelayedReader(IReader& reader,
     roc_log(LogDebug, "delayed reader: initializing: delay=%lu", (unsigned long)delay_);
 }
 
+DelayedReader::DelayedReader(IReader& reader,
+                             core::nanoseconds_t delay,
+                             size_t sample_rate,
+                             size_t ring_size,
+                             core::IAllocator& allocator)
+    : reader_(reader)
+    , queue_(0, ring_size, allocator)
+    , delay_((timestamp_t)timestamp_from_ns(delay, sample_rate))
+    , started_(false) {
+    roc_log(LogDebug, "delayed reader: initializing: delay=%lu ring_size=%lu",
+            (unsigned long)delay_, (unsigned long)ring_size);
+}
+
+bool DelayedReader::valid() const {
+    return queue_.valid();
+}
+
 PacketPtr DelayedReader::read() {
     if (!started_) {
         if (!fetch_packets_()) {
@@ -44,7 +61,7 @@ bool DelayedReader::fetch_packets_() {
         queue_.write(pp);
     }
 
-    const timestamp_t qs = queue_size_();
+    const timestamp_t qs = queue_.duration();
     if (qs < delay_) {
         return false;
     }
@@ -63,7 +80,7 @@ PacketPtr DelayedReader::read_queued_packet_() {
     for (;;) {
         pp = queue_.read();
 
-        const timestamp_t new_qs = queue_size_();
+        const timestamp_t new_qs = queue_.duration();
         if (new_qs < delay_) {
             break;
         }
@@ -80,22 +97,5 @@ PacketPtr DelayedReader::read_queued_packet_() {
     return pp;
 }
 
-timestamp_t DelayedReader::queue_size_() const {
-    if (queue_.size() == 0) {
-        return 0;
-    }
-
-    const timestamp_diff_t qs =
-        timestamp_diff(queue_.tail()->end(), queue_.head()->begin());
-
-    if (qs < 0) {
-        roc_log(LogError, "delayed reader: unexpected negative queue size: %ld",
-                (long)qs);
-        return 0;
-    }
-
-    return (timestamp_t)qs;
-}
-
 } // namespace packet
 } // namespace roc
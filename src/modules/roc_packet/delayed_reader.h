@@ -12,6 +12,7 @@
 #ifndef ROC_PACKET_DELAYED_READER_H_
 #define ROC_PACKET_DELAYED_READER_H_
 
+#include "roc_core/iallocator.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/time.h"
 #include "roc_packet/ireader.h"
@@ -34,6 +35,21 @@ public:
     //!  - @p sample_rate is the number of samples per second in incoming packets
     DelayedReader(IReader& reader, core::nanoseconds_t delay, size_t sample_rate);
 
+    //! Initialize with queue ring.
+    //!
+    //! @b Parameters
+    //!  - @p reader, @p delay, and @p sample_rate are the same as above
+    //!  - @p ring_size is the number of seqnums covered by the queue ring
+    //!  - @p allocator is used to allocate the queue ring
+    DelayedReader(IReader& reader,
+                  core::nanoseconds_t delay,
+                  size_t sample_rate,
+                  size_t ring_size,
+                  core::IAllocator& allocator);
+
+    //! Check if the reader was successfully constructed.
+    bool valid() const;
+
     //! Read packet.
     virtual PacketPtr read();
 
@@ -41,8 +57,6 @@ private:
     bool fetch_packets_();
     PacketPtr read_queued_packet_();
 
-    timestamp_t queue_size_() const;
-
     IReader& reader_;
     SortedQueue queue_;
 
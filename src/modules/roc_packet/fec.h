@@ -28,7 +28,17 @@ enum FECScheme {
     FEC_ReedSolomon_M8,
 
     //! LDPC-Staircase.
-    FEC_LDPC_Staircase
+    FEC_LDPC_Staircase,
+
+    //! Sliding window Random Linear Codes over GF(2^8).
+    //!
+    //! @remarks
+    //!  Unlike block schemes, there are no source blocks. Source packets are
+    //!  numbered sequentially and every repair packet protects a window of
+    //!  recent source packets. For repair packets, source_block_number is the
+    //!  first source ESI of the window, source_block_length is the window
+    //!  length, and encoding_symbol_id is the repair key.
+    FEC_RLC
 };
 
 //! FECFRAME packet.
@@ -18,6 +18,8 @@ Interleaver::Interleaver(IWriter& writer, core::IAllocator& allocator, size_t bl
     , block_size_(block_sz)
     , send_seq_(allocator)
     , packets_(allocator)
+    , batch_(allocator)
+    , batch_size_(0)
     , next_2_put_(0)
     , next_2_send_(0)
     , valid_(false) {
@@ -29,6 +31,9 @@ Interleaver::Interleaver(IWriter& writer, core::IAllocator& allocator, size_t bl
     if (!packets_.resize(block_size_)) {
         return;
     }
+    if (!batch_.resize(block_size_ * 2)) {
+        return;
+    }
 
     reinit_seq_();
 
@@ -49,14 +54,22 @@ bool Interleaver::valid() const {
 void Interleaver::write(const PacketPtr& p) {
     roc_panic_if_not(valid());
 
-    packets_[next_2_put_] = p;
-    next_2_put_ = (next_2_put_ + 1) % block_size_;
+    put_(p);
+    send_batch_();
+}
 
-    while (packets_[send_seq_[next_2_send_]]) {
-        writer_.write(packets_[send_seq_[next_2_send_]]);
-        packets_[send_seq_[next_2_send_]] = NULL;
-        next_2_send_ = (next_2_send_ + 1) % block_size_;
+void Interleaver::write_batch(const PacketPtr* packets, size_t n_packets) {
+    roc_panic_if_not(valid());
+
+    for (size_t n = 0; n < n_packets; n++) {
+        // one put_() adds at most block_size_ packets to the batch
+        if (batch_size_ > block_size_) {
+            send_batch_();
+        }
+        put_(packets[n]);
     }
+
+    send_batch_();
 }
 
 void Interleaver::flush() {
@@ -64,11 +77,13 @@ void Interleaver::flush() {
 
     for (size_t i = 0; i < block_size_; ++i) {
         if (packets_[i]) {
-            writer_.write(packets_[i]);
+            batch_[batch_size_++] = packets_[i];
             packets_[i] = NULL;
         }
     }
 
+    send_batch_();
+
     next_2_put_ = next_2_send_ = 0;
 }
 
@@ -76,6 +91,31 @@ size_t Interleaver::block_size() const {
     return block_size_;
 }
 
+void Interleaver::put_(const PacketPtr& p) {
+    packets_[next_2_put_] = p;
+    next_2_put_ = (next_2_put_ + 1) % block_size_;
+
+    while (packets_[send_seq_[next_2_send_]]) {
+        batch_[batch_size_++] = packets_[send_seq_[next_2_send_]];
+        packets_[send_seq_[next_2_send_]] = NULL;
+        next_2_send_ = (next_2_send_ + 1) % block_size_;
+    }
+}
+
+void Interleaver::send_batch_() {
+    if (batch_size_ == 0) {
+        return;
+    }
+
+    writer_.write_batch(&batch_[0], batch_size_);
+
+    for (size_t n = 0; n < batch_size_; n++) {
+        batch_[n] = NULL;
+    }
+
+    batch_size_ = 0;
+}
+
 void Interleaver::reinit_seq_() {
     for (size_t i = 0; i < block_size_; ++i) {
         send_seq_[i] = i;
@@ -39,6 +39,12 @@ public:
     //!  then reordered and sent to output writer.
     virtual void write(const PacketPtr& packet);
 
+    //! Write multiple packets.
+    //! @remarks
+    //!  Same as calling write() for every packet, but packets that become ready
+    //!  are sent to output writer in batches.
+    virtual void write_batch(const PacketPtr* packets, size_t n_packets);
+
     //! Send all buffered packets to output writer.
     void flush();
 
@@ -50,6 +56,9 @@ private:
     //! Initialize tx_seq_ to a new randomized sequence.
     void reinit_seq_();
 
+    void put_(const PacketPtr& packet);
+    void send_batch_();
+
     // Output writer.
     IWriter& writer_;
 
@@ -62,6 +71,10 @@ private:
     // Delay line.
     core::Array<PacketPtr> packets_;
 
+    // Packets ready to be sent to output writer.
+    core::Array<PacketPtr> batch_;
+    size_t batch_size_;
+
     size_t next_2_put_;
     size_t next_2_send_;
 
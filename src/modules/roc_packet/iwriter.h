@@ -24,6 +24,12 @@ public:
 
     //! Write packet.
     virtual void write(const PacketPtr&) = 0;
+
+    //! Write multiple packets.
+    //! @remarks
+    //!  Default implementation calls write() for every packet. Writers that
+    //!  can handle a burst of packets cheaper than one by one override it.
+    virtual void write_batch(const PacketPtr* packets, size_t n_packets);
 };
 
 } // namespace packet
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/pacer.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace packet {
+
+Pacer::Pacer(core::nanoseconds_t interval, core::nanoseconds_t max_delay)
+    : interval_(interval)
+    , max_delay_(max_delay)
+    , next_time_(0) {
+    roc_panic_if(interval < 0);
+    roc_panic_if(max_delay < 0);
+}
+
+core::nanoseconds_t Pacer::schedule(core::nanoseconds_t now) {
+    core::nanoseconds_t send_time = next_time_;
+
+    if (send_time < now) {
+        send_time = now;
+    }
+
+    if (send_time - now > max_delay_) {
+        roc_log(LogDebug, "pacer: packets are produced too fast, resetting: delay=%ld",
+                (long)(send_time - now));
+        send_time = now;
+    }
+
+    next_time_ = send_time + interval_;
+
+    return send_time;
+}
+
+} // namespace packet
+} // namespace roc
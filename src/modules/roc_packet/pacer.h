@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/pacer.h
+//! @brief Packet pacer.
+
+#ifndef ROC_PACKET_PACER_H_
+#define ROC_PACKET_PACER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace packet {
+
+//! Packet pacer.
+//! @remarks
+//!  Computes send times for a stream of packets, so that packets are sent
+//!  at least @p interval apart. This is a token bucket with a depth of one
+//!  packet: if packets are produced slower than the configured rate, they
+//!  are sent immediately; if they're produced in bursts, the bursts are
+//!  spread evenly over time.
+class Pacer : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p interval defines minimum distance between two packets
+    //!  - @p max_delay defines maximum delay added to a packet; if a packet
+    //!    would be delayed more, pacing is reset
+    Pacer(core::nanoseconds_t interval, core::nanoseconds_t max_delay);
+
+    //! Compute send time for the next packet.
+    //! @remarks
+    //!  @p now is the current time of the caller's clock, e.g. IClock::now()
+    //!  of the sender port; all calls should use the same clock.
+    //! @returns
+    //!  time when the packet should be sent, never less than @p now.
+    core::nanoseconds_t schedule(core::nanoseconds_t now);
+
+private:
+    const core::nanoseconds_t interval_;
+    const core::nanoseconds_t max_delay_;
+
+    core::nanoseconds_t next_time_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_PACER_H_
@@ -13,8 +13,8 @@ namespace roc {
 namespace packet {
 
 Packet::Packet(PacketPool& pool)
-    : pool_(pool)
-    , flags_(0) {
+    : flags_(0)
+    , pool_(pool) {
 }
 
 void Packet::add_flags(unsigned fl) {
@@ -124,6 +124,21 @@ int Packet::compare(const Packet& other) const {
     return 0;
 }
 
+PacketPtr Packet::clone() const {
+    PacketPtr pp = new (pool_) Packet(pool_);
+    if (!pp) {
+        return NULL;
+    }
+
+    pp->flags_ = flags_;
+    pp->rtp_ = rtp_;
+    pp->data_ = data_;
+    pp->fec_ = fec_;
+    pp->udp_ = udp_;
+
+    return pp;
+}
+
 void Packet::destroy() {
     pool_.destroy(*this);
 }
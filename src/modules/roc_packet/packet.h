@@ -45,7 +45,8 @@ public:
         FlagAudio = (1 << 3),    //!< Packet contains audio samples.
         FlagRepair = (1 << 4),   //!< Packet contains repair FEC symbols.
         FlagComposed = (1 << 5), //!< Packet is already composed.
-        FlagRestored = (1 << 6)  //!< Packet was restored using FEC decoder.
+        FlagRestored = (1 << 6), //!< Packet was restored using FEC decoder.
+        FlagControl = (1 << 7)   //!< Packet contains RTCP control data.
     };
 
     //! Add flags.
@@ -103,30 +104,37 @@ public:
     //!  * +1 if this packet succeeds @p other packet
     int compare(const Packet& other) const;
 
+    //! Create a shallow copy of the packet.
+    //! @remarks
+    //!  The copy is allocated from the same pool. It has the same flags and
+    //!  headers and shares the data buffer with this packet, so the data
+    //!  should not be modified in place after the packet is cloned.
+    //! @returns
+    //!  a new packet or NULL if allocation failed.
+    PacketPtr clone() const;
+
     //! Print packet to stderr.
     void print(int flags) const {
         packet::print(*this, flags);
     }
 
-    //! Get pointer to packet from a pointer to its UDP part.
-    static Packet* container_of(UDP* udp) {
-        return ROC_CONTAINER_OF(udp, Packet, udp_);
-    }
-
 private:
     friend class core::RefCnt<Packet>;
 
     void destroy();
 
-    PacketPool& pool_;
-
+    // Fields used on every routing and queueing step go first, so that
+    // flags, seqnum, timestamp, source and payload share the first cache
+    // line. Addresses and pool reference are touched only at the edges
+    // of the pipeline.
     unsigned flags_;
 
-    UDP udp_;
     RTP rtp_;
+    core::Slice<uint8_t> data_;
     FEC fec_;
+    UDP udp_;
 
-    core::Slice<uint8_t> data_;
+    PacketPool& pool_;
 };
 
 } // namespace packet
@@ -27,6 +27,12 @@ void Queue::write(const PacketPtr& packet) {
     list_.push_back(*packet);
 }
 
+void Queue::write_batch(const PacketPtr* packets, size_t n_packets) {
+    for (size_t n = 0; n < n_packets; n++) {
+        Queue::write(packets[n]);
+    }
+}
+
 size_t Queue::size() const {
     return list_.size();
 }
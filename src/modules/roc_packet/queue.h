@@ -34,6 +34,9 @@ public:
     //!  Adds packet to the end of the queue.
     virtual void write(const PacketPtr& packet);
 
+    //! Add multiple packets to the queue.
+    virtual void write_batch(const PacketPtr* packets, size_t n_packets);
+
     //! Get number of packets in queue.
     size_t size() const;
 
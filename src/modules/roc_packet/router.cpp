@@ -48,6 +48,42 @@ bool Router::add_route(IWriter& writer, unsigned flags) {
 void Router::write(const PacketPtr& packet) {
     roc_panic_if_not(valid());
 
+    if (Route* r = find_route_(packet)) {
+        r->writer->write(packet);
+    } else {
+        roc_log(LogDebug, "router: can't route packet, dropping");
+    }
+}
+
+void Router::write_batch(const PacketPtr* packets, size_t n_packets) {
+    roc_panic_if_not(valid());
+
+    size_t first = 0;
+    Route* first_route = NULL;
+
+    for (size_t n = 0; n < n_packets; n++) {
+        Route* r = find_route_(packets[n]);
+
+        if (r != first_route) {
+            if (first_route) {
+                first_route->writer->write_batch(packets + first, n - first);
+            }
+            first = n;
+            first_route = r;
+        }
+
+        if (!r) {
+            roc_log(LogDebug, "router: can't route packet, dropping");
+            first = n + 1;
+        }
+    }
+
+    if (first_route) {
+        first_route->writer->write_batch(packets + first, n_packets - first);
+    }
+}
+
+Router::Route* Router::find_route_(const PacketPtr& packet) {
     if (!packet) {
         roc_panic("router: unexpected null packet");
     }
@@ -77,11 +113,10 @@ void Router::write(const PacketPtr& packet) {
                     (unsigned long)r.source, (unsigned int)r.flags);
         }
 
-        r.writer->write(packet);
-        return;
+        return &r;
     }
 
-    roc_log(LogDebug, "router: can't route packet, dropping");
+    return NULL;
 }
 
 } // namespace packet
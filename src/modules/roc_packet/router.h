@@ -41,6 +41,12 @@ public:
     //!  Route @p packet to a writer or drop it if no routes found.
     virtual void write(const PacketPtr& packet);
 
+    //! Write multiple packets.
+    //! @remarks
+    //!  Routes @p packets like write() does, but passes every run of consecutive
+    //!  packets with the same route to its writer as a single batch.
+    virtual void write_batch(const PacketPtr* packets, size_t n_packets);
+
 private:
     struct Route {
         IWriter* writer;
@@ -49,6 +55,8 @@ private:
         bool has_source;
     };
 
+    Route* find_route_(const PacketPtr& packet);
+
     core::Array<Route> routes_;
 
     bool valid_;
@@ -53,14 +53,14 @@ struct RTP {
     //! Packet payload type.
     unsigned int payload_type;
 
-    //! Packet header.
-    core::Slice<uint8_t> header;
-
     //! Packet payload.
     //! @remarks
     //!  Doesn't include RTP headers and padding.
     core::Slice<uint8_t> payload;
 
+    //! Packet header.
+    core::Slice<uint8_t> header;
+
     //! Packet padding.
     //! @remarks
     //!  Not included in header and payload, but affects overall packet size.
@@ -13,17 +13,82 @@
 namespace roc {
 namespace packet {
 
+namespace {
+
+// number of seqnums from a to b, inclusive
+size_t seqnum_span(seqnum_t a, seqnum_t b) {
+    return size_t(seqnum_t(b - a)) + 1;
+}
+
+} // namespace
+
 SortedQueue::SortedQueue(size_t max_size)
-    : max_size_(max_size) {
+    : allocator_(NULL)
+    , ring_(NULL)
+    , ring_capacity_(0)
+    , ring_size_(0)
+    , ring_head_(0)
+    , ring_tail_(0)
+    , list_non_rtp_(0)
+    , latest_end_(0)
+    , head_begin_(0)
+    , tail_end_(0)
+    , max_size_(max_size)
+    , valid_(true) {
+}
+
+SortedQueue::SortedQueue(size_t max_size,
+                         size_t ring_size,
+                         core::IAllocator& allocator)
+    : allocator_(&allocator)
+    , ring_(NULL)
+    , ring_capacity_(0)
+    , ring_size_(0)
+    , ring_head_(0)
+    , ring_tail_(0)
+    , list_non_rtp_(0)
+    , latest_end_(0)
+    , head_begin_(0)
+    , tail_end_(0)
+    , max_size_(max_size)
+    , valid_(false) {
+    if (!alloc_ring_(ring_size)) {
+        return;
+    }
+
+    valid_ = true;
+}
+
+SortedQueue::~SortedQueue() {
+    if (!ring_) {
+        return;
+    }
+
+    for (size_t n = 0; n < ring_capacity_; n++) {
+        ring_[n].~PacketPtr();
+    }
+
+    allocator_->deallocate(ring_);
+}
+
+bool SortedQueue::valid() const {
+    return valid_;
 }
 
 PacketPtr SortedQueue::read() {
-    if (PacketPtr packet = list_.back()) {
-        list_.remove(*packet);
-        return packet;
+    PacketPtr packet;
+
+    if (ring_size_ != 0) {
+        packet = ring_read_();
+    } else {
+        packet = list_read_();
     }
 
-    return NULL;
+    if (packet) {
+        duration_remove_();
+    }
+
+    return packet;
 }
 
 void SortedQueue::write(const PacketPtr& packet) {
@@ -31,7 +96,7 @@ void SortedQueue::write(const PacketPtr& packet) {
         roc_panic("sorted queue: attempting to add null packet");
     }
 
-    if (max_size_ > 0 && list_.size() == max_size_) {
+    if (max_size_ > 0 && size() == max_size_) {
         roc_log(LogDebug,
                 "sorted queue: queue is full, dropping packet:"
                 " max_size=%u",
@@ -41,8 +106,213 @@ void SortedQueue::write(const PacketPtr& packet) {
 
     if (!latest_ || latest_->compare(*packet) <= 0) {
         latest_ = packet;
+        latest_end_ = packet->end();
+    }
+
+    duration_add_(*packet, size() == 0);
+
+    if (list_.size() == 0 && ring_write_(packet)) {
+        return;
+    }
+
+    if (ring_size_ != 0) {
+        ring_to_list_();
+    }
+
+    list_write_(packet);
+}
+
+void SortedQueue::write_batch(const PacketPtr* packets, size_t n_packets) {
+    for (size_t n = 0; n < n_packets; n++) {
+        SortedQueue::write(packets[n]);
+    }
+}
+
+size_t SortedQueue::size() const {
+    return ring_size_ + list_.size();
+}
+
+PacketPtr SortedQueue::head() const {
+    if (ring_size_ != 0) {
+        return ring_[ring_index_(ring_head_)];
+    }
+
+    return list_.back();
+}
+
+PacketPtr SortedQueue::tail() const {
+    if (ring_size_ != 0) {
+        return ring_[ring_index_(ring_tail_)];
+    }
+
+    return list_.front();
+}
+
+PacketPtr SortedQueue::latest() const {
+    return latest_;
+}
+
+bool SortedQueue::get_latest_end(timestamp_t& end) const {
+    if (!latest_) {
+        return false;
+    }
+
+    end = latest_end_;
+    return true;
+}
+
+timestamp_t SortedQueue::duration() const {
+    if (size() == 0) {
+        return 0;
+    }
+
+    const timestamp_diff_t d = timestamp_diff(tail_end_, head_begin_);
+    if (d < 0) {
+        return 0;
+    }
+
+    return (timestamp_t)d;
+}
+
+void SortedQueue::duration_add_(const Packet& packet, bool first) {
+    // duplicates have the same begin and end, so it's fine to account
+    // the packet before it's known whether it will be dropped
+    if (first || timestamp_lt(packet.begin(), head_begin_)) {
+        head_begin_ = packet.begin();
+    }
+
+    if (first || timestamp_lt(tail_end_, packet.end())) {
+        tail_end_ = packet.end();
     }
+}
+
+void SortedQueue::duration_remove_() {
+    // only the head is ever removed, so the tail stays the same
+    if (PacketPtr packet = head()) {
+        head_begin_ = packet->begin();
+    }
+}
+
+bool SortedQueue::alloc_ring_(size_t ring_size) {
+    if (ring_size == 0 || ring_size > (size_t)seqnum_t(-1) + 1) {
+        roc_log(LogError, "sorted queue: ring size should be in range [1; %lu]: size=%lu",
+                (unsigned long)seqnum_t(-1) + 1, (unsigned long)ring_size);
+        return false;
+    }
+
+    size_t capacity = 1;
+    while (capacity < ring_size) {
+        capacity <<= 1;
+    }
+
+    ring_ = (PacketPtr*)allocator_->allocate(capacity * sizeof(PacketPtr));
+    if (!ring_) {
+        roc_log(LogError, "sorted queue: can't allocate ring: size=%lu",
+                (unsigned long)capacity);
+        return false;
+    }
+
+    for (size_t n = 0; n < capacity; n++) {
+        new (ring_ + n) PacketPtr();
+    }
+
+    ring_capacity_ = capacity;
+
+    return true;
+}
+
+size_t SortedQueue::ring_index_(seqnum_t sn) const {
+    return size_t(sn) & (ring_capacity_ - 1);
+}
 
+bool SortedQueue::ring_write_(const PacketPtr& packet) {
+    if (ring_capacity_ == 0) {
+        return false;
+    }
+
+    const RTP* rtp = packet->rtp();
+    if (!rtp) {
+        return false;
+    }
+
+    const seqnum_t sn = rtp->seqnum;
+
+    if (ring_size_ == 0) {
+        ring_head_ = sn;
+        ring_tail_ = sn;
+    } else if (seqnum_lt(sn, ring_head_)) {
+        if (seqnum_span(sn, ring_tail_) > ring_capacity_) {
+            return false;
+        }
+        ring_head_ = sn;
+    } else if (seqnum_lt(ring_tail_, sn)) {
+        if (seqnum_span(ring_head_, sn) > ring_capacity_) {
+            return false;
+        }
+        ring_tail_ = sn;
+    } else if (ring_[ring_index_(sn)]) {
+        roc_log(LogDebug, "sorted queue: dropping duplicate packet");
+        return true;
+    }
+
+    ring_[ring_index_(sn)] = packet;
+    ring_size_++;
+
+    return true;
+}
+
+PacketPtr SortedQueue::ring_read_() {
+    PacketPtr packet = ring_[ring_index_(ring_head_)];
+    roc_panic_if_not(packet);
+
+    ring_[ring_index_(ring_head_)] = NULL;
+    ring_size_--;
+
+    // the gap between head and next packet is skipped once, so reading
+    // is O(1) amortized
+    if (ring_size_ != 0) {
+        do {
+            ring_head_++;
+        } while (!ring_[ring_index_(ring_head_)]);
+    }
+
+    return packet;
+}
+
+void SortedQueue::ring_to_list_() {
+    roc_log(LogDebug,
+            "sorted queue: switching to list: size=%lu head=%lu tail=%lu",
+            (unsigned long)ring_size_, (unsigned long)ring_head_,
+            (unsigned long)ring_tail_);
+
+    while (ring_size_ != 0) {
+        list_.push_front(*ring_read_());
+    }
+}
+
+void SortedQueue::list_to_ring_() {
+    roc_log(LogDebug, "sorted queue: switching to ring: size=%lu",
+            (unsigned long)list_.size());
+
+    while (PacketPtr packet = list_.back()) {
+        list_.remove(*packet);
+
+        if (!ring_write_(packet)) {
+            roc_panic("sorted queue: can't move packet from list to ring");
+        }
+    }
+}
+
+bool SortedQueue::list_fits_ring_() const {
+    if (ring_capacity_ == 0 || list_.size() == 0 || list_non_rtp_ != 0) {
+        return false;
+    }
+
+    return seqnum_span(list_.back()->rtp()->seqnum, list_.front()->rtp()->seqnum)
+        <= ring_capacity_;
+}
+
+void SortedQueue::list_write_(const PacketPtr& packet) {
     PacketPtr pos = list_.front();
 
     for (; pos; pos = list_.nextof(*pos)) {
@@ -65,22 +335,29 @@ void SortedQueue::write(const PacketPtr& packet) {
     } else {
         list_.push_back(*packet);
     }
-}
 
-size_t SortedQueue::size() const {
-    return list_.size();
+    if (!packet->rtp()) {
+        list_non_rtp_++;
+    }
 }
 
-PacketPtr SortedQueue::head() const {
-    return list_.back();
-}
+PacketPtr SortedQueue::list_read_() {
+    PacketPtr packet = list_.back();
+    if (!packet) {
+        return NULL;
+    }
 
-PacketPtr SortedQueue::tail() const {
-    return list_.front();
-}
+    list_.remove(*packet);
 
-PacketPtr SortedQueue::latest() const {
-    return latest_;
+    if (!packet->rtp()) {
+        list_non_rtp_--;
+    }
+
+    if (list_fits_ring_()) {
+        list_to_ring_();
+    }
+
+    return packet;
 }
 
 } // namespace packet
@@ -12,11 +12,13 @@
 #ifndef ROC_PACKET_SORTED_QUEUE_H_
 #define ROC_PACKET_SORTED_QUEUE_H_
 
+#include "roc_core/iallocator.h"
 #include "roc_core/list.h"
 #include "roc_core/noncopyable.h"
 #include "roc_packet/ireader.h"
 #include "roc_packet/iwriter.h"
 #include "roc_packet/packet.h"
+#include "roc_packet/units.h"
 
 namespace roc {
 namespace packet {
@@ -24,13 +26,32 @@ namespace packet {
 //! Sorted packet queue.
 //! @remarks
 //!  Packets order is determined by Packet::compare() method.
+//!
+//!  If the queue has a ring, RTP packets are stored in it indexed by seqnum,
+//!  which gives O(1) insertion, duplicate detection and removal, as long as the
+//!  seqnums currently in the queue span no more than the ring size. Packets
+//!  without RTP header and seqnum jumps that don't fit into the ring are handled
+//!  by falling back to a sorted list until the queue contents fit into the ring
+//!  again. A queue without ring always uses the list.
 class SortedQueue : public IWriter, public IReader, public core::NonCopyable<> {
 public:
-    //! Construct empty queue.
+    //! Construct empty queue without ring.
     //! @remarks
     //!  If @p max_size is non-zero, it specifies maximum number of packets in queue.
     explicit SortedQueue(size_t max_size);
 
+    //! Construct empty queue with ring.
+    //! @remarks
+    //!  If @p max_size is non-zero, it specifies maximum number of packets in queue.
+    //!  @p ring_size is the number of seqnums covered by the ring; it's rounded
+    //!  up to a power of two and the ring is allocated using @p allocator.
+    SortedQueue(size_t max_size, size_t ring_size, core::IAllocator& allocator);
+
+    ~SortedQueue();
+
+    //! Check if the queue was successfully constructed.
+    bool valid() const;
+
     //! Add packet to the queue.
     //! @remarks
     //!  - if the maximum queue size is reached, packet is dropped
@@ -45,6 +66,11 @@ public:
     //!  Removes returned packet from the queue.
     virtual PacketPtr read();
 
+    //! Add multiple packets to the queue.
+    //! @remarks
+    //!  Same as calling write() for every packet.
+    virtual void write_batch(const PacketPtr* packets, size_t n_packets);
+
     //! Get number of packets in queue.
     size_t size() const;
 
@@ -69,10 +95,60 @@ public:
     //!  in the queue. Returned packet is not removed from the queue.
     PacketPtr latest() const;
 
+    //! Get the end of the latest packet that were ever added to the queue.
+    //! @returns
+    //!  false if the queue never had any packets.
+    //! @remarks
+    //!  Same as latest()->end(), but doesn't touch the packet.
+    bool get_latest_end(timestamp_t& end) const;
+
+    //! Get duration of the queued packets.
+    //! @remarks
+    //!  Returns the distance from the beginning of the first packet to the
+    //!  end of the last packet in the queue, in packet timestamp units, or
+    //!  zero if the queue is empty. The value is maintained incrementally
+    //!  on every write and read, so the call is O(1).
+    timestamp_t duration() const;
+
 private:
+    bool alloc_ring_(size_t ring_size);
+
+    size_t ring_index_(seqnum_t sn) const;
+
+    bool ring_write_(const PacketPtr& packet);
+    PacketPtr ring_read_();
+
+    void ring_to_list_();
+    void list_to_ring_();
+    bool list_fits_ring_() const;
+
+    void duration_add_(const Packet& packet, bool first);
+    void duration_remove_();
+
+    void list_write_(const PacketPtr& packet);
+    PacketPtr list_read_();
+
+    core::IAllocator* allocator_;
+
+    // ring capacity is a power of two, so that ring index survives seqnum wrap
+    PacketPtr* ring_;
+    size_t ring_capacity_;
+    size_t ring_size_;
+    seqnum_t ring_head_;
+    seqnum_t ring_tail_;
+
     core::List<Packet> list_;
+    size_t list_non_rtp_;
+
     PacketPtr latest_;
+    timestamp_t latest_end_;
+
+    timestamp_t head_begin_;
+    timestamp_t tail_end_;
+
     const size_t max_size_;
+
+    bool valid_;
 };
 
 } // namespace packet
@@ -13,8 +13,10 @@
 namespace roc {
 namespace packet {
 
-Address::Address() {
+Address::Address()
+    : has_miface_(false) {
     memset(&sa_, 0, sizeof(sa_));
+    memset(&miface_, 0, sizeof(miface_));
 }
 
 bool Address::valid() const {
@@ -124,6 +126,58 @@ bool Address::get_ip(char* buf, size_t bufsz) const {
     return true;
 }
 
+bool Address::set_miface(const char* ip_str) {
+    switch (family_()) {
+    case AF_INET:
+        if (inet_pton(AF_INET, ip_str, &miface_.addr4) != 1) {
+            return false;
+        }
+        break;
+
+    case AF_INET6:
+        if (inet_pton(AF_INET6, ip_str, &miface_.addr6) != 1) {
+            return false;
+        }
+        break;
+
+    default:
+        return false;
+    }
+
+    has_miface_ = true;
+
+    return true;
+}
+
+bool Address::has_miface() const {
+    return has_miface_;
+}
+
+bool Address::get_miface(char* buf, size_t bufsz) const {
+    if (!has_miface_) {
+        return false;
+    }
+
+    switch (family_()) {
+    case AF_INET:
+        if (!inet_ntop(AF_INET, &miface_.addr4, buf, (socklen_t)bufsz)) {
+            return false;
+        }
+        break;
+
+    case AF_INET6:
+        if (!inet_ntop(AF_INET6, &miface_.addr6, buf, (socklen_t)bufsz)) {
+            return false;
+        }
+        break;
+
+    default:
+        return false;
+    }
+
+    return true;
+}
+
 bool Address::operator==(const Address& other) const {
     if (family_() != other.family_()) {
         return false;
@@ -59,7 +59,22 @@ public:
     //! Get IP address.
     bool get_ip(char* buf, size_t bufsz) const;
 
+    //! Set multicast interface address.
+    //! @remarks
+    //!  Selects the local interface used to join the multicast group. @p ip
+    //!  should have the same IP version as the address itself. Should be
+    //!  called after setting the address.
+    bool set_miface(const char* ip);
+
+    //! Check whether multicast interface address is set.
+    bool has_miface() const;
+
+    //! Get multicast interface address.
+    bool get_miface(char* buf, size_t bufsz) const;
+
     //! Compare addresses.
+    //! @remarks
+    //!  Multicast interface is not taken into account.
     bool operator==(const Address& other) const;
 
     //! Compare addresses.
@@ -74,6 +89,13 @@ private:
         sockaddr_in addr4;
         sockaddr_in6 addr6;
     } sa_;
+
+    union {
+        in_addr addr4;
+        in6_addr addr6;
+    } miface_;
+
+    bool has_miface_;
 };
 
 } // namespace packet
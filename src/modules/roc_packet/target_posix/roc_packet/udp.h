@@ -6,16 +6,15 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
-//! @file roc_packet/target_libuv/roc_packet/udp.h
+//! @file roc_packet/target_posix/roc_packet/udp.h
 //! @brief UDP packet.
 
 #ifndef ROC_PACKET_UDP_H_
 #define ROC_PACKET_UDP_H_
 
-#include <uv.h>
-
 #include "roc_core/slice.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 #include "roc_packet/address.h"
 
 namespace roc {
@@ -29,8 +28,16 @@ struct UDP {
     //! Destination address.
     Address dst_addr;
 
-    //! Sender request state.
-    uv_udp_send_t request;
+    //! Time when the packet should be sent.
+    //! @remarks
+    //!  Monotonic time of the clock used by the sender pipeline, which is
+    //!  also passed to the transceiver sending the packet. Zero means that
+    //!  the packet should be sent as soon as possible.
+    core::nanoseconds_t send_time;
+
+    UDP()
+        : send_time(0) {
+    }
 };
 
 } // namespace packet
@@ -15,7 +15,9 @@
 #include "roc_audio/latency_monitor.h"
 #include "roc_audio/resampler.h"
 #include "roc_audio/watchdog.h"
+#include "roc_core/iclock.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/system_clock.h"
 #include "roc_core/time.h"
 #include "roc_fec/codec_config.h"
 #include "roc_fec/reader.h"
@@ -40,9 +42,21 @@ const core::nanoseconds_t DefaultPacketLength = 7 * core::Millisecond;
 //! Default latency.
 const core::nanoseconds_t DefaultLatency = 200 * core::Millisecond;
 
+//! Default number of seqnums covered by receiver packet queue ring.
+const size_t DefaultQueueRingSize = 256;
+
+//! Default interval between RTCP reports.
+const core::nanoseconds_t DefaultRtcpInterval = core::Second;
+
 //! Default internal frame size.
 const size_t DefaultInternalFrameSize = 640;
 
+//! Default size of buffer between pipeline thread and reader.
+const size_t DefaultThreadBufferSize = DefaultInternalFrameSize * 4;
+
+//! Default duration of input chunk for parallel conversion.
+const core::nanoseconds_t DefaultChunkDuration = 5 * core::Second;
+
 //! Default minum latency relative to target latency.
 const int DefaultMinLatencyFactor = -1;
 
@@ -91,28 +105,81 @@ struct SenderConfig {
     //! RTP payload type for audio packets.
     rtp::PayloadType payload_type;
 
+    //! Interval between RTCP sender reports, in nanoseconds of stream time.
+    //! @remarks
+    //!  Reports are sent only if control port is configured.
+    core::nanoseconds_t rtcp_interval;
+
     //! Resample frames with a constant ratio.
     bool resampling;
 
     //! Interleave packets.
+    //! @remarks
+    //!  Packets are interleaved only if FEC is enabled.
     bool interleaving;
 
+    //! Maximum delay added by interleaving, in packets.
+    //! @remarks
+    //!  If zero, packets are shuffled within FEC blocks, which adds up to a
+    //!  whole block of delay. Otherwise, convolutional interleaver is used,
+    //!  which spreads bursts across blocks with a bounded delay. Receiver
+    //!  target latency should be large enough to cover this delay.
+    size_t interleaving_delay;
+
     //! Constrain receiver speed using a CPU timer according to the sample rate.
     bool timing;
 
+    //! Busy-wait interval before each timing deadline, in nanoseconds.
+    //! @remarks
+    //!  If non-zero, the timer sleeps until this interval before the deadline
+    //!  and then spins, which reduces wakeup jitter at the cost of CPU time.
+    core::nanoseconds_t timing_spin_margin;
+
+    //! Spread packets evenly over time.
+    //! @remarks
+    //!  If enabled, source and repair packets get send times spaced evenly, so
+    //!  that repair packets are not sent in a burst at the end of FEC block.
+    //!  The network writer is responsible for respecting send times.
+    bool pacing;
+
     //! Fill unitialized data with large values to make them more noticable.
     bool poisoning;
 
+    //! Process frames in a dedicated pipeline thread.
+    //! @remarks
+    //!  If set, writing only copies samples to a ring buffer, and resampling,
+    //!  encoding, FEC and sending are performed by the pipeline thread.
+    bool threading;
+
+    //! Number of samples in the ring buffer used when threading is enabled.
+    //! @remarks
+    //!  Writing blocks only when the ring buffer is full. Should be not less
+    //!  than internal_frame_size.
+    size_t thread_buffer_size;
+
+    //! Clock used for timing and timestamps.
+    //! @remarks
+    //!  System clock by default. May be replaced with a virtual clock to run
+    //!  the pipeline in simulation.
+    core::IClock* clock;
+
     SenderConfig()
         : input_sample_rate(DefaultSampleRate)
         , input_channels(DefaultChannelMask)
         , internal_frame_size(DefaultInternalFrameSize)
         , packet_length(DefaultPacketLength)
         , payload_type(rtp::PayloadType_L16_Stereo)
+        , rtcp_interval(DefaultRtcpInterval)
         , resampling(false)
         , interleaving(false)
+        , interleaving_delay(0)
         , timing(false)
-        , poisoning(false) {
+        , timing_spin_margin(0)
+        , pacing(false)
+        , poisoning(false)
+        , threading(false)
+        , thread_buffer_size(DefaultThreadBufferSize)
+        , clock(&core::SystemClock::instance()) {
     }
 };
 
@@ -129,12 +196,32 @@ struct ReceiverSessionConfig {
     //! Packet payload type.
     unsigned int payload_type;
 
+    //! Number of seqnums covered by the source packet queue rings.
+    //! @remarks
+    //!  Used by the session queue, the delayed reader, and the FEC reader.
+    //!  Reordered and duplicate packets are handled in O(1) while queued
+    //!  packets span no more seqnums than this; otherwise the queue falls
+    //!  back to a sorted list. Should cover the maximum latency.
+    size_t queue_ring_size;
+
+    //! Interval between RTCP receiver reports, in nanoseconds.
+    //! @remarks
+    //!  Reports are sent only if control writer is set.
+    core::nanoseconds_t rtcp_interval;
+
     //! FEC reader parameters.
     fec::ReaderConfig fec_reader;
 
     //! FEC decoder parameters.
     fec::CodecConfig fec_decoder;
 
+    //! Number of threads repairing FEC blocks ahead of time.
+    //! @remarks
+    //!  If zero, blocks are repaired in the pipeline thread when they are read.
+    //!  Otherwise, every session starts its own repair threads, each with its
+    //!  own decoder. Not used for sliding window schemes.
+    size_t fec_repair_threads;
+
     //! RTP validator parameters.
     rtp::ValidatorConfig rtp_validator;
 
@@ -150,7 +237,10 @@ struct ReceiverSessionConfig {
     ReceiverSessionConfig()
         : target_latency(DefaultLatency)
         , channels(DefaultChannelMask)
-        , payload_type(0) {
+        , payload_type(0)
+        , queue_ring_size(DefaultQueueRingSize)
+        , rtcp_interval(DefaultRtcpInterval)
+        , fec_repair_threads(0) {
         latency_monitor.min_latency = target_latency * DefaultMinLatencyFactor;
         latency_monitor.max_latency = target_latency * DefaultMaxLatencyFactor;
     }
@@ -175,20 +265,56 @@ struct ReceiverCommonConfig {
     //! Constrain receiver speed using a CPU timer according to the sample rate.
     bool timing;
 
+    //! Busy-wait interval before each timing deadline, in nanoseconds.
+    //! @remarks
+    //!  If non-zero, the timer sleeps until this interval before the deadline
+    //!  and then spins, which reduces wakeup jitter at the cost of CPU time.
+    core::nanoseconds_t timing_spin_margin;
+
     //! Fill uninitialized data with large values to make them more noticeable.
     bool poisoning;
 
     //! Insert weird beeps instead of silence on packet loss.
     bool beeping;
 
+    //! Maximum number of sessions.
+    //! @remarks
+    //!  Packets from new senders are dropped when the limit is reached.
+    //!  Zero means no limit.
+    size_t max_sessions;
+
+    //! Process packets in a dedicated pipeline thread.
+    //! @remarks
+    //!  If set, the pipeline thread routes packets, updates sessions and
+    //!  mixes them ahead of time into a ring buffer, and reading only copies
+    //!  samples from the ring buffer.
+    bool threading;
+
+    //! Number of samples in the ring buffer used when threading is enabled.
+    //! @remarks
+    //!  Adds the corresponding latency. Should be not less than
+    //!  internal_frame_size.
+    size_t thread_buffer_size;
+
+    //! Clock used for timing and timestamps.
+    //! @remarks
+    //!  System clock by default. May be replaced with a virtual clock to run
+    //!  the pipeline in simulation.
+    core::IClock* clock;
+
     ReceiverCommonConfig()
         : output_sample_rate(DefaultSampleRate)
         , output_channels(DefaultChannelMask)
         , internal_frame_size(DefaultInternalFrameSize)
         , resampling(false)
         , timing(false)
+        , timing_spin_margin(0)
         , poisoning(false)
-        , beeping(false) {
+        , beeping(false)
+        , max_sessions(0)
+        , threading(false)
+        , thread_buffer_size(DefaultThreadBufferSize)
+        , clock(&core::SystemClock::instance()) {
     }
 };
 
@@ -227,6 +353,17 @@ struct ConverterConfig {
     //! Fill unitialized data with large values to make them more noticable.
     bool poisoning;
 
+    //! Number of worker threads.
+    //! @remarks
+    //!  Used by ParallelConverter.
+    size_t num_threads;
+
+    //! Number of input samples per channel in a chunk.
+    //! @remarks
+    //!  Used by ParallelConverter. Rounded up so that every chunk starts at the
+    //!  same resampler phase. Zero selects DefaultChunkDuration.
+    size_t chunk_size;
+
     ConverterConfig()
         : input_sample_rate(DefaultSampleRate)
         , output_sample_rate(DefaultSampleRate)
@@ -234,7 +371,9 @@ struct ConverterConfig {
         , output_channels(DefaultChannelMask)
         , internal_frame_size(DefaultInternalFrameSize)
         , resampling(false)
-        , poisoning(false) {
+        , poisoning(false)
+        , num_threads(1)
+        , chunk_size(0) {
     }
 };
 
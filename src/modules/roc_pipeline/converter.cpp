@@ -34,7 +34,7 @@ Converter::Converter(const ConverterConfig& config,
             awriter = resampler_poisoner_.get();
         }
         resampler_.reset(new (allocator) audio::ResamplerWriter(
-                             *awriter, pool, allocator, config.resampler,
+                             *awriter, pool, config.resampler,
                              config.output_channels, config.internal_frame_size),
                          allocator);
         if (!resampler_ || !resampler_->valid()) {
@@ -79,6 +79,10 @@ bool Converter::has_clock() const {
     return false;
 }
 
+core::nanoseconds_t Converter::latency() const {
+    return 0;
+}
+
 void Converter::write(audio::Frame& frame) {
     roc_panic_if(!valid());
 
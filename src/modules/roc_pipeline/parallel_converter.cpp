@@ -0,0 +1,508 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_pipeline/parallel_converter.h"
+#include "roc_audio/resampler_writer.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+size_t gcd(size_t a, size_t b) {
+    while (b != 0) {
+        const size_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+} // namespace
+
+ParallelConverter::ParallelConverter(const ConverterConfig& config,
+                                     audio::IWriter* output_writer,
+                                     core::BufferPool<audio::sample_t>& pool,
+                                     core::IAllocator& allocator)
+    : config_(config)
+    , pool_(pool)
+    , allocator_(allocator)
+    , output_writer_(output_writer ? output_writer : &null_writer_)
+    , splitter_(*this)
+    , audio_writer_(NULL)
+    , num_ch_(packet::num_channels(config.output_channels))
+    , chunk_size_(0)
+    , chunk_head_(0)
+    , chunk_tail_(0)
+    , chunks_(allocator)
+    , workers_(allocator)
+    , submit_cond_(mutex_)
+    , done_cond_(mutex_)
+    , n_submitted_(0)
+    , n_taken_(0)
+    , n_written_(0)
+    , stop_(false)
+    , valid_(false) {
+    if (config.num_threads == 0) {
+        roc_log(LogError, "parallel converter: num_threads should be > 0");
+        return;
+    }
+
+    if (num_ch_ == 0 || config.internal_frame_size % num_ch_ != 0) {
+        roc_log(LogError,
+                "parallel converter: frame size is not multiple of num_channels:"
+                " frame_size=%lu num_channels=%lu",
+                (unsigned long)config.internal_frame_size, (unsigned long)num_ch_);
+        return;
+    }
+
+    if (config.input_sample_rate == 0 || config.output_sample_rate == 0) {
+        roc_log(LogError, "parallel converter: sample rate is zero");
+        return;
+    }
+
+    size_t chunk_align = 1;
+
+    if (config.resampling) {
+        if (!check_resampler_()) {
+            return;
+        }
+
+        // Resampler uses the first frame only as history and produces samples
+        // for the last frame only when the next one arrives.
+        chunk_head_ = config.internal_frame_size / num_ch_;
+        chunk_tail_ = config.internal_frame_size / num_ch_;
+
+        // Input and output sample positions coincide every chunk_align samples.
+        chunk_align = config.input_sample_rate
+            / gcd(config.input_sample_rate, config.output_sample_rate);
+    }
+
+    chunk_size_ = config.chunk_size;
+    if (chunk_size_ == 0) {
+        chunk_size_ =
+            size_t(config.input_sample_rate * DefaultChunkDuration / core::Second);
+    }
+    chunk_size_ = (chunk_size_ + chunk_align - 1) / chunk_align * chunk_align;
+
+    if (!init_chunks_()) {
+        return;
+    }
+
+    profiler_.reset(new (allocator) audio::ProfilingWriter(
+                        splitter_, config.input_channels, config.input_sample_rate),
+                    allocator);
+    if (!profiler_) {
+        return;
+    }
+    audio::IWriter* awriter = profiler_.get();
+
+    if (config.poisoning) {
+        pipeline_poisoner_.reset(new (allocator) audio::PoisonWriter(*awriter),
+                                 allocator);
+        if (!pipeline_poisoner_) {
+            return;
+        }
+        awriter = pipeline_poisoner_.get();
+    }
+
+    if (!init_workers_()) {
+        return;
+    }
+
+    roc_log(LogDebug,
+            "parallel converter: initialized: num_threads=%lu chunk_size=%lu"
+            " chunk_overlap=%lu",
+            (unsigned long)workers_.size(), (unsigned long)chunk_size_,
+            (unsigned long)(chunk_head_ + chunk_tail_));
+
+    audio_writer_ = awriter;
+    valid_ = true;
+}
+
+ParallelConverter::~ParallelConverter() {
+    stop_workers_();
+
+    for (size_t n = 0; n < workers_.size(); n++) {
+        allocator_.destroy(*workers_[n]);
+    }
+
+    for (size_t n = 0; n < chunks_.size(); n++) {
+        allocator_.destroy(*chunks_[n]);
+    }
+}
+
+bool ParallelConverter::valid() {
+    return valid_;
+}
+
+size_t ParallelConverter::sample_rate() const {
+    return config_.output_sample_rate;
+}
+
+bool ParallelConverter::has_clock() const {
+    return false;
+}
+
+core::nanoseconds_t ParallelConverter::latency() const {
+    return 0;
+}
+
+void ParallelConverter::write(audio::Frame& frame) {
+    roc_panic_if(!valid());
+
+    audio_writer_->write(frame);
+}
+
+void ParallelConverter::flush() {
+    roc_panic_if(!valid());
+
+    Chunk& chunk = *chunks_[n_submitted_ % chunks_.size()];
+
+    const size_t input_size = chunk.input.size() / num_ch_;
+
+    if (input_size > chunk_head_) {
+        submit_(output_size_(input_size - chunk_head_));
+    }
+
+    while (n_written_ != n_submitted_) {
+        write_oldest_();
+    }
+
+    if (!chunks_[n_submitted_ % chunks_.size()]->input.resize(0)) {
+        roc_panic("parallel converter: can't reset chunk");
+    }
+}
+
+bool ParallelConverter::init_chunks_() {
+    const size_t num_chunks = config_.num_threads * 2;
+
+    if (!chunks_.grow(num_chunks)) {
+        roc_log(LogError, "parallel converter: can't allocate chunks");
+        return false;
+    }
+
+    const size_t input_size = (chunk_head_ + chunk_size_ + chunk_tail_) * num_ch_;
+    const size_t output_size = output_size_(chunk_size_ + chunk_tail_);
+
+    for (size_t n = 0; n < num_chunks; n++) {
+        Chunk* chunk = new (allocator_) Chunk(allocator_);
+        if (!chunk) {
+            roc_log(LogError, "parallel converter: can't allocate chunk");
+            return false;
+        }
+
+        chunks_.push_back(chunk);
+
+        if (!chunk->input.grow(input_size) || !chunk->output.grow(output_size)) {
+            roc_log(LogError, "parallel converter: can't allocate chunk buffers");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ParallelConverter::init_workers_() {
+    if (!workers_.grow(config_.num_threads)) {
+        roc_log(LogError, "parallel converter: can't allocate workers");
+        return false;
+    }
+
+    core::ThreadAttributes attrs;
+    attrs.name = "roc-converter";
+
+    for (size_t n = 0; n < config_.num_threads; n++) {
+        Worker* worker = new (allocator_) Worker(*this);
+        if (!worker) {
+            roc_log(LogError, "parallel converter: can't allocate worker");
+            return false;
+        }
+
+        workers_.push_back(worker);
+
+        if (!worker->valid()) {
+            return false;
+        }
+
+        worker->set_attributes(attrs);
+
+        if (!worker->start()) {
+            roc_log(LogError, "parallel converter: can't start worker thread");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ParallelConverter::check_resampler_() {
+    audio::ResamplerWriter resampler(null_writer_, pool_, config_.resampler,
+                                     config_.output_channels,
+                                     config_.internal_frame_size);
+    if (!resampler.valid()) {
+        return false;
+    }
+
+    if (!resampler.set_scaling(float(config_.input_sample_rate)
+                               / config_.output_sample_rate)) {
+        return false;
+    }
+
+    return true;
+}
+
+void ParallelConverter::stop_workers_() {
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        stop_ = true;
+        submit_cond_.broadcast();
+    }
+
+    for (size_t n = 0; n < workers_.size(); n++) {
+        workers_[n]->join();
+    }
+}
+
+size_t ParallelConverter::output_size_(size_t n_samples) const {
+    if (!config_.resampling) {
+        return n_samples * num_ch_;
+    }
+
+    const uint64_t n_out_samples =
+        ((uint64_t)n_samples * config_.output_sample_rate + config_.input_sample_rate
+         - 1)
+        / config_.input_sample_rate;
+
+    return size_t(n_out_samples) * num_ch_;
+}
+
+void ParallelConverter::split_(audio::Frame& frame) {
+    const size_t chunk_input_size = (chunk_head_ + chunk_size_ + chunk_tail_) * num_ch_;
+
+    const audio::sample_t* data = frame.data();
+    size_t size = frame.size();
+
+    while (size != 0) {
+        Chunk& chunk = *chunks_[n_submitted_ % chunks_.size()];
+
+        const size_t pos = chunk.input.size();
+        const size_t n = std::min(size, chunk_input_size - pos);
+
+        if (!chunk.input.resize(pos + n)) {
+            roc_panic("parallel converter: can't resize chunk");
+        }
+        memcpy(&chunk.input[pos], data, n * sizeof(audio::sample_t));
+
+        data += n;
+        size -= n;
+
+        if (chunk.input.size() == chunk_input_size) {
+            submit_(output_size_(chunk_size_));
+            acquire_();
+        }
+    }
+}
+
+void ParallelConverter::submit_(size_t output_size) {
+    Chunk& chunk = *chunks_[n_submitted_ % chunks_.size()];
+
+    chunk.output_size = output_size;
+    chunk.done = false;
+
+    core::Mutex::Lock lock(mutex_);
+
+    n_submitted_++;
+    submit_cond_.broadcast();
+}
+
+void ParallelConverter::acquire_() {
+    while (n_submitted_ - n_written_ >= chunks_.size()) {
+        write_oldest_();
+    }
+
+    const Chunk& prev = *chunks_[(n_submitted_ - 1) % chunks_.size()];
+    Chunk& chunk = *chunks_[n_submitted_ % chunks_.size()];
+
+    // Next chunk starts chunk_size_ samples after the previous one, so its
+    // head and tail are the last samples of the previous chunk.
+    const size_t overlap = (chunk_head_ + chunk_tail_) * num_ch_;
+
+    if (!chunk.input.resize(overlap)) {
+        roc_panic("parallel converter: can't resize chunk");
+    }
+
+    if (overlap != 0) {
+        memcpy(&chunk.input[0], &prev.input[prev.input.size() - overlap],
+               overlap * sizeof(audio::sample_t));
+    }
+}
+
+void ParallelConverter::write_oldest_() {
+    Chunk& chunk = *chunks_[n_written_ % chunks_.size()];
+
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        while (!chunk.done) {
+            done_cond_.wait();
+        }
+    }
+
+    const size_t frame_size = config_.internal_frame_size;
+
+    for (size_t pos = 0; pos < chunk.output.size(); pos += frame_size) {
+        audio::Frame frame(&chunk.output[pos],
+                           std::min(frame_size, chunk.output.size() - pos));
+        output_writer_->write(frame);
+    }
+
+    n_written_++;
+}
+
+ParallelConverter::Chunk* ParallelConverter::take_() {
+    core::Mutex::Lock lock(mutex_);
+
+    while (n_taken_ == n_submitted_ && !stop_) {
+        submit_cond_.wait();
+    }
+
+    if (stop_) {
+        return NULL;
+    }
+
+    return chunks_[n_taken_++ % chunks_.size()];
+}
+
+void ParallelConverter::finish_(Chunk& chunk) {
+    core::Mutex::Lock lock(mutex_);
+
+    chunk.done = true;
+    done_cond_.broadcast();
+}
+
+ParallelConverter::Splitter::Splitter(ParallelConverter& converter)
+    : converter_(converter) {
+}
+
+void ParallelConverter::Splitter::write(audio::Frame& frame) {
+    converter_.split_(frame);
+}
+
+ParallelConverter::Worker::Worker(ParallelConverter& converter)
+    : converter_(converter)
+    , chunk_(NULL) {
+    zeros_ = new (converter.pool_) core::Buffer<audio::sample_t>(converter.pool_);
+
+    if (!zeros_) {
+        roc_log(LogError, "parallel converter: can't allocate buffer");
+        return;
+    }
+
+    zeros_.resize(converter.config_.internal_frame_size);
+    memset(zeros_.data(), 0, zeros_.size() * sizeof(audio::sample_t));
+}
+
+ParallelConverter::Worker::~Worker() {
+}
+
+bool ParallelConverter::Worker::valid() const {
+    return zeros_;
+}
+
+void ParallelConverter::Worker::write(audio::Frame& frame) {
+    Chunk& chunk = *chunk_;
+
+    const size_t pos = chunk.output.size();
+    const size_t n = std::min(frame.size(), chunk.output_size - pos);
+
+    if (n == 0) {
+        return;
+    }
+
+    if (!chunk.output.resize(pos + n)) {
+        roc_panic("parallel converter: can't resize chunk");
+    }
+    memcpy(&chunk.output[pos], frame.data(), n * sizeof(audio::sample_t));
+}
+
+void ParallelConverter::Worker::run() {
+    while (Chunk* chunk = converter_.take_()) {
+        if (!convert_(*chunk)) {
+            roc_log(LogError,
+                    "parallel converter: can't convert chunk, filling with zeros");
+        }
+
+        if (!chunk->output.resize(chunk->output_size)) {
+            roc_panic("parallel converter: can't resize chunk");
+        }
+
+        converter_.finish_(*chunk);
+    }
+}
+
+bool ParallelConverter::Worker::convert_(Chunk& chunk) {
+    const ConverterConfig& config = converter_.config_;
+
+    chunk_ = &chunk;
+
+    if (!chunk.output.resize(0)) {
+        roc_panic("parallel converter: can't resize chunk");
+    }
+
+    audio::IWriter* awriter = this;
+
+    core::UniquePtr<audio::PoisonWriter> poisoner;
+    core::UniquePtr<audio::ResamplerWriter> resampler;
+
+    if (config.resampling) {
+        if (config.poisoning) {
+            poisoner.reset(new (converter_.allocator_) audio::PoisonWriter(*awriter),
+                           converter_.allocator_);
+            if (!poisoner) {
+                return false;
+            }
+            awriter = poisoner.get();
+        }
+        resampler.reset(new (converter_.allocator_) audio::ResamplerWriter(
+                            *awriter, converter_.pool_, config.resampler,
+                            config.output_channels, config.internal_frame_size),
+                        converter_.allocator_);
+        if (!resampler || !resampler->valid()) {
+            return false;
+        }
+        if (!resampler->set_scaling(float(config.input_sample_rate)
+                                    / config.output_sample_rate)) {
+            return false;
+        }
+        awriter = resampler.get();
+    }
+
+    const size_t frame_size = config.internal_frame_size;
+
+    for (size_t pos = 0; pos < chunk.input.size(); pos += frame_size) {
+        audio::Frame frame(&chunk.input[pos],
+                           std::min(frame_size, chunk.input.size() - pos));
+        awriter->write(frame);
+    }
+
+    // Push the rest of the chunk out of the resampler.
+    while (chunk.output.size() < chunk.output_size) {
+        audio::Frame frame(zeros_.data(), zeros_.size());
+        awriter->write(frame);
+    }
+
+    return true;
+}
+
+} // namespace pipeline
+} // namespace roc
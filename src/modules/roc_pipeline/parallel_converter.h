@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/parallel_converter.h
+//! @brief Parallel converter pipeline.
+
+#ifndef ROC_PIPELINE_PARALLEL_CONVERTER_H_
+#define ROC_PIPELINE_PARALLEL_CONVERTER_H_
+
+#include "roc_audio/null_writer.h"
+#include "roc_audio/poison_writer.h"
+#include "roc_audio/profiling_writer.h"
+#include "roc_core/array.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/cond.h"
+#include "roc_core/mutex.h"
+#include "roc_core/thread.h"
+#include "roc_core/unique_ptr.h"
+#include "roc_pipeline/config.h"
+#include "roc_sndio/isink.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Parallel converter pipeline.
+//! @remarks
+//!  Splits input stream into chunks, converts chunks concurrently on a pool of
+//!  worker threads, and writes converted chunks to the output writer in order.
+//!
+//!  Every chunk is resampled by its own resampler. To make chunk boundaries
+//!  seamless, neighbour chunks overlap by the resampler window: every chunk
+//!  additionally includes one internal frame before its first sample and one
+//!  internal frame after its last sample, and the chunk length is aligned so
+//!  that every chunk starts at the same output sample phase. As a result, the
+//!  output is the same as the output of Converter, up to the accumulated
+//!  rounding error of the resampler position.
+class ParallelConverter : public sndio::ISink, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  Starts config.num_threads worker threads.
+    ParallelConverter(const ConverterConfig& config,
+                      audio::IWriter* output_writer,
+                      core::BufferPool<audio::sample_t>& pool,
+                      core::IAllocator& allocator);
+
+    //! Stop worker threads.
+    //! @remarks
+    //!  Chunks which were not flushed are discarded.
+    ~ParallelConverter();
+
+    //! Check if the pipeline was successfully constructed.
+    bool valid();
+
+    //! Get sink sample rate.
+    virtual size_t sample_rate() const;
+
+    //! Check if the sink has own clock.
+    virtual bool has_clock() const;
+
+    //! Get playback latency of the sink.
+    virtual core::nanoseconds_t latency() const;
+
+    //! Write audio frame.
+    //! @remarks
+    //!  Appends samples to the current chunk. When the chunk becomes full, passes
+    //!  it to worker threads. If too many chunks are in flight, blocks until the
+    //!  oldest one is converted and written to the output writer.
+    virtual void write(audio::Frame& frame);
+
+    //! Flush remaining samples.
+    //! @remarks
+    //!  Converts the last incomplete chunk and blocks until all chunks are
+    //!  written to the output writer. Unlike Converter, the tail of the stream
+    //!  is resampled too. Should be called after the last write().
+    void flush();
+
+private:
+    struct Chunk {
+        core::Array<audio::sample_t> input;
+        core::Array<audio::sample_t> output;
+
+        size_t output_size;
+        bool done;
+
+        Chunk(core::IAllocator& allocator)
+            : input(allocator)
+            , output(allocator)
+            , output_size(0)
+            , done(false) {
+        }
+    };
+
+    class Splitter : public audio::IWriter {
+    public:
+        Splitter(ParallelConverter& converter);
+
+        virtual void write(audio::Frame& frame);
+
+    private:
+        ParallelConverter& converter_;
+    };
+
+    class Worker : public core::Thread, public audio::IWriter {
+    public:
+        Worker(ParallelConverter& converter);
+        ~Worker();
+
+        bool valid() const;
+
+        virtual void write(audio::Frame& frame);
+
+    private:
+        virtual void run();
+
+        bool convert_(Chunk& chunk);
+
+        ParallelConverter& converter_;
+
+        core::Slice<audio::sample_t> zeros_;
+
+        Chunk* chunk_;
+    };
+
+    friend class Splitter;
+    friend class Worker;
+
+    bool init_chunks_();
+    bool init_workers_();
+    bool check_resampler_();
+
+    void stop_workers_();
+
+    size_t output_size_(size_t n_samples) const;
+
+    void split_(audio::Frame& frame);
+    void submit_(size_t output_size);
+    void acquire_();
+    void write_oldest_();
+
+    Chunk* take_();
+    void finish_(Chunk& chunk);
+
+    const ConverterConfig config_;
+
+    core::BufferPool<audio::sample_t>& pool_;
+    core::IAllocator& allocator_;
+
+    audio::NullWriter null_writer_;
+    audio::IWriter* output_writer_;
+
+    Splitter splitter_;
+
+    core::UniquePtr<audio::ProfilingWriter> profiler_;
+    core::UniquePtr<audio::PoisonWriter> pipeline_poisoner_;
+
+    audio::IWriter* audio_writer_;
+
+    size_t num_ch_;
+
+    // Chunk sizes, in samples per channel.
+    size_t chunk_size_;
+    size_t chunk_head_;
+    size_t chunk_tail_;
+
+    core::Array<Chunk*> chunks_;
+    core::Array<Worker*> workers_;
+
+    core::Mutex mutex_;
+    core::Cond submit_cond_;
+    core::Cond done_cond_;
+
+    size_t n_submitted_;
+    size_t n_taken_;
+    size_t n_written_;
+
+    bool stop_;
+    bool valid_;
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_PARALLEL_CONVERTER_H_
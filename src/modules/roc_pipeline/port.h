@@ -21,7 +21,10 @@ enum PortType {
     Port_AudioSource,
 
     //! Audio repair packets.
-    Port_AudioRepair
+    Port_AudioRepair,
+
+    //! Audio control packets.
+    Port_AudioControl
 };
 
 //! Port protocol.
@@ -42,7 +45,16 @@ enum PortProtocol {
     Proto_RTP_LDPC_Source,
 
     //! FEC repair packet + FECFRAME LDPC header.
-    Proto_LDPC_Repair
+    Proto_LDPC_Repair,
+
+    //! RTP source packet + sliding window RLC footer.
+    Proto_RTP_RLC_Source,
+
+    //! FEC repair packet + sliding window RLC header.
+    Proto_RLC_Repair,
+
+    //! RTCP control packet.
+    Proto_RTCP
 };
 
 } // namespace pipeline
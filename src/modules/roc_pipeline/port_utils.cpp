@@ -33,6 +33,15 @@ packet::FECScheme port_fec_scheme(PortProtocol proto) {
 
     case Proto_LDPC_Repair:
         return packet::FEC_LDPC_Staircase;
+
+    case Proto_RTP_RLC_Source:
+        return packet::FEC_RLC;
+
+    case Proto_RLC_Repair:
+        return packet::FEC_RLC;
+
+    case Proto_RTCP:
+        return packet::FEC_None;
     }
 
     return packet::FEC_None;
@@ -41,6 +50,18 @@ packet::FECScheme port_fec_scheme(PortProtocol proto) {
 bool validate_port(packet::FECScheme fec_scheme,
                    PortProtocol port_protocol,
                    PortType port_type) {
+    if ((port_type == Port_AudioControl) != (port_protocol == Proto_RTCP)) {
+        roc_log(LogError,
+                "bad ports configuration:"
+                " %s port can't use protocol '%s'",
+                port_type_to_str(port_type), port_proto_to_str(port_protocol));
+        return false;
+    }
+
+    if (port_type == Port_AudioControl) {
+        return true;
+    }
+
     const packet::FECScheme port_scheme = port_fec_scheme(port_protocol);
 
     if (port_scheme != fec_scheme) {
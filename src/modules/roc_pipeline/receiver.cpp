@@ -10,7 +10,9 @@
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/shared_ptr.h"
+#include "roc_core/stddefs.h"
 #include "roc_packet/address_to_str.h"
+#include "roc_packet/units.h"
 #include "roc_pipeline/port_to_str.h"
 
 namespace roc {
@@ -29,11 +31,17 @@ Receiver::Receiver(const ReceiverConfig& config,
     , byte_buffer_pool_(byte_buffer_pool)
     , sample_buffer_pool_(sample_buffer_pool)
     , allocator_(allocator)
-    , ticker_(config.common.output_sample_rate)
+    , control_writer_(NULL)
+    , ticker_(config.common.output_sample_rate,
+              config.common.timing_spin_margin,
+              *config.common.clock)
     , audio_reader_(NULL)
+    , thread_buff_(allocator)
     , config_(config)
     , timestamp_(0)
+    , read_timestamp_(0)
     , num_channels_(packet::num_channels(config.common.output_channels))
+    , valid_(false)
     , active_cond_(control_mutex_) {
     mixer_.reset(new (allocator_)
                      audio::Mixer(sample_buffer_pool, config.common.internal_frame_size),
@@ -52,16 +60,34 @@ Receiver::Receiver(const ReceiverConfig& config,
     }
 
     audio_reader_ = areader;
+
+    if (config.common.threading) {
+        if (!start_thread_()) {
+            return;
+        }
+    }
+
+    valid_ = true;
+}
+
+Receiver::~Receiver() {
+    if (joinable()) {
+        thread_stop_ = true;
+        thread_sem_.post();
+        join();
+    }
+
+    ticker_.wakeup_errors().log(LogDebug, "receiver: timer wakeup errors");
 }
 
 bool Receiver::valid() {
-    return audio_reader_;
+    return valid_;
 }
 
 bool Receiver::add_port(const PortConfig& config) {
     roc_log(LogInfo, "receiver: adding port %s", port_to_str(config).c_str());
 
-    core::Mutex::Lock lock(control_mutex_);
+    core::Mutex::Lock lock(ports_mutex_);
 
     core::SharedPtr<ReceiverPort> port =
         new (allocator_) ReceiverPort(config, format_map_, allocator_);
@@ -76,7 +102,7 @@ bool Receiver::add_port(const PortConfig& config) {
 }
 
 void Receiver::iterate_ports(void (*fn)(void*, const PortConfig&), void* arg) const {
-    core::Mutex::Lock lock(control_mutex_);
+    core::Mutex::Lock lock(ports_mutex_);
 
     core::SharedPtr<ReceiverPort> port;
 
@@ -85,6 +111,25 @@ void Receiver::iterate_ports(void (*fn)(void*, const PortConfig&), void* arg) co
     }
 }
 
+void Receiver::set_control_writer(packet::IWriter& writer) {
+    core::Mutex::Lock lock(control_mutex_);
+
+    control_writer_ = &writer;
+}
+
+void Receiver::iterate_sessions(void (*fn)(void*,
+                                           const packet::Address&,
+                                           const rtcp::ReceiverStats&),
+                                void* arg) const {
+    core::Mutex::Lock lock(control_mutex_);
+
+    core::SharedPtr<ReceiverSession> sess;
+
+    for (sess = sessions_.front(); sess; sess = sessions_.nextof(*sess)) {
+        fn(arg, sess->address(), sess->rtcp_stats());
+    }
+}
+
 size_t Receiver::num_sessions() const {
     core::Mutex::Lock lock(control_mutex_);
 
@@ -114,30 +159,198 @@ void Receiver::wait_active() const {
 }
 
 void Receiver::write(const packet::PacketPtr& packet) {
-    core::Mutex::Lock lock(control_mutex_);
+    write_batch(&packet, 1);
+}
 
-    const State old_state = state_();
+void Receiver::write_batch(const packet::PacketPtr* packets, size_t n_packets) {
+    // removed sessions are moved here and destroyed after the lock is released
+    core::List<ReceiverSession> garbage;
 
-    packets_.push_back(*packet);
+    while (n_packets != 0) {
+        const size_t n_chunk = std::min(n_packets, (size_t)MaxParseBatch);
 
-    if (old_state != Active) {
-        active_cond_.broadcast();
+        // parsed before taking control_mutex_, so that the pipeline thread
+        // doesn't wait for the network thread parsing packets
+        bool parsed[MaxParseBatch];
+        parse_packets_(packets, parsed, n_chunk);
+
+        size_t n = 0;
+
+        while (n < n_chunk) {
+            const packet::PacketPtr* new_sess_packet = NULL;
+
+            {
+                core::Mutex::Lock lock(control_mutex_);
+
+                while (core::SharedPtr<ReceiverSession> sess = old_sessions_.front()) {
+                    old_sessions_.remove(*sess);
+                    garbage.push_back(*sess);
+                }
+
+                const State old_state = state_();
+
+                size_t n_queued = 0;
+
+                for (; n < n_chunk; n++) {
+                    if (!parsed[n]) {
+                        continue;
+                    }
+                    if (need_session_(packets[n])) {
+                        new_sess_packet = &packets[n++];
+                        break;
+                    }
+                    packets_.push_back(*packets[n]);
+                    n_queued++;
+                }
+
+                if (old_state != Active && n_queued != 0) {
+                    active_cond_.broadcast();
+                }
+            }
+
+            if (new_sess_packet) {
+                prepare_session_(*new_sess_packet);
+            }
+        }
+
+        packets += n_chunk;
+        n_packets -= n_chunk;
     }
 }
 
 bool Receiver::read(audio::Frame& frame) {
+    if (ring_) {
+        read_ring_(frame);
+        return true;
+    }
+
     core::Mutex::Lock lock(pipeline_mutex_);
 
     if (config_.common.timing) {
         ticker_.wait(timestamp_);
     }
 
+    process_frame_(frame);
+
+    return true;
+}
+
+void Receiver::reclock(core::nanoseconds_t playback_time) {
+    if (ring_) {
+        // samples already rendered into ring will be played before the next
+        // sample produced by sessions
+        playback_time += packet::timestamp_to_ns(
+            packet::timestamp_diff_t(ring_->readable() / num_channels_),
+            config_.common.output_sample_rate);
+    }
+
+    core::Mutex::Lock lock(control_mutex_);
+
+    core::SharedPtr<ReceiverSession> sess;
+
+    for (sess = sessions_.front(); sess; sess = sessions_.nextof(*sess)) {
+        sess->reclock(playback_time);
+    }
+}
+
+void Receiver::run() {
+    roc_log(LogDebug, "receiver: starting pipeline thread");
+
+    for (;;) {
+        while (!thread_stop_ && ring_->writable() >= thread_buff_.size()) {
+            audio::Frame frame(&thread_buff_[0], thread_buff_.size());
+
+            {
+                core::Mutex::Lock lock(pipeline_mutex_);
+
+                process_frame_(frame);
+            }
+
+            ring_->write(frame.data(), frame.size());
+        }
+
+        if (thread_stop_) {
+            break;
+        }
+
+        // ring is full, so there is time to destroy sessions removed while
+        // filling it, even if no packets arrive to do it in write()
+        collect_sessions_();
+
+        // woken up by read() when it frees space in ring
+        thread_sem_.wait();
+    }
+
+    roc_log(LogDebug, "receiver: finishing pipeline thread");
+}
+
+bool Receiver::start_thread_() {
+    if (config_.common.thread_buffer_size < config_.common.internal_frame_size) {
+        roc_log(LogError,
+                "receiver: thread buffer size should be >= internal frame size:"
+                " thread_buffer_size=%lu internal_frame_size=%lu",
+                (unsigned long)config_.common.thread_buffer_size,
+                (unsigned long)config_.common.internal_frame_size);
+        return false;
+    }
+
+    if (!thread_buff_.resize(config_.common.internal_frame_size)) {
+        roc_log(LogError, "receiver: can't allocate thread buffer");
+        return false;
+    }
+
+    ring_.reset(new (allocator_)
+                    audio::SampleRing(allocator_, config_.common.thread_buffer_size),
+                allocator_);
+    if (!ring_ || !ring_->valid()) {
+        return false;
+    }
+
+    if (!start()) {
+        roc_log(LogError, "receiver: can't start pipeline thread");
+        return false;
+    }
+
+    return true;
+}
+
+void Receiver::read_ring_(audio::Frame& frame) {
+    if (config_.common.timing) {
+        ticker_.wait(read_timestamp_);
+    }
+
+    const size_t n_read = ring_->read(frame.data(), frame.size());
+
+    if (n_read < frame.size()) {
+        roc_log(LogDebug, "receiver: pipeline thread underrun: requested=%lu got=%lu",
+                (unsigned long)frame.size(), (unsigned long)n_read);
+
+        memset(frame.data() + n_read, 0,
+               (frame.size() - n_read) * sizeof(audio::sample_t));
+    }
+
+    read_timestamp_ += frame.size() / num_channels_;
+
+    thread_sem_.post();
+}
+
+void Receiver::collect_sessions_() {
+    // destroyed when going out of scope, after the lock is released
+    core::List<ReceiverSession> garbage;
+
+    core::Mutex::Lock lock(control_mutex_);
+
+    while (core::SharedPtr<ReceiverSession> sess = old_sessions_.front()) {
+        old_sessions_.remove(*sess);
+        garbage.push_back(*sess);
+    }
+}
+
+void Receiver::process_frame_(audio::Frame& frame) {
     prepare_();
 
     audio_reader_->read(frame);
     timestamp_ += frame.size() / num_channels_;
-
-    return true;
 }
 
 void Receiver::prepare_() {
@@ -174,16 +387,22 @@ void Receiver::fetch_packets_() {
 
         packets_.remove(*packet);
 
-        if (!parse_packet_(packet)) {
-            continue;
-        }
-
         if (!route_packet_(packet)) {
             continue;
         }
     }
 }
 
+void Receiver::parse_packets_(const packet::PacketPtr* packets,
+                              bool* parsed,
+                              size_t n_packets) {
+    core::Mutex::Lock lock(ports_mutex_);
+
+    for (size_t n = 0; n < n_packets; n++) {
+        parsed[n] = parse_packet_(packets[n]);
+    }
+}
+
 bool Receiver::parse_packet_(const packet::PacketPtr& packet) {
     core::SharedPtr<ReceiverPort> port;
 
@@ -220,21 +439,60 @@ bool Receiver::can_create_session_(const packet::PacketPtr& packet) {
         return false;
     }
 
+    if (packet->flags() & packet::Packet::FlagControl) {
+        roc_log(LogDebug, "receiver: ignoring control packet for unknown session");
+        return false;
+    }
+
     return true;
 }
 
-bool Receiver::create_session_(const packet::PacketPtr& packet) {
-    if (!packet->udp()) {
-        roc_log(LogError, "receiver: can't create session, unexpected non-udp packet");
+bool Receiver::need_session_(const packet::PacketPtr& packet) const {
+    const packet::UDP* udp = packet->udp();
+    if (!udp || !packet->rtp()) {
         return false;
     }
 
-    if (!packet->rtp()) {
-        roc_log(LogError, "receiver: can't create session, unexpected non-rtp packet");
+    if (packet->flags() & (packet::Packet::FlagRepair | packet::Packet::FlagControl)) {
         return false;
     }
 
-    const ReceiverSessionConfig sess_config = make_session_config_(packet);
+    core::SharedPtr<ReceiverSession> sess;
+
+    for (sess = sessions_.front(); sess; sess = sessions_.nextof(*sess)) {
+        if (sess->address() == udp->src_addr) {
+            return false;
+        }
+    }
+
+    for (sess = new_sessions_.front(); sess; sess = new_sessions_.nextof(*sess)) {
+        if (sess->address() == udp->src_addr) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Receiver::prepare_session_(const packet::PacketPtr& packet) {
+    ReceiverSessionConfig sess_config;
+    packet::IWriter* control_writer = NULL;
+
+    {
+        core::Mutex::Lock lock(control_mutex_);
+
+        if (config_.common.max_sessions != 0
+            && sessions_.size() + new_sessions_.size() >= config_.common.max_sessions) {
+            roc_log(LogDebug,
+                    "receiver: can't create session, maximum number of sessions"
+                    " reached: max_sessions=%lu",
+                    (unsigned long)config_.common.max_sessions);
+            return;
+        }
+
+        sess_config = make_session_config_(packet);
+        control_writer = control_writer_;
+    }
 
     const packet::Address src_address = packet->udp()->src_addr;
     const packet::Address dst_address = packet->udp()->dst_addr;
@@ -243,17 +501,61 @@ bool Receiver::create_session_(const packet::PacketPtr& packet) {
             packet::address_to_str(src_address).c_str(),
             packet::address_to_str(dst_address).c_str());
 
+    // constructed without holding the lock, so that the pipeline thread is not
+    // blocked while the session allocates its components
     core::SharedPtr<ReceiverSession> sess = new (allocator_)
-        ReceiverSession(sess_config, config_.common, src_address, codec_map_, format_map_,
-                        packet_pool_, byte_buffer_pool_, sample_buffer_pool_, allocator_);
+        ReceiverSession(sess_config, config_.common, src_address, control_writer,
+                        codec_map_, format_map_, packet_pool_, byte_buffer_pool_,
+                        sample_buffer_pool_, allocator_);
 
     if (!sess || !sess->valid()) {
         roc_log(LogError, "receiver: can't create session, initialization failed");
+        return;
+    }
+
+    core::Mutex::Lock lock(control_mutex_);
+
+    const State old_state = state_();
+
+    if (need_session_(packet)) {
+        new_sessions_.push_back(*sess);
+    } else {
+        // another thread has prepared a session for the same sender
+        old_sessions_.push_back(*sess);
+    }
+
+    packets_.push_back(*packet);
+
+    if (old_state != Active) {
+        active_cond_.broadcast();
+    }
+}
+
+bool Receiver::create_session_(const packet::PacketPtr& packet) {
+    const packet::UDP* udp = packet->udp();
+    if (!udp) {
+        roc_log(LogError, "receiver: can't create session, unexpected non-udp packet");
+        return false;
+    }
+
+    core::SharedPtr<ReceiverSession> sess;
+
+    for (sess = new_sessions_.front(); sess; sess = new_sessions_.nextof(*sess)) {
+        if (sess->address() == udp->src_addr) {
+            break;
+        }
+    }
+
+    if (!sess) {
+        roc_log(LogDebug, "receiver: can't create session, session was not prepared");
         return false;
     }
 
+    new_sessions_.remove(*sess);
+
     if (!sess->handle(packet)) {
         roc_log(LogError, "receiver: can't create session, can't handle first packet");
+        old_sessions_.push_back(*sess);
         return false;
     }
 
@@ -268,6 +570,10 @@ void Receiver::remove_session_(ReceiverSession& sess) {
 
     mixer_->remove(sess.reader());
     sessions_.remove(sess);
+
+    // will be destroyed in write() or, if threading is enabled, when the
+    // pipeline thread has filled the ring
+    old_sessions_.push_back(sess);
 }
 
 void Receiver::update_sessions_() {
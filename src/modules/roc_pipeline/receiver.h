@@ -15,12 +15,17 @@
 #include "roc_audio/ireader.h"
 #include "roc_audio/mixer.h"
 #include "roc_audio/poison_reader.h"
+#include "roc_audio/sample_ring.h"
+#include "roc_core/array.h"
+#include "roc_core/atomic.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/cond.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/list.h"
 #include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/semaphore.h"
+#include "roc_core/thread.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_fec/codec_map.h"
 #include "roc_packet/ireader.h"
@@ -36,8 +41,23 @@ namespace roc {
 namespace pipeline {
 
 //! Receiver pipeline.
+//! @remarks
+//!  Sessions are constructed in write(), when the first packet from a new
+//!  sender arrives. Thus, read() never allocates or deallocates memory for
+//!  sessions, even when senders come and go.
+//!
+//!  If threading is enabled in config, packets are routed, sessions are
+//!  updated and mixed in a dedicated pipeline thread, which keeps a ring
+//!  buffer filled with samples. read() then only copies samples from the
+//!  ring buffer and never blocks on the pipeline.
+//!
+//!  Sessions removed by the pipeline are kept until the next write(), or,
+//!  if threading is enabled, until the pipeline thread fills the ring,
+//!  whichever comes first. Without threading, if no packets arrive after
+//!  the last session is removed, it's kept until the receiver is destroyed.
 class Receiver : public sndio::ISource,
                  public packet::IWriter,
+                 private core::Thread,
                  public core::NonCopyable<> {
 public:
     //! Initialize.
@@ -49,6 +69,9 @@ public:
              core::BufferPool<audio::sample_t>& sample_buffer_pool,
              core::IAllocator& allocator);
 
+    //! Stop pipeline thread, if any.
+    virtual ~Receiver();
+
     //! Check if the pipeline was successfully constructed.
     bool valid();
 
@@ -58,6 +81,18 @@ public:
     //! Iterate added ports.
     void iterate_ports(void (*fn)(void*, const PortConfig&), void* arg) const;
 
+    //! Set writer for outgoing control packets.
+    //! @remarks
+    //!  If set, sessions created after this call periodically send RTCP
+    //!  receiver reports to the sender address using this writer.
+    void set_control_writer(packet::IWriter& writer);
+
+    //! Iterate RTCP statistics of alive sessions.
+    void iterate_sessions(void (*fn)(void*,
+                                     const packet::Address&,
+                                     const rtcp::ReceiverStats&),
+                          void* arg) const;
+
     //! Get number of alive sessions.
     size_t num_sessions() const;
 
@@ -74,23 +109,60 @@ public:
     virtual bool has_clock() const;
 
     //! Write packet.
+    //! @remarks
+    //!  The packet is parsed by the matching port in the calling thread, so
+    //!  that the pipeline thread gets packets with all headers already parsed.
+    //!  Packets for unknown ports or with malformed headers are dropped. If
+    //!  the packet is the first one from a new sender, a session for it is
+    //!  constructed in the calling thread as well.
     virtual void write(const packet::PacketPtr&);
 
+    //! Write multiple packets.
+    //! @remarks
+    //!  Packets are parsed before taking the lock shared with the pipeline
+    //!  thread, and then enqueued under a single lock, unless a new session
+    //!  should be constructed.
+    virtual void write_batch(const packet::PacketPtr* packets, size_t n_packets);
+
     //! Read frame.
+    //! @remarks
+    //!  If threading is enabled, copies samples prepared by the pipeline
+    //!  thread and fills the rest of the frame with zeros if there are not
+    //!  enough samples. In this mode, read() should not be called from
+    //!  multiple threads concurrently.
     virtual bool read(audio::Frame&);
 
+    //! Adjust session clocks to match playback time.
+    //! @remarks
+    //!  Passes playback time to the latency monitor of every session. Used
+    //!  when sessions measure end-to-end latency. If threading is enabled,
+    //!  the duration of samples buffered in the ring is added to it.
+    virtual void reclock(core::nanoseconds_t playback_time);
+
 private:
+    enum { MaxParseBatch = 32 };
+
+    virtual void run();
+
     State state_() const;
 
+    bool start_thread_();
+    void read_ring_(audio::Frame& frame);
+
+    void collect_sessions_();
+    void process_frame_(audio::Frame& frame);
     void prepare_();
 
     void fetch_packets_();
 
+    void parse_packets_(const packet::PacketPtr* packets, bool* parsed, size_t n_packets);
     bool parse_packet_(const packet::PacketPtr& packet);
     bool route_packet_(const packet::PacketPtr& packet);
 
     bool can_create_session_(const packet::PacketPtr& packet);
+    bool need_session_(const packet::PacketPtr& packet) const;
 
+    void prepare_session_(const packet::PacketPtr& packet);
     bool create_session_(const packet::PacketPtr& packet);
     void remove_session_(ReceiverSession& sess);
 
@@ -106,8 +178,12 @@ private:
     core::BufferPool<audio::sample_t>& sample_buffer_pool_;
     core::IAllocator& allocator_;
 
+    packet::IWriter* control_writer_;
+
     core::List<ReceiverPort> ports_;
     core::List<ReceiverSession> sessions_;
+    core::List<ReceiverSession> new_sessions_;
+    core::List<ReceiverSession> old_sessions_;
 
     core::List<packet::Packet> packets_;
 
@@ -118,13 +194,22 @@ private:
 
     audio::IReader* audio_reader_;
 
+    core::UniquePtr<audio::SampleRing> ring_;
+    core::Array<audio::sample_t> thread_buff_;
+    core::Semaphore thread_sem_;
+    core::Atomic thread_stop_;
+
     ReceiverConfig config_;
 
     packet::timestamp_t timestamp_;
+    packet::timestamp_t read_timestamp_;
     size_t num_channels_;
 
+    bool valid_;
+
     core::Mutex control_mutex_;
     core::Mutex pipeline_mutex_;
+    core::Mutex ports_mutex_;
     core::Cond active_cond_;
 };
 
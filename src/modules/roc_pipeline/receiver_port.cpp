@@ -28,12 +28,21 @@ ReceiverPort::ReceiverPort(const PortConfig& config,
     case Proto_RTP:
     case Proto_RTP_LDPC_Source:
     case Proto_RTP_RSm8_Source:
+    case Proto_RTP_RLC_Source:
         rtp_parser_.reset(new (allocator) rtp::Parser(format_map, NULL), allocator);
         if (!rtp_parser_) {
             return;
         }
         parser = rtp_parser_.get();
         break;
+
+    case Proto_RTCP:
+        rtcp_parser_.reset(new (allocator) rtcp::Parser(), allocator);
+        if (!rtcp_parser_) {
+            return;
+        }
+        parser = rtcp_parser_.get();
+        break;
     }
 
     switch ((unsigned)config.protocol) {
@@ -77,6 +86,26 @@ ReceiverPort::ReceiverPort(const PortConfig& config,
         }
         parser = fec_parser_.get();
         break;
+    case Proto_RTP_RLC_Source:
+        fec_parser_.reset(
+            new (allocator)
+                fec::Parser<fec::RLC_Source_PayloadID, fec::Source, fec::Footer>(parser),
+            allocator);
+        if (!fec_parser_) {
+            return;
+        }
+        parser = fec_parser_.get();
+        break;
+    case Proto_RLC_Repair:
+        fec_parser_.reset(
+            new (allocator)
+                fec::Parser<fec::RLC_Repair_PayloadID, fec::Repair, fec::Header>(parser),
+            allocator);
+        if (!fec_parser_) {
+            return;
+        }
+        parser = fec_parser_.get();
+        break;
     }
 
     parser_ = parser;
@@ -106,6 +135,16 @@ bool ReceiverPort::handle(packet::Packet& packet) {
         return false;
     }
 
+    // Packets from a loopback port arrive here as they were composed by the
+    // sender, with all headers already filled.
+    if (packet.flags() & ~unsigned(packet::Packet::FlagUDP)) {
+        if (!check_protocol_(packet)) {
+            roc_log(LogDebug, "receiver port: dropping packet of unexpected protocol");
+            return false;
+        }
+        return true;
+    }
+
     if (!parser_->parse(packet, packet.data())) {
         roc_log(LogDebug, "receiver port: failed to parse packet");
         return false;
@@ -114,5 +153,46 @@ bool ReceiverPort::handle(packet::Packet& packet) {
     return true;
 }
 
+bool ReceiverPort::check_protocol_(const packet::Packet& packet) const {
+    const unsigned flags = packet.flags()
+        & (packet::Packet::FlagRTP | packet::Packet::FlagFEC | packet::Packet::FlagRepair
+           | packet::Packet::FlagControl);
+
+    const unsigned source_flags = packet::Packet::FlagRTP | packet::Packet::FlagFEC;
+    const unsigned repair_flags = packet::Packet::FlagFEC | packet::Packet::FlagRepair;
+
+    switch ((unsigned)config_.protocol) {
+    case Proto_RTP:
+        return flags == packet::Packet::FlagRTP;
+
+    case Proto_RTP_LDPC_Source:
+        return flags == source_flags
+            && packet.fec()->fec_scheme == packet::FEC_LDPC_Staircase;
+
+    case Proto_LDPC_Repair:
+        return flags == repair_flags
+            && packet.fec()->fec_scheme == packet::FEC_LDPC_Staircase;
+
+    case Proto_RTP_RSm8_Source:
+        return flags == source_flags
+            && packet.fec()->fec_scheme == packet::FEC_ReedSolomon_M8;
+
+    case Proto_RSm8_Repair:
+        return flags == repair_flags
+            && packet.fec()->fec_scheme == packet::FEC_ReedSolomon_M8;
+
+    case Proto_RTP_RLC_Source:
+        return flags == source_flags && packet.fec()->fec_scheme == packet::FEC_RLC;
+
+    case Proto_RLC_Repair:
+        return flags == repair_flags && packet.fec()->fec_scheme == packet::FEC_RLC;
+
+    case Proto_RTCP:
+        return flags == packet::Packet::FlagControl;
+    }
+
+    return false;
+}
+
 } // namespace pipeline
 } // namespace roc
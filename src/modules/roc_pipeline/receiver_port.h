@@ -18,6 +18,7 @@
 #include "roc_core/unique_ptr.h"
 #include "roc_packet/iparser.h"
 #include "roc_pipeline/config.h"
+#include "roc_rtcp/parser.h"
 #include "roc_rtp/format_map.h"
 #include "roc_rtp/parser.h"
 
@@ -50,6 +51,10 @@ private:
 
     void destroy();
 
+    // Check that headers of an already parsed or composed packet match
+    // the port protocol.
+    bool check_protocol_(const packet::Packet& packet) const;
+
     core::IAllocator& allocator_;
 
     const PortConfig config_;
@@ -58,6 +63,7 @@ private:
 
     core::UniquePtr<rtp::Parser> rtp_parser_;
     core::UniquePtr<packet::IParser> fec_parser_;
+    core::UniquePtr<rtcp::Parser> rtcp_parser_;
 };
 
 } // namespace pipeline
@@ -9,6 +9,9 @@
 #include "roc_pipeline/receiver_session.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/random.h"
+#include "roc_core/time.h"
+#include "roc_rtcp/parser.h"
 
 namespace roc {
 namespace pipeline {
@@ -16,6 +19,7 @@ namespace pipeline {
 ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
                                  const ReceiverCommonConfig& common_config,
                                  const packet::Address& src_address,
+                                 packet::IWriter* control_writer,
                                  const fec::CodecMap& codec_map,
                                  const rtp::FormatMap& format_map,
                                  packet::PacketPool& packet_pool,
@@ -23,20 +27,39 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
                                  core::BufferPool<audio::sample_t>& sample_buffer_pool,
                                  core::IAllocator& allocator)
     : src_address_(src_address)
+    , control_writer_(control_writer)
+    , packet_pool_(packet_pool)
+    , byte_buffer_pool_(byte_buffer_pool)
+    , rtcp_interval_(0)
+    , next_report_(0)
     , allocator_(allocator)
+    , clock_(*common_config.clock)
     , audio_reader_(NULL) {
     const rtp::Format* format = format_map.format(session_config.payload_type);
     if (!format) {
         return;
     }
 
+    rtcp_reporter_.reset(new (allocator_) rtcp::ReceiverReporter(
+                             (packet::source_t)core::random(packet::source_t(-1)),
+                             format->sample_rate),
+                         allocator_);
+    if (!rtcp_reporter_) {
+        return;
+    }
+
+    rtcp_interval_ = (packet::timestamp_t)packet::timestamp_from_ns(
+        session_config.rtcp_interval, common_config.output_sample_rate);
+
     queue_router_.reset(new (allocator_) packet::Router(allocator_, 2), allocator_);
     if (!queue_router_ || !queue_router_->valid()) {
         return;
     }
 
-    source_queue_.reset(new (allocator_) packet::SortedQueue(0), allocator_);
-    if (!source_queue_) {
+    source_queue_.reset(new (allocator_) packet::SortedQueue(
+                            0, session_config.queue_ring_size, allocator_),
+                        allocator_);
+    if (!source_queue_ || !source_queue_->valid()) {
         return;
     }
 
@@ -48,11 +71,12 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
 
     packet::IReader* preader = source_queue_.get();
 
-    delayed_reader_.reset(
-        new (allocator_) packet::DelayedReader(*preader, session_config.target_latency,
-                                               format->sample_rate),
-        allocator_);
-    if (!delayed_reader_) {
+    delayed_reader_.reset(new (allocator_) packet::DelayedReader(
+                              *preader, session_config.target_latency,
+                              format->sample_rate, session_config.queue_ring_size,
+                              allocator_),
+                          allocator_);
+    if (!delayed_reader_ || !delayed_reader_->valid()) {
         return;
     }
     preader = delayed_reader_.get();
@@ -66,6 +90,7 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
     preader = validator_.get();
 
     if (session_config.fec_decoder.scheme != packet::FEC_None) {
+        // repair packets have no RTP header, so they can't use a ring
         repair_queue_.reset(new (allocator_) packet::SortedQueue(0), allocator_);
         if (!repair_queue_) {
             return;
@@ -74,27 +99,62 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
             return;
         }
 
-        fec_decoder_.reset(codec_map.new_decoder(session_config.fec_decoder,
-                                                 byte_buffer_pool, allocator_),
-                           allocator_);
-        if (!fec_decoder_) {
-            return;
-        }
-
         fec_parser_.reset(new (allocator_) rtp::Parser(format_map, NULL), allocator_);
         if (!fec_parser_) {
             return;
         }
 
-        fec_reader_.reset(new (allocator_) fec::Reader(
-                              session_config.fec_reader,
-                              session_config.fec_decoder.scheme, *fec_decoder_, *preader,
-                              *repair_queue_, *fec_parser_, packet_pool, allocator_),
-                          allocator_);
-        if (!fec_reader_ || !fec_reader_->valid()) {
-            return;
+        if (session_config.fec_decoder.scheme == packet::FEC_RLC) {
+            fec_sliding_reader_.reset(
+                new (allocator_) fec::SlidingReader(
+                    session_config.fec_reader, session_config.fec_decoder.scheme,
+                    *preader, *repair_queue_, *fec_parser_, packet_pool,
+                    byte_buffer_pool, allocator_),
+                allocator_);
+            if (!fec_sliding_reader_ || !fec_sliding_reader_->valid()) {
+                return;
+            }
+            preader = fec_sliding_reader_.get();
+        } else {
+            fec_decoder_.reset(codec_map.new_decoder(session_config.fec_decoder,
+                                                     byte_buffer_pool, allocator_),
+                               allocator_);
+            if (!fec_decoder_) {
+                return;
+            }
+
+            if (session_config.fec_repair_threads != 0) {
+                fec_repair_pool_.reset(new (allocator_) fec::RepairPool(allocator_),
+                                       allocator_);
+                if (!fec_repair_pool_) {
+                    return;
+                }
+                for (size_t n = 0; n < session_config.fec_repair_threads; n++) {
+                    fec::IBlockDecoder* decoder = codec_map.new_decoder(
+                        session_config.fec_decoder, byte_buffer_pool, allocator_);
+                    if (!decoder) {
+                        return;
+                    }
+                    if (!fec_repair_pool_->add_worker(decoder)) {
+                        return;
+                    }
+                }
+            }
+
+            fec::ReaderConfig fec_reader_config = session_config.fec_reader;
+            fec_reader_config.queue_ring_size = session_config.queue_ring_size;
+
+            fec_reader_.reset(new (allocator_) fec::Reader(
+                                  fec_reader_config,
+                                  session_config.fec_decoder.scheme, *fec_decoder_,
+                                  *preader, *repair_queue_, *fec_parser_, packet_pool,
+                                  allocator_, fec_repair_pool_.get()),
+                              allocator_);
+            if (!fec_reader_ || !fec_reader_->valid()) {
+                return;
+            }
+            preader = fec_reader_.get();
         }
-        preader = fec_reader_.get();
 
         fec_validator_.reset(new (allocator_)
                                  rtp::Validator(*preader, session_config.rtp_validator,
@@ -145,8 +205,8 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
             areader = resampler_poisoner_.get();
         }
         resampler_.reset(new (allocator_) audio::ResamplerReader(
-                             *areader, sample_buffer_pool, allocator,
-                             session_config.resampler, session_config.channels,
+                             *areader, sample_buffer_pool, session_config.resampler,
+                             session_config.channels,
                              common_config.internal_frame_size),
                          allocator_);
         if (!resampler_ || !resampler_->valid()) {
@@ -168,7 +228,7 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
                                *source_queue_, *depacketizer_, resampler_.get(),
                                session_config.latency_monitor,
                                session_config.target_latency, format->sample_rate,
-                               common_config.output_sample_rate),
+                               common_config.output_sample_rate, clock_),
                            allocator_);
     if (!latency_monitor_ || !latency_monitor_->valid()) {
         return;
@@ -197,6 +257,28 @@ bool ReceiverSession::handle(const packet::PacketPtr& packet) {
         return false;
     }
 
+    if (packet->flags() & packet::Packet::FlagControl) {
+        rtcp::Report report;
+        if (!rtcp::Parser::parse_report(packet->data(), report)) {
+            roc_log(LogDebug,
+                    "receiver session: ignoring control packet, can't parse report");
+            return true;
+        }
+        rtcp_reporter_->process_report(report, clock_.now_unix());
+
+        packet::timestamp_t rtp_timestamp = 0;
+        core::nanoseconds_t capture_time = 0;
+        if (rtcp_reporter_->get_mapping(rtp_timestamp, capture_time)) {
+            latency_monitor_->set_mapping(rtp_timestamp, capture_time);
+        }
+
+        return true;
+    }
+
+    if (packet->flags() & packet::Packet::FlagAudio) {
+        rtcp_reporter_->process_packet(*packet, clock_.now_unix());
+    }
+
     queue_router_->write(packet);
     return true;
 }
@@ -216,14 +298,66 @@ bool ReceiverSession::update(packet::timestamp_t time) {
         }
     }
 
+    if (control_writer_ && rtcp_interval_ != 0 && rtcp_reporter_->has_source()
+        && packet::timestamp_diff(time, next_report_) >= 0) {
+        send_report_();
+        next_report_ = time + rtcp_interval_;
+    }
+
     return true;
 }
 
+void ReceiverSession::reclock(core::nanoseconds_t playback_time) {
+    roc_panic_if(!valid());
+
+    latency_monitor_->reclock(playback_time);
+}
+
 audio::IReader& ReceiverSession::reader() {
     roc_panic_if(!valid());
 
     return *audio_reader_;
 }
 
+const packet::Address& ReceiverSession::address() const {
+    return src_address_;
+}
+
+const rtcp::ReceiverStats& ReceiverSession::rtcp_stats() const {
+    roc_panic_if(!valid());
+
+    return rtcp_reporter_->stats();
+}
+
+void ReceiverSession::send_report_() {
+    packet::PacketPtr pp = new (packet_pool_) packet::Packet(packet_pool_);
+    if (!pp) {
+        roc_log(LogError, "receiver session: can't allocate control packet");
+        return;
+    }
+
+    core::Slice<uint8_t> data =
+        new (byte_buffer_pool_) core::Buffer<uint8_t>(byte_buffer_pool_);
+    if (!data) {
+        roc_log(LogError, "receiver session: can't allocate control buffer");
+        return;
+    }
+
+    rtcp::Report report;
+    rtcp_reporter_->generate(report, clock_.now_unix());
+
+    if (!rtcp_composer_.compose(report, data)) {
+        roc_log(LogError, "receiver session: can't compose control packet");
+        return;
+    }
+
+    pp->set_data(data);
+    pp->add_flags(packet::Packet::FlagUDP | packet::Packet::FlagControl
+                  | packet::Packet::FlagComposed);
+    pp->udp()->dst_addr = src_address_;
+
+    control_writer_->write(pp);
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -21,12 +21,15 @@
 #include "roc_audio/watchdog.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/iallocator.h"
+#include "roc_core/iclock.h"
 #include "roc_core/list_node.h"
 #include "roc_core/refcnt.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_fec/codec_map.h"
 #include "roc_fec/iblock_decoder.h"
 #include "roc_fec/reader.h"
+#include "roc_fec/repair_pool.h"
+#include "roc_fec/sliding_reader.h"
 #include "roc_packet/address.h"
 #include "roc_packet/delayed_reader.h"
 #include "roc_packet/iparser.h"
@@ -36,6 +39,8 @@
 #include "roc_packet/router.h"
 #include "roc_packet/sorted_queue.h"
 #include "roc_pipeline/config.h"
+#include "roc_rtcp/composer.h"
+#include "roc_rtcp/receiver_reporter.h"
 #include "roc_rtp/format_map.h"
 #include "roc_rtp/parser.h"
 #include "roc_rtp/validator.h"
@@ -45,13 +50,16 @@ namespace pipeline {
 
 //! Receiver session pipeline.
 //! @remarks
-//!  Created at the receiver side for every connected sender.
+//!  Created at the receiver side for every connected sender. Tracks RTCP
+//!  statistics and, if control writer is provided, periodically sends RTCP
+//!  receiver reports to the sender address.
 class ReceiverSession : public core::RefCnt<ReceiverSession>, public core::ListNode {
 public:
     //! Initialize.
     ReceiverSession(const ReceiverSessionConfig& session_config,
                     const ReceiverCommonConfig& common_config,
                     const packet::Address& src_address,
+                    packet::IWriter* control_writer,
                     const fec::CodecMap& codec_map,
                     const rtp::FormatMap& format_map,
                     packet::PacketPool& packet_pool,
@@ -72,17 +80,42 @@ public:
     //!  false if the session is terminated
     bool update(packet::timestamp_t time);
 
+    //! Adjust session clock to match playback time.
+    //! @remarks
+    //!  @p playback_time is wall clock time when the next sample read from
+    //!  the session is expected to be played.
+    void reclock(core::nanoseconds_t playback_time);
+
     //! Get audio reader.
     audio::IReader& reader();
 
+    //! Get session source address.
+    const packet::Address& address() const;
+
+    //! Get statistics derived from received packets and RTCP sender reports.
+    const rtcp::ReceiverStats& rtcp_stats() const;
+
 private:
     friend class core::RefCnt<ReceiverSession>;
 
     void destroy();
 
+    void send_report_();
+
     const packet::Address src_address_;
 
+    packet::IWriter* control_writer_;
+    packet::PacketPool& packet_pool_;
+    core::BufferPool<uint8_t>& byte_buffer_pool_;
+
+    core::UniquePtr<rtcp::ReceiverReporter> rtcp_reporter_;
+    rtcp::Composer rtcp_composer_;
+
+    packet::timestamp_t rtcp_interval_;
+    packet::timestamp_t next_report_;
+
     core::IAllocator& allocator_;
+    core::IClock& clock_;
 
     audio::IReader* audio_reader_;
 
@@ -97,7 +130,9 @@ private:
 
     core::UniquePtr<rtp::Parser> fec_parser_;
     core::UniquePtr<fec::IBlockDecoder> fec_decoder_;
+    core::UniquePtr<fec::RepairPool> fec_repair_pool_;
     core::UniquePtr<fec::Reader> fec_reader_;
+    core::UniquePtr<fec::SlidingReader> fec_sliding_reader_;
     core::UniquePtr<rtp::Validator> fec_validator_;
 
     core::UniquePtr<audio::IFrameDecoder> payload_decoder_;
@@ -9,8 +9,10 @@
 #include "roc_pipeline/sender.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/time.h"
 #include "roc_pipeline/port_to_str.h"
 #include "roc_pipeline/port_utils.h"
+#include "roc_rtcp/parser.h"
 
 namespace roc {
 namespace pipeline {
@@ -20,40 +22,84 @@ Sender::Sender(const SenderConfig& config,
                packet::IWriter& source_writer,
                const PortConfig& repair_port_config,
                packet::IWriter& repair_writer,
+               const PortConfig& control_port_config,
+               packet::IWriter& control_writer,
                const fec::CodecMap& codec_map,
                const rtp::FormatMap& format_map,
                packet::PacketPool& packet_pool,
                core::BufferPool<uint8_t>& byte_buffer_pool,
                core::BufferPool<audio::sample_t>& sample_buffer_pool,
                core::IAllocator& allocator)
-    : audio_writer_(NULL)
+    : packet_pool_(packet_pool)
+    , byte_buffer_pool_(byte_buffer_pool)
+    , num_pending_reports_(0)
+    , rtcp_interval_(0)
+    , next_report_(0)
+    , audio_writer_(NULL)
+    , thread_buff_(allocator)
     , config_(config)
     , timestamp_(0)
-    , num_channels_(packet::num_channels(config.input_channels)) {
+    , write_timestamp_(0)
+    , num_channels_(packet::num_channels(config.input_channels))
+    , allocator_(allocator)
+    , valid_(false) {
     roc_log(LogInfo, "sender: using remote source port %s",
             port_to_str(source_port_config).c_str());
     roc_log(LogInfo, "sender: using remote repair port %s",
             port_to_str(repair_port_config).c_str());
+    roc_log(LogInfo, "sender: using remote control port %s",
+            port_to_str(control_port_config).c_str());
 
     if (!validate_ports(config.fec_encoder.scheme, source_port_config.protocol,
                         repair_port_config.protocol)) {
         return;
     }
 
+    if (control_port_config.protocol != Proto_None
+        && !validate_port(config.fec_encoder.scheme, control_port_config.protocol,
+                          Port_AudioControl)) {
+        return;
+    }
+
     const rtp::Format* format = format_map.format(config.payload_type);
     if (!format) {
         return;
     }
 
     if (config.timing) {
-        ticker_.reset(new (allocator) core::Ticker(config.input_sample_rate), allocator);
+        ticker_.reset(new (allocator) core::Ticker(config.input_sample_rate,
+                                                   config.timing_spin_margin,
+                                                   *config.clock),
+                      allocator);
         if (!ticker_) {
             return;
         }
     }
 
-    source_port_.reset(new (allocator)
-                           SenderPort(source_port_config, source_writer, allocator),
+    if (config.pacing) {
+        core::nanoseconds_t interval = config.packet_length;
+        core::nanoseconds_t max_delay = config.packet_length;
+
+        if (config.fec_encoder.scheme != packet::FEC_None) {
+            const size_t n_source = config.fec_writer.n_source_packets;
+            const size_t n_repair = config.fec_writer.n_repair_packets;
+
+            interval = config.packet_length * (core::nanoseconds_t)n_source
+                / (core::nanoseconds_t)(n_source + n_repair);
+            max_delay = config.packet_length * (core::nanoseconds_t)n_source;
+        }
+
+        roc_log(LogDebug, "sender: enabling pacing: interval=%ld max_delay=%ld",
+                (long)interval, (long)max_delay);
+
+        pacer_.reset(new (allocator) packet::Pacer(interval, max_delay), allocator);
+        if (!pacer_) {
+            return;
+        }
+    }
+
+    source_port_.reset(new (allocator) SenderPort(source_port_config, source_writer,
+                                                  pacer_.get(), *config.clock, allocator),
                        allocator);
     if (!source_port_ || !source_port_->valid()) {
         return;
@@ -65,13 +111,37 @@ Sender::Sender(const SenderConfig& config,
     }
     packet::IWriter* pwriter = router_.get();
 
-    if (!router_->add_route(*source_port_, packet::Packet::FlagAudio)) {
+    packet::IWriter* source_writer_chain = source_port_.get();
+
+    if (control_port_config.protocol != Proto_None) {
+        control_port_.reset(new (allocator)
+                                SenderPort(control_port_config, control_writer, NULL,
+                                           *config.clock, allocator),
+                            allocator);
+        if (!control_port_ || !control_port_->valid()) {
+            return;
+        }
+
+        rtcp_reporter_.reset(new (allocator) rtcp::SenderReporter(
+                                 *source_writer_chain, format->sample_rate),
+                             allocator);
+        if (!rtcp_reporter_) {
+            return;
+        }
+        source_writer_chain = rtcp_reporter_.get();
+
+        rtcp_interval_ = (packet::timestamp_t)packet::timestamp_from_ns(
+            config.rtcp_interval, config.input_sample_rate);
+    }
+
+    if (!router_->add_route(*source_writer_chain, packet::Packet::FlagAudio)) {
         return;
     }
 
     if (config.fec_encoder.scheme != packet::FEC_None) {
         repair_port_.reset(new (allocator)
-                               SenderPort(repair_port_config, repair_writer, allocator),
+                               SenderPort(repair_port_config, repair_writer,
+                                          pacer_.get(), *config.clock, allocator),
                            allocator);
         if (!repair_port_ || !repair_port_->valid()) {
             return;
@@ -81,7 +151,15 @@ Sender::Sender(const SenderConfig& config,
             return;
         }
 
-        if (config.interleaving) {
+        if (config.interleaving && config.interleaving_delay != 0) {
+            conv_interleaver_.reset(new (allocator) packet::ConvInterleaver(
+                                        *pwriter, allocator, config.interleaving_delay),
+                                    allocator);
+            if (!conv_interleaver_ || !conv_interleaver_->valid()) {
+                return;
+            }
+            pwriter = conv_interleaver_.get();
+        } else if (config.interleaving) {
             interleaver_.reset(new (allocator) packet::Interleaver(
                                    *pwriter, allocator,
                                    config.fec_writer.n_source_packets
@@ -93,23 +171,36 @@ Sender::Sender(const SenderConfig& config,
             pwriter = interleaver_.get();
         }
 
-        fec_encoder_.reset(
-            codec_map.new_encoder(config.fec_encoder, byte_buffer_pool, allocator),
-            allocator);
-        if (!fec_encoder_) {
-            return;
-        }
+        if (config.fec_encoder.scheme == packet::FEC_RLC) {
+            fec_sliding_writer_.reset(
+                new (allocator) fec::SlidingWriter(
+                    config.fec_writer, config.fec_encoder.scheme, *pwriter,
+                    source_port_->composer(), repair_port_->composer(), packet_pool,
+                    byte_buffer_pool, allocator),
+                allocator);
+            if (!fec_sliding_writer_ || !fec_sliding_writer_->valid()) {
+                return;
+            }
+            pwriter = fec_sliding_writer_.get();
+        } else {
+            fec_encoder_.reset(
+                codec_map.new_encoder(config.fec_encoder, byte_buffer_pool, allocator),
+                allocator);
+            if (!fec_encoder_) {
+                return;
+            }
 
-        fec_writer_.reset(
-            new (allocator)
-                fec::Writer(config.fec_writer, config.fec_encoder.scheme, *fec_encoder_,
-                            *pwriter, source_port_->composer(), repair_port_->composer(),
-                            packet_pool, byte_buffer_pool, allocator),
-            allocator);
-        if (!fec_writer_ || !fec_writer_->valid()) {
-            return;
+            fec_writer_.reset(new (allocator) fec::Writer(
+                                  config.fec_writer, config.fec_encoder.scheme,
+                                  *fec_encoder_, *pwriter, source_port_->composer(),
+                                  repair_port_->composer(), packet_pool,
+                                  byte_buffer_pool, allocator),
+                              allocator);
+            if (!fec_writer_ || !fec_writer_->valid()) {
+                return;
+            }
+            pwriter = fec_writer_.get();
         }
-        pwriter = fec_writer_.get();
     }
 
     payload_encoder_.reset(format->new_encoder(allocator), allocator);
@@ -138,7 +229,7 @@ Sender::Sender(const SenderConfig& config,
             awriter = resampler_poisoner_.get();
         }
         resampler_.reset(new (allocator) audio::ResamplerWriter(
-                             *awriter, sample_buffer_pool, allocator, config.resampler,
+                             *awriter, sample_buffer_pool, config.resampler,
                              config.input_channels, config.internal_frame_size),
                          allocator);
         if (!resampler_ || !resampler_->valid()) {
@@ -161,10 +252,30 @@ Sender::Sender(const SenderConfig& config,
     }
 
     audio_writer_ = awriter;
+
+    if (config.threading) {
+        if (!start_thread_()) {
+            return;
+        }
+    }
+
+    valid_ = true;
+}
+
+Sender::~Sender() {
+    if (joinable()) {
+        thread_stop_ = true;
+        thread_data_sem_.post();
+        join();
+    }
+
+    if (ticker_) {
+        ticker_->wakeup_errors().log(LogDebug, "sender: timer wakeup errors");
+    }
 }
 
 bool Sender::valid() {
-    return audio_writer_;
+    return valid_;
 }
 
 size_t Sender::sample_rate() const {
@@ -175,15 +286,211 @@ bool Sender::has_clock() const {
     return config_.timing;
 }
 
+core::nanoseconds_t Sender::latency() const {
+    return 0;
+}
+
 void Sender::write(audio::Frame& frame) {
     roc_panic_if(!valid());
 
+    if (ring_) {
+        write_ring_(frame);
+        return;
+    }
+
     if (ticker_) {
         ticker_->wait(timestamp_);
     }
 
+    process_frame_(frame);
+}
+
+void Sender::write(const packet::PacketPtr& packet) {
+    roc_panic_if(!valid());
+
+    if (!rtcp_reporter_) {
+        roc_log(LogDebug, "sender: ignoring control packet, no control port");
+        return;
+    }
+
+    PendingReport pending;
+    pending.time = config_.clock->now_unix();
+
+    if (!rtcp::Parser::parse_report(packet->data(), pending.report)) {
+        roc_log(LogDebug, "sender: ignoring control packet, can't parse report");
+        return;
+    }
+
+    core::Mutex::Lock lock(control_mutex_);
+
+    if (num_pending_reports_ == MaxPendingReports) {
+        roc_log(LogDebug, "sender: ignoring control packet, too many pending reports");
+        return;
+    }
+
+    pending_reports_[num_pending_reports_++] = pending;
+}
+
+rtcp::SenderStats Sender::rtcp_stats() const {
+    core::Mutex::Lock lock(control_mutex_);
+
+    return rtcp_stats_;
+}
+
+void Sender::run() {
+    roc_log(LogDebug, "sender: starting pipeline thread");
+
+    for (;;) {
+        size_t n_samples;
+
+        while ((n_samples = ring_->readable()) != 0) {
+            if (n_samples > thread_buff_.size()) {
+                n_samples = thread_buff_.size();
+            }
+
+            ring_->read(&thread_buff_[0], n_samples);
+            thread_space_sem_.post();
+
+            audio::Frame frame(&thread_buff_[0], n_samples);
+            process_frame_(frame);
+        }
+
+        // checked after the ring is drained, so that no samples are lost
+        if (thread_stop_) {
+            break;
+        }
+
+        thread_data_sem_.wait();
+    }
+
+    roc_log(LogDebug, "sender: finishing pipeline thread");
+}
+
+bool Sender::start_thread_() {
+    if (config_.thread_buffer_size < config_.internal_frame_size) {
+        roc_log(LogError,
+                "sender: thread buffer size should be >= internal frame size:"
+                " thread_buffer_size=%lu internal_frame_size=%lu",
+                (unsigned long)config_.thread_buffer_size,
+                (unsigned long)config_.internal_frame_size);
+        return false;
+    }
+
+    // the pipeline thread processes samples in chunks of multiple of channels
+    const size_t frame_size =
+        config_.internal_frame_size - config_.internal_frame_size % num_channels_;
+    const size_t ring_size =
+        config_.thread_buffer_size - config_.thread_buffer_size % num_channels_;
+
+    if (frame_size == 0) {
+        roc_log(LogError, "sender: internal frame size is too small");
+        return false;
+    }
+
+    if (!thread_buff_.resize(frame_size)) {
+        roc_log(LogError, "sender: can't allocate thread buffer");
+        return false;
+    }
+
+    ring_.reset(new (allocator_) audio::SampleRing(allocator_, ring_size), allocator_);
+    if (!ring_ || !ring_->valid()) {
+        return false;
+    }
+
+    if (!start()) {
+        roc_log(LogError, "sender: can't start pipeline thread");
+        return false;
+    }
+
+    return true;
+}
+
+void Sender::write_ring_(const audio::Frame& frame) {
+    if (ticker_) {
+        ticker_->wait(write_timestamp_);
+    }
+
+    const audio::sample_t* samples = frame.data();
+    size_t n_samples = frame.size();
+
+    while (n_samples != 0) {
+        size_t n_chunk = ring_->writable();
+        n_chunk -= n_chunk % num_channels_;
+
+        if (n_chunk == 0) {
+            // ring is full, wait until the pipeline thread reads something
+            thread_space_sem_.wait();
+            continue;
+        }
+
+        if (n_chunk > n_samples) {
+            n_chunk = n_samples;
+        }
+
+        ring_->write(samples, n_chunk);
+        thread_data_sem_.post();
+
+        samples += n_chunk;
+        n_samples -= n_chunk;
+    }
+
+    write_timestamp_ += frame.size() / num_channels_;
+}
+
+void Sender::process_frame_(audio::Frame& frame) {
     audio_writer_->write(frame);
     timestamp_ += frame.size() / num_channels_;
+
+    if (rtcp_reporter_) {
+        process_reports_();
+
+        if (rtcp_interval_ != 0 && rtcp_reporter_->has_source()
+            && packet::timestamp_diff(timestamp_, next_report_) >= 0) {
+            send_report_();
+            next_report_ = timestamp_ + rtcp_interval_;
+        }
+    }
+}
+
+void Sender::process_reports_() {
+    core::Mutex::Lock lock(control_mutex_);
+
+    for (size_t n = 0; n < num_pending_reports_; n++) {
+        rtcp_reporter_->process(pending_reports_[n].report, pending_reports_[n].time);
+    }
+
+    if (num_pending_reports_ != 0) {
+        num_pending_reports_ = 0;
+        rtcp_stats_ = rtcp_reporter_->stats();
+    }
+}
+
+void Sender::send_report_() {
+    packet::PacketPtr pp = new (packet_pool_) packet::Packet(packet_pool_);
+    if (!pp) {
+        roc_log(LogError, "sender: can't allocate control packet");
+        return;
+    }
+
+    core::Slice<uint8_t> data =
+        new (byte_buffer_pool_) core::Buffer<uint8_t>(byte_buffer_pool_);
+    if (!data) {
+        roc_log(LogError, "sender: can't allocate control buffer");
+        return;
+    }
+
+    rtcp::Report report;
+    rtcp_reporter_->generate(report, config_.clock->now_unix());
+
+    if (!rtcp_composer_.compose(report, data)) {
+        roc_log(LogError, "sender: can't compose control packet");
+        return;
+    }
+
+    pp->set_data(data);
+    pp->add_flags(packet::Packet::FlagControl | packet::Packet::FlagComposed);
+
+    control_port_->write(pp);
 }
 
 } // namespace pipeline
@@ -16,19 +16,31 @@
 #include "roc_audio/packetizer.h"
 #include "roc_audio/poison_writer.h"
 #include "roc_audio/resampler_writer.h"
+#include "roc_audio/sample_ring.h"
+#include "roc_core/array.h"
+#include "roc_core/atomic.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/iallocator.h"
+#include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/semaphore.h"
+#include "roc_core/thread.h"
 #include "roc_core/ticker.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_fec/codec_map.h"
 #include "roc_fec/iblock_encoder.h"
+#include "roc_fec/sliding_writer.h"
 #include "roc_fec/writer.h"
+#include "roc_packet/conv_interleaver.h"
 #include "roc_packet/interleaver.h"
+#include "roc_packet/pacer.h"
 #include "roc_packet/packet_pool.h"
 #include "roc_packet/router.h"
 #include "roc_pipeline/config.h"
 #include "roc_pipeline/sender_port.h"
+#include "roc_rtcp/composer.h"
+#include "roc_rtcp/report.h"
+#include "roc_rtcp/sender_reporter.h"
 #include "roc_rtp/format_map.h"
 #include "roc_sndio/isink.h"
 
@@ -36,7 +48,17 @@ namespace roc {
 namespace pipeline {
 
 //! Sender pipeline.
-class Sender : public sndio::ISink, public core::NonCopyable<> {
+//! @remarks
+//!  If control port is configured, periodically sends RTCP sender reports
+//!  to it. RTCP receiver reports should be written to the sender as packets.
+//!
+//!  If threading is enabled in config, frames are copied to a ring buffer,
+//!  and the rest of the pipeline runs in a dedicated pipeline thread, so
+//!  that the writer doesn't pay for resampling, encoding, FEC and sending.
+class Sender : public sndio::ISink,
+               public packet::IWriter,
+               private core::Thread,
+               public core::NonCopyable<> {
 public:
     //! Initialize.
     Sender(const SenderConfig& config,
@@ -44,6 +66,8 @@ public:
            packet::IWriter& source_writer,
            const PortConfig& repair_port,
            packet::IWriter& repair_writer,
+           const PortConfig& control_port,
+           packet::IWriter& control_writer,
            const fec::CodecMap& codec_map,
            const rtp::FormatMap& format_map,
            packet::PacketPool& packet_pool,
@@ -51,6 +75,11 @@ public:
            core::BufferPool<audio::sample_t>& sample_buffer_pool,
            core::IAllocator& allocator);
 
+    //! Stop pipeline thread, if any.
+    //! @remarks
+    //!  Samples remaining in the ring buffer are processed before stopping.
+    virtual ~Sender();
+
     //! Check if the pipeline was successfully constructed.
     bool valid();
 
@@ -60,19 +89,72 @@ public:
     //! Check if the sink has own clock.
     virtual bool has_clock() const;
 
+    //! Get playback latency of the sink.
+    virtual core::nanoseconds_t latency() const;
+
     //! Write audio frame.
+    //! @remarks
+    //!  If threading is enabled, copies samples to the ring buffer and blocks
+    //!  only if the ring buffer is full. In this mode, write() should not be
+    //!  called from multiple threads concurrently.
     virtual void write(audio::Frame& frame);
 
+    //! Write control packet received from receiver.
+    //! @remarks
+    //!  Thread-safe. The report is processed during next write of audio frame.
+    virtual void write(const packet::PacketPtr& packet);
+
+    //! Get statistics derived from RTCP receiver reports.
+    //! @remarks
+    //!  Thread-safe.
+    rtcp::SenderStats rtcp_stats() const;
+
 private:
+    enum { MaxPendingReports = 8 };
+
+    struct PendingReport {
+        rtcp::Report report;
+        core::nanoseconds_t time;
+    };
+
+    virtual void run();
+
+    bool start_thread_();
+    void write_ring_(const audio::Frame& frame);
+
+    void process_frame_(audio::Frame& frame);
+
+    void process_reports_();
+    void send_report_();
+
+    packet::PacketPool& packet_pool_;
+    core::BufferPool<uint8_t>& byte_buffer_pool_;
+
+    core::UniquePtr<packet::Pacer> pacer_;
+
     core::UniquePtr<SenderPort> source_port_;
     core::UniquePtr<SenderPort> repair_port_;
+    core::UniquePtr<SenderPort> control_port_;
+
+    core::UniquePtr<rtcp::SenderReporter> rtcp_reporter_;
+    rtcp::Composer rtcp_composer_;
+
+    core::Mutex control_mutex_;
+    PendingReport pending_reports_[MaxPendingReports];
+    size_t num_pending_reports_;
+    rtcp::SenderStats rtcp_stats_;
+
+    packet::timestamp_t rtcp_interval_;
+    packet::timestamp_t next_report_;
 
     core::UniquePtr<packet::Router> router_;
 
     core::UniquePtr<packet::Interleaver> interleaver_;
+    core::UniquePtr<packet::ConvInterleaver> conv_interleaver_;
 
     core::UniquePtr<fec::IBlockEncoder> fec_encoder_;
     core::UniquePtr<fec::Writer> fec_writer_;
+    core::UniquePtr<fec::SlidingWriter> fec_sliding_writer_;
 
     core::UniquePtr<audio::IFrameEncoder> payload_encoder_;
     core::UniquePtr<audio::Packetizer> packetizer_;
@@ -86,10 +168,21 @@ private:
 
     audio::IWriter* audio_writer_;
 
+    core::UniquePtr<audio::SampleRing> ring_;
+    core::Array<audio::sample_t> thread_buff_;
+    core::Semaphore thread_data_sem_;
+    core::Semaphore thread_space_sem_;
+    core::Atomic thread_stop_;
+
     SenderConfig config_;
 
     packet::timestamp_t timestamp_;
+    packet::timestamp_t write_timestamp_;
     size_t num_channels_;
+
+    core::IAllocator& allocator_;
+
+    bool valid_;
 };
 
 } // namespace pipeline
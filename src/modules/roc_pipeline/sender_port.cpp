@@ -9,6 +9,7 @@
 #include "roc_pipeline/sender_port.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/time.h"
 #include "roc_fec/composer.h"
 #include "roc_fec/headers.h"
 
@@ -17,16 +18,22 @@ namespace pipeline {
 
 SenderPort::SenderPort(const PortConfig& config,
                        packet::IWriter& writer,
+                       packet::Pacer* pacer,
+                       core::IClock& clock,
                        core::IAllocator& allocator)
     : dst_address_(config.address)
     , writer_(writer)
-    , composer_(NULL) {
+    , pacer_(pacer)
+    , clock_(clock)
+    , composer_(NULL)
+    , valid_(false) {
     packet::IComposer* composer = NULL;
 
     switch ((unsigned)config.protocol) {
     case Proto_RTP:
     case Proto_RTP_LDPC_Source:
     case Proto_RTP_RSm8_Source:
+    case Proto_RTP_RLC_Source:
         rtp_composer_.reset(new (allocator) rtp::Composer(NULL), allocator);
         if (!rtp_composer_) {
             return;
@@ -78,17 +85,45 @@ SenderPort::SenderPort(const PortConfig& config,
         }
         composer = fec_composer_.get();
         break;
+    case Proto_RTP_RLC_Source:
+        fec_composer_.reset(
+            new (allocator)
+                fec::Composer<fec::RLC_Source_PayloadID, fec::Source, fec::Footer>(
+                    composer),
+            allocator);
+        if (!fec_composer_) {
+            return;
+        }
+        composer = fec_composer_.get();
+        break;
+    case Proto_RLC_Repair:
+        fec_composer_.reset(
+            new (allocator)
+                fec::Composer<fec::RLC_Repair_PayloadID, fec::Repair, fec::Header>(
+                    composer),
+            allocator);
+        if (!fec_composer_) {
+            return;
+        }
+        composer = fec_composer_.get();
+        break;
+    }
+
+    if (!composer && config.protocol != Proto_RTCP) {
+        return;
     }
 
     composer_ = composer;
+    valid_ = true;
 }
 
 bool SenderPort::valid() const {
-    return composer_;
+    return valid_;
 }
 
 packet::IComposer& SenderPort::composer() {
     roc_panic_if(!valid());
+    roc_panic_if(!composer_);
 
     return *composer_;
 }
@@ -96,20 +131,38 @@ packet::IComposer& SenderPort::composer() {
 void SenderPort::write(const packet::PacketPtr& packet) {
     roc_panic_if(!valid());
 
-    packet->add_flags(packet::Packet::FlagUDP);
+    prepare_(*packet);
 
-    packet::UDP& udp = *packet->udp();
+    writer_.write(packet);
+}
+
+void SenderPort::write_batch(const packet::PacketPtr* packets, size_t n_packets) {
+    roc_panic_if(!valid());
+
+    for (size_t n = 0; n < n_packets; n++) {
+        prepare_(*packets[n]);
+    }
+
+    writer_.write_batch(packets, n_packets);
+}
+
+void SenderPort::prepare_(packet::Packet& packet) {
+    packet.add_flags(packet::Packet::FlagUDP);
+
+    packet::UDP& udp = *packet.udp();
 
     udp.dst_addr = dst_address_;
 
-    if ((packet->flags() & packet::Packet::FlagComposed) == 0) {
-        if (!composer_->compose(*packet)) {
+    if (pacer_) {
+        udp.send_time = pacer_->schedule(clock_.now());
+    }
+
+    if ((packet.flags() & packet::Packet::FlagComposed) == 0) {
+        if (!composer_ || !composer_->compose(packet)) {
             roc_panic("sender port: can't compose packet");
         }
-        packet->add_flags(packet::Packet::FlagComposed);
+        packet.add_flags(packet::Packet::FlagComposed);
     }
-
-    writer_.write(packet);
 }
 
 } // namespace pipeline
@@ -13,10 +13,12 @@
 #define ROC_PIPELINE_SENDER_PORT_H_
 
 #include "roc_core/iallocator.h"
+#include "roc_core/iclock.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_packet/icomposer.h"
 #include "roc_packet/iwriter.h"
+#include "roc_packet/pacer.h"
 #include "roc_pipeline/config.h"
 #include "roc_rtp/composer.h"
 
@@ -25,12 +27,17 @@ namespace pipeline {
 
 //! Sender port pipeline.
 //! @remarks
-//!  Created at the sender side for every sending port.
+//!  Created at the sender side for every sending port. Control port has
+//!  no composer and accepts only already composed packets. If pacer is
+//!  provided, it's used to assign send time to every packet, using the
+//!  current time of the given clock.
 class SenderPort : public packet::IWriter, public core::NonCopyable<> {
 public:
     //! Initialize.
     SenderPort(const PortConfig& config,
                packet::IWriter& writer,
+               packet::Pacer* pacer,
+               core::IClock& clock,
                core::IAllocator& allocator);
 
     //! Check if the port pipeline was succefully constructed.
@@ -40,16 +47,28 @@ public:
     packet::IComposer& composer();
 
     //! Write packet.
-    void write(const packet::PacketPtr& packet);
+    virtual void write(const packet::PacketPtr& packet);
+
+    //! Write multiple packets.
+    //! @remarks
+    //!  Prepares every packet like write() does and passes them to the
+    //!  writer as a single batch.
+    virtual void write_batch(const packet::PacketPtr* packets, size_t n_packets);
 
 private:
+    void prepare_(packet::Packet& packet);
+
     const packet::Address dst_address_;
 
     packet::IWriter& writer_;
+    packet::Pacer* pacer_;
+    core::IClock& clock_;
     packet::IComposer* composer_;
 
     core::UniquePtr<rtp::Composer> rtp_composer_;
     core::UniquePtr<packet::IComposer> fec_composer_;
+
+    bool valid_;
 };
 
 } // namespace pipeline
@@ -20,6 +20,8 @@ const char* port_type_to_str(PortType type) {
         return "source";
     case Port_AudioRepair:
         return "repair";
+    case Port_AudioControl:
+        return "control";
     }
     return "?";
 }
@@ -38,6 +40,12 @@ const char* port_proto_to_str(PortProtocol proto) {
         return "rtp+ldpc";
     case Proto_LDPC_Repair:
         return "ldpc";
+    case Proto_RTP_RLC_Source:
+        return "rtp+rlc";
+    case Proto_RLC_Repair:
+        return "rlc";
+    case Proto_RTCP:
+        return "rtcp";
     }
     return "?";
 }
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtcp/composer.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_rtcp/headers.h"
+
+namespace roc {
+namespace rtcp {
+
+namespace {
+
+size_t report_size(const Report& report) {
+    size_t sz = report.has_sender_info ? sizeof(SenderReportPacket)
+                                       : sizeof(ReceiverReportPacket);
+    return sz + report.num_blocks * sizeof(ReportBlock);
+}
+
+size_t xr_size(const Report& report) {
+    if (!report.has_rrtr && report.num_dlrr_blocks == 0) {
+        return 0;
+    }
+
+    size_t sz = sizeof(XRPacket);
+    if (report.has_rrtr) {
+        sz += sizeof(XRRrtrBlock);
+    }
+    if (report.num_dlrr_blocks != 0) {
+        sz += sizeof(XRBlockHeader) + report.num_dlrr_blocks * sizeof(XRDlrrSubblock);
+    }
+    return sz;
+}
+
+void compose_report(const Report& report, uint8_t* data, size_t size) {
+    memset(data, 0, size);
+
+    PacketHeader* header = NULL;
+    uint8_t* blocks = NULL;
+
+    if (report.has_sender_info) {
+        SenderReportPacket& sr = *(SenderReportPacket*)data;
+        sr.header().set_type(RTCP_SR);
+        sr.set_ssrc(report.ssrc);
+        sr.set_ntp_timestamp(report.sender_info.ntp_timestamp);
+        sr.set_rtp_timestamp(report.sender_info.rtp_timestamp);
+        sr.set_packet_count(report.sender_info.packet_count);
+        sr.set_byte_count(report.sender_info.byte_count);
+        header = &sr.header();
+        blocks = data + sizeof(SenderReportPacket);
+    } else {
+        ReceiverReportPacket& rr = *(ReceiverReportPacket*)data;
+        rr.header().set_type(RTCP_RR);
+        rr.set_ssrc(report.ssrc);
+        header = &rr.header();
+        blocks = data + sizeof(ReceiverReportPacket);
+    }
+
+    header->set_version(V2);
+    header->set_counter(report.num_blocks);
+    header->set_size(size);
+
+    for (size_t n = 0; n < report.num_blocks; n++) {
+        const ReceptionBlock& src = report.blocks[n];
+        ReportBlock& dst = *(ReportBlock*)(blocks + n * sizeof(ReportBlock));
+
+        dst.set_ssrc(src.ssrc);
+        dst.set_losses(src.fraction_lost, src.cumulative_lost);
+        dst.set_last_seqnum(src.last_seqnum);
+        dst.set_jitter(src.jitter);
+        dst.set_last_sr(src.last_sr);
+        dst.set_delay_last_sr(src.delay_last_sr);
+    }
+}
+
+void compose_xr(const Report& report, uint8_t* data, size_t size) {
+    memset(data, 0, size);
+
+    XRPacket& xr = *(XRPacket*)data;
+    xr.header().set_version(V2);
+    xr.header().set_type(RTCP_XR);
+    xr.header().set_size(size);
+    xr.set_ssrc(report.ssrc);
+
+    uint8_t* ptr = data + sizeof(XRPacket);
+
+    if (report.has_rrtr) {
+        XRRrtrBlock& rrtr = *(XRRrtrBlock*)ptr;
+        rrtr.header().set_type(XR_RRTR);
+        rrtr.header().set_size(sizeof(XRRrtrBlock));
+        rrtr.set_ntp_timestamp(report.rrtr_timestamp);
+        ptr += sizeof(XRRrtrBlock);
+    }
+
+    if (report.num_dlrr_blocks != 0) {
+        XRBlockHeader& dlrr = *(XRBlockHeader*)ptr;
+        dlrr.set_type(XR_DLRR);
+        dlrr.set_size(sizeof(XRBlockHeader)
+                      + report.num_dlrr_blocks * sizeof(XRDlrrSubblock));
+        ptr += sizeof(XRBlockHeader);
+
+        for (size_t n = 0; n < report.num_dlrr_blocks; n++) {
+            const DlrrBlock& src = report.dlrr_blocks[n];
+            XRDlrrSubblock& dst = *(XRDlrrSubblock*)ptr;
+
+            dst.set_ssrc(src.ssrc);
+            dst.set_last_rr(src.last_rr);
+            dst.set_delay_last_rr(src.delay_last_rr);
+
+            ptr += sizeof(XRDlrrSubblock);
+        }
+    }
+
+    roc_panic_if(ptr != data + size);
+}
+
+} // namespace
+
+size_t Composer::compose_size(const Report& report) const {
+    return report_size(report) + xr_size(report);
+}
+
+bool Composer::compose(const Report& report, core::Slice<uint8_t>& buffer) const {
+    if (report.num_blocks > Report::MaxBlocks) {
+        roc_panic("rtcp composer: too many reception blocks: num=%lu max=%lu",
+                  (unsigned long)report.num_blocks, (unsigned long)Report::MaxBlocks);
+    }
+
+    if (report.num_dlrr_blocks > Report::MaxDlrrBlocks) {
+        roc_panic("rtcp composer: too many dlrr blocks: num=%lu max=%lu",
+                  (unsigned long)report.num_dlrr_blocks,
+                  (unsigned long)Report::MaxDlrrBlocks);
+    }
+
+    const size_t rep_size = report_size(report);
+    const size_t total_size = rep_size + xr_size(report);
+
+    if (buffer.capacity() < total_size) {
+        roc_log(LogDebug,
+                "rtcp composer: not enough space for report: size=%lu capacity=%lu",
+                (unsigned long)total_size, (unsigned long)buffer.capacity());
+        return false;
+    }
+
+    buffer.resize(total_size);
+
+    compose_report(report, buffer.data(), rep_size);
+
+    if (total_size != rep_size) {
+        compose_xr(report, buffer.data() + rep_size, total_size - rep_size);
+    }
+
+    return true;
+}
+
+} // namespace rtcp
+} // namespace roc
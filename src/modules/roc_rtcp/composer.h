@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtcp/composer.h
+//! @brief RTCP packet composer.
+
+#ifndef ROC_RTCP_COMPOSER_H_
+#define ROC_RTCP_COMPOSER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_rtcp/report.h"
+
+namespace roc {
+namespace rtcp {
+
+//! RTCP packet composer.
+//! @remarks
+//!  Composes compound RTCP packet from a report. The packet consists of
+//!  SR or RR packet, depending on whether sender info is present, and,
+//!  if the report has RRTR or DLRR blocks, XR packet.
+class Composer : public core::NonCopyable<> {
+public:
+    //! Get size of composed report in bytes.
+    size_t compose_size(const Report& report) const;
+
+    //! Compose report to buffer.
+    //! @remarks
+    //!  Resizes @p buffer to compose_size().
+    //! @returns
+    //!  false if the buffer capacity is too small.
+    bool compose(const Report& report, core::Slice<uint8_t>& buffer) const;
+};
+
+} // namespace rtcp
+} // namespace roc
+
+#endif // ROC_RTCP_COMPOSER_H_
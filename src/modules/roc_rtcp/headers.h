@@ -0,0 +1,510 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtcp/headers.h
+//! @brief RTCP headers.
+
+#ifndef ROC_RTCP_HEADERS_H_
+#define ROC_RTCP_HEADERS_H_
+
+#include "roc_core/attributes.h"
+#include "roc_core/endian.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace rtcp {
+
+//! RTCP protocol version.
+enum Version {
+    V2 = 2 //!< RTCP version 2.
+};
+
+//! RTCP packet type.
+enum PacketType {
+    RTCP_SR = 200,  //!< Sender report.
+    RTCP_RR = 201,  //!< Receiver report.
+    RTCP_SDES = 202, //!< Source description.
+    RTCP_BYE = 203, //!< Goodbye.
+    RTCP_APP = 204, //!< Application-defined.
+    RTCP_XR = 207   //!< Extended report (RFC 3611).
+};
+
+//! XR block type.
+enum XRBlockType {
+    XR_RRTR = 4, //!< Receiver reference time report block.
+    XR_DLRR = 5  //!< Delay since last receiver report block.
+};
+
+//! Maximum number of report blocks in SR or RR packet.
+const size_t MaxReportBlocks = 31;
+
+//! RTCP common packet header.
+//!
+//! @code
+//!    0                   1                   2                   3
+//!    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |V=2|P|    RC   |      PT       |             length            |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+class ROC_ATTR_PACKED PacketHeader {
+private:
+    enum {
+        Flag_VersionShift = 6,
+        Flag_VersionMask = 0x3,
+
+        Flag_PaddingShift = 5,
+        Flag_PaddingMask = 0x1,
+
+        Flag_CountShift = 0,
+        Flag_CountMask = 0x1f
+    };
+
+    //! Packed version, padding and counter.
+    uint8_t flags_;
+
+    //! Packet type.
+    uint8_t type_;
+
+    //! Packet length in 32-bit words minus one.
+    uint16_t length_;
+
+public:
+    //! Clear header.
+    void clear() {
+        memset(this, 0, sizeof(*this));
+    }
+
+    //! Get version.
+    uint8_t version() const {
+        return ((flags_ >> Flag_VersionShift) & Flag_VersionMask);
+    }
+
+    //! Set version.
+    void set_version(Version v) {
+        roc_panic_if((v & Flag_VersionMask) != v);
+        flags_ &= ~(Flag_VersionMask << Flag_VersionShift);
+        flags_ |= (v << Flag_VersionShift);
+    }
+
+    //! Get padding flag.
+    bool has_padding() const {
+        return (flags_ & (Flag_PaddingMask << Flag_PaddingShift));
+    }
+
+    //! Get number of report blocks or other items.
+    size_t counter() const {
+        return ((flags_ >> Flag_CountShift) & Flag_CountMask);
+    }
+
+    //! Set number of report blocks or other items.
+    void set_counter(size_t c) {
+        roc_panic_if(c > Flag_CountMask);
+        flags_ &= ~(Flag_CountMask << Flag_CountShift);
+        flags_ |= (uint8_t(c) << Flag_CountShift);
+    }
+
+    //! Get packet type.
+    uint8_t type() const {
+        return type_;
+    }
+
+    //! Set packet type.
+    void set_type(PacketType t) {
+        type_ = uint8_t(t);
+    }
+
+    //! Get packet size in bytes, including header.
+    size_t size() const {
+        return (size_t(core::ntoh16(length_)) + 1) * 4;
+    }
+
+    //! Set packet size in bytes, including header.
+    void set_size(size_t sz) {
+        roc_panic_if(sz < 4 || sz % 4 != 0 || sz / 4 - 1 > 0xffff);
+        length_ = core::hton16(uint16_t(sz / 4 - 1));
+    }
+};
+
+//! Sender report packet (SR), without report blocks.
+//!
+//! @code
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |V=2|P|    RC   |   PT=SR=200   |             length            |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                         SSRC of sender                        |
+//!   +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+//!   |              NTP timestamp, most significant word             |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |             NTP timestamp, least significant word             |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                         RTP timestamp                         |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                     sender's packet count                     |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                      sender's octet count                     |
+//!   +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+//! @endcode
+class ROC_ATTR_PACKED SenderReportPacket {
+private:
+    PacketHeader header_;
+    uint32_t ssrc_;
+    uint32_t ntp_msw_;
+    uint32_t ntp_lsw_;
+    uint32_t rtp_timestamp_;
+    uint32_t packet_count_;
+    uint32_t byte_count_;
+
+public:
+    //! Get common header.
+    PacketHeader& header() {
+        return header_;
+    }
+
+    //! Get common header.
+    const PacketHeader& header() const {
+        return header_;
+    }
+
+    //! Get SSRC of sender.
+    uint32_t ssrc() const {
+        return core::ntoh32(ssrc_);
+    }
+
+    //! Set SSRC of sender.
+    void set_ssrc(uint32_t s) {
+        ssrc_ = core::hton32(s);
+    }
+
+    //! Get NTP timestamp.
+    uint64_t ntp_timestamp() const {
+        return (uint64_t(core::ntoh32(ntp_msw_)) << 32) | core::ntoh32(ntp_lsw_);
+    }
+
+    //! Set NTP timestamp.
+    void set_ntp_timestamp(uint64_t t) {
+        ntp_msw_ = core::hton32(uint32_t(t >> 32));
+        ntp_lsw_ = core::hton32(uint32_t(t));
+    }
+
+    //! Get RTP timestamp.
+    uint32_t rtp_timestamp() const {
+        return core::ntoh32(rtp_timestamp_);
+    }
+
+    //! Set RTP timestamp.
+    void set_rtp_timestamp(uint32_t t) {
+        rtp_timestamp_ = core::hton32(t);
+    }
+
+    //! Get sender's packet count.
+    uint32_t packet_count() const {
+        return core::ntoh32(packet_count_);
+    }
+
+    //! Set sender's packet count.
+    void set_packet_count(uint32_t c) {
+        packet_count_ = core::hton32(c);
+    }
+
+    //! Get sender's octet count.
+    uint32_t byte_count() const {
+        return core::ntoh32(byte_count_);
+    }
+
+    //! Set sender's octet count.
+    void set_byte_count(uint32_t c) {
+        byte_count_ = core::hton32(c);
+    }
+};
+
+//! Receiver report packet (RR), without report blocks.
+//!
+//! @code
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |V=2|P|    RC   |   PT=RR=201   |             length            |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                     SSRC of packet sender                     |
+//!   +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+//! @endcode
+class ROC_ATTR_PACKED ReceiverReportPacket {
+private:
+    PacketHeader header_;
+    uint32_t ssrc_;
+
+public:
+    //! Get common header.
+    PacketHeader& header() {
+        return header_;
+    }
+
+    //! Get common header.
+    const PacketHeader& header() const {
+        return header_;
+    }
+
+    //! Get SSRC of packet sender.
+    uint32_t ssrc() const {
+        return core::ntoh32(ssrc_);
+    }
+
+    //! Set SSRC of packet sender.
+    void set_ssrc(uint32_t s) {
+        ssrc_ = core::hton32(s);
+    }
+};
+
+//! Reception report block, used in SR and RR packets.
+//!
+//! @code
+//!   +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+//!   |                 SSRC_1 (SSRC of first source)                 |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   | fraction lost |       cumulative number of packets lost       |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |           extended highest sequence number received           |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                      interarrival jitter                      |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                         last SR (LSR)                         |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                   delay since last SR (DLSR)                  |
+//!   +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+//! @endcode
+class ROC_ATTR_PACKED ReportBlock {
+private:
+    uint32_t ssrc_;
+    uint32_t losses_;
+    uint32_t last_seqnum_;
+    uint32_t jitter_;
+    uint32_t last_sr_;
+    uint32_t delay_last_sr_;
+
+public:
+    //! Get SSRC of the reported source.
+    uint32_t ssrc() const {
+        return core::ntoh32(ssrc_);
+    }
+
+    //! Set SSRC of the reported source.
+    void set_ssrc(uint32_t s) {
+        ssrc_ = core::hton32(s);
+    }
+
+    //! Get fraction lost, as a fixed point number with 8 fractional bits.
+    uint8_t fraction_lost() const {
+        return uint8_t(core::ntoh32(losses_) >> 24);
+    }
+
+    //! Get cumulative number of packets lost.
+    int32_t cumulative_lost() const {
+        uint32_t v = core::ntoh32(losses_) & 0xffffff;
+        // sign-extend 24-bit value
+        if (v & 0x800000) {
+            v |= 0xff000000;
+        }
+        return int32_t(v);
+    }
+
+    //! Set fraction lost and cumulative number of packets lost.
+    void set_losses(uint8_t fraction, int32_t cumulative) {
+        if (cumulative > 0x7fffff) {
+            cumulative = 0x7fffff;
+        }
+        if (cumulative < -0x800000) {
+            cumulative = -0x800000;
+        }
+        losses_ =
+            core::hton32((uint32_t(fraction) << 24) | (uint32_t(cumulative) & 0xffffff));
+    }
+
+    //! Get extended highest sequence number received.
+    uint32_t last_seqnum() const {
+        return core::ntoh32(last_seqnum_);
+    }
+
+    //! Set extended highest sequence number received.
+    void set_last_seqnum(uint32_t sn) {
+        last_seqnum_ = core::hton32(sn);
+    }
+
+    //! Get interarrival jitter, in RTP timestamp units.
+    uint32_t jitter() const {
+        return core::ntoh32(jitter_);
+    }
+
+    //! Set interarrival jitter, in RTP timestamp units.
+    void set_jitter(uint32_t j) {
+        jitter_ = core::hton32(j);
+    }
+
+    //! Get middle 32 bits of NTP timestamp of last SR.
+    uint32_t last_sr() const {
+        return core::ntoh32(last_sr_);
+    }
+
+    //! Set middle 32 bits of NTP timestamp of last SR.
+    void set_last_sr(uint32_t t) {
+        last_sr_ = core::hton32(t);
+    }
+
+    //! Get delay since last SR, in units of 1/65536 seconds.
+    uint32_t delay_last_sr() const {
+        return core::ntoh32(delay_last_sr_);
+    }
+
+    //! Set delay since last SR, in units of 1/65536 seconds.
+    void set_delay_last_sr(uint32_t d) {
+        delay_last_sr_ = core::hton32(d);
+    }
+};
+
+//! Extended report packet (XR), without report blocks.
+//!
+//! @code
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |V=2|P|reserved |   PT=XR=207   |             length            |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                              SSRC                             |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+typedef ReceiverReportPacket XRPacket;
+
+//! XR block header.
+//!
+//! @code
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |      BT       | type-specific |         block length          |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+class ROC_ATTR_PACKED XRBlockHeader {
+private:
+    uint8_t type_;
+    uint8_t type_specific_;
+    uint16_t length_;
+
+public:
+    //! Get block type.
+    uint8_t type() const {
+        return type_;
+    }
+
+    //! Set block type.
+    void set_type(XRBlockType t) {
+        type_ = uint8_t(t);
+        type_specific_ = 0;
+    }
+
+    //! Get block size in bytes, including header.
+    size_t size() const {
+        return (size_t(core::ntoh16(length_)) + 1) * 4;
+    }
+
+    //! Set block size in bytes, including header.
+    void set_size(size_t sz) {
+        roc_panic_if(sz < 4 || sz % 4 != 0 || sz / 4 - 1 > 0xffff);
+        length_ = core::hton16(uint16_t(sz / 4 - 1));
+    }
+};
+
+//! XR receiver reference time report block.
+//!
+//! @code
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |     BT=4      |   reserved    |       block length = 2        |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |              NTP timestamp, most significant word             |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |             NTP timestamp, least significant word             |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+class ROC_ATTR_PACKED XRRrtrBlock {
+private:
+    XRBlockHeader header_;
+    uint32_t ntp_msw_;
+    uint32_t ntp_lsw_;
+
+public:
+    //! Get block header.
+    XRBlockHeader& header() {
+        return header_;
+    }
+
+    //! Get block header.
+    const XRBlockHeader& header() const {
+        return header_;
+    }
+
+    //! Get NTP timestamp.
+    uint64_t ntp_timestamp() const {
+        return (uint64_t(core::ntoh32(ntp_msw_)) << 32) | core::ntoh32(ntp_lsw_);
+    }
+
+    //! Set NTP timestamp.
+    void set_ntp_timestamp(uint64_t t) {
+        ntp_msw_ = core::hton32(uint32_t(t >> 32));
+        ntp_lsw_ = core::hton32(uint32_t(t));
+    }
+};
+
+//! XR DLRR sub-block.
+//! @remarks
+//!  DLRR block consists of XR block header followed by one or more sub-blocks.
+//!
+//! @code
+//!   +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+//!   |                 SSRC_1 (SSRC of first receiver)               |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                         last RR (LRR)                         |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                   delay since last RR (DLRR)                  |
+//!   +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+//! @endcode
+class ROC_ATTR_PACKED XRDlrrSubblock {
+private:
+    uint32_t ssrc_;
+    uint32_t last_rr_;
+    uint32_t delay_last_rr_;
+
+public:
+    //! Get SSRC of receiver.
+    uint32_t ssrc() const {
+        return core::ntoh32(ssrc_);
+    }
+
+    //! Set SSRC of receiver.
+    void set_ssrc(uint32_t s) {
+        ssrc_ = core::hton32(s);
+    }
+
+    //! Get middle 32 bits of NTP timestamp of last RRTR.
+    uint32_t last_rr() const {
+        return core::ntoh32(last_rr_);
+    }
+
+    //! Set middle 32 bits of NTP timestamp of last RRTR.
+    void set_last_rr(uint32_t t) {
+        last_rr_ = core::hton32(t);
+    }
+
+    //! Get delay since last RRTR, in units of 1/65536 seconds.
+    uint32_t delay_last_rr() const {
+        return core::ntoh32(delay_last_rr_);
+    }
+
+    //! Set delay since last RRTR, in units of 1/65536 seconds.
+    void set_delay_last_rr(uint32_t d) {
+        delay_last_rr_ = core::hton32(d);
+    }
+};
+
+} // namespace rtcp
+} // namespace roc
+
+#endif // ROC_RTCP_HEADERS_H_
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtcp/ntp.h"
+
+namespace roc {
+namespace rtcp {
+
+namespace {
+
+// Seconds between 1 Jan 1900 and 1 Jan 1970.
+const uint64_t NtpUnixOffset = 2208988800ull;
+
+} // namespace
+
+ntp_timestamp_t unix_to_ntp(core::nanoseconds_t unix_time) {
+    if (unix_time < 0) {
+        unix_time = 0;
+    }
+
+    const uint64_t sec = uint64_t(unix_time / core::Second);
+    const uint64_t nsec = uint64_t(unix_time % core::Second);
+
+    return ((sec + NtpUnixOffset) << 32)
+        | ((nsec << 32) / uint64_t(core::Second) & 0xffffffff);
+}
+
+core::nanoseconds_t ntp_to_unix(ntp_timestamp_t ntp_time) {
+    const uint64_t sec = ntp_time >> 32;
+    const uint64_t frac = ntp_time & 0xffffffff;
+
+    if (sec < NtpUnixOffset) {
+        return 0;
+    }
+
+    return core::nanoseconds_t(sec - NtpUnixOffset) * core::Second
+        + core::nanoseconds_t((frac * uint64_t(core::Second)) >> 32);
+}
+
+uint32_t duration_to_ntp_short(core::nanoseconds_t duration) {
+    if (duration <= 0) {
+        return 0;
+    }
+
+    if (duration >= 65536 * core::Second) {
+        return 0xffffffff;
+    }
+
+    return uint32_t((uint64_t(duration) << 16) / uint64_t(core::Second));
+}
+
+core::nanoseconds_t ntp_short_to_duration(uint32_t ntp_short) {
+    return core::nanoseconds_t((uint64_t(ntp_short) * uint64_t(core::Second)) >> 16);
+}
+
+} // namespace rtcp
+} // namespace roc
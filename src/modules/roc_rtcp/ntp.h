@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtcp/ntp.h
+//! @brief NTP timestamps.
+
+#ifndef ROC_RTCP_NTP_H_
+#define ROC_RTCP_NTP_H_
+
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace rtcp {
+
+//! NTP timestamp.
+//! @remarks
+//!  64-bit fixed point number: seconds since 1 Jan 1900 in the high 32 bits
+//!  and fraction of second in the low 32 bits.
+typedef uint64_t ntp_timestamp_t;
+
+//! Convert Unix time in nanoseconds to NTP timestamp.
+ntp_timestamp_t unix_to_ntp(core::nanoseconds_t unix_time);
+
+//! Convert NTP timestamp to Unix time in nanoseconds.
+core::nanoseconds_t ntp_to_unix(ntp_timestamp_t ntp_time);
+
+//! Get middle 32 bits of NTP timestamp.
+//! @remarks
+//!  Used in LSR and LRR fields of reports.
+inline uint32_t ntp_middle(ntp_timestamp_t ntp_time) {
+    return uint32_t(ntp_time >> 16);
+}
+
+//! Convert duration to 16.16 fixed point number of seconds.
+//! @remarks
+//!  Used in DLSR and DLRR fields of reports. Negative durations are
+//!  clamped to zero.
+uint32_t duration_to_ntp_short(core::nanoseconds_t duration);
+
+//! Convert 16.16 fixed point number of seconds to duration.
+core::nanoseconds_t ntp_short_to_duration(uint32_t ntp_short);
+
+} // namespace rtcp
+} // namespace roc
+
+#endif // ROC_RTCP_NTP_H_
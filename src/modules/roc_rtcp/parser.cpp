@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtcp/parser.h"
+#include "roc_core/log.h"
+#include "roc_rtcp/headers.h"
+
+namespace roc {
+namespace rtcp {
+
+namespace {
+
+bool validate(const uint8_t* data, size_t size) {
+    if (size == 0) {
+        roc_log(LogDebug, "rtcp parser: bad packet, empty packet");
+        return false;
+    }
+
+    size_t off = 0;
+
+    while (off < size) {
+        if (size - off < sizeof(PacketHeader)) {
+            roc_log(LogDebug, "rtcp parser: bad packet, size < %d (rtcp header)",
+                    (int)sizeof(PacketHeader));
+            return false;
+        }
+
+        const PacketHeader& header = *(const PacketHeader*)(data + off);
+
+        if (header.version() != V2) {
+            roc_log(LogDebug, "rtcp parser: bad version, get %d, expected %d",
+                    (int)header.version(), (int)V2);
+            return false;
+        }
+
+        if (off == 0 && header.type() != RTCP_SR && header.type() != RTCP_RR) {
+            roc_log(LogDebug,
+                    "rtcp parser: bad packet, compound packet should start with SR or"
+                    " RR, get type %d",
+                    (int)header.type());
+            return false;
+        }
+
+        if (size - off < header.size()) {
+            roc_log(LogDebug, "rtcp parser: bad packet, size < %d (rtcp length)",
+                    (int)header.size());
+            return false;
+        }
+
+        off += header.size();
+
+        if (header.has_padding() && off != size) {
+            roc_log(LogDebug,
+                    "rtcp parser: bad packet, padding flag is set in non-last packet");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void parse_blocks(const uint8_t* data, size_t size, size_t count, Report& report) {
+    for (size_t n = 0; n < count; n++) {
+        if (size < sizeof(ReportBlock)) {
+            roc_log(LogDebug, "rtcp parser: truncated report block");
+            return;
+        }
+
+        if (report.num_blocks == Report::MaxBlocks) {
+            roc_log(LogDebug, "rtcp parser: dropping report block, too many blocks");
+            return;
+        }
+
+        const ReportBlock& src = *(const ReportBlock*)data;
+        ReceptionBlock& dst = report.blocks[report.num_blocks++];
+
+        dst.ssrc = src.ssrc();
+        dst.fraction_lost = src.fraction_lost();
+        dst.cumulative_lost = src.cumulative_lost();
+        dst.last_seqnum = src.last_seqnum();
+        dst.jitter = src.jitter();
+        dst.last_sr = src.last_sr();
+        dst.delay_last_sr = src.delay_last_sr();
+
+        data += sizeof(ReportBlock);
+        size -= sizeof(ReportBlock);
+    }
+}
+
+void parse_dlrr(const uint8_t* data, size_t size, Report& report) {
+    while (size >= sizeof(XRDlrrSubblock)) {
+        if (report.num_dlrr_blocks == Report::MaxDlrrBlocks) {
+            roc_log(LogDebug, "rtcp parser: dropping dlrr block, too many blocks");
+            return;
+        }
+
+        const XRDlrrSubblock& src = *(const XRDlrrSubblock*)data;
+        DlrrBlock& dst = report.dlrr_blocks[report.num_dlrr_blocks++];
+
+        dst.ssrc = src.ssrc();
+        dst.last_rr = src.last_rr();
+        dst.delay_last_rr = src.delay_last_rr();
+
+        data += sizeof(XRDlrrSubblock);
+        size -= sizeof(XRDlrrSubblock);
+    }
+}
+
+void parse_xr(const uint8_t* data, size_t size, Report& report) {
+    if (size < sizeof(XRPacket)) {
+        roc_log(LogDebug, "rtcp parser: truncated xr packet");
+        return;
+    }
+
+    data += sizeof(XRPacket);
+    size -= sizeof(XRPacket);
+
+    while (size >= sizeof(XRBlockHeader)) {
+        const XRBlockHeader& header = *(const XRBlockHeader*)data;
+
+        if (header.size() > size) {
+            roc_log(LogDebug, "rtcp parser: truncated xr block");
+            return;
+        }
+
+        switch (header.type()) {
+        case XR_RRTR:
+            if (header.size() >= sizeof(XRRrtrBlock)) {
+                report.has_rrtr = true;
+                report.rrtr_timestamp = ((const XRRrtrBlock*)data)->ntp_timestamp();
+            }
+            break;
+
+        case XR_DLRR:
+            parse_dlrr(data + sizeof(XRBlockHeader),
+                       header.size() - sizeof(XRBlockHeader), report);
+            break;
+
+        default:
+            break;
+        }
+
+        data += header.size();
+        size -= header.size();
+    }
+}
+
+} // namespace
+
+bool Parser::parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
+    if (!validate(buffer.data(), buffer.size())) {
+        return false;
+    }
+
+    packet.add_flags(packet::Packet::FlagControl);
+
+    return true;
+}
+
+bool Parser::parse_report(const core::Slice<uint8_t>& buffer, Report& report) {
+    const uint8_t* data = buffer.data();
+    const size_t size = buffer.size();
+
+    if (!validate(data, size)) {
+        return false;
+    }
+
+    report = Report();
+
+    for (size_t off = 0; off < size;) {
+        const PacketHeader& header = *(const PacketHeader*)(data + off);
+        const size_t pkt_size = header.size();
+
+        switch (header.type()) {
+        case RTCP_SR: {
+            if (pkt_size < sizeof(SenderReportPacket)) {
+                roc_log(LogDebug, "rtcp parser: truncated sr packet");
+                return false;
+            }
+
+            const SenderReportPacket& sr = *(const SenderReportPacket*)(data + off);
+
+            report.ssrc = sr.ssrc();
+            report.has_sender_info = true;
+            report.sender_info.ntp_timestamp = sr.ntp_timestamp();
+            report.sender_info.rtp_timestamp = sr.rtp_timestamp();
+            report.sender_info.packet_count = sr.packet_count();
+            report.sender_info.byte_count = sr.byte_count();
+
+            parse_blocks(data + off + sizeof(SenderReportPacket),
+                         pkt_size - sizeof(SenderReportPacket), header.counter(), report);
+        } break;
+
+        case RTCP_RR: {
+            if (pkt_size < sizeof(ReceiverReportPacket)) {
+                roc_log(LogDebug, "rtcp parser: truncated rr packet");
+                return false;
+            }
+
+            const ReceiverReportPacket& rr = *(const ReceiverReportPacket*)(data + off);
+
+            report.ssrc = rr.ssrc();
+
+            parse_blocks(data + off + sizeof(ReceiverReportPacket),
+                         pkt_size - sizeof(ReceiverReportPacket), header.counter(),
+                         report);
+        } break;
+
+        case RTCP_XR:
+            parse_xr(data + off, pkt_size, report);
+            break;
+
+        default:
+            break;
+        }
+
+        off += pkt_size;
+    }
+
+    return true;
+}
+
+} // namespace rtcp
+} // namespace roc
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtcp/parser.h
+//! @brief RTCP packet parser.
+
+#ifndef ROC_RTCP_PARSER_H_
+#define ROC_RTCP_PARSER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_packet/iparser.h"
+#include "roc_rtcp/report.h"
+
+namespace roc {
+namespace rtcp {
+
+//! RTCP packet parser.
+//! @remarks
+//!  Validates compound RTCP packet and marks it as a control packet.
+//!  The report itself is decoded later by parse_report(), when the
+//!  packet reaches its session.
+class Parser : public packet::IParser, public core::NonCopyable<> {
+public:
+    //! Parse packet from buffer.
+    virtual bool parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer);
+
+    //! Decode report from compound RTCP packet.
+    //! @remarks
+    //!  Fills @p report from SR, RR, and XR packets. Other packet types,
+    //!  like SDES and BYE, and unknown XR blocks are skipped. Blocks that
+    //!  don't fit into report are dropped.
+    //! @returns
+    //!  false if the packet is malformed or has no SR or RR packet.
+    static bool parse_report(const core::Slice<uint8_t>& buffer, Report& report);
+};
+
+} // namespace rtcp
+} // namespace roc
+
+#endif // ROC_RTCP_PARSER_H_
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtcp/receiver_reporter.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace rtcp {
+
+namespace {
+
+// Maximum seqnum distance that is considered a jump forward rather than a
+// reordered or duplicate packet.
+const uint32_t MaxDropout = 3000;
+
+} // namespace
+
+ReceiverReporter::ReceiverReporter(packet::source_t ssrc, size_t sample_rate)
+    : ssrc_(ssrc)
+    , sample_rate_(sample_rate)
+    , has_source_(false)
+    , source_(0)
+    , base_seqnum_(0)
+    , max_seqnum_(0)
+    , cycles_(0)
+    , received_(0)
+    , expected_prior_(0)
+    , received_prior_(0)
+    , last_transit_(0)
+    , jitter_(0)
+    , last_sr_(0)
+    , last_sr_time_(0)
+    , sr_rtp_timestamp_(0)
+    , sr_capture_time_(0) {
+    roc_panic_if(sample_rate == 0);
+}
+
+void ReceiverReporter::process_packet(const packet::Packet& packet,
+                                      core::nanoseconds_t now) {
+    const packet::RTP* rtp = packet.rtp();
+    if (!rtp || !(packet.flags() & packet::Packet::FlagAudio)) {
+        return;
+    }
+
+    const packet::timestamp_diff_t transit =
+        packet::timestamp_diff_t(to_rtp_units_(now) - rtp->timestamp);
+
+    if (!has_source_ || source_ != rtp->source) {
+        has_source_ = true;
+        source_ = rtp->source;
+        base_seqnum_ = max_seqnum_ = rtp->seqnum;
+        cycles_ = 0;
+        received_ = 0;
+        expected_prior_ = 0;
+        received_prior_ = 0;
+        last_transit_ = transit;
+        jitter_ = 0;
+    } else {
+        const uint16_t delta = uint16_t(rtp->seqnum - uint16_t(max_seqnum_));
+
+        if (delta < MaxDropout) {
+            if (rtp->seqnum < uint16_t(max_seqnum_)) {
+                cycles_ += 0x10000;
+            }
+            max_seqnum_ = rtp->seqnum;
+        }
+
+        const packet::timestamp_diff_t d = transit - last_transit_;
+        last_transit_ = transit;
+        jitter_ += (double(d < 0 ? -d : d) - jitter_) / 16.;
+    }
+
+    received_++;
+
+    stats_.num_packets++;
+    stats_.last_seqnum = cycles_ + max_seqnum_;
+    stats_.cumulative_lost =
+        int32_t(stats_.last_seqnum - base_seqnum_ + 1) - int32_t(received_);
+    stats_.jitter =
+        core::nanoseconds_t(jitter_ * double(core::Second) / double(sample_rate_));
+}
+
+void ReceiverReporter::process_report(const Report& report, core::nanoseconds_t now) {
+    if (report.has_sender_info && (!has_source_ || report.ssrc == source_)) {
+        last_sr_ = ntp_middle(report.sender_info.ntp_timestamp);
+        last_sr_time_ = now;
+        sr_rtp_timestamp_ = report.sender_info.rtp_timestamp;
+        sr_capture_time_ = ntp_to_unix(report.sender_info.ntp_timestamp);
+        stats_.num_reports++;
+    }
+
+    for (size_t n = 0; n < report.num_dlrr_blocks; n++) {
+        const DlrrBlock& block = report.dlrr_blocks[n];
+
+        if (block.ssrc != ssrc_ || block.last_rr == 0) {
+            continue;
+        }
+
+        const int32_t rtt = int32_t(ntp_middle(unix_to_ntp(now)) - block.last_rr
+                                    - block.delay_last_rr);
+        stats_.rtt = rtt > 0 ? ntp_short_to_duration(uint32_t(rtt)) : 0;
+    }
+}
+
+bool ReceiverReporter::has_source() const {
+    return has_source_;
+}
+
+void ReceiverReporter::generate(Report& report, core::nanoseconds_t now) {
+    roc_panic_if_not(has_source_);
+
+    report = Report();
+
+    report.ssrc = ssrc_;
+
+    const uint32_t extended_max = cycles_ + max_seqnum_;
+    const uint32_t expected = extended_max - base_seqnum_ + 1;
+
+    const uint32_t expected_interval = expected - expected_prior_;
+    const uint32_t received_interval = received_ - received_prior_;
+
+    expected_prior_ = expected;
+    received_prior_ = received_;
+
+    const int32_t lost_interval = int32_t(expected_interval - received_interval);
+
+    uint8_t fraction = 0;
+    if (expected_interval != 0 && lost_interval > 0) {
+        fraction = uint8_t((uint32_t(lost_interval) << 8) / expected_interval);
+    }
+
+    ReceptionBlock& block = report.blocks[report.num_blocks++];
+
+    block.ssrc = source_;
+    block.fraction_lost = fraction;
+    block.cumulative_lost = stats_.cumulative_lost;
+    block.last_seqnum = extended_max;
+    block.jitter = uint32_t(jitter_);
+
+    if (last_sr_time_ != 0) {
+        block.last_sr = last_sr_;
+        block.delay_last_sr = duration_to_ntp_short(now - last_sr_time_);
+    }
+
+    report.has_rrtr = true;
+    report.rrtr_timestamp = unix_to_ntp(now);
+}
+
+const ReceiverStats& ReceiverReporter::stats() const {
+    return stats_;
+}
+
+bool ReceiverReporter::get_mapping(packet::timestamp_t& rtp_timestamp,
+                                   core::nanoseconds_t& capture_time) const {
+    if (stats_.num_reports == 0) {
+        return false;
+    }
+
+    rtp_timestamp = sr_rtp_timestamp_;
+    capture_time = sr_capture_time_;
+    return true;
+}
+
+packet::timestamp_t ReceiverReporter::to_rtp_units_(core::nanoseconds_t time) const {
+    const uint64_t sec = uint64_t(time / core::Second);
+    const uint64_t nsec = uint64_t(time % core::Second);
+
+    return packet::timestamp_t(sec * sample_rate_
+                               + nsec * sample_rate_ / uint64_t(core::Second));
+}
+
+} // namespace rtcp
+} // namespace roc
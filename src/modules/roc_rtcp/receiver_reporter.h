@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtcp/receiver_reporter.h
+//! @brief Receiver-side RTCP reporter.
+
+#ifndef ROC_RTCP_RECEIVER_REPORTER_H_
+#define ROC_RTCP_RECEIVER_REPORTER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/time.h"
+#include "roc_packet/packet.h"
+#include "roc_rtcp/report.h"
+
+namespace roc {
+namespace rtcp {
+
+//! Receiver statistics, derived from received packets and sender reports.
+struct ReceiverStats {
+    //! Number of received audio packets.
+    //! @remarks
+    //!  If zero, other fields are not valid.
+    size_t num_packets;
+
+    //! Number of received sender reports.
+    size_t num_reports;
+
+    //! Cumulative number of packets lost.
+    int32_t cumulative_lost;
+
+    //! Extended highest sequence number received.
+    uint32_t last_seqnum;
+
+    //! Interarrival jitter.
+    core::nanoseconds_t jitter;
+
+    //! Round-trip time.
+    //! @remarks
+    //!  Zero until sender reports an RRTR that it got from us.
+    core::nanoseconds_t rtt;
+
+    ReceiverStats()
+        : num_packets(0)
+        , num_reports(0)
+        , cumulative_lost(0)
+        , last_seqnum(0)
+        , jitter(0)
+        , rtt(0) {
+    }
+};
+
+//! Receiver-side RTCP reporter.
+//! @remarks
+//!  Tracks sequence numbers and interarrival jitter of audio packets as
+//!  described in RFC 3550, appendices A.1, A.3, and A.8, and generates
+//!  receiver reports (RR) with RRTR blocks. Processes sender reports (SR)
+//!  and DLRR blocks.
+class ReceiverReporter : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p ssrc defines SSRC of the receiver
+    //!  - @p sample_rate defines RTP timestamp units
+    ReceiverReporter(packet::source_t ssrc, size_t sample_rate);
+
+    //! Account received audio packet.
+    //! @remarks
+    //!  @p now is wall clock time, in nanoseconds since Unix epoch, when
+    //!  the packet was received.
+    void process_packet(const packet::Packet& packet, core::nanoseconds_t now);
+
+    //! Process sender report.
+    //! @remarks
+    //!  @p now is wall clock time, in nanoseconds since Unix epoch, when
+    //!  the report was received.
+    void process_report(const Report& report, core::nanoseconds_t now);
+
+    //! Check whether at least one audio packet was received.
+    bool has_source() const;
+
+    //! Generate receiver report.
+    void generate(Report& report, core::nanoseconds_t now);
+
+    //! Get statistics.
+    const ReceiverStats& stats() const;
+
+    //! Get mapping between RTP timestamps and sender wall clock.
+    //! @remarks
+    //!  Returns RTP and NTP timestamps, the latter converted to nanoseconds
+    //!  since Unix epoch, from the last sender report.
+    //! @returns
+    //!  false if no sender report was received yet.
+    bool get_mapping(packet::timestamp_t& rtp_timestamp,
+                     core::nanoseconds_t& capture_time) const;
+
+private:
+    packet::timestamp_t to_rtp_units_(core::nanoseconds_t time) const;
+
+    const packet::source_t ssrc_;
+    const size_t sample_rate_;
+
+    bool has_source_;
+    packet::source_t source_;
+
+    uint32_t base_seqnum_;
+    uint32_t max_seqnum_;
+    uint32_t cycles_;
+
+    uint32_t received_;
+    uint32_t expected_prior_;
+    uint32_t received_prior_;
+
+    packet::timestamp_diff_t last_transit_;
+    double jitter_;
+
+    uint32_t last_sr_;
+    core::nanoseconds_t last_sr_time_;
+
+    packet::timestamp_t sr_rtp_timestamp_;
+    core::nanoseconds_t sr_capture_time_;
+
+    ReceiverStats stats_;
+};
+
+} // namespace rtcp
+} // namespace roc
+
+#endif // ROC_RTCP_RECEIVER_REPORTER_H_
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtcp/report.h
+//! @brief RTCP report.
+
+#ifndef ROC_RTCP_REPORT_H_
+#define ROC_RTCP_REPORT_H_
+
+#include "roc_core/stddefs.h"
+#include "roc_packet/units.h"
+#include "roc_rtcp/ntp.h"
+
+namespace roc {
+namespace rtcp {
+
+//! Sender information from SR packet.
+struct SenderInfo {
+    //! Wall clock time when the report was sent.
+    ntp_timestamp_t ntp_timestamp;
+
+    //! RTP timestamp corresponding to the same instant as NTP timestamp.
+    packet::timestamp_t rtp_timestamp;
+
+    //! Total number of RTP packets sent.
+    uint32_t packet_count;
+
+    //! Total number of payload octets sent.
+    uint32_t byte_count;
+};
+
+//! Reception report block from SR or RR packet.
+struct ReceptionBlock {
+    //! SSRC of the source this block is about.
+    packet::source_t ssrc;
+
+    //! Fraction of packets lost since previous report, multiplied by 256.
+    uint8_t fraction_lost;
+
+    //! Cumulative number of packets lost.
+    int32_t cumulative_lost;
+
+    //! Extended highest sequence number received.
+    uint32_t last_seqnum;
+
+    //! Interarrival jitter, in RTP timestamp units.
+    uint32_t jitter;
+
+    //! Middle 32 bits of NTP timestamp of last SR from the source.
+    uint32_t last_sr;
+
+    //! Delay since last SR, in units of 1/65536 seconds.
+    uint32_t delay_last_sr;
+};
+
+//! DLRR sub-block from XR packet.
+struct DlrrBlock {
+    //! SSRC of the receiver this block is about.
+    packet::source_t ssrc;
+
+    //! Middle 32 bits of NTP timestamp of last RRTR from the receiver.
+    uint32_t last_rr;
+
+    //! Delay since last RRTR, in units of 1/65536 seconds.
+    uint32_t delay_last_rr;
+};
+
+//! RTCP report.
+//! @remarks
+//!  Host-order representation of a compound RTCP packet consisting of
+//!  SR or RR packet and optional XR packet with RRTR and DLRR blocks.
+struct Report {
+    enum {
+        //! Maximum number of reception blocks.
+        MaxBlocks = 8,
+
+        //! Maximum number of DLRR sub-blocks.
+        MaxDlrrBlocks = 8
+    };
+
+    //! SSRC of the report originator.
+    packet::source_t ssrc;
+
+    //! Whether sender_info is present, i.e. report is SR.
+    bool has_sender_info;
+
+    //! Sender information.
+    SenderInfo sender_info;
+
+    //! Number of reception blocks.
+    size_t num_blocks;
+
+    //! Reception blocks.
+    ReceptionBlock blocks[MaxBlocks];
+
+    //! Whether rrtr_timestamp is present.
+    bool has_rrtr;
+
+    //! NTP timestamp from RRTR block.
+    ntp_timestamp_t rrtr_timestamp;
+
+    //! Number of DLRR sub-blocks.
+    size_t num_dlrr_blocks;
+
+    //! DLRR sub-blocks.
+    DlrrBlock dlrr_blocks[MaxDlrrBlocks];
+
+    //! Initialize empty report.
+    Report() {
+        memset(this, 0, sizeof(*this));
+    }
+};
+
+} // namespace rtcp
+} // namespace roc
+
+#endif // ROC_RTCP_REPORT_H_
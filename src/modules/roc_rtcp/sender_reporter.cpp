@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtcp/sender_reporter.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace rtcp {
+
+SenderReporter::SenderReporter(packet::IWriter& writer, size_t sample_rate)
+    : writer_(writer)
+    , sample_rate_(sample_rate)
+    , has_source_(false)
+    , source_(0)
+    , next_timestamp_(0)
+    , packet_count_(0)
+    , byte_count_(0)
+    , has_rrtr_(false)
+    , rrtr_ssrc_(0)
+    , rrtr_ntp_(0)
+    , rrtr_time_(0) {
+    roc_panic_if(sample_rate == 0);
+}
+
+void SenderReporter::write(const packet::PacketPtr& pp) {
+    account_(pp);
+
+    writer_.write(pp);
+}
+
+void SenderReporter::write_batch(const packet::PacketPtr* packets, size_t n_packets) {
+    for (size_t n = 0; n < n_packets; n++) {
+        account_(packets[n]);
+    }
+
+    writer_.write_batch(packets, n_packets);
+}
+
+void SenderReporter::account_(const packet::PacketPtr& pp) {
+    if (!pp) {
+        roc_panic("rtcp sender reporter: unexpected null packet");
+    }
+
+    const packet::RTP* rtp = pp->rtp();
+
+    if (rtp && (pp->flags() & packet::Packet::FlagAudio)) {
+        if (!has_source_ || source_ != rtp->source) {
+            has_source_ = true;
+            source_ = rtp->source;
+            packet_count_ = 0;
+            byte_count_ = 0;
+        }
+
+        next_timestamp_ = rtp->timestamp + rtp->duration;
+
+        packet_count_++;
+        byte_count_ += (uint32_t)rtp->payload.size();
+    }
+}
+
+bool SenderReporter::has_source() const {
+    return has_source_;
+}
+
+void SenderReporter::generate(Report& report, core::nanoseconds_t now) const {
+    roc_panic_if_not(has_source_);
+
+    report = Report();
+
+    report.ssrc = source_;
+    report.has_sender_info = true;
+    report.sender_info.ntp_timestamp = unix_to_ntp(now);
+    report.sender_info.rtp_timestamp = next_timestamp_;
+    report.sender_info.packet_count = packet_count_;
+    report.sender_info.byte_count = byte_count_;
+
+    if (has_rrtr_) {
+        report.num_dlrr_blocks = 1;
+        report.dlrr_blocks[0].ssrc = rrtr_ssrc_;
+        report.dlrr_blocks[0].last_rr = rrtr_ntp_;
+        report.dlrr_blocks[0].delay_last_rr = duration_to_ntp_short(now - rrtr_time_);
+    }
+}
+
+void SenderReporter::process(const Report& report, core::nanoseconds_t now) {
+    if (report.has_rrtr) {
+        has_rrtr_ = true;
+        rrtr_ssrc_ = report.ssrc;
+        rrtr_ntp_ = ntp_middle(report.rrtr_timestamp);
+        rrtr_time_ = now;
+    }
+
+    for (size_t n = 0; n < report.num_blocks; n++) {
+        const ReceptionBlock& block = report.blocks[n];
+
+        if (!has_source_ || block.ssrc != source_) {
+            continue;
+        }
+
+        stats_.num_reports++;
+        stats_.fraction_lost = float(block.fraction_lost) / 256;
+        stats_.cumulative_lost = block.cumulative_lost;
+        stats_.last_seqnum = block.last_seqnum;
+        stats_.jitter = core::nanoseconds_t(block.jitter) * core::Second
+            / core::nanoseconds_t(sample_rate_);
+
+        if (block.last_sr != 0) {
+            const int32_t rtt = int32_t(ntp_middle(unix_to_ntp(now)) - block.last_sr
+                                        - block.delay_last_sr);
+            stats_.rtt = rtt > 0 ? ntp_short_to_duration(uint32_t(rtt)) : 0;
+        }
+
+        roc_log(LogDebug,
+                "rtcp sender reporter: got report: ssrc=%lu lost=%d fraction=%.3f"
+                " jitter=%.3fms rtt=%.3fms",
+                (unsigned long)report.ssrc, (int)stats_.cumulative_lost,
+                (double)stats_.fraction_lost, (double)stats_.jitter / core::Millisecond,
+                (double)stats_.rtt / core::Millisecond);
+    }
+}
+
+const SenderStats& SenderReporter::stats() const {
+    return stats_;
+}
+
+} // namespace rtcp
+} // namespace roc
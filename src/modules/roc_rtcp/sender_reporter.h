@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtcp/sender_reporter.h
+//! @brief Sender-side RTCP reporter.
+
+#ifndef ROC_RTCP_SENDER_REPORTER_H_
+#define ROC_RTCP_SENDER_REPORTER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/time.h"
+#include "roc_packet/iwriter.h"
+#include "roc_rtcp/report.h"
+
+namespace roc {
+namespace rtcp {
+
+//! Sender statistics, derived from receiver reports.
+struct SenderStats {
+    //! Number of receiver reports processed.
+    //! @remarks
+    //!  If zero, other fields are not valid.
+    size_t num_reports;
+
+    //! Fraction of packets lost since previous report, in range [0; 1].
+    float fraction_lost;
+
+    //! Cumulative number of packets lost.
+    int32_t cumulative_lost;
+
+    //! Extended highest sequence number received.
+    uint32_t last_seqnum;
+
+    //! Interarrival jitter.
+    core::nanoseconds_t jitter;
+
+    //! Round-trip time.
+    //! @remarks
+    //!  Zero until receiver reports an SR that it got from us.
+    core::nanoseconds_t rtt;
+
+    SenderStats()
+        : num_reports(0)
+        , fraction_lost(0)
+        , cumulative_lost(0)
+        , last_seqnum(0)
+        , jitter(0)
+        , rtt(0) {
+    }
+};
+
+//! Sender-side RTCP reporter.
+//! @remarks
+//!  Passes audio packets to the underlying writer and accounts them to
+//!  produce sender reports (SR). Processes receiver reports (RR) and
+//!  derives sender statistics from them.
+class SenderReporter : public packet::IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p writer is used to write packets
+    //!  - @p sample_rate defines RTP timestamp units
+    SenderReporter(packet::IWriter& writer, size_t sample_rate);
+
+    //! Account packet and pass it to the writer.
+    virtual void write(const packet::PacketPtr& packet);
+
+    //! Account packets and pass them to the writer as a single batch.
+    virtual void write_batch(const packet::PacketPtr* packets, size_t n_packets);
+
+    //! Check whether at least one audio packet was written.
+    bool has_source() const;
+
+    //! Generate sender report.
+    //! @remarks
+    //!  @p now is wall clock time, in nanoseconds since Unix epoch. It's
+    //!  mapped to the RTP timestamp following the last written packet,
+    //!  so the report should be generated right after writing a frame.
+    void generate(Report& report, core::nanoseconds_t now) const;
+
+    //! Process receiver report.
+    //! @remarks
+    //!  @p now is wall clock time, in nanoseconds since Unix epoch, when
+    //!  the report was received.
+    void process(const Report& report, core::nanoseconds_t now);
+
+    //! Get statistics.
+    const SenderStats& stats() const;
+
+private:
+    void account_(const packet::PacketPtr& pp);
+
+    packet::IWriter& writer_;
+    const size_t sample_rate_;
+
+    bool has_source_;
+    packet::source_t source_;
+    packet::timestamp_t next_timestamp_;
+
+    uint32_t packet_count_;
+    uint32_t byte_count_;
+
+    bool has_rrtr_;
+    packet::source_t rrtr_ssrc_;
+    uint32_t rrtr_ntp_;
+    core::nanoseconds_t rrtr_time_;
+
+    SenderStats stats_;
+};
+
+} // namespace rtcp
+} // namespace roc
+
+#endif // ROC_RTCP_SENDER_REPORTER_H_
@@ -11,6 +11,7 @@
 #include "roc_audio/pcm_encoder.h"
 #include "roc_audio/pcm_funcs.h"
 #include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
 
 namespace roc {
 namespace rtp {
@@ -29,6 +30,8 @@ template <class I, class T> I* new_codec_pcm_int16_2ch(core::IAllocator& allocat
 
 FormatMap::FormatMap()
     : n_formats_(0) {
+    memset(index_, 0, sizeof(index_));
+
     {
         Format fmt;
         fmt.payload_type = PayloadType_L16_Mono;
@@ -58,18 +61,22 @@ FormatMap::FormatMap()
 }
 
 const Format* FormatMap::format(unsigned int pt) const {
-    for (size_t n = 0; n < n_formats_; n++) {
-        if ((unsigned int)formats_[n].payload_type == pt) {
-            return &formats_[n];
-        }
+    if (pt >= MaxPayloadTypes) {
+        return NULL;
     }
 
-    return NULL;
+    return index_[pt];
 }
 
 void FormatMap::add_(const Format& fmt) {
     roc_panic_if(n_formats_ == MaxFormats);
-    formats_[n_formats_++] = fmt;
+    roc_panic_if((unsigned int)fmt.payload_type >= MaxPayloadTypes);
+    roc_panic_if(index_[fmt.payload_type]);
+
+    formats_[n_formats_] = fmt;
+    index_[fmt.payload_type] = &formats_[n_formats_];
+
+    n_formats_++;
 }
 
 } // namespace rtp
@@ -24,17 +24,21 @@ public:
     FormatMap();
 
     //! Get format by payload type.
+    //! @remarks
+    //!  Performs a constant-time table lookup.
     //! @returns
     //!  pointer to the format structure or null if there is no format
     //!  registered for this payload type.
     const Format* format(unsigned int pt) const;
 
 private:
-    enum { MaxFormats = 2 };
+    enum { MaxFormats = 2, MaxPayloadTypes = 128 };
 
     Format formats_[MaxFormats];
     size_t n_formats_;
 
+    const Format* index_[MaxPayloadTypes];
+
     void add_(const Format& fmt);
 };
 
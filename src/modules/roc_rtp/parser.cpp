@@ -7,12 +7,37 @@
  */
 
 #include "roc_rtp/parser.h"
+#include "roc_core/endian.h"
 #include "roc_core/log.h"
+#include "roc_core/stddefs.h"
 #include "roc_rtp/headers.h"
 
 namespace roc {
 namespace rtp {
 
+namespace {
+
+// Layout of the first 32-bit word of the fixed RTP header, in host order.
+enum {
+    Word_VersionShift = 30,
+    Word_VersionMask = 0x3,
+
+    Word_PaddingBit = 1 << 29,
+    Word_ExtensionBit = 1 << 28,
+
+    Word_CSRCShift = 24,
+    Word_CSRCMask = 0xf,
+
+    Word_MarkerBit = 1 << 23,
+
+    Word_PayloadTypeShift = 16,
+    Word_PayloadTypeMask = 0x7f,
+
+    Word_SeqnumMask = 0xffff
+};
+
+} // namespace
+
 Parser::Parser(const FormatMap& format_map, packet::IParser* inner_parser)
     : format_map_(format_map)
     , inner_parser_(inner_parser) {
@@ -25,17 +50,30 @@ bool Parser::parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
         return false;
     }
 
-    const Header& header = *(const Header*)buffer.data();
+    // Load the whole fixed header at once and decode all fields from three
+    // host-order words, instead of byte-swapping every field separately.
+    uint32_t words[3];
+    memcpy(words, buffer.data(), sizeof(words));
+
+    const uint32_t word0 = core::ntoh32(words[0]);
 
-    if (header.version() != V2) {
-        roc_log(LogDebug, "rtp parser: bad version, get %d, expected %d",
-                (int)header.version(), (int)V2);
+    const unsigned int version = (word0 >> Word_VersionShift) & Word_VersionMask;
+
+    if (version != V2) {
+        roc_log(LogDebug, "rtp parser: bad version, get %d, expected %d", (int)version,
+                (int)V2);
         return false;
     }
 
-    size_t header_size = header.header_size();
+    const bool has_padding = (word0 & Word_PaddingBit);
+    const bool has_extension = (word0 & Word_ExtensionBit);
+
+    const size_t fixed_size =
+        sizeof(words) + ((word0 >> Word_CSRCShift) & Word_CSRCMask) * sizeof(uint32_t);
+
+    size_t header_size = fixed_size;
 
-    if (header.has_extension()) {
+    if (has_extension) {
         header_size += sizeof(ExtentionHeader);
     }
 
@@ -45,9 +83,9 @@ bool Parser::parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
         return false;
     }
 
-    if (header.has_extension()) {
+    if (has_extension) {
         const ExtentionHeader& extension =
-            *(const ExtentionHeader*)(buffer.data() + header.header_size());
+            *(const ExtentionHeader*)(buffer.data() + fixed_size);
 
         header_size += extension.data_size();
     }
@@ -64,7 +102,7 @@ bool Parser::parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
 
     uint8_t pad_size = 0;
 
-    if (header.has_padding()) {
+    if (has_padding) {
         if (payload_begin == payload_end) {
             roc_log(LogDebug,
                     "rtp parser: bad packet, empty payload but padding flag is set");
@@ -92,11 +130,11 @@ bool Parser::parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
 
     packet::RTP& rtp = *packet.rtp();
 
-    rtp.source = header.ssrc();
-    rtp.seqnum = header.seqnum();
-    rtp.timestamp = header.timestamp();
-    rtp.marker = header.marker();
-    rtp.payload_type = header.payload_type();
+    rtp.source = core::ntoh32(words[2]);
+    rtp.seqnum = packet::seqnum_t(word0 & Word_SeqnumMask);
+    rtp.timestamp = core::ntoh32(words[1]);
+    rtp.marker = (word0 & Word_MarkerBit);
+    rtp.payload_type = (word0 >> Word_PayloadTypeShift) & Word_PayloadTypeMask;
     rtp.header = buffer.range(0, header_size);
     rtp.payload = buffer.range(payload_begin, payload_end);
 
@@ -104,7 +142,7 @@ bool Parser::parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
         rtp.padding = buffer.range(payload_end, payload_end + pad_size);
     }
 
-    if (const Format* format = format_map_.format(header.payload_type())) {
+    if (const Format* format = format_map_.format(rtp.payload_type)) {
         packet.add_flags(format->flags);
         rtp.duration = (packet::timestamp_t)format->get_num_samples(rtp.payload.size());
     }
@@ -16,8 +16,13 @@ Validator::Validator(packet::IReader& reader,
                      const ValidatorConfig& config,
                      size_t sample_rate)
     : reader_(reader)
-    , config_(config)
-    , sample_rate_(sample_rate) {
+    , has_prev_(false)
+    , prev_source_(0)
+    , prev_payload_type_(0)
+    , prev_seqnum_(0)
+    , prev_timestamp_(0)
+    , max_sn_jump_(config.max_sn_jump)
+    , max_ts_jump_(packet::timestamp_from_ns(config.max_ts_jump, sample_rate)) {
 }
 
 packet::PacketPtr Validator::read() {
@@ -32,61 +37,58 @@ packet::PacketPtr Validator::read() {
         return NULL;
     }
 
-    const packet::RTP* prev_rtp = NULL;
-    if (prev_packet_) {
-        prev_rtp = prev_packet_->rtp();
-    }
-
-    if (prev_rtp && !check_(*prev_rtp, *next_rtp)) {
+    if (has_prev_ && !check_(*next_rtp)) {
         return NULL;
     }
 
-    if (!prev_rtp || prev_rtp->compare(*next_rtp) < 0) {
-        prev_packet_ = next_packet;
+    if (!has_prev_ || packet::seqnum_lt(prev_seqnum_, next_rtp->seqnum)) {
+        has_prev_ = true;
+        prev_source_ = next_rtp->source;
+        prev_payload_type_ = next_rtp->payload_type;
+        prev_seqnum_ = next_rtp->seqnum;
+        prev_timestamp_ = next_rtp->timestamp;
     }
 
     return next_packet;
 }
 
-bool Validator::check_(const packet::RTP& prev, const packet::RTP& next) const {
-    if (prev.source != next.source) {
+bool Validator::check_(const packet::RTP& next) const {
+    if (prev_source_ != next.source) {
         roc_log(LogDebug, "rtp validator: source id jump: prev=%lu next=%lu",
-                (unsigned long)prev.source, (unsigned long)next.source);
+                (unsigned long)prev_source_, (unsigned long)next.source);
         return false;
     }
 
-    if (next.payload_type != prev.payload_type) {
+    if (next.payload_type != prev_payload_type_) {
         roc_log(LogDebug, "rtp validator: payload type jump: prev=%u, next=%u",
-                (unsigned)prev.payload_type, (unsigned)next.payload_type);
+                (unsigned)prev_payload_type_, (unsigned)next.payload_type);
         return false;
     }
 
-    packet::seqnum_diff_t sn_dist = packet::seqnum_diff(next.seqnum, prev.seqnum);
+    packet::seqnum_diff_t sn_dist = packet::seqnum_diff(next.seqnum, prev_seqnum_);
     if (sn_dist < 0) {
         sn_dist = -sn_dist;
     }
 
-    if ((size_t)sn_dist > config_.max_sn_jump) {
+    if ((size_t)sn_dist > max_sn_jump_) {
         roc_log(LogDebug,
                 "rtp validator: too long seqnum jump: prev=%lu next=%lu dist=%lu",
-                (unsigned long)prev.seqnum, (unsigned long)next.seqnum,
+                (unsigned long)prev_seqnum_, (unsigned long)next.seqnum,
                 (unsigned long)sn_dist);
         return false;
     }
 
     packet::timestamp_diff_t ts_dist =
-        packet::timestamp_diff(next.timestamp, prev.timestamp);
+        packet::timestamp_diff(next.timestamp, prev_timestamp_);
     if (ts_dist < 0) {
         ts_dist = -ts_dist;
     }
 
-    const core::nanoseconds_t ts_dist_ns = packet::timestamp_to_ns(ts_dist, sample_rate_);
-
-    if (ts_dist_ns > config_.max_ts_jump) {
+    if (ts_dist > max_ts_jump_) {
         roc_log(LogDebug,
                 "rtp validator:"
                 " too long timestamp jump: prev=%lu next=%lu dist=%lu",
-                (unsigned long)prev.timestamp, (unsigned long)next.timestamp,
+                (unsigned long)prev_timestamp_, (unsigned long)next.timestamp,
                 (unsigned long)ts_dist);
         return false;
     }
@@ -15,6 +15,7 @@
 #include "roc_core/noncopyable.h"
 #include "roc_core/time.h"
 #include "roc_packet/ireader.h"
+#include "roc_packet/units.h"
 
 namespace roc {
 namespace rtp {
@@ -51,13 +52,18 @@ public:
     virtual packet::PacketPtr read();
 
 private:
-    bool check_(const packet::RTP& prev, const packet::RTP& next) const;
+    bool check_(const packet::RTP& next) const;
 
     packet::IReader& reader_;
-    packet::PacketPtr prev_packet_;
 
-    const ValidatorConfig config_;
-    const size_t sample_rate_;
+    bool has_prev_;
+    packet::source_t prev_source_;
+    unsigned int prev_payload_type_;
+    packet::seqnum_t prev_seqnum_;
+    packet::timestamp_t prev_timestamp_;
+
+    const size_t max_sn_jump_;
+    const packet::timestamp_diff_t max_ts_jump_;
 };
 
 } // namespace rtp
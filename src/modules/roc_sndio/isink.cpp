@@ -14,5 +14,12 @@ namespace sndio {
 ISink::~ISink() {
 }
 
+bool ISink::start_pull(ISource&) {
+    return false;
+}
+
+void ISink::stop_pull() {
+}
+
 } // namespace sndio
 } // namespace roc
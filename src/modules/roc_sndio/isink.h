@@ -13,6 +13,8 @@
 #define ROC_SNDIO_ISINK_H_
 
 #include "roc_audio/iwriter.h"
+#include "roc_core/time.h"
+#include "roc_sndio/isource.h"
 
 namespace roc {
 namespace sndio {
@@ -27,6 +29,29 @@ public:
 
     //! Check if the sink has own clock.
     virtual bool has_clock() const = 0;
+
+    //! Get playback latency of the sink.
+    //! @returns
+    //!  the delay between writing a frame and playing its first sample, or
+    //!  zero if the sink does not play sound or can't measure the delay.
+    virtual core::nanoseconds_t latency() const = 0;
+
+    //! Start pulling frames from source.
+    //! @remarks
+    //!  Sinks that have own clock may support pull mode. In this mode, the sink
+    //!  reads frames from @p source by itself, from its own thread, exactly when
+    //!  the device requests more samples, and reclocks the source after every
+    //!  frame. If the source returns false from read(), the sink plays silence.
+    //!  write() should not be called until stop_pull().
+    //! @returns
+    //!  false if the sink does not support pull mode. Default implementation
+    //!  always returns false.
+    virtual bool start_pull(ISource& source);
+
+    //! Stop pulling frames from source.
+    //! @remarks
+    //!  Blocks until the sink stops accessing the source passed to start_pull().
+    virtual void stop_pull();
 };
 
 } // namespace sndio
@@ -13,6 +13,7 @@
 #define ROC_SNDIO_ISOURCE_H_
 
 #include "roc_audio/frame.h"
+#include "roc_core/time.h"
 
 namespace roc {
 namespace sndio {
@@ -49,6 +50,13 @@ public:
     //! @returns
     //!  false if there is nothing to read anymore.
     virtual bool read(audio::Frame&) = 0;
+
+    //! Adjust source clock to match playback time.
+    //! @remarks
+    //!  @p playback_time is wall clock time, in nanoseconds since Unix epoch,
+    //!  when the first sample of the next frame returned by read() is expected
+    //!  to be played. Sources that don't care about it may ignore the call.
+    virtual void reclock(core::nanoseconds_t playback_time) = 0;
 };
 
 } // namespace sndio
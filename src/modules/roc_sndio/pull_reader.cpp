@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <string.h>
+
+#include "roc_audio/frame.h"
+#include "roc_core/panic.h"
+#include "roc_packet/units.h"
+#include "roc_sndio/pull_reader.h"
+
+namespace roc {
+namespace sndio {
+
+PullReader::PullReader(size_t frame_size, size_t num_channels)
+    : frame_size_(frame_size)
+    , num_channels_(num_channels) {
+}
+
+bool PullReader::read(ISource& source,
+                      audio::sample_t* data,
+                      size_t size,
+                      size_t sample_rate,
+                      core::nanoseconds_t playback_time) {
+    if (frame_size_ == 0 || num_channels_ == 0) {
+        roc_panic("pull reader: frame size and # of channels should be positive");
+    }
+
+    for (size_t pos = 0; pos < size;) {
+        audio::Frame frame(data + pos, std::min(frame_size_, size - pos));
+
+        if (!source.read(frame)) {
+            memset(data + pos, 0, (size - pos) * sizeof(audio::sample_t));
+            return false;
+        }
+
+        pos += frame.size();
+
+        playback_time += packet::timestamp_to_ns(
+            packet::timestamp_diff_t(frame.size() / num_channels_), sample_rate);
+
+        source.reclock(playback_time);
+    }
+
+    return true;
+}
+
+} // namespace sndio
+} // namespace roc
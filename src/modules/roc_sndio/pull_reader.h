@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_sndio/pull_reader.h
+//! @brief Pull mode reader.
+
+#ifndef ROC_SNDIO_PULL_READER_H_
+#define ROC_SNDIO_PULL_READER_H_
+
+#include "roc_audio/units.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_sndio/isource.h"
+
+namespace roc {
+namespace sndio {
+
+//! Pull mode reader.
+//! @remarks
+//!  Used by sinks in pull mode to fill device buffers from the source.
+class PullReader : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  @p frame_size is the maximum number of samples for all channels
+    //!  passed to a single source read.
+    PullReader(size_t frame_size, size_t num_channels);
+
+    //! Fill buffer from source.
+    //! @remarks
+    //!  Reads frames from @p source into @p data until it is filled and
+    //!  reclocks the source after every frame. @p playback_time is the time
+    //!  when the first sample of @p data will be played. If the source returns
+    //!  false, the rest of the buffer is filled with silence.
+    //! @returns
+    //!  false if the source returned false.
+    bool read(ISource& source,
+              audio::sample_t* data,
+              size_t size,
+              size_t sample_rate,
+              core::nanoseconds_t playback_time);
+
+private:
+    const size_t frame_size_;
+    const size_t num_channels_;
+};
+
+} // namespace sndio
+} // namespace roc
+
+#endif // ROC_SNDIO_PULL_READER_H_
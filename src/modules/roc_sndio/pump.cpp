@@ -8,6 +8,7 @@
 
 #include "roc_sndio/pump.h"
 #include "roc_core/log.h"
+#include "roc_core/time.h"
 
 namespace roc {
 namespace sndio {
@@ -16,11 +17,14 @@ Pump::Pump(core::BufferPool<audio::sample_t>& buffer_pool,
            ISource& source,
            ISink& sink,
            size_t frame_size,
-           Mode mode)
+           Mode mode,
+           Drive drive)
     : source_(source)
     , sink_(sink)
     , n_bufs_(0)
     , oneshot_(mode == ModeOneshot)
+    , pull_(drive == DrivePull)
+    , eof_(false)
     , stop_(0) {
     if (buffer_pool.buffer_size() < frame_size) {
         roc_log(LogError, "pump: buffer size is too small: required=%lu actual=%lu",
@@ -43,16 +47,22 @@ bool Pump::valid() const {
 }
 
 bool Pump::run() {
+    if (pull_) {
+        if (sink_.start_pull(*this)) {
+            return run_pull_();
+        }
+        roc_log(LogInfo, "pump: sink does not support pull mode, using push mode");
+    }
+
+    return run_push_();
+}
+
+bool Pump::run_push_() {
     roc_log(LogDebug, "pump: starting main loop");
 
     while (!stop_) {
-        if (source_.state() == ISource::Inactive) {
-            if (oneshot_ && n_bufs_ != 0) {
-                roc_log(LogInfo, "pump: got inactive status in oneshot mode");
-                break;
-            }
-        } else {
-            n_bufs_++;
+        if (!check_state_()) {
+            break;
         }
 
         audio::Frame frame(frame_buffer_.data(), frame_buffer_.size());
@@ -62,6 +72,8 @@ bool Pump::run() {
         }
 
         sink_.write(frame);
+
+        source_.reclock(core::timestamp_unix() + sink_.latency());
     }
 
     roc_log(LogDebug, "pump: exiting main loop, wrote %lu buffers",
@@ -70,8 +82,78 @@ bool Pump::run() {
     return !stop_;
 }
 
+bool Pump::run_pull_() {
+    roc_log(LogDebug, "pump: sink started pulling frames");
+
+    done_.wait();
+
+    sink_.stop_pull();
+
+    roc_log(LogDebug, "pump: sink stopped pulling frames, read %lu buffers",
+            (unsigned long)n_bufs_);
+
+    return !stop_;
+}
+
+bool Pump::check_state_() {
+    if (source_.state() == ISource::Inactive) {
+        if (oneshot_ && n_bufs_ != 0) {
+            roc_log(LogInfo, "pump: got inactive status in oneshot mode");
+            return false;
+        }
+    } else {
+        n_bufs_++;
+    }
+
+    return true;
+}
+
+size_t Pump::sample_rate() const {
+    return source_.sample_rate();
+}
+
+bool Pump::has_clock() const {
+    return source_.has_clock();
+}
+
+ISource::State Pump::state() const {
+    return source_.state();
+}
+
+void Pump::wait_active() const {
+    source_.wait_active();
+}
+
+bool Pump::read(audio::Frame& frame) {
+    if (eof_) {
+        return false;
+    }
+
+    if (!stop_ && check_state_()) {
+        if (source_.read(frame)) {
+            return true;
+        }
+        roc_log(LogDebug, "pump: got eof from source");
+    }
+
+    // Wake up run(), the sink plays silence until stop_pull() is called.
+    eof_ = true;
+    done_.post();
+
+    return false;
+}
+
+void Pump::reclock(core::nanoseconds_t playback_time) {
+    if (eof_) {
+        return;
+    }
+
+    source_.reclock(playback_time);
+}
+
 void Pump::stop() {
     stop_ = 1;
+    done_.post();
 }
 
 } // namespace sndio
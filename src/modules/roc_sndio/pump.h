@@ -15,6 +15,7 @@
 #include "roc_core/atomic.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/semaphore.h"
 #include "roc_core/slice.h"
 #include "roc_core/stddefs.h"
 #include "roc_sndio/isink.h"
@@ -26,7 +27,7 @@ namespace sndio {
 //! Audio pump.
 //! @remarks
 //!  Reads frames from source and writes them to sink.
-class Pump : public core::NonCopyable<> {
+class Pump : public core::NonCopyable<>, private ISource {
 public:
     //! Pump mode.
     enum Mode {
@@ -37,12 +38,23 @@ public:
         ModeOneshot = 1
     };
 
+    //! Pump drive.
+    enum Drive {
+        // Pump thread reads frames from the source and writes them to the sink.
+        DrivePush = 0,
+
+        // Sink reads frames from the source by itself, if it supports pull mode;
+        // the pump thread just waits. Falls back to DrivePush otherwise.
+        DrivePull = 1
+    };
+
     //! Initialize.
     Pump(core::BufferPool<audio::sample_t>& buffer_pool,
          ISource& source,
          ISink& sink,
          size_t frame_size,
-         Mode mode);
+         Mode mode,
+         Drive drive = DrivePush);
 
     //! Check if the object was successfulyl constructed.
     bool valid() const;
@@ -50,7 +62,8 @@ public:
     //! Run the pump.
     //! @remarks
     //!  Run until the stop() is called or, if oneshot mode is enabled,
-    //!  the source becomes inactive.
+    //!  the source becomes inactive. In pull mode, the frames are read by
+    //!  the sink thread, and the calling thread just waits.
     bool run();
 
     //! Stop the pump.
@@ -59,6 +72,19 @@ public:
     void stop();
 
 private:
+    // Source passed to the sink in pull mode, forwards to source_.
+    virtual size_t sample_rate() const;
+    virtual bool has_clock() const;
+    virtual State state() const;
+    virtual void wait_active() const;
+    virtual bool read(audio::Frame& frame);
+    virtual void reclock(core::nanoseconds_t playback_time);
+
+    bool run_push_();
+    bool run_pull_();
+
+    bool check_state_();
+
     ISource& source_;
     ISink& sink_;
 
@@ -66,6 +92,10 @@ private:
 
     size_t n_bufs_;
     const bool oneshot_;
+    const bool pull_;
+
+    bool eof_;
+    core::Semaphore done_;
 
     core::Atomic stop_;
 };
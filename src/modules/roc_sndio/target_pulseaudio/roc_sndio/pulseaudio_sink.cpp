@@ -26,6 +26,8 @@ const core::nanoseconds_t DefaultLatency = core::Millisecond * 60;
 const core::nanoseconds_t MinTimeout = core::Millisecond * 50;
 const core::nanoseconds_t MaxTimeout = core::Second * 2;
 
+const core::nanoseconds_t RestartInterval = core::Second;
+
 } // namespace
 
 PulseaudioSink::PulseaudioSink(const Config& config)
@@ -35,12 +37,17 @@ PulseaudioSink::PulseaudioSink(const Config& config)
     , frame_size_(config.frame_size)
     , open_done_(false)
     , opened_(false)
+    , restarting_(false)
     , mainloop_(NULL)
     , context_(NULL)
     , sink_info_op_(NULL)
     , stream_(NULL)
     , timer_(NULL)
+    , restart_timer_(NULL)
+    , pull_source_(NULL)
+    , pull_reader_(config.frame_size, num_channels_)
     , timer_deadline_(0)
+    , cached_latency_(0)
     , rate_limiter_(ReportInterval) {
     if (config.latency != 0) {
         latency_ = config.latency;
@@ -104,6 +111,14 @@ bool PulseaudioSink::has_clock() const {
     return true;
 }
 
+core::nanoseconds_t PulseaudioSink::latency() const {
+    ensure_started_();
+
+    core::Mutex::Lock lock(latency_mutex_);
+
+    return cached_latency_;
+}
+
 void PulseaudioSink::write(audio::Frame& frame) {
     ensure_started_();
 
@@ -118,6 +133,44 @@ void PulseaudioSink::write(audio::Frame& frame) {
     }
 }
 
+bool PulseaudioSink::start_pull(ISource& source) {
+    ensure_started_();
+
+    pa_threaded_mainloop_lock(mainloop_);
+
+    ensure_opened_();
+
+    roc_log(LogDebug, "pulseaudio sink: starting pull mode");
+
+    pull_source_ = &source;
+
+    // The stream may have requested samples before pull mode was started,
+    // in which case the write callback won't be invoked until they're written.
+    if (stream_) {
+        const size_t writable_size = pa_stream_writable_size(stream_);
+
+        if (writable_size != (size_t)-1 && writable_size != 0) {
+            pull_frames_(writable_size);
+        }
+    }
+
+    pa_threaded_mainloop_unlock(mainloop_);
+
+    return true;
+}
+
+void PulseaudioSink::stop_pull() {
+    ensure_started_();
+
+    pa_threaded_mainloop_lock(mainloop_);
+
+    roc_log(LogDebug, "pulseaudio sink: stopping pull mode");
+
+    pull_source_ = NULL;
+
+    pa_threaded_mainloop_unlock(mainloop_);
+}
+
 bool PulseaudioSink::write_frame_(audio::Frame& frame) {
     const audio::sample_t* data = frame.data();
     size_t size = frame.size();
@@ -140,6 +193,56 @@ bool PulseaudioSink::write_frame_(audio::Frame& frame) {
     return true;
 }
 
+bool PulseaudioSink::pull_frames_(size_t size) {
+    const size_t sample_frame_size = num_channels_ * sizeof(audio::sample_t);
+
+    // Time when the first sample written now will be played.
+    const core::nanoseconds_t latency = stream_latency_();
+    update_latency_(latency);
+
+    core::nanoseconds_t playback_time = core::timestamp_unix() + latency;
+
+    while (size >= sample_frame_size) {
+        void* buf = NULL;
+        size_t buf_size = size;
+
+        if (int err = pa_stream_begin_write(stream_, &buf, &buf_size)) {
+            roc_log(LogError, "pulseaudio sink: pa_stream_begin_write(): %s",
+                    pa_strerror(err));
+            return false;
+        }
+
+        buf_size -= buf_size % sample_frame_size;
+
+        if (!buf || buf_size == 0) {
+            pa_stream_cancel_write(stream_);
+            break;
+        }
+
+        const size_t n_samples = buf_size / sizeof(audio::sample_t);
+
+        pull_reader_.read(*pull_source_, (audio::sample_t*)buf, n_samples, sample_rate_,
+                          playback_time);
+
+        playback_time += packet::timestamp_to_ns(
+            packet::timestamp_diff_t(n_samples / num_channels_), sample_rate_);
+
+        roc_log(LogTrace, "pulseaudio sink: pull: requested_size=%lu written_size=%lu",
+                (unsigned long)(size / sizeof(audio::sample_t)),
+                (unsigned long)n_samples);
+
+        if (int err =
+                pa_stream_write(stream_, buf, buf_size, NULL, 0, PA_SEEK_RELATIVE)) {
+            roc_log(LogError, "pulseaudio sink: pa_stream_write(): %s", pa_strerror(err));
+            return false;
+        }
+
+        size -= buf_size;
+    }
+
+    return true;
+}
+
 bool PulseaudioSink::check_params_() const {
     if (num_channels_ == 0) {
         roc_log(LogError, "pulseaudio sink: # of channels is zero");
@@ -221,6 +324,7 @@ void PulseaudioSink::close_() {
 
     pa_threaded_mainloop_lock(mainloop_);
 
+    cancel_restart_();
     stop_timer_();
     close_stream_();
     cancel_sink_info_op_();
@@ -228,11 +332,25 @@ void PulseaudioSink::close_() {
 
     open_done_ = false;
     opened_ = false;
+    restarting_ = false;
 
     pa_threaded_mainloop_unlock(mainloop_);
 }
 
 void PulseaudioSink::set_opened_(bool opened) {
+    if (restarting_) {
+        if (opened) {
+            roc_log(LogInfo, "pulseaudio sink: successfully restarted stream");
+
+            restarting_ = false;
+        } else {
+            roc_log(LogError, "pulseaudio sink: failed to restart stream");
+
+            schedule_restart_();
+        }
+        return;
+    }
+
     if (opened) {
         roc_log(LogTrace, "pulseaudio sink: successfully opened sink");
     } else {
@@ -245,6 +363,64 @@ void PulseaudioSink::set_opened_(bool opened) {
     pa_threaded_mainloop_signal(mainloop_, 0);
 }
 
+void PulseaudioSink::handle_failure_() {
+    if (!pull_source_) {
+        // In push mode, write() finds that the stream is broken and restarts it.
+        pa_threaded_mainloop_signal(mainloop_, 0);
+        return;
+    }
+
+    roc_log(LogInfo, "pulseaudio sink: stream failed in pull mode, restarting stream");
+
+    restart_();
+}
+
+void PulseaudioSink::restart_() {
+    restarting_ = true;
+
+    cancel_restart_();
+    stop_timer_();
+    close_stream_();
+    cancel_sink_info_op_();
+    close_context_();
+
+    // Callbacks finish the restart asynchronously and call set_opened_().
+    if (!open_context_()) {
+        schedule_restart_();
+    }
+}
+
+void PulseaudioSink::schedule_restart_() {
+    roc_log(LogDebug, "pulseaudio sink: scheduling stream restart: interval=%lums",
+            (unsigned long)(RestartInterval / core::Millisecond));
+
+    pa_mainloop_api* api = pa_threaded_mainloop_get_api(mainloop_);
+
+    struct timeval tv;
+    pa_gettimeofday(&tv);
+    pa_timeval_add(&tv, (pa_usec_t)(RestartInterval / core::Microsecond));
+
+    if (!restart_timer_) {
+        restart_timer_ = api->time_new(api, &tv, restart_timer_cb_, this);
+        if (!restart_timer_) {
+            roc_panic("pulseaudio sink: can't create restart timer");
+        }
+    } else {
+        api->time_restart(restart_timer_, &tv);
+    }
+}
+
+void PulseaudioSink::cancel_restart_() {
+    if (!restart_timer_) {
+        return;
+    }
+
+    pa_mainloop_api* api = pa_threaded_mainloop_get_api(mainloop_);
+    api->time_free(restart_timer_);
+
+    restart_timer_ = NULL;
+}
+
 bool PulseaudioSink::open_context_() {
     roc_log(LogTrace, "pulseaudio sink: opening context");
 
@@ -271,6 +447,7 @@ void PulseaudioSink::close_context_() {
 
     roc_log(LogTrace, "pulseaudio sink: closing context");
 
+    pa_context_set_state_callback(context_, NULL, NULL);
     pa_context_disconnect(context_);
     pa_context_unref(context_);
 
@@ -282,12 +459,16 @@ void PulseaudioSink::context_state_cb_(pa_context* context, void* userdata) {
 
     PulseaudioSink& self = *(PulseaudioSink*)userdata;
 
-    if (self.opened_) {
+    const pa_context_state_t state = pa_context_get_state(context);
+
+    if (self.opened_ && !self.restarting_) {
+        if (state == PA_CONTEXT_FAILED || state == PA_CONTEXT_TERMINATED) {
+            roc_log(LogError, "pulseaudio sink: context failed");
+            self.handle_failure_();
+        }
         return;
     }
 
-    const pa_context_state_t state = pa_context_get_state(context);
-
     switch ((unsigned)state) {
     case PA_CONTEXT_READY:
         roc_log(LogTrace, "pulseaudio sink: successfully opened context");
@@ -419,15 +600,25 @@ void PulseaudioSink::close_stream_() {
 
     roc_log(LogTrace, "pulseaudio sink: closing stream");
 
+    pa_stream_set_state_callback(stream_, NULL, NULL);
+    pa_stream_set_write_callback(stream_, NULL, NULL);
+    pa_stream_set_latency_update_callback(stream_, NULL, NULL);
+
     pa_stream_disconnect(stream_);
     pa_stream_unref(stream_);
 
     stream_ = NULL;
+
+    update_latency_(0);
 }
 
 ssize_t PulseaudioSink::write_stream_(const audio::sample_t* data, size_t size) {
     ensure_opened_();
 
+    if (!stream_ || restarting_) {
+        return -1;
+    }
+
     ssize_t writable_size = wait_stream_();
 
     if (writable_size == -1) {
@@ -496,17 +687,46 @@ ssize_t PulseaudioSink::wait_stream_() {
     }
 }
 
+core::nanoseconds_t PulseaudioSink::stream_latency_() const {
+    if (!stream_) {
+        return 0;
+    }
+
+    pa_usec_t latency_us = 0;
+    int negative = 0;
+
+    if (pa_stream_get_latency(stream_, &latency_us, &negative) != 0) {
+        return 0;
+    }
+
+    if (negative) {
+        return 0;
+    }
+
+    return (core::nanoseconds_t)latency_us * core::Microsecond;
+}
+
+void PulseaudioSink::update_latency_(core::nanoseconds_t latency) {
+    core::Mutex::Lock lock(latency_mutex_);
+
+    cached_latency_ = latency;
+}
+
 void PulseaudioSink::stream_state_cb_(pa_stream* stream, void* userdata) {
     roc_log(LogTrace, "pulseaudio sink: stream state callback");
 
     PulseaudioSink& self = *(PulseaudioSink*)userdata;
 
-    if (self.opened_) {
+    const pa_stream_state_t state = pa_stream_get_state(stream);
+
+    if (self.opened_ && !self.restarting_) {
+        if (state == PA_STREAM_FAILED || state == PA_STREAM_TERMINATED) {
+            roc_log(LogError, "pulseaudio sink: stream failed");
+            self.handle_failure_();
+        }
         return;
     }
 
-    const pa_stream_state_t state = pa_stream_get_state(stream);
-
     switch ((unsigned)state) {
     case PA_STREAM_READY:
         roc_log(LogTrace, "pulseaudio sink: successfully opened stream");
@@ -532,9 +752,18 @@ void PulseaudioSink::stream_write_cb_(pa_stream*, size_t length, void* userdata)
 
     PulseaudioSink& self = *(PulseaudioSink*)userdata;
 
-    if (length != 0) {
-        pa_threaded_mainloop_signal(self.mainloop_, 0);
+    if (length == 0) {
+        return;
+    }
+
+    if (self.pull_source_) {
+        if (!self.pull_frames_(length)) {
+            roc_log(LogError, "pulseaudio sink: can't pull frames");
+        }
+        return;
     }
+
+    pa_threaded_mainloop_signal(self.mainloop_, 0);
 }
 
 void PulseaudioSink::stream_latency_cb_(pa_stream* stream, void* userdata) {
@@ -542,6 +771,8 @@ void PulseaudioSink::stream_latency_cb_(pa_stream* stream, void* userdata) {
 
     PulseaudioSink& self = *(PulseaudioSink*)userdata;
 
+    self.update_latency_(self.stream_latency_());
+
     if (!self.rate_limiter_.allow()) {
         return;
     }
@@ -586,7 +817,7 @@ void PulseaudioSink::start_timer_(core::nanoseconds_t timeout) {
 }
 
 bool PulseaudioSink::stop_timer_() {
-    if (!timer_) {
+    if (!timer_ || !context_) {
         return false;
     }
 
@@ -608,5 +839,16 @@ void PulseaudioSink::timer_cb_(pa_mainloop_api*,
     pa_threaded_mainloop_signal(self.mainloop_, 0);
 }
 
+void PulseaudioSink::restart_timer_cb_(pa_mainloop_api*,
+                                       pa_time_event*,
+                                       const struct timeval*,
+                                       void* userdata) {
+    roc_log(LogTrace, "pulseaudio sink: restart timer callback");
+
+    PulseaudioSink& self = *(PulseaudioSink*)userdata;
+
+    self.restart_();
+}
+
 } // namespace sndio
 } // namespace roc
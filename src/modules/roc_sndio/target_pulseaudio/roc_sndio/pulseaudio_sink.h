@@ -14,12 +14,14 @@
 
 #include <pulse/pulseaudio.h>
 
+#include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/rate_limiter.h"
 #include "roc_core/stddefs.h"
 #include "roc_packet/units.h"
 #include "roc_sndio/config.h"
 #include "roc_sndio/isink.h"
+#include "roc_sndio/pull_reader.h"
 
 namespace roc {
 namespace sndio {
@@ -41,9 +43,27 @@ public:
     //! Check if the sink has own clock.
     virtual bool has_clock() const;
 
+    //! Get playback latency of the sink.
+    //! @remarks
+    //!  Returns the value cached on the last stream latency update, so that
+    //!  it can be called for every frame without locking the main loop.
+    virtual core::nanoseconds_t latency() const;
+
     //! Write audio frame.
     virtual void write(audio::Frame& frame);
 
+    //! Start pulling frames from source.
+    //! @remarks
+    //!  After this call, frames are read from @p source in the PulseAudio
+    //!  thread, from the stream write callback, directly into the stream
+    //!  buffer and exactly for the requested number of samples. If the stream
+    //!  fails, e.g. because the server was restarted, the sink keeps trying
+    //!  to reopen it until stop_pull() is called.
+    virtual bool start_pull(ISource& source);
+
+    //! Stop pulling frames from source.
+    virtual void stop_pull();
+
 private:
     static void context_state_cb_(pa_context* context, void* userdata);
 
@@ -59,7 +79,13 @@ private:
                           const struct timeval* tv,
                           void* userdata);
 
+    static void restart_timer_cb_(pa_mainloop_api* mainloop,
+                                  pa_time_event* timer,
+                                  const struct timeval* tv,
+                                  void* userdata);
+
     bool write_frame_(audio::Frame& frame);
+    bool pull_frames_(size_t size);
 
     bool check_params_() const;
 
@@ -73,6 +99,11 @@ private:
     void close_();
     void set_opened_(bool opened);
 
+    void handle_failure_();
+    void restart_();
+    void schedule_restart_();
+    void cancel_restart_();
+
     bool open_context_();
     void close_context_();
 
@@ -84,6 +115,8 @@ private:
     void close_stream_();
     ssize_t write_stream_(const audio::sample_t* data, size_t size);
     ssize_t wait_stream_();
+    core::nanoseconds_t stream_latency_() const;
+    void update_latency_(core::nanoseconds_t latency);
 
     void start_timer_(core::nanoseconds_t timeout);
     bool stop_timer_();
@@ -98,15 +131,23 @@ private:
 
     bool open_done_;
     bool opened_;
+    bool restarting_;
 
     pa_threaded_mainloop* mainloop_;
     pa_context* context_;
     pa_operation* sink_info_op_;
     pa_stream* stream_;
     pa_time_event* timer_;
+    pa_time_event* restart_timer_;
+
+    ISource* pull_source_;
+    PullReader pull_reader_;
 
     core::nanoseconds_t timer_deadline_;
 
+    core::nanoseconds_t cached_latency_;
+    core::Mutex latency_mutex_;
+
     pa_sample_spec sample_spec_;
     pa_buffer_attr buffer_attrs_;
 
@@ -94,6 +94,10 @@ bool SoxSink::has_clock() const {
     return !is_file_;
 }
 
+core::nanoseconds_t SoxSink::latency() const {
+    return 0;
+}
+
 void SoxSink::write(audio::Frame& frame) {
     roc_panic_if(!valid_);
 
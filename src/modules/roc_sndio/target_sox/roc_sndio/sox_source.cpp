@@ -154,6 +154,9 @@ bool SoxSource::read(audio::Frame& frame) {
     return true;
 }
 
+void SoxSource::reclock(core::nanoseconds_t) {
+}
+
 bool SoxSource::prepare_() {
     buffer_.reset(new (allocator_) sox_sample_t[buffer_size_], allocator_);
 
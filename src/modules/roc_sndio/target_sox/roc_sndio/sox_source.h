@@ -64,6 +64,9 @@ public:
     //! Read frame.
     virtual bool read(audio::Frame&);
 
+    //! Adjust source clock to match playback time.
+    virtual void reclock(core::nanoseconds_t playback_time);
+
 private:
     bool prepare_();
     bool open_(const char* driver, const char* input);
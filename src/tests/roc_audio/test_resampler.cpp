@@ -101,7 +101,7 @@ TEST(resampler, invalid_scaling) {
     enum { ChMask = 0x1, InvalidScaling = FrameSize };
 
     MockReader reader;
-    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask, FrameSize);
+    ResamplerReader rr(reader, buffer_pool, config, ChMask, FrameSize);
 
     CHECK(rr.valid());
 
@@ -113,7 +113,7 @@ TEST(resampler, upscaling_twice_single) {
     enum { ChMask = 0x1 };
 
     MockReader reader;
-    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask, FrameSize);
+    ResamplerReader rr(reader, buffer_pool, config, ChMask, FrameSize);
 
     CHECK(rr.valid());
 
@@ -144,7 +144,7 @@ TEST(resampler, upscaling_twice_awgn) {
     enum { ChMask = 0x1 };
 
     MockReader reader;
-    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask, FrameSize);
+    ResamplerReader rr(reader, buffer_pool, config, ChMask, FrameSize);
 
     CHECK(rr.valid());
     CHECK(rr.set_scaling(0.5f));
@@ -185,7 +185,7 @@ TEST(resampler, downsample) {
     enum { ChMask = 0x1 };
 
     MockReader reader;
-    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask, FrameSize);
+    ResamplerReader rr(reader, buffer_pool, config, ChMask, FrameSize);
 
     CHECK(rr.valid());
     CHECK(rr.set_scaling(1.5f));
@@ -215,7 +215,7 @@ TEST(resampler, two_tones_sep_channels) {
     enum { ChMask = 0x3, nChannels = 2 };
 
     MockReader reader;
-    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask, FrameSize);
+    ResamplerReader rr(reader, buffer_pool, config, ChMask, FrameSize);
 
     CHECK(rr.valid());
     CHECK(rr.set_scaling(0.5f));
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/sample_ring.h"
+#include "roc_core/heap_allocator.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum { Capacity = 10 };
+
+core::HeapAllocator allocator;
+
+} // namespace
+
+TEST_GROUP(sample_ring) {};
+
+TEST(sample_ring, empty) {
+    SampleRing ring(allocator, Capacity);
+    CHECK(ring.valid());
+
+    UNSIGNED_LONGS_EQUAL(Capacity, ring.capacity());
+    UNSIGNED_LONGS_EQUAL(0, ring.readable());
+    UNSIGNED_LONGS_EQUAL(Capacity, ring.writable());
+
+    sample_t samples[Capacity] = {};
+    UNSIGNED_LONGS_EQUAL(0, ring.read(samples, Capacity));
+}
+
+TEST(sample_ring, write_read) {
+    SampleRing ring(allocator, Capacity);
+    CHECK(ring.valid());
+
+    sample_t input[Capacity];
+    for (size_t n = 0; n < Capacity; n++) {
+        input[n] = sample_t(n) / Capacity;
+    }
+
+    UNSIGNED_LONGS_EQUAL(4, ring.write(input, 4));
+    UNSIGNED_LONGS_EQUAL(4, ring.readable());
+    UNSIGNED_LONGS_EQUAL(Capacity - 4, ring.writable());
+
+    sample_t output[Capacity] = {};
+    UNSIGNED_LONGS_EQUAL(4, ring.read(output, Capacity));
+
+    for (size_t n = 0; n < 4; n++) {
+        DOUBLES_EQUAL((double)input[n], (double)output[n], 0.0001);
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, ring.readable());
+}
+
+TEST(sample_ring, overflow) {
+    SampleRing ring(allocator, Capacity);
+    CHECK(ring.valid());
+
+    sample_t input[Capacity * 2] = {};
+
+    UNSIGNED_LONGS_EQUAL(Capacity, ring.write(input, Capacity * 2));
+    UNSIGNED_LONGS_EQUAL(0, ring.writable());
+    UNSIGNED_LONGS_EQUAL(0, ring.write(input, 1));
+}
+
+TEST(sample_ring, wrap_around) {
+    SampleRing ring(allocator, Capacity);
+    CHECK(ring.valid());
+
+    size_t wr_pos = 0;
+    size_t rd_pos = 0;
+
+    for (size_t iter = 0; iter < Capacity * 5; iter++) {
+        sample_t input[7];
+        for (size_t n = 0; n < 7; n++) {
+            input[n] = sample_t(wr_pos + n) / 1000;
+        }
+        wr_pos += ring.write(input, 7);
+
+        sample_t output[5];
+        const size_t n_read = ring.read(output, 5);
+        for (size_t n = 0; n < n_read; n++) {
+            DOUBLES_EQUAL(double(rd_pos + n) / 1000, (double)output[n], 0.0001);
+        }
+        rd_pos += n_read;
+
+        UNSIGNED_LONGS_EQUAL(wr_pos - rd_pos, ring.readable());
+    }
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/resampler.h"
+#include "roc_audio/sinc_table_cache.h"
+
+namespace roc {
+namespace audio {
+
+TEST_GROUP(sinc_table_cache) {};
+
+TEST(sinc_table_cache, same_params) {
+    core::SharedPtr<SincTable> t1 = SincTableCache::instance().get(16, 64);
+    core::SharedPtr<SincTable> t2 = SincTableCache::instance().get(16, 64);
+
+    CHECK(t1);
+    CHECK(t2);
+
+    CHECK(t1 == t2);
+    POINTERS_EQUAL(t1->data(), t2->data());
+}
+
+TEST(sinc_table_cache, different_params) {
+    core::SharedPtr<SincTable> t1 = SincTableCache::instance().get(16, 32);
+    core::SharedPtr<SincTable> t2 = SincTableCache::instance().get(16, 128);
+    core::SharedPtr<SincTable> t3 = SincTableCache::instance().get(8, 32);
+
+    CHECK(t1);
+    CHECK(t2);
+    CHECK(t3);
+
+    CHECK(t1 != t2);
+    CHECK(t1 != t3);
+    CHECK(t2 != t3);
+
+    UNSIGNED_LONGS_EQUAL(16, t1->window_size());
+    UNSIGNED_LONGS_EQUAL(32, t1->window_interp());
+    UNSIGNED_LONGS_EQUAL(16 * 32 + 2, t1->size());
+
+    UNSIGNED_LONGS_EQUAL(16 * 128 + 2, t2->size());
+    UNSIGNED_LONGS_EQUAL(8 * 32 + 2, t3->size());
+}
+
+TEST(sinc_table_cache, num_tables) {
+    const size_t size = SincTableCache::instance().size();
+
+    CHECK(SincTableCache::instance().get(4, 16));
+    UNSIGNED_LONGS_EQUAL(size + 1, SincTableCache::instance().size());
+
+    CHECK(SincTableCache::instance().get(4, 16));
+    UNSIGNED_LONGS_EQUAL(size + 1, SincTableCache::instance().size());
+}
+
+TEST(sinc_table_cache, release) {
+    const size_t size = SincTableCache::instance().size();
+
+    core::SharedPtr<SincTable> t1 = SincTableCache::instance().get(4, 8);
+    core::SharedPtr<SincTable> t2 = SincTableCache::instance().get(4, 8);
+
+    CHECK(t1);
+    CHECK(t1 == t2);
+    UNSIGNED_LONGS_EQUAL(size + 1, SincTableCache::instance().size());
+
+    SincTableCache::instance().release(t1);
+    CHECK(!t1);
+    UNSIGNED_LONGS_EQUAL(size + 1, SincTableCache::instance().size());
+
+    SincTableCache::instance().release(t2);
+    CHECK(!t2);
+    UNSIGNED_LONGS_EQUAL(size, SincTableCache::instance().size());
+
+    // released table is computed again on next request
+    core::SharedPtr<SincTable> t3 = SincTableCache::instance().get(4, 8);
+    CHECK(t3);
+    UNSIGNED_LONGS_EQUAL(size + 1, SincTableCache::instance().size());
+
+    SincTableCache::instance().release(t3);
+    UNSIGNED_LONGS_EQUAL(size, SincTableCache::instance().size());
+}
+
+TEST(sinc_table_cache, resampler) {
+    ResamplerConfig config;
+    config.window_size = 4;
+    config.window_interp = 4;
+
+    const size_t size = SincTableCache::instance().size();
+
+    {
+        Resampler r1(config, 0x3, 64);
+        CHECK(r1.valid());
+        UNSIGNED_LONGS_EQUAL(size + 1, SincTableCache::instance().size());
+
+        {
+            Resampler r2(config, 0x3, 64);
+            CHECK(r2.valid());
+            UNSIGNED_LONGS_EQUAL(size + 1, SincTableCache::instance().size());
+        }
+
+        UNSIGNED_LONGS_EQUAL(size + 1, SincTableCache::instance().size());
+    }
+
+    UNSIGNED_LONGS_EQUAL(size, SincTableCache::instance().size());
+}
+
+TEST(sinc_table_cache, values) {
+    enum { WindowSize = 8, WindowInterp = 16 };
+
+    core::SharedPtr<SincTable> table =
+        SincTableCache::instance().get(WindowSize, WindowInterp);
+    CHECK(table);
+
+    const sample_t* data = table->data();
+
+    DOUBLES_EQUAL(1.0, data[0], 1e-6);
+
+    // zero crossings of sinc
+    for (size_t n = 1; n < WindowSize; n++) {
+        DOUBLES_EQUAL(0.0, data[n * WindowInterp], 1e-6);
+    }
+
+    DOUBLES_EQUAL(0.0, data[table->size() - 2], 0);
+    DOUBLES_EQUAL(0.0, data[table->size() - 1], 0);
+}
+
+} // namespace audio
+} // namespace roc
@@ -40,5 +40,25 @@ TEST(atomic, inc_dec) {
     CHECK(a == 0);
 }
 
+TEST(atomic, add_sub) {
+    Atomic a;
+
+    CHECK((a += 10) == 10);
+    CHECK(a == 10);
+
+    CHECK((a -= 3) == 7);
+    CHECK(a == 7);
+}
+
+TEST(atomic, compare_exchange) {
+    Atomic a(5);
+
+    CHECK(!a.compare_exchange(4, 10));
+    CHECK(a == 5);
+
+    CHECK(a.compare_exchange(5, 10));
+    CHECK(a == 10);
+}
+
 } // namespace core
 } // namespace roc
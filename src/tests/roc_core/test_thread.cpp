@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/atomic.h"
+#include "roc_core/thread.h"
+#include "roc_core/thread_attributes.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+class TestThread : public Thread {
+public:
+    TestThread()
+        : ran_(0) {
+    }
+
+    bool ran() const {
+        return ran_;
+    }
+
+private:
+    virtual void run() {
+        ran_ = true;
+    }
+
+    Atomic ran_;
+};
+
+} // namespace
+
+TEST_GROUP(thread) {};
+
+TEST(thread, start_join) {
+    TestThread thr;
+
+    CHECK(!thr.joinable());
+    CHECK(thr.start());
+    CHECK(thr.joinable());
+
+    thr.join();
+
+    CHECK(!thr.joinable());
+    CHECK(thr.ran());
+}
+
+TEST(thread, default_attributes) {
+    CHECK(apply_thread_attributes(ThreadAttributes()));
+}
+
+TEST(thread, attributes_fallback) {
+    ThreadAttributes attrs;
+    attrs.name = "roc_test_thread_long_name";
+    attrs.sched_policy = SchedPolicy_FIFO;
+    attrs.sched_priority = 1000;
+    attrs.cpu_mask = 0x1;
+
+    TestThread thr;
+    thr.set_attributes(attrs);
+
+    // the thread should run even if there are no privileges for real-time
+    // scheduling
+    CHECK(thr.start());
+    thr.join();
+
+    CHECK(thr.ran());
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/ticker.h"
+#include "roc_core/time_histogram.h"
+
+namespace roc {
+namespace core {
+
+TEST_GROUP(time_histogram) {};
+
+TEST(time_histogram, empty) {
+    TimeHistogram hist;
+
+    UNSIGNED_LONGS_EQUAL(0, hist.total());
+    LONGS_EQUAL(0, hist.max());
+
+    for (size_t n = 0; n < TimeHistogram::NumBuckets; n++) {
+        UNSIGNED_LONGS_EQUAL(0, hist.count(n));
+    }
+}
+
+TEST(time_histogram, buckets) {
+    TimeHistogram hist;
+
+    hist.add(-1);
+    hist.add(0);
+    hist.add(Microsecond - 1);
+    hist.add(Microsecond);
+    hist.add(Microsecond * 3);
+    hist.add(Microsecond * 4);
+    hist.add(Second);
+
+    UNSIGNED_LONGS_EQUAL(3, hist.count(0));
+    UNSIGNED_LONGS_EQUAL(1, hist.count(1));
+    UNSIGNED_LONGS_EQUAL(1, hist.count(2));
+    UNSIGNED_LONGS_EQUAL(1, hist.count(3));
+    UNSIGNED_LONGS_EQUAL(1, hist.count(TimeHistogram::NumBuckets - 1));
+
+    UNSIGNED_LONGS_EQUAL(7, hist.total());
+    LONGS_EQUAL(Second, hist.max());
+}
+
+TEST(time_histogram, upper_bound) {
+    LONGS_EQUAL(Microsecond, TimeHistogram::upper_bound(0));
+    LONGS_EQUAL(Microsecond * 2, TimeHistogram::upper_bound(1));
+    LONGS_EQUAL(Microsecond * 4, TimeHistogram::upper_bound(2));
+    LONGS_EQUAL(0, TimeHistogram::upper_bound(TimeHistogram::NumBuckets - 1));
+}
+
+TEST(time_histogram, ticker_spin) {
+    enum { NumWaits = 10 };
+
+    Ticker ticker(Second / Millisecond, Millisecond);
+
+    const nanoseconds_t start = timestamp();
+
+    for (Ticker::Ticks n = 1; n <= NumWaits; n++) {
+        ticker.wait(n);
+        CHECK(timestamp() - start >= nanoseconds_t(n) * Millisecond);
+    }
+
+    CHECK(ticker.wakeup_errors().total() > 0);
+}
+
+} // namespace core
+} // namespace roc
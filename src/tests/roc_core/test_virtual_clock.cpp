@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/rate_limiter.h"
+#include "roc_core/ticker.h"
+#include "roc_core/virtual_clock.h"
+
+namespace roc {
+namespace core {
+
+TEST_GROUP(virtual_clock) {};
+
+TEST(virtual_clock, advance) {
+    VirtualClock clock(100 * Second);
+
+    LONGS_EQUAL(0, clock.now());
+    LONGS_EQUAL(100 * Second, clock.now_unix());
+
+    clock.advance(5 * Millisecond);
+
+    LONGS_EQUAL(5 * Millisecond, clock.now());
+    LONGS_EQUAL(100 * Second + 5 * Millisecond, clock.now_unix());
+}
+
+TEST(virtual_clock, sleep_until) {
+    VirtualClock clock;
+
+    clock.sleep_until(10 * Second);
+    LONGS_EQUAL(10 * Second, clock.now());
+
+    clock.spin_until(20 * Second);
+    LONGS_EQUAL(20 * Second, clock.now());
+
+    clock.sleep_until(5 * Second);
+    LONGS_EQUAL(20 * Second, clock.now());
+}
+
+TEST(virtual_clock, ticker) {
+    enum { Freq = 1000, NumTicks = 100000 };
+
+    VirtualClock clock;
+    Ticker ticker(Freq, 0, clock);
+
+    ticker.wait(NumTicks);
+
+    LONGS_EQUAL(NumTicks * (Second / Freq), clock.now());
+    UNSIGNED_LONGS_EQUAL(NumTicks, ticker.elapsed());
+}
+
+TEST(virtual_clock, rate_limiter) {
+    VirtualClock clock;
+    RateLimiter limiter(Second, clock);
+
+    CHECK(limiter.allow());
+    CHECK(!limiter.allow());
+
+    clock.advance(Second / 2);
+    CHECK(!limiter.allow());
+
+    clock.advance(Second / 2);
+    CHECK(limiter.allow());
+    CHECK(!limiter.allow());
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,656 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// Throughput benchmark for FEC codecs.
+//
+// Measures encoding and decoding speed of every available FEC scheme for
+// several block geometries, payload sizes and loss patterns, and prints
+// results as a table.
+//
+// Usage:
+//  roc-bench-fec [scheme]
+//
+// If scheme is specified ("rs8m", "ldpc", "rlc"), only this scheme is measured.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/log.h"
+#include "roc_core/time.h"
+#include "roc_core/unique_ptr.h"
+#include "roc_fec/codec_map.h"
+#include "roc_fec/composer.h"
+#include "roc_fec/headers.h"
+#include "roc_fec/rlc.h"
+#include "roc_fec/sliding_reader.h"
+#include "roc_fec/sliding_writer.h"
+#include "roc_packet/fec_scheme_to_str.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/format_map.h"
+#include "roc_rtp/headers.h"
+#include "roc_rtp/parser.h"
+
+namespace roc {
+namespace fec {
+namespace {
+
+// Minimum time spent measuring one case.
+const core::nanoseconds_t MinDuration = 200 * core::Millisecond;
+
+// Minimum number of blocks processed in one case.
+const size_t MinBlocks = 10;
+
+// Number of distinct pre-encoded blocks used by decoding benchmark.
+const size_t NumBlocks = 8;
+
+const size_t MaxPayloadSize = 1500;
+const size_t MaxBuffSize = MaxPayloadSize + 64;
+
+const size_t PayloadSizes[] = { 64, 256, 1024 };
+
+struct Geometry {
+    size_t sblen;
+    size_t rblen;
+};
+
+const Geometry Geometries[] = {
+    { 10, 5 },   //
+    { 20, 10 },  //
+    { 50, 25 },  //
+    { 100, 50 }, //
+    { 200, 50 }
+};
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBuffSize, false);
+packet::PacketPool packet_pool(allocator, false);
+
+fec::CodecMap codec_map;
+
+rtp::FormatMap format_map;
+rtp::Parser rtp_parser(format_map, NULL);
+rtp::Composer rtp_composer(NULL);
+
+fec::Composer<RLC_Source_PayloadID, Source, Footer> rlc_source_composer(&rtp_composer);
+fec::Composer<RLC_Repair_PayloadID, Repair, Header> rlc_repair_composer(NULL);
+
+// Deterministic pseudo-random generator, so that every run and every scheme
+// sees the same losses.
+class Random {
+public:
+    explicit Random(uint32_t seed)
+        : state_(seed ? seed : 1) {
+    }
+
+    uint32_t next() {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 17;
+        state_ ^= state_ << 5;
+        return state_;
+    }
+
+    bool chance(double probability) {
+        return next() < (uint32_t)(probability * (double)(uint32_t)-1);
+    }
+
+private:
+    uint32_t state_;
+};
+
+// Generates a stream of loss decisions for consecutive packets.
+class LossGenerator {
+public:
+    enum Pattern {
+        // no losses
+        None,
+
+        // independent losses with fixed probability
+        Uniform,
+
+        // bursts of fixed length with fixed period
+        Burst,
+
+        // two-state Markov chain (Gilbert-Elliott model)
+        GilbertElliott
+    };
+
+    explicit LossGenerator(Pattern pattern)
+        : pattern_(pattern)
+        , random_(12345)
+        , pos_(0)
+        , bad_(false) {
+    }
+
+    const char* name() const {
+        switch (pattern_) {
+        case None:
+            return "none";
+        case Uniform:
+            return "uniform5%";
+        case Burst:
+            return "burst4/40";
+        case GilbertElliott:
+            return "gilbert";
+        }
+        return "?";
+    }
+
+    bool lose() {
+        switch (pattern_) {
+        case None:
+            return false;
+
+        case Uniform:
+            return random_.chance(0.05);
+
+        case Burst:
+            return (pos_++ % 40) < 4;
+
+        case GilbertElliott:
+            if (bad_) {
+                bad_ = !random_.chance(0.25);
+            } else {
+                bad_ = random_.chance(0.02);
+            }
+            return bad_ ? random_.chance(0.9) : random_.chance(0.005);
+        }
+        return false;
+    }
+
+private:
+    Pattern pattern_;
+    Random random_;
+    size_t pos_;
+    bool bad_;
+};
+
+const LossGenerator::Pattern LossPatterns[] = {
+    LossGenerator::None,    //
+    LossGenerator::Uniform, //
+    LossGenerator::Burst,   //
+    LossGenerator::GilbertElliott
+};
+
+struct Result {
+    double mbps;
+    double blocks_per_sec;
+    size_t n_lost;
+    size_t n_restored;
+
+    Result()
+        : mbps(0)
+        , blocks_per_sec(0)
+        , n_lost(0)
+        , n_restored(0) {
+    }
+};
+
+void print_header() {
+    printf("%-6s %5s %5s %7s %-10s %10s %12s %10s\n", "scheme", "sblen", "rblen",
+           "payload", "loss", "MB/s", "blocks/s", "restored");
+}
+
+void print_result(packet::FECScheme scheme,
+                  const Geometry& geom,
+                  size_t payload_size,
+                  const char* op,
+                  const Result& res) {
+    char restored[32] = "-";
+    if (res.n_lost != 0) {
+        snprintf(restored, sizeof(restored), "%.1f%%",
+                 100.0 * (double)res.n_restored / (double)res.n_lost);
+    }
+
+    printf("%-6s %5lu %5lu %7lu %-10s %10.1f %12.1f %10s\n",
+           packet::fec_scheme_to_str(scheme), (unsigned long)geom.sblen,
+           (unsigned long)geom.rblen, (unsigned long)payload_size, op, res.mbps,
+           res.blocks_per_sec, restored);
+
+    fflush(stdout);
+}
+
+void compute_rate(Result& res,
+                  size_t n_blocks,
+                  size_t block_bytes,
+                  core::nanoseconds_t elapsed) {
+    const double secs = (double)elapsed / core::Second;
+
+    res.mbps = (double)n_blocks * (double)block_bytes / secs / 1e6;
+    res.blocks_per_sec = (double)n_blocks / secs;
+}
+
+core::Slice<uint8_t> make_buffer(size_t payload_size, size_t alignment) {
+    core::Slice<uint8_t> buffer = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+    if (!buffer) {
+        roc_panic("bench: can't allocate buffer");
+    }
+
+    const size_t off =
+        (alignment - (size_t)((uintptr_t)buffer.data() % alignment)) % alignment;
+
+    return buffer.range(off, off + payload_size);
+}
+
+// Set of blocks encoded once and then decoded many times.
+struct EncodedBlocks {
+    core::Slice<uint8_t> buffers[NumBlocks][256];
+};
+
+bool encode_blocks(IBlockEncoder& encoder,
+                   const Geometry& geom,
+                   size_t payload_size,
+                   EncodedBlocks& blocks) {
+    Random random(777);
+
+    for (size_t b = 0; b < NumBlocks; b++) {
+        if (!encoder.begin(geom.sblen, geom.rblen, payload_size)) {
+            return false;
+        }
+
+        for (size_t i = 0; i < geom.sblen + geom.rblen; i++) {
+            blocks.buffers[b][i] = make_buffer(payload_size, encoder.alignment());
+
+            if (i < geom.sblen) {
+                for (size_t n = 0; n < payload_size; n++) {
+                    blocks.buffers[b][i].data()[n] = (uint8_t)random.next();
+                }
+            }
+
+            encoder.set(i, blocks.buffers[b][i]);
+        }
+
+        encoder.fill();
+        encoder.end();
+    }
+
+    return true;
+}
+
+Result bench_block_encoder(IBlockEncoder& encoder,
+                           const Geometry& geom,
+                           size_t payload_size,
+                           EncodedBlocks& blocks) {
+    Result res;
+
+    size_t n_blocks = 0;
+
+    const core::nanoseconds_t start = core::timestamp();
+    core::nanoseconds_t elapsed = 0;
+
+    while (n_blocks < MinBlocks || elapsed < MinDuration) {
+        const size_t b = n_blocks % NumBlocks;
+
+        if (!encoder.begin(geom.sblen, geom.rblen, payload_size)) {
+            roc_panic("bench: can't begin encoder block");
+        }
+
+        for (size_t i = 0; i < geom.sblen + geom.rblen; i++) {
+            encoder.set(i, blocks.buffers[b][i]);
+        }
+
+        encoder.fill();
+        encoder.end();
+
+        n_blocks++;
+        elapsed = core::timestamp() - start;
+    }
+
+    compute_rate(res, n_blocks, geom.sblen * payload_size, elapsed);
+
+    return res;
+}
+
+Result bench_block_decoder(IBlockDecoder& decoder,
+                           const Geometry& geom,
+                           size_t payload_size,
+                           EncodedBlocks& blocks,
+                           LossGenerator& losses) {
+    Result res;
+
+    bool lost[256];
+
+    size_t n_blocks = 0;
+    core::nanoseconds_t elapsed = 0;
+
+    while (n_blocks < MinBlocks || elapsed < MinDuration) {
+        const size_t b = n_blocks % NumBlocks;
+
+        size_t n_source_lost = 0;
+        for (size_t i = 0; i < geom.sblen + geom.rblen; i++) {
+            lost[i] = losses.lose();
+            if (lost[i] && i < geom.sblen) {
+                n_source_lost++;
+            }
+        }
+
+        const core::nanoseconds_t start = core::timestamp();
+
+        if (!decoder.begin(geom.sblen, geom.rblen, payload_size)) {
+            roc_panic("bench: can't begin decoder block");
+        }
+
+        for (size_t i = 0; i < geom.sblen + geom.rblen; i++) {
+            if (!lost[i]) {
+                decoder.set(i, blocks.buffers[b][i]);
+            }
+        }
+
+        for (size_t i = 0; i < geom.sblen; i++) {
+            if (lost[i] && decoder.repair(i)) {
+                res.n_restored++;
+            }
+        }
+
+        decoder.end();
+
+        elapsed += core::timestamp() - start;
+
+        res.n_lost += n_source_lost;
+        n_blocks++;
+    }
+
+    compute_rate(res, n_blocks, geom.sblen * payload_size, elapsed);
+
+    return res;
+}
+
+void bench_block_codec(packet::FECScheme scheme) {
+    CodecConfig config;
+    config.scheme = scheme;
+
+    core::UniquePtr<IBlockEncoder> encoder(
+        codec_map.new_encoder(config, buffer_pool, allocator), allocator);
+    core::UniquePtr<IBlockDecoder> decoder(
+        codec_map.new_decoder(config, buffer_pool, allocator), allocator);
+
+    if (!encoder || !decoder) {
+        printf("%-6s not supported\n", packet::fec_scheme_to_str(scheme));
+        return;
+    }
+
+    core::UniquePtr<EncodedBlocks> blocks(new (allocator) EncodedBlocks, allocator);
+    if (!blocks) {
+        roc_panic("bench: can't allocate blocks");
+    }
+
+    for (size_t g = 0; g < ROC_ARRAY_SIZE(Geometries); g++) {
+        const Geometry& geom = Geometries[g];
+
+        if (geom.sblen + geom.rblen > encoder->max_block_length()) {
+            continue;
+        }
+
+        for (size_t p = 0; p < ROC_ARRAY_SIZE(PayloadSizes); p++) {
+            const size_t payload_size = PayloadSizes[p];
+
+            if (!encode_blocks(*encoder, geom, payload_size, *blocks)) {
+                roc_panic("bench: can't encode blocks");
+            }
+
+            print_result(scheme, geom, payload_size, "encode",
+                         bench_block_encoder(*encoder, geom, payload_size, *blocks));
+
+            for (size_t l = 0; l < ROC_ARRAY_SIZE(LossPatterns); l++) {
+                LossGenerator losses(LossPatterns[l]);
+
+                char op[32];
+                snprintf(op, sizeof(op), "%s", losses.name());
+
+                print_result(
+                    scheme, geom, payload_size, op,
+                    bench_block_decoder(*decoder, geom, payload_size, *blocks, losses));
+            }
+        }
+    }
+}
+
+// Drops everything written to it.
+class NullWriter : public packet::IWriter {
+public:
+    virtual void write(const packet::PacketPtr&) {
+    }
+};
+
+// Stores everything written to it.
+class PacketStream : public packet::IWriter {
+public:
+    PacketStream()
+        : packets_(allocator) {
+    }
+
+    virtual void write(const packet::PacketPtr& pp) {
+        if (packets_.size() == packets_.max_size()
+            && !packets_.grow(packets_.max_size() * 2 + 1)) {
+            roc_panic("bench: can't grow packet array");
+        }
+        packets_.push_back(pp);
+    }
+
+    size_t size() const {
+        return packets_.size();
+    }
+
+    const packet::PacketPtr& operator[](size_t n) const {
+        return packets_[n];
+    }
+
+private:
+    core::Array<packet::PacketPtr> packets_;
+};
+
+packet::PacketPtr make_rlc_packet(size_t seqnum, size_t payload_size, Random& random) {
+    packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+    if (!pp) {
+        roc_panic("bench: can't allocate packet");
+    }
+
+    core::Slice<uint8_t> bp = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+    if (!bp) {
+        roc_panic("bench: can't allocate buffer");
+    }
+
+    if (!rlc_source_composer.prepare(*pp, bp, payload_size - sizeof(rtp::Header))) {
+        roc_panic("bench: can't prepare packet");
+    }
+
+    pp->set_data(bp);
+    pp->add_flags(packet::Packet::FlagAudio);
+
+    pp->rtp()->payload_type = rtp::PayloadType_L16_Stereo;
+    pp->rtp()->seqnum = (packet::seqnum_t)seqnum;
+
+    for (size_t n = 0; n < pp->rtp()->payload.size(); n++) {
+        pp->rtp()->payload.data()[n] = (uint8_t)random.next();
+    }
+
+    return pp;
+}
+
+void count_restored(const packet::PacketPtr& pp, Result& res) {
+    if (pp && (pp->flags() & packet::Packet::FlagRestored)) {
+        res.n_restored++;
+    }
+}
+
+void bench_sliding_codec() {
+    enum { NumWindows = 20 };
+
+    for (size_t g = 0; g < ROC_ARRAY_SIZE(Geometries); g++) {
+        const Geometry& geom = Geometries[g];
+
+        if (geom.sblen > RLCMaxWindowLength) {
+            continue;
+        }
+
+        WriterConfig writer_config;
+        writer_config.n_source_packets = geom.sblen;
+        writer_config.n_repair_packets = geom.rblen;
+
+        for (size_t p = 0; p < ROC_ARRAY_SIZE(PayloadSizes); p++) {
+            const size_t payload_size = PayloadSizes[p];
+            const size_t n_packets = geom.sblen * NumWindows;
+
+            Random random(777);
+
+            // encode
+            {
+                NullWriter null_writer;
+
+                SlidingWriter writer(writer_config, packet::FEC_RLC, null_writer,
+                                     rlc_source_composer, rlc_repair_composer,
+                                     packet_pool, buffer_pool, allocator);
+                if (!writer.valid()) {
+                    roc_panic("bench: can't create writer");
+                }
+
+                Result res;
+
+                size_t n_blocks = 0;
+                core::nanoseconds_t elapsed = 0;
+
+                while (n_blocks < MinBlocks || elapsed < MinDuration) {
+                    packet::PacketPtr packets[RLCMaxWindowLength];
+                    for (size_t i = 0; i < geom.sblen; i++) {
+                        packets[i] = make_rlc_packet(n_blocks * geom.sblen + i,
+                                                     payload_size, random);
+                    }
+
+                    const core::nanoseconds_t start = core::timestamp();
+
+                    for (size_t i = 0; i < geom.sblen; i++) {
+                        writer.write(packets[i]);
+                    }
+
+                    elapsed += core::timestamp() - start;
+                    n_blocks++;
+                }
+
+                compute_rate(res, n_blocks, geom.sblen * payload_size, elapsed);
+                print_result(packet::FEC_RLC, geom, payload_size, "encode", res);
+            }
+
+            // decode
+            PacketStream stream;
+            bool lost[(RLCMaxWindowLength * 2) * NumWindows];
+
+            SlidingWriter writer(writer_config, packet::FEC_RLC, stream,
+                                 rlc_source_composer, rlc_repair_composer, packet_pool,
+                                 buffer_pool, allocator);
+            if (!writer.valid()) {
+                roc_panic("bench: can't create writer");
+            }
+
+            for (size_t i = 0; i < n_packets; i++) {
+                writer.write(make_rlc_packet(i, payload_size, random));
+            }
+
+            roc_panic_if(stream.size() > ROC_ARRAY_SIZE(lost));
+
+            for (size_t l = 0; l < ROC_ARRAY_SIZE(LossPatterns); l++) {
+                LossGenerator losses(LossPatterns[l]);
+
+                Result res;
+
+                size_t n_blocks = 0;
+                core::nanoseconds_t elapsed = 0;
+
+                while (n_blocks < MinBlocks || elapsed < MinDuration) {
+                    for (size_t n = 0; n < stream.size(); n++) {
+                        lost[n] = losses.lose();
+                    }
+
+                    const core::nanoseconds_t start = core::timestamp();
+
+                    packet::Queue source_queue;
+                    packet::Queue repair_queue;
+
+                    SlidingReader reader(ReaderConfig(), packet::FEC_RLC, source_queue,
+                                         repair_queue, rtp_parser, packet_pool,
+                                         buffer_pool, allocator);
+                    if (!reader.valid()) {
+                        roc_panic("bench: can't create reader");
+                    }
+
+                    size_t n_source = 0;
+
+                    // keep one window of packets between writing and reading,
+                    // like receiver latency does
+                    for (size_t n = 0; n < stream.size(); n++) {
+                        const packet::PacketPtr& pp = stream[n];
+
+                        const bool is_repair = (pp->flags() & packet::Packet::FlagRepair);
+
+                        if (!is_repair && lost[n]) {
+                            res.n_lost++;
+                        }
+
+                        if (!lost[n]) {
+                            if (is_repair) {
+                                repair_queue.write(pp);
+                            } else {
+                                source_queue.write(pp);
+                            }
+                        }
+
+                        if (!is_repair && ++n_source > geom.sblen) {
+                            count_restored(reader.read(), res);
+                        }
+                    }
+
+                    while (packet::PacketPtr pp = reader.read()) {
+                        count_restored(pp, res);
+                    }
+
+                    elapsed += core::timestamp() - start;
+
+                    n_blocks += NumWindows;
+                }
+
+                compute_rate(res, n_blocks, geom.sblen * payload_size, elapsed);
+                print_result(packet::FEC_RLC, geom, payload_size, losses.name(), res);
+            }
+        }
+    }
+}
+
+bool matches(const char* filter, packet::FECScheme scheme) {
+    return !filter || strcmp(filter, packet::fec_scheme_to_str(scheme)) == 0;
+}
+
+} // namespace
+} // namespace fec
+} // namespace roc
+
+int main(int argc, char** argv) {
+    using namespace roc;
+
+    core::Logger::instance().set_level(LogNone);
+
+    const char* filter = argc > 1 ? argv[1] : NULL;
+
+    fec::print_header();
+
+    if (fec::matches(filter, packet::FEC_ReedSolomon_M8)) {
+        fec::bench_block_codec(packet::FEC_ReedSolomon_M8);
+    }
+
+    if (fec::matches(filter, packet::FEC_LDPC_Staircase)) {
+        fec::bench_block_codec(packet::FEC_LDPC_Staircase);
+    }
+
+    if (fec::matches(filter, packet::FEC_RLC)) {
+        fec::bench_sliding_codec();
+    }
+
+    return 0;
+}
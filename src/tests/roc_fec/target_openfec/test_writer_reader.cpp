@@ -20,6 +20,7 @@
 #include "roc_fec/headers.h"
 #include "roc_fec/parser.h"
 #include "roc_fec/reader.h"
+#include "roc_fec/repair_pool.h"
 #include "roc_fec/writer.h"
 #include "roc_packet/interleaver.h"
 #include "roc_packet/packet_pool.h"
@@ -549,6 +550,132 @@ TEST(writer_reader, multiple_blocks_in_queue) {
     }
 }
 
+TEST(writer_reader, multiple_blocks_in_queue_with_losses) {
+    // Simulate catch-up after a stall: several blocks with losses are queued
+    // before the reader starts reading.
+    enum { NumBlocks = 5 };
+
+    for (size_t n_scheme = 0; n_scheme < Test_n_fec_schemes; n_scheme++) {
+        codec_config.scheme = Test_fec_schemes[n_scheme];
+
+        core::UniquePtr<IBlockEncoder> encoder(
+            codec_map.new_encoder(codec_config, buffer_pool, allocator), allocator);
+        core::UniquePtr<IBlockDecoder> decoder(
+            codec_map.new_decoder(codec_config, buffer_pool, allocator), allocator);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        PacketDispatcher dispatcher(source_parser(), repair_parser(), packet_pool,
+                                    NumSourcePackets, NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_pool, buffer_pool,
+                      allocator);
+
+        Reader reader(reader_config, codec_config.scheme, *decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_pool, allocator);
+
+        CHECK(writer.valid());
+        CHECK(reader.valid());
+
+        // lose packets in every block
+        dispatcher.lose(1);
+        dispatcher.lose(7);
+        dispatcher.lose(NumSourcePackets - 1);
+
+        for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
+            fill_all_packets(NumSourcePackets * block_num);
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                writer.write(source_packets[i]);
+            }
+        }
+
+        dispatcher.push_stocks();
+
+        UNSIGNED_LONGS_EQUAL((NumSourcePackets - 3) * NumBlocks,
+                             dispatcher.source_size());
+        UNSIGNED_LONGS_EQUAL(NumRepairPackets * NumBlocks, dispatcher.repair_size());
+
+        for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                packet::PacketPtr p = reader.read();
+                CHECK(p);
+                check_audio_packet(p, NumSourcePackets * block_num + i);
+                check_restored(p, i == 1 || i == 7 || i == NumSourcePackets - 1);
+            }
+        }
+
+        CHECK(!reader.read());
+    }
+}
+
+TEST(writer_reader, multiple_blocks_in_queue_repair_pool) {
+    // Same as above, but queued blocks are repaired ahead of time by a pool.
+    enum { NumBlocks = 5, NumWorkers = 2 };
+
+    for (size_t n_scheme = 0; n_scheme < Test_n_fec_schemes; n_scheme++) {
+        codec_config.scheme = Test_fec_schemes[n_scheme];
+
+        core::UniquePtr<IBlockEncoder> encoder(
+            codec_map.new_encoder(codec_config, buffer_pool, allocator), allocator);
+        core::UniquePtr<IBlockDecoder> decoder(
+            codec_map.new_decoder(codec_config, buffer_pool, allocator), allocator);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        RepairPool repair_pool(allocator);
+
+        for (size_t n = 0; n < NumWorkers; n++) {
+            CHECK(repair_pool.add_worker(
+                codec_map.new_decoder(codec_config, buffer_pool, allocator)));
+        }
+
+        PacketDispatcher dispatcher(source_parser(), repair_parser(), packet_pool,
+                                    NumSourcePackets, NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_pool, buffer_pool,
+                      allocator);
+
+        Reader reader(reader_config, codec_config.scheme, *decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_pool, allocator, &repair_pool);
+
+        CHECK(writer.valid());
+        CHECK(reader.valid());
+
+        // lose packets in every block
+        dispatcher.lose(1);
+        dispatcher.lose(7);
+        dispatcher.lose(NumSourcePackets - 1);
+
+        for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
+            fill_all_packets(NumSourcePackets * block_num);
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                writer.write(source_packets[i]);
+            }
+        }
+
+        dispatcher.push_stocks();
+
+        for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                packet::PacketPtr p = reader.read();
+                CHECK(p);
+                check_audio_packet(p, NumSourcePackets * block_num + i);
+                check_restored(p, i == 1 || i == 7 || i == NumSourcePackets - 1);
+            }
+        }
+
+        CHECK(!reader.read());
+    }
+}
+
 TEST(writer_reader, interleaved_packets) {
     enum { NumPackets = NumSourcePackets * 30 };
 
@@ -1971,6 +2098,74 @@ TEST(writer_reader, writer_resize_blocks) {
     }
 }
 
+TEST(writer_reader, writer_reuse_repair_buffers) {
+    for (size_t n_scheme = 0; n_scheme < Test_n_fec_schemes; n_scheme++) {
+        codec_config.scheme = Test_fec_schemes[n_scheme];
+
+        core::UniquePtr<IBlockEncoder> encoder(
+            codec_map.new_encoder(codec_config, buffer_pool, allocator), allocator);
+        CHECK(encoder);
+
+        packet::Queue queue;
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, queue,
+                      source_composer(), repair_composer(), packet_pool, buffer_pool,
+                      allocator);
+
+        CHECK(writer.valid());
+
+        packet::PacketPtr held_packets[NumRepairPackets];
+        const uint8_t* released_buffers[NumRepairPackets];
+
+        for (size_t block_num = 0; block_num < 3; ++block_num) {
+            fill_all_packets(NumSourcePackets * block_num);
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                writer.write(source_packets[i]);
+            }
+
+            size_t n_repair = 0;
+
+            while (packet::PacketPtr p = queue.read()) {
+                if ((p->flags() & packet::Packet::FlagRepair) == 0) {
+                    continue;
+                }
+
+                CHECK(n_repair < NumRepairPackets);
+
+                UNSIGNED_LONGS_EQUAL(NumSourcePackets + n_repair,
+                                     p->fec()->encoding_symbol_id);
+
+                const uint8_t* buffer = p->data().data();
+
+                switch (block_num) {
+                case 0:
+                    // keep packets from first block referenced
+                    held_packets[n_repair] = p;
+                    break;
+
+                case 1:
+                    // buffers still referenced by us are not reused
+                    for (size_t i = 0; i < NumRepairPackets; ++i) {
+                        CHECK(buffer != held_packets[i]->data().data());
+                    }
+                    released_buffers[n_repair] = buffer;
+                    break;
+
+                default:
+                    // released buffers are reused
+                    POINTERS_EQUAL(released_buffers[n_repair], buffer);
+                    break;
+                }
+
+                n_repair++;
+            }
+
+            UNSIGNED_LONGS_EQUAL(NumRepairPackets, n_repair);
+        }
+    }
+}
+
 TEST(writer_reader, resize_block_begin) {
     for (size_t n_scheme = 0; n_scheme < Test_n_fec_schemes; n_scheme++) {
         codec_config.scheme = Test_fec_schemes[n_scheme];
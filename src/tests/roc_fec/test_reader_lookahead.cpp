@@ -0,0 +1,374 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/mutex.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_fec/composer.h"
+#include "roc_fec/headers.h"
+#include "roc_fec/iblock_decoder.h"
+#include "roc_fec/iblock_encoder.h"
+#include "roc_fec/parser.h"
+#include "roc_fec/reader.h"
+#include "roc_fec/repair_pool.h"
+#include "roc_fec/writer.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/format_map.h"
+#include "roc_rtp/headers.h"
+#include "roc_rtp/parser.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+const size_t NumSourcePackets = 20;
+const size_t NumRepairPackets = 10;
+
+const size_t NumBlocks = 8;
+const size_t NumWorkers = 4;
+
+// lost packet in every block
+const size_t LostPacket = 1;
+
+const unsigned SourceID = 555;
+const unsigned PayloadType = rtp::PayloadType_L16_Stereo;
+
+const size_t FECPayloadSize = 193;
+
+const size_t MaxBuffSize = 500;
+const size_t MaxBlockLength = 255;
+
+const core::nanoseconds_t DecodeTime = 20 * core::Millisecond;
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBuffSize, true);
+packet::PacketPool packet_pool(allocator, true);
+
+rtp::FormatMap format_map;
+rtp::Parser rtp_parser(format_map, NULL);
+
+fec::Parser<RSm8_PayloadID, Source, Footer> source_parser(&rtp_parser);
+fec::Parser<RSm8_PayloadID, Repair, Header> repair_parser(NULL);
+
+rtp::Composer rtp_composer(NULL);
+fec::Composer<RSm8_PayloadID, Source, Footer> source_composer(&rtp_composer);
+fec::Composer<RSm8_PayloadID, Repair, Header> repair_composer(NULL);
+
+// Repetition code: repair packet N is a copy of source packet N.
+class MockEncoder : public IBlockEncoder {
+public:
+    MockEncoder()
+        : sblen_(0)
+        , rblen_(0)
+        , payload_size_(0) {
+    }
+
+    virtual size_t alignment() const {
+        return 8;
+    }
+
+    virtual size_t max_block_length() const {
+        return MaxBlockLength;
+    }
+
+    virtual bool begin(size_t sblen, size_t rblen, size_t payload_size) {
+        sblen_ = sblen;
+        rblen_ = rblen;
+        payload_size_ = payload_size;
+        return true;
+    }
+
+    virtual void set(size_t index, const core::Slice<uint8_t>& buffer) {
+        CHECK(index < MaxBlockLength);
+        buffers_[index] = buffer;
+    }
+
+    virtual void fill() {
+        for (size_t n = 0; n < rblen_ && n < sblen_; n++) {
+            memcpy(buffers_[sblen_ + n].data(), buffers_[n].data(), payload_size_);
+        }
+    }
+
+    virtual void end() {
+        for (size_t n = 0; n < MaxBlockLength; n++) {
+            buffers_[n] = NULL;
+        }
+    }
+
+private:
+    core::Slice<uint8_t> buffers_[MaxBlockLength];
+
+    size_t sblen_;
+    size_t rblen_;
+    size_t payload_size_;
+};
+
+// Decoder statistics, shared by decoders of repair pool threads.
+struct DecoderStats {
+    core::Mutex mutex;
+
+    size_t n_active;
+    size_t max_active;
+    size_t n_repaired;
+
+    DecoderStats()
+        : n_active(0)
+        , max_active(0)
+        , n_repaired(0) {
+    }
+};
+
+// Decodes repetition code, spending DecodeTime on every restored packet.
+class MockDecoder : public IBlockDecoder {
+public:
+    explicit MockDecoder(DecoderStats& stats)
+        : stats_(stats)
+        , sblen_(0) {
+    }
+
+    virtual size_t max_block_length() const {
+        return MaxBlockLength;
+    }
+
+    virtual bool begin(size_t sblen, size_t, size_t) {
+        core::Mutex::Lock lock(stats_.mutex);
+
+        stats_.n_active++;
+        if (stats_.max_active < stats_.n_active) {
+            stats_.max_active = stats_.n_active;
+        }
+
+        sblen_ = sblen;
+        return true;
+    }
+
+    virtual void set(size_t index, const core::Slice<uint8_t>& buffer) {
+        CHECK(index < MaxBlockLength);
+        buffers_[index] = buffer;
+    }
+
+    virtual core::Slice<uint8_t> repair(size_t index) {
+        core::sleep_for(DecodeTime);
+
+        core::Mutex::Lock lock(stats_.mutex);
+        stats_.n_repaired++;
+
+        return buffers_[sblen_ + index];
+    }
+
+    virtual void end() {
+        for (size_t n = 0; n < MaxBlockLength; n++) {
+            buffers_[n] = NULL;
+        }
+
+        core::Mutex::Lock lock(stats_.mutex);
+        stats_.n_active--;
+    }
+
+private:
+    DecoderStats& stats_;
+
+    core::Slice<uint8_t> buffers_[MaxBlockLength];
+    size_t sblen_;
+};
+
+// Reparses packets from writer and routes them to source and repair queues,
+// dropping source packet LostPacket of every block.
+class Dispatcher : public packet::IWriter {
+public:
+    Dispatcher()
+        : n_source_(0) {
+    }
+
+    virtual void write(const packet::PacketPtr& pp) {
+        CHECK(pp);
+        CHECK(pp->flags() & packet::Packet::FlagComposed);
+
+        if (pp->flags() & packet::Packet::FlagAudio) {
+            if (n_source_++ % NumSourcePackets != LostPacket) {
+                source_queue_.write(reparse_(source_parser, pp));
+            }
+        } else if (pp->flags() & packet::Packet::FlagRepair) {
+            repair_queue_.write(reparse_(repair_parser, pp));
+        } else {
+            FAIL("unexpected packet type");
+        }
+    }
+
+    packet::IReader& source_reader() {
+        return source_queue_;
+    }
+
+    packet::IReader& repair_reader() {
+        return repair_queue_;
+    }
+
+private:
+    packet::PacketPtr reparse_(packet::IParser& parser, const packet::PacketPtr& old_pp) {
+        packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+        CHECK(pp);
+
+        CHECK(parser.parse(*pp, old_pp->data()));
+        pp->set_data(old_pp->data());
+
+        return pp;
+    }
+
+    packet::Queue source_queue_;
+    packet::Queue repair_queue_;
+
+    size_t n_source_;
+};
+
+} // namespace
+
+TEST_GROUP(reader_lookahead) {
+    WriterConfig writer_config;
+    ReaderConfig reader_config;
+
+    void setup() {
+        writer_config.n_source_packets = NumSourcePackets;
+        writer_config.n_repair_packets = NumRepairPackets;
+    }
+
+    packet::PacketPtr make_packet(size_t sn) {
+        const size_t rtp_payload_size = FECPayloadSize - sizeof(rtp::Header);
+
+        packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+        CHECK(pp);
+
+        core::Slice<uint8_t> bp = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+        CHECK(bp);
+
+        CHECK(source_composer.prepare(*pp, bp, rtp_payload_size));
+
+        pp->set_data(bp);
+
+        pp->add_flags(packet::Packet::FlagAudio);
+
+        pp->rtp()->source = SourceID;
+        pp->rtp()->payload_type = PayloadType;
+        pp->rtp()->seqnum = packet::seqnum_t(sn);
+        pp->rtp()->timestamp = packet::timestamp_t(sn * 10);
+
+        for (size_t i = 0; i < rtp_payload_size; i++) {
+            pp->rtp()->payload.data()[i] = uint8_t(sn * 7 + i);
+        }
+
+        return pp;
+    }
+
+    void check_packet(const packet::PacketPtr& pp, size_t sn) {
+        const size_t rtp_payload_size = FECPayloadSize - sizeof(rtp::Header);
+
+        CHECK(pp);
+
+        CHECK(pp->rtp());
+        UNSIGNED_LONGS_EQUAL(SourceID, pp->rtp()->source);
+        UNSIGNED_LONGS_EQUAL(sn, pp->rtp()->seqnum);
+        UNSIGNED_LONGS_EQUAL(packet::timestamp_t(sn * 10), pp->rtp()->timestamp);
+        UNSIGNED_LONGS_EQUAL(rtp_payload_size, pp->rtp()->payload.size());
+
+        for (size_t i = 0; i < rtp_payload_size; i++) {
+            UNSIGNED_LONGS_EQUAL(uint8_t(sn * 7 + i), pp->rtp()->payload.data()[i]);
+        }
+
+        CHECK(bool(pp->flags() & packet::Packet::FlagRestored)
+              == (sn % NumSourcePackets == LostPacket));
+    }
+
+    void write_blocks(Dispatcher& dispatcher) {
+        MockEncoder encoder;
+
+        Writer writer(writer_config, packet::FEC_ReedSolomon_M8, encoder, dispatcher,
+                      source_composer, repair_composer, packet_pool, buffer_pool,
+                      allocator);
+        CHECK(writer.valid());
+
+        for (size_t sn = 0; sn < NumSourcePackets * NumBlocks; sn++) {
+            writer.write(make_packet(sn));
+        }
+    }
+
+    void read_blocks(Reader& reader) {
+        CHECK(reader.valid());
+
+        for (size_t sn = 0; sn < NumSourcePackets * NumBlocks; sn++) {
+            check_packet(reader.read(), sn);
+        }
+
+        CHECK(!reader.read());
+        CHECK(reader.alive());
+    }
+};
+
+TEST(reader_lookahead, no_pool) {
+    Dispatcher dispatcher;
+    write_blocks(dispatcher);
+
+    DecoderStats stats;
+    MockDecoder decoder(stats);
+
+    Reader reader(reader_config, packet::FEC_ReedSolomon_M8, decoder,
+                  dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                  packet_pool, allocator);
+
+    read_blocks(reader);
+
+    // every block is repaired in reader thread
+    UNSIGNED_LONGS_EQUAL(NumBlocks, stats.n_repaired);
+}
+
+TEST(reader_lookahead, parallel_repair) {
+    Dispatcher dispatcher;
+    write_blocks(dispatcher);
+
+    DecoderStats pool_stats;
+
+    RepairPool pool(allocator);
+    for (size_t n = 0; n < NumWorkers; n++) {
+        CHECK(pool.add_worker(new (allocator) MockDecoder(pool_stats)));
+    }
+    UNSIGNED_LONGS_EQUAL(NumWorkers, pool.num_workers());
+
+    DecoderStats stats;
+    MockDecoder decoder(stats);
+
+    const core::nanoseconds_t start = core::timestamp();
+
+    {
+        Reader reader(reader_config, packet::FEC_ReedSolomon_M8, decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(),
+                      rtp_parser, packet_pool, allocator, &pool);
+
+        read_blocks(reader);
+    }
+
+    const core::nanoseconds_t elapsed = core::timestamp() - start;
+
+    // the first block is being read while following blocks arrive, and the
+    // last block is never followed by another one, so they are repaired in
+    // reader thread; all others are repaired by pool, concurrently
+    UNSIGNED_LONGS_EQUAL(2, stats.n_repaired);
+    UNSIGNED_LONGS_EQUAL(NumBlocks - 2, pool_stats.n_repaired);
+
+    CHECK(pool_stats.max_active > 1);
+    CHECK(pool_stats.max_active <= NumWorkers);
+
+    CHECK(elapsed < core::nanoseconds_t(NumBlocks - 1) * DecodeTime);
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,465 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_fec/composer.h"
+#include "roc_fec/headers.h"
+#include "roc_fec/parser.h"
+#include "roc_fec/rlc.h"
+#include "roc_fec/sliding_reader.h"
+#include "roc_fec/sliding_writer.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/format_map.h"
+#include "roc_rtp/headers.h"
+#include "roc_rtp/parser.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+const size_t NumSourcePackets = 20;
+const size_t NumRepairPackets = 10;
+
+const unsigned SourceID = 555;
+const unsigned PayloadType = rtp::PayloadType_L16_Stereo;
+
+const size_t FECPayloadSize = 193;
+
+const size_t MaxBuffSize = 500;
+
+const size_t MaxLost = 100;
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBuffSize, true);
+packet::PacketPool packet_pool(allocator, true);
+
+rtp::FormatMap format_map;
+rtp::Parser rtp_parser(format_map, NULL);
+
+fec::Parser<RLC_Source_PayloadID, Source, Footer> source_parser(&rtp_parser);
+fec::Parser<RLC_Repair_PayloadID, Repair, Header> repair_parser(NULL);
+
+rtp::Composer rtp_composer(NULL);
+fec::Composer<RLC_Source_PayloadID, Source, Footer> source_composer(&rtp_composer);
+fec::Composer<RLC_Repair_PayloadID, Repair, Header> repair_composer(NULL);
+
+// Reparses packets from writer and routes them to source and repair queues,
+// dropping source packets with the given numbers.
+class Dispatcher : public packet::IWriter {
+public:
+    Dispatcher()
+        : n_source_(0)
+        , n_repair_(0)
+        , n_lost_(0) {
+    }
+
+    virtual void write(const packet::PacketPtr& pp) {
+        CHECK(pp);
+        CHECK(pp->flags() & packet::Packet::FlagComposed);
+
+        if (pp->flags() & packet::Packet::FlagAudio) {
+            if (!is_lost_(n_source_++)) {
+                source_queue_.write(reparse_(source_parser, pp));
+            }
+        } else if (pp->flags() & packet::Packet::FlagRepair) {
+            n_repair_++;
+            repair_queue_.write(reparse_(repair_parser, pp));
+        } else {
+            FAIL("unexpected packet type");
+        }
+    }
+
+    packet::IReader& source_reader() {
+        return source_queue_;
+    }
+
+    packet::IReader& repair_reader() {
+        return repair_queue_;
+    }
+
+    size_t n_source() const {
+        return n_source_;
+    }
+
+    size_t n_repair() const {
+        return n_repair_;
+    }
+
+    void lose(size_t n) {
+        CHECK(n_lost_ != MaxLost);
+        lost_[n_lost_++] = n;
+    }
+
+private:
+    packet::PacketPtr reparse_(packet::IParser& parser, const packet::PacketPtr& old_pp) {
+        packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+        CHECK(pp);
+
+        CHECK(parser.parse(*pp, old_pp->data()));
+        pp->set_data(old_pp->data());
+
+        return pp;
+    }
+
+    bool is_lost_(size_t n) const {
+        for (size_t i = 0; i < n_lost_; i++) {
+            if (lost_[i] == n) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    packet::Queue source_queue_;
+    packet::Queue repair_queue_;
+
+    size_t n_source_;
+    size_t n_repair_;
+
+    size_t lost_[MaxLost];
+    size_t n_lost_;
+};
+
+} // namespace
+
+TEST_GROUP(sliding_writer_reader) {
+    WriterConfig writer_config;
+    ReaderConfig reader_config;
+
+    void setup() {
+        writer_config.n_source_packets = NumSourcePackets;
+        writer_config.n_repair_packets = NumRepairPackets;
+    }
+
+    packet::PacketPtr make_packet(size_t sn, size_t fec_payload_size = FECPayloadSize) {
+        CHECK(fec_payload_size > sizeof(rtp::Header));
+        const size_t rtp_payload_size = fec_payload_size - sizeof(rtp::Header);
+
+        packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+        CHECK(pp);
+
+        core::Slice<uint8_t> bp = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+        CHECK(bp);
+
+        CHECK(source_composer.prepare(*pp, bp, rtp_payload_size));
+
+        pp->set_data(bp);
+
+        UNSIGNED_LONGS_EQUAL(rtp_payload_size, pp->rtp()->payload.size());
+        UNSIGNED_LONGS_EQUAL(fec_payload_size, pp->fec()->payload.size());
+
+        pp->add_flags(packet::Packet::FlagAudio);
+
+        pp->rtp()->source = SourceID;
+        pp->rtp()->payload_type = PayloadType;
+        pp->rtp()->seqnum = packet::seqnum_t(sn);
+        pp->rtp()->timestamp = packet::timestamp_t(sn * 10);
+
+        for (size_t i = 0; i < rtp_payload_size; i++) {
+            pp->rtp()->payload.data()[i] = uint8_t(sn * 7 + i);
+        }
+
+        return pp;
+    }
+
+    void check_packet(const packet::PacketPtr& pp,
+                      size_t sn,
+                      bool restored,
+                      size_t fec_payload_size = FECPayloadSize) {
+        const size_t rtp_payload_size = fec_payload_size - sizeof(rtp::Header);
+
+        CHECK(pp);
+
+        CHECK(pp->flags() & packet::Packet::FlagRTP);
+        CHECK(pp->flags() & packet::Packet::FlagAudio);
+
+        CHECK(pp->rtp());
+        UNSIGNED_LONGS_EQUAL(SourceID, pp->rtp()->source);
+        UNSIGNED_LONGS_EQUAL(sn, pp->rtp()->seqnum);
+        UNSIGNED_LONGS_EQUAL(packet::timestamp_t(sn * 10), pp->rtp()->timestamp);
+        UNSIGNED_LONGS_EQUAL(PayloadType, pp->rtp()->payload_type);
+        UNSIGNED_LONGS_EQUAL(rtp_payload_size, pp->rtp()->payload.size());
+
+        for (size_t i = 0; i < rtp_payload_size; i++) {
+            UNSIGNED_LONGS_EQUAL(uint8_t(sn * 7 + i), pp->rtp()->payload.data()[i]);
+        }
+
+        CHECK(bool(pp->flags() & packet::Packet::FlagRestored) == restored);
+    }
+};
+
+TEST(sliding_writer_reader, no_losses) {
+    enum { NumPackets = NumSourcePackets * 5 };
+
+    Dispatcher dispatcher;
+
+    SlidingWriter writer(writer_config, packet::FEC_RLC, dispatcher, source_composer,
+                         repair_composer, packet_pool, buffer_pool, allocator);
+
+    SlidingReader reader(reader_config, packet::FEC_RLC, dispatcher.source_reader(),
+                         dispatcher.repair_reader(), rtp_parser, packet_pool,
+                         buffer_pool, allocator);
+
+    CHECK(writer.valid());
+    CHECK(reader.valid());
+
+    for (size_t i = 0; i < NumPackets; ++i) {
+        writer.write(make_packet(i));
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, dispatcher.n_source());
+    UNSIGNED_LONGS_EQUAL(NumPackets * NumRepairPackets / NumSourcePackets,
+                         dispatcher.n_repair());
+
+    for (size_t i = 0; i < NumPackets; ++i) {
+        check_packet(reader.read(), i, false);
+    }
+
+    CHECK(!reader.read());
+
+    CHECK(writer.alive());
+    CHECK(reader.alive());
+}
+
+TEST(sliding_writer_reader, scattered_losses) {
+    enum { NumPackets = NumSourcePackets * 10 };
+
+    Dispatcher dispatcher;
+
+    SlidingWriter writer(writer_config, packet::FEC_RLC, dispatcher, source_composer,
+                         repair_composer, packet_pool, buffer_pool, allocator);
+
+    SlidingReader reader(reader_config, packet::FEC_RLC, dispatcher.source_reader(),
+                         dispatcher.repair_reader(), rtp_parser, packet_pool,
+                         buffer_pool, allocator);
+
+    CHECK(writer.valid());
+    CHECK(reader.valid());
+
+    for (size_t i = 3; i < NumPackets - NumSourcePackets; i += 7) {
+        dispatcher.lose(i);
+    }
+
+    for (size_t i = 0; i < NumPackets; ++i) {
+        writer.write(make_packet(i));
+    }
+
+    for (size_t i = 0; i < NumPackets; ++i) {
+        check_packet(reader.read(), i, i >= 3 && i < NumPackets - NumSourcePackets
+                                           && (i - 3) % 7 == 0);
+    }
+
+    CHECK(!reader.read());
+}
+
+TEST(sliding_writer_reader, burst_loss) {
+    enum { NumPackets = NumSourcePackets * 4, FirstLost = 25, NumLost = 8 };
+
+    Dispatcher dispatcher;
+
+    SlidingWriter writer(writer_config, packet::FEC_RLC, dispatcher, source_composer,
+                         repair_composer, packet_pool, buffer_pool, allocator);
+
+    SlidingReader reader(reader_config, packet::FEC_RLC, dispatcher.source_reader(),
+                         dispatcher.repair_reader(), rtp_parser, packet_pool,
+                         buffer_pool, allocator);
+
+    CHECK(writer.valid());
+    CHECK(reader.valid());
+
+    for (size_t i = FirstLost; i < FirstLost + NumLost; ++i) {
+        dispatcher.lose(i);
+    }
+
+    for (size_t i = 0; i < NumPackets; ++i) {
+        writer.write(make_packet(i));
+    }
+
+    for (size_t i = 0; i < NumPackets; ++i) {
+        check_packet(reader.read(), i, i >= FirstLost && i < FirstLost + NumLost);
+    }
+
+    CHECK(!reader.read());
+}
+
+TEST(sliding_writer_reader, restore_without_waiting_window_end) {
+    enum { NumPackets = NumSourcePackets * 2, LostPacket = NumSourcePackets + 1 };
+
+    Dispatcher dispatcher;
+
+    SlidingWriter writer(writer_config, packet::FEC_RLC, dispatcher, source_composer,
+                         repair_composer, packet_pool, buffer_pool, allocator);
+
+    SlidingReader reader(reader_config, packet::FEC_RLC, dispatcher.source_reader(),
+                         dispatcher.repair_reader(), rtp_parser, packet_pool,
+                         buffer_pool, allocator);
+
+    CHECK(writer.valid());
+    CHECK(reader.valid());
+
+    dispatcher.lose(LostPacket);
+
+    // a repair packet is generated after every two source packets, so the
+    // lost packet can be restored right after the next repair packet
+    for (size_t i = 0; i < LostPacket + 2; ++i) {
+        writer.write(make_packet(i));
+    }
+
+    for (size_t i = 0; i < LostPacket + 2; ++i) {
+        check_packet(reader.read(), i, i == LostPacket);
+    }
+
+    CHECK(!reader.read());
+
+    for (size_t i = LostPacket + 2; i < NumPackets; ++i) {
+        writer.write(make_packet(i));
+        check_packet(reader.read(), i, false);
+    }
+}
+
+TEST(sliding_writer_reader, lost_first_packet) {
+    enum { NumPackets = NumSourcePackets * 2 };
+
+    Dispatcher dispatcher;
+
+    SlidingWriter writer(writer_config, packet::FEC_RLC, dispatcher, source_composer,
+                         repair_composer, packet_pool, buffer_pool, allocator);
+
+    SlidingReader reader(reader_config, packet::FEC_RLC, dispatcher.source_reader(),
+                         dispatcher.repair_reader(), rtp_parser, packet_pool,
+                         buffer_pool, allocator);
+
+    CHECK(writer.valid());
+    CHECK(reader.valid());
+
+    dispatcher.lose(0);
+
+    for (size_t i = 0; i < NumPackets; ++i) {
+        writer.write(make_packet(i));
+    }
+
+    // decoding starts from the first received source packet, so the packets
+    // before it are not restored, even if repair packets cover them
+    for (size_t i = 1; i < NumPackets; ++i) {
+        check_packet(reader.read(), i, false);
+    }
+
+    CHECK(!reader.read());
+    CHECK(reader.alive());
+}
+
+TEST(sliding_writer_reader, too_many_losses) {
+    enum { NumPackets = NumSourcePackets * 5, FirstLost = 30, NumLost = 15 };
+
+    Dispatcher dispatcher;
+
+    SlidingWriter writer(writer_config, packet::FEC_RLC, dispatcher, source_composer,
+                         repair_composer, packet_pool, buffer_pool, allocator);
+
+    SlidingReader reader(reader_config, packet::FEC_RLC, dispatcher.source_reader(),
+                         dispatcher.repair_reader(), rtp_parser, packet_pool,
+                         buffer_pool, allocator);
+
+    CHECK(writer.valid());
+    CHECK(reader.valid());
+
+    for (size_t i = FirstLost; i < FirstLost + NumLost; ++i) {
+        dispatcher.lose(i);
+    }
+
+    for (size_t i = 0; i < NumPackets; ++i) {
+        writer.write(make_packet(i));
+    }
+
+    for (size_t i = 0; i < FirstLost; ++i) {
+        check_packet(reader.read(), i, false);
+    }
+
+    // lost packets which can't be restored are skipped
+    for (size_t i = FirstLost; i < NumPackets; ++i) {
+        packet::PacketPtr pp = reader.read();
+        CHECK(pp);
+
+        if (pp->rtp()->seqnum == i) {
+            continue;
+        }
+
+        CHECK(pp->rtp()->seqnum > i);
+        CHECK(pp->rtp()->seqnum >= FirstLost + NumLost
+              || (pp->flags() & packet::Packet::FlagRestored));
+
+        i = pp->rtp()->seqnum;
+    }
+
+    CHECK(!reader.read());
+    CHECK(reader.alive());
+}
+
+TEST(sliding_writer_reader, payload_size_change) {
+    enum { NumPackets = NumSourcePackets * 3, LostPacket = 10 };
+
+    const size_t payload_sizes[] = { FECPayloadSize, FECPayloadSize + 50 };
+
+    Dispatcher dispatcher;
+
+    SlidingWriter writer(writer_config, packet::FEC_RLC, dispatcher, source_composer,
+                         repair_composer, packet_pool, buffer_pool, allocator);
+
+    SlidingReader reader(reader_config, packet::FEC_RLC, dispatcher.source_reader(),
+                         dispatcher.repair_reader(), rtp_parser, packet_pool,
+                         buffer_pool, allocator);
+
+    CHECK(writer.valid());
+    CHECK(reader.valid());
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(payload_sizes); n++) {
+        dispatcher.lose(n * NumPackets + LostPacket);
+    }
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(payload_sizes); n++) {
+        for (size_t i = 0; i < NumPackets; ++i) {
+            writer.write(make_packet(n * NumPackets + i, payload_sizes[n]));
+        }
+    }
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(payload_sizes); n++) {
+        for (size_t i = 0; i < NumPackets; ++i) {
+            check_packet(reader.read(), n * NumPackets + i, i == LostPacket,
+                         payload_sizes[n]);
+        }
+    }
+
+    CHECK(!reader.read());
+}
+
+TEST(sliding_writer_reader, invalid_window_length) {
+    Dispatcher dispatcher;
+
+    writer_config.n_source_packets = 0;
+
+    SlidingWriter writer1(writer_config, packet::FEC_RLC, dispatcher, source_composer,
+                          repair_composer, packet_pool, buffer_pool, allocator);
+
+    CHECK(!writer1.valid());
+
+    writer_config.n_source_packets = RLCMaxWindowLength + 1;
+
+    SlidingWriter writer2(writer_config, packet::FEC_RLC, dispatcher, source_composer,
+                          repair_composer, packet_pool, buffer_pool, allocator);
+
+    CHECK(!writer2.valid());
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_netio/transceiver.h"
+#include "roc_packet/address.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+enum { NumPackets = 10, BufferSize = 125 };
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, BufferSize, true);
+packet::PacketPool packet_pool(allocator, true);
+
+} // namespace
+
+TEST_GROUP(loopback) {
+    packet::Address new_address(int port) {
+        packet::Address addr;
+        CHECK(addr.set_ipv4("127.0.0.1", port));
+        return addr;
+    }
+
+    packet::PacketPtr new_packet(packet::Address rx_addr) {
+        packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+        CHECK(pp);
+
+        pp->add_flags(packet::Packet::FlagUDP);
+        pp->udp()->dst_addr = rx_addr;
+
+        core::Slice<uint8_t> buf = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+        CHECK(buf);
+        pp->set_data(buf);
+
+        return pp;
+    }
+};
+
+TEST(loopback, zero_copy) {
+    packet::Queue rx_queue;
+
+    packet::Address tx_addr = new_address(10001);
+    packet::Address rx_addr = new_address(10002);
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_loopback_sender(tx_addr);
+    CHECK(tx_sender);
+
+    CHECK(trx.add_loopback_receiver(rx_addr, rx_queue));
+
+    UNSIGNED_LONGS_EQUAL(2, trx.num_ports());
+
+    for (int p = 0; p < NumPackets; p++) {
+        packet::PacketPtr pp = new_packet(rx_addr);
+        tx_sender->write(pp);
+
+        packet::PacketPtr rp = rx_queue.read();
+        CHECK(rp == pp);
+        CHECK(rp->data().data() == pp->data().data());
+
+        CHECK(rp->udp()->src_addr == tx_addr);
+        CHECK(rp->udp()->dst_addr == rx_addr);
+    }
+
+    trx.remove_port(tx_addr);
+    trx.remove_port(rx_addr);
+
+    UNSIGNED_LONGS_EQUAL(0, trx.num_ports());
+}
+
+TEST(loopback, multiple_receivers) {
+    packet::Queue rx_queue1;
+    packet::Queue rx_queue2;
+
+    packet::Address tx_addr = new_address(10001);
+    packet::Address rx_addr1 = new_address(10002);
+    packet::Address rx_addr2 = new_address(10003);
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_loopback_sender(tx_addr);
+    CHECK(tx_sender);
+
+    CHECK(trx.add_loopback_receiver(rx_addr1, rx_queue1));
+    CHECK(trx.add_loopback_receiver(rx_addr2, rx_queue2));
+
+    for (int p = 0; p < NumPackets; p++) {
+        tx_sender->write(new_packet(rx_addr1));
+        tx_sender->write(new_packet(rx_addr2));
+        tx_sender->write(new_packet(rx_addr2));
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, rx_queue1.size());
+    UNSIGNED_LONGS_EQUAL(NumPackets * 2, rx_queue2.size());
+}
+
+TEST(loopback, unbound_address) {
+    packet::Queue rx_queue;
+
+    packet::Address tx_addr = new_address(10001);
+    packet::Address rx_addr = new_address(10002);
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_loopback_sender(tx_addr);
+    CHECK(tx_sender);
+
+    CHECK(trx.add_loopback_receiver(rx_addr, rx_queue));
+
+    tx_sender->write(new_packet(new_address(10003)));
+    UNSIGNED_LONGS_EQUAL(0, rx_queue.size());
+
+    trx.remove_port(rx_addr);
+
+    tx_sender->write(new_packet(rx_addr));
+    UNSIGNED_LONGS_EQUAL(0, rx_queue.size());
+}
+
+TEST(loopback, bind_twice) {
+    packet::Queue rx_queue1;
+    packet::Queue rx_queue2;
+
+    packet::Address rx_addr = new_address(10002);
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    CHECK(trx.add_loopback_receiver(rx_addr, rx_queue1));
+    CHECK(!trx.add_loopback_receiver(rx_addr, rx_queue2));
+
+    UNSIGNED_LONGS_EQUAL(1, trx.num_ports());
+}
+
+TEST(loopback, bind_zero_port) {
+    packet::Queue rx_queue;
+
+    packet::Address rx_addr = new_address(0);
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    CHECK(!trx.add_loopback_receiver(rx_addr, rx_queue));
+
+    UNSIGNED_LONGS_EQUAL(0, trx.num_ports());
+}
+
+} // namespace netio
+} // namespace roc
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/time.h"
+#include "roc_netio/shm_ring.h"
+#include "roc_netio/transceiver.h"
+#include "roc_packet/address.h"
+#include "roc_packet/concurrent_queue.h"
+#include "roc_packet/packet_pool.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+enum { NumIterations = 20, NumPackets = 10, BufferSize = 125, MaxAttempts = 500 };
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, BufferSize, true);
+packet::PacketPool packet_pool(allocator, true);
+
+} // namespace
+
+TEST_GROUP(shm) {
+    packet::Address new_address(int port) {
+        packet::Address addr;
+        CHECK(addr.set_ipv4("127.0.0.1", port));
+        return addr;
+    }
+
+    core::Slice<uint8_t> new_buffer(int value) {
+        core::Slice<uint8_t> buf = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+        CHECK(buf);
+        buf.resize(BufferSize);
+        for (int n = 0; n < BufferSize; n++) {
+            buf.data()[n] = uint8_t((value + n) & 0xff);
+        }
+        return buf;
+    }
+
+    packet::PacketPtr new_packet(packet::Address rx_addr, int value) {
+        packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+        CHECK(pp);
+
+        pp->add_flags(packet::Packet::FlagUDP);
+        pp->udp()->dst_addr = rx_addr;
+
+        pp->set_data(new_buffer(value));
+
+        return pp;
+    }
+
+    void check_packet(const packet::PacketPtr& pp,
+                      packet::Address tx_addr,
+                      packet::Address rx_addr,
+                      int value) {
+        CHECK(pp);
+
+        CHECK(pp->udp());
+        CHECK(pp->data());
+
+        CHECK(pp->udp()->src_addr == tx_addr);
+        CHECK(pp->udp()->dst_addr == rx_addr);
+
+        core::Slice<uint8_t> expected = new_buffer(value);
+
+        UNSIGNED_LONGS_EQUAL(expected.size(), pp->data().size());
+        CHECK(memcmp(pp->data().data(), expected.data(), expected.size()) == 0);
+    }
+};
+
+TEST(shm, one_sender_one_receiver) {
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr = new_address(20001);
+    packet::Address rx_addr = new_address(20002);
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    CHECK(trx.add_shm_receiver(rx_addr, rx_queue));
+
+    packet::IWriter* tx_sender = trx.add_shm_sender(tx_addr);
+    CHECK(tx_sender);
+
+    for (int i = 0; i < NumIterations; i++) {
+        for (int p = 0; p < NumPackets; p++) {
+            tx_sender->write(new_packet(rx_addr, p));
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            check_packet(rx_queue.read(), tx_addr, rx_addr, p);
+        }
+    }
+
+    trx.remove_port(tx_addr);
+    trx.remove_port(rx_addr);
+}
+
+TEST(shm, separate_transceivers) {
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr = new_address(20001);
+    packet::Address rx_addr = new_address(20002);
+
+    Transceiver rx(packet_pool, buffer_pool, allocator);
+    CHECK(rx.valid());
+
+    CHECK(rx.add_shm_receiver(rx_addr, rx_queue));
+
+    Transceiver tx(packet_pool, buffer_pool, allocator);
+    CHECK(tx.valid());
+
+    packet::IWriter* tx_sender = tx.add_shm_sender(tx_addr);
+    CHECK(tx_sender);
+
+    for (int i = 0; i < NumIterations; i++) {
+        for (int p = 0; p < NumPackets; p++) {
+            tx_sender->write(new_packet(rx_addr, p));
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            check_packet(rx_queue.read(), tx_addr, rx_addr, p);
+        }
+    }
+}
+
+TEST(shm, receiver_restart) {
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr = new_address(20001);
+    packet::Address rx_addr = new_address(20002);
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_shm_sender(tx_addr);
+    CHECK(tx_sender);
+
+    for (int i = 0; i < 2; i++) {
+        CHECK(trx.add_shm_receiver(rx_addr, rx_queue));
+
+        tx_sender->write(new_packet(rx_addr, i));
+        check_packet(rx_queue.read(), tx_addr, rx_addr, i);
+
+        trx.remove_port(rx_addr);
+    }
+}
+
+TEST(shm, receiver_crash) {
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr = new_address(20001);
+    packet::Address rx_addr = new_address(20002);
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_shm_sender(tx_addr);
+    CHECK(tx_sender);
+
+    // segment of a receiver which crashed and didn't close it
+    char name[ShmRing::MaxNameLen];
+    CHECK(ShmRing::make_name(rx_addr, name, sizeof(name)));
+
+    ShmRing crashed_ring;
+    CHECK(crashed_ring.create(name, NumPackets, BufferSize));
+
+    packet::Address addr;
+    uint8_t data[BufferSize];
+    size_t size = 0;
+
+    tx_sender->write(new_packet(rx_addr, 0));
+    CHECK(crashed_ring.read(addr, data, size));
+
+    CHECK(trx.add_shm_receiver(rx_addr, rx_queue));
+
+    // sender switches to the new segment when it notices that the old one
+    // was replaced
+    int value = 1;
+    for (;; value++) {
+        CHECK(value < MaxAttempts);
+
+        tx_sender->write(new_packet(rx_addr, value));
+
+        if (!crashed_ring.read(addr, data, size)) {
+            break;
+        }
+
+        core::sleep_for(10 * core::Millisecond);
+    }
+
+    check_packet(rx_queue.read(), tx_addr, rx_addr, value);
+
+    trx.remove_port(rx_addr);
+}
+
+TEST(shm, bind_zero_port) {
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address rx_addr = new_address(0);
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    CHECK(!trx.add_shm_receiver(rx_addr, rx_queue));
+}
+
+} // namespace netio
+} // namespace roc
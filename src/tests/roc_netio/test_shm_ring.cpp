@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include "roc_core/thread.h"
+#include "roc_netio/shm_ring.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+enum { NumSlots = 16, SlotSize = 100, NumPackets = 10000 };
+
+class Writer : public core::Thread {
+public:
+    Writer(ShmRing& ring, const packet::Address& addr, uint8_t id)
+        : ring_(ring)
+        , addr_(addr)
+        , id_(id) {
+    }
+
+private:
+    virtual void run() {
+        for (size_t n = 0; n < NumPackets;) {
+            uint8_t data[2] = { id_, uint8_t(n & 0xff) };
+            if (ring_.write(addr_, data, sizeof(data))) {
+                n++;
+            }
+        }
+    }
+
+    ShmRing& ring_;
+    packet::Address addr_;
+    uint8_t id_;
+};
+
+} // namespace
+
+TEST_GROUP(shm_ring) {
+    char name[ShmRing::MaxNameLen];
+
+    void setup() {
+        snprintf(name, sizeof(name), "/roc-test-%ld", (long)getpid());
+    }
+
+    packet::Address new_address(int port) {
+        packet::Address addr;
+        CHECK(addr.set_ipv4("127.0.0.1", port));
+        return addr;
+    }
+};
+
+TEST(shm_ring, make_name) {
+    char buf[ShmRing::MaxNameLen];
+
+    CHECK(ShmRing::make_name(new_address(123), buf, sizeof(buf)));
+    STRCMP_EQUAL("/roc-127.0.0.1-123", buf);
+
+    packet::Address addr6;
+    CHECK(addr6.set_ipv6("::1", 123));
+
+    CHECK(ShmRing::make_name(addr6, buf, sizeof(buf)));
+    STRCMP_EQUAL("/roc-__1-123", buf);
+}
+
+TEST(shm_ring, attach_missing) {
+    ShmRing writer;
+    CHECK(!writer.attach(name));
+    CHECK(!writer.valid());
+}
+
+TEST(shm_ring, write_read) {
+    ShmRing reader;
+    CHECK(reader.create(name, NumSlots, SlotSize));
+
+    ShmRing writer;
+    CHECK(writer.attach(name));
+
+    UNSIGNED_LONGS_EQUAL(SlotSize, writer.slot_size());
+
+    const packet::Address src_addr = new_address(123);
+
+    for (size_t i = 0; i < NumSlots * 3; i++) {
+        uint8_t wdata[SlotSize];
+        for (size_t n = 0; n < i % SlotSize + 1; n++) {
+            wdata[n] = uint8_t(i + n);
+        }
+        CHECK(writer.write(src_addr, wdata, i % SlotSize + 1));
+
+        packet::Address addr;
+        uint8_t rdata[SlotSize];
+        size_t size = 0;
+        CHECK(reader.read(addr, rdata, size));
+
+        UNSIGNED_LONGS_EQUAL(i % SlotSize + 1, size);
+        CHECK(memcmp(wdata, rdata, size) == 0);
+        CHECK(addr == src_addr);
+
+        CHECK(!reader.read(addr, rdata, size));
+    }
+}
+
+TEST(shm_ring, full) {
+    ShmRing reader;
+    CHECK(reader.create(name, NumSlots, SlotSize));
+
+    ShmRing writer;
+    CHECK(writer.attach(name));
+
+    const packet::Address src_addr = new_address(123);
+    uint8_t data[SlotSize] = {};
+
+    for (size_t i = 0; i < NumSlots; i++) {
+        CHECK(writer.write(src_addr, data, sizeof(data)));
+    }
+    CHECK(!writer.write(src_addr, data, sizeof(data)));
+
+    packet::Address addr;
+    size_t size = 0;
+    CHECK(reader.read(addr, data, size));
+
+    CHECK(writer.write(src_addr, data, sizeof(data)));
+    CHECK(!writer.write(src_addr, data, sizeof(data)));
+}
+
+TEST(shm_ring, too_large) {
+    ShmRing reader;
+    CHECK(reader.create(name, NumSlots, SlotSize));
+
+    ShmRing writer;
+    CHECK(writer.attach(name));
+
+    uint8_t data[SlotSize + 1] = {};
+    CHECK(!writer.write(new_address(123), data, sizeof(data)));
+}
+
+TEST(shm_ring, closed) {
+    ShmRing writer;
+
+    {
+        ShmRing reader;
+        CHECK(reader.create(name, NumSlots, SlotSize));
+
+        CHECK(writer.attach(name));
+        CHECK(!writer.closed());
+    }
+
+    CHECK(writer.closed());
+}
+
+TEST(shm_ring, stale) {
+    ShmRing writer;
+
+    ShmRing reader1;
+    CHECK(reader1.create(name, NumSlots, SlotSize));
+
+    CHECK(writer.attach(name));
+    CHECK(!writer.stale());
+
+    {
+        // reader restarted without closing the old segment, e.g. after crash
+        ShmRing reader2;
+        CHECK(reader2.create(name, NumSlots, SlotSize));
+
+        CHECK(!writer.closed());
+        CHECK(writer.stale());
+    }
+
+    // segment removed
+    CHECK(writer.stale());
+}
+
+TEST(shm_ring, wait_timeout) {
+    ShmRing reader;
+    CHECK(reader.create(name, NumSlots, SlotSize));
+
+    reader.wait(core::Millisecond);
+
+    packet::Address addr;
+    uint8_t data[SlotSize];
+    size_t size = 0;
+    CHECK(!reader.read(addr, data, size));
+}
+
+TEST(shm_ring, concurrent_writers) {
+    ShmRing reader;
+    CHECK(reader.create(name, NumSlots, SlotSize));
+
+    ShmRing writer_ring1;
+    CHECK(writer_ring1.attach(name));
+
+    ShmRing writer_ring2;
+    CHECK(writer_ring2.attach(name));
+
+    Writer writer1(writer_ring1, new_address(1), 1);
+    Writer writer2(writer_ring2, new_address(2), 2);
+
+    CHECK(writer1.start());
+    CHECK(writer2.start());
+
+    size_t counts[3] = {};
+
+    for (size_t n = 0; n < NumPackets * 2;) {
+        packet::Address addr;
+        uint8_t data[SlotSize];
+        size_t size = 0;
+
+        if (!reader.read(addr, data, size)) {
+            reader.wait(core::Millisecond);
+            continue;
+        }
+
+        UNSIGNED_LONGS_EQUAL(2, size);
+        CHECK(data[0] == 1 || data[0] == 2);
+        LONGS_EQUAL(data[0], addr.port());
+
+        // packets of every writer are received in order
+        UNSIGNED_LONGS_EQUAL(counts[data[0]] & 0xff, data[1]);
+        counts[data[0]]++;
+
+        n++;
+    }
+
+    writer1.join();
+    writer2.join();
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, counts[1]);
+    UNSIGNED_LONGS_EQUAL(NumPackets, counts[2]);
+}
+
+} // namespace netio
+} // namespace roc
@@ -181,5 +181,33 @@ TEST(transceiver, add_duplicate) {
     UNSIGNED_LONGS_EQUAL(0, trx.num_ports());
 }
 
+TEST(transceiver, shared_multicast) {
+    packet::ConcurrentQueue queue1;
+    packet::ConcurrentQueue queue2;
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+
+    CHECK(trx.valid());
+
+    packet::Address rx_addr1 = make_address("224.0.0.1", 0);
+    CHECK(rx_addr1.set_miface("127.0.0.1"));
+
+    CHECK(trx.add_udp_receiver(rx_addr1, queue1));
+    UNSIGNED_LONGS_EQUAL(1, trx.num_ports());
+
+    packet::Address rx_addr2 = rx_addr1;
+
+    CHECK(trx.add_udp_receiver(rx_addr2, queue2));
+    UNSIGNED_LONGS_EQUAL(1, trx.num_ports());
+
+    CHECK(rx_addr1 == rx_addr2);
+
+    trx.remove_udp_receiver(rx_addr1, queue1);
+    UNSIGNED_LONGS_EQUAL(1, trx.num_ports());
+
+    trx.remove_udp_receiver(rx_addr2, queue2);
+    UNSIGNED_LONGS_EQUAL(0, trx.num_ports());
+}
+
 } // namespace netio
 } // namespace roc
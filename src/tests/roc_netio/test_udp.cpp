@@ -8,8 +8,10 @@
 
 #include <CppUTest/TestHarness.h>
 
+#include "roc_core/atomic.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
+#include "roc_core/time.h"
 #include "roc_netio/transceiver.h"
 #include "roc_packet/address.h"
 #include "roc_packet/concurrent_queue.h"
@@ -22,10 +24,74 @@ namespace {
 
 enum { NumIterations = 20, NumPackets = 10, BufferSize = 125 };
 
+const core::nanoseconds_t SendDelay = 100 * core::Millisecond;
+
 core::HeapAllocator allocator;
 core::BufferPool<uint8_t> buffer_pool(allocator, BufferSize, true);
 packet::PacketPool packet_pool(allocator, true);
 
+// Emulates a receiver pipeline which parses packets in write().
+class ParsingWriter : public packet::IWriter {
+public:
+    ParsingWriter(packet::IWriter& writer)
+        : writer_(writer)
+        , n_parsed_(0) {
+    }
+
+    virtual void write(const packet::PacketPtr& pp) {
+        if (pp->flags() != packet::Packet::FlagUDP) {
+            ++n_parsed_;
+        }
+        pp->add_flags(packet::Packet::FlagRTP);
+        writer_.write(pp);
+    }
+
+    size_t num_already_parsed() const {
+        return (size_t)(long)n_parsed_;
+    }
+
+private:
+    packet::IWriter& writer_;
+    core::Atomic n_parsed_;
+};
+
+// Records batches passed by receiver port.
+class BatchWriter : public packet::IWriter {
+public:
+    BatchWriter(packet::IWriter& writer)
+        : writer_(writer)
+        , n_writes_(0)
+        , max_batch_(0) {
+    }
+
+    virtual void write(const packet::PacketPtr& pp) {
+        ++n_writes_;
+        writer_.write(pp);
+    }
+
+    virtual void write_batch(const packet::PacketPtr* packets, size_t n_packets) {
+        if (max_batch_ < n_packets) {
+            max_batch_ = n_packets;
+        }
+        writer_.write_batch(packets, n_packets);
+    }
+
+    // Should be called after packets are read from the queue, which
+    // synchronizes with the network thread.
+    size_t num_writes() const {
+        return n_writes_;
+    }
+
+    size_t max_batch() const {
+        return max_batch_;
+    }
+
+private:
+    packet::IWriter& writer_;
+    size_t n_writes_;
+    size_t max_batch_;
+};
+
 } // namespace
 
 TEST_GROUP(udp) {
@@ -220,5 +286,147 @@ TEST(udp, multiple_senders_one_receiver) {
     }
 }
 
+TEST(udp, shared_multicast_receivers) {
+    packet::ConcurrentQueue rx_queue1;
+    packet::ConcurrentQueue rx_queue2;
+
+    ParsingWriter rx_writer1(rx_queue1);
+    ParsingWriter rx_writer2(rx_queue2);
+
+    packet::Address tx_addr = new_address();
+
+    packet::Address rx_addr;
+    CHECK(rx_addr.set_ipv4("224.0.0.1", 0));
+    CHECK(rx_addr.set_miface("127.0.0.1"));
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr);
+    CHECK(tx_sender);
+
+    CHECK(trx.add_udp_receiver(rx_addr, rx_writer1));
+    CHECK(trx.add_udp_receiver(rx_addr, rx_writer2));
+    UNSIGNED_LONGS_EQUAL(2, trx.num_ports());
+
+    for (int p = 0; p < NumPackets; p++) {
+        tx_sender->write(new_packet(tx_addr, rx_addr, p));
+    }
+
+    for (int p = 0; p < NumPackets; p++) {
+        packet::PacketPtr pp1 = rx_queue1.read();
+        packet::PacketPtr pp2 = rx_queue2.read();
+
+        check_packet(pp1, tx_addr, rx_addr, p);
+        check_packet(pp2, tx_addr, rx_addr, p);
+
+        // Every receiver gets its own headers, but data buffer is shared.
+        CHECK(pp1 != pp2);
+        CHECK(pp1->data().data() == pp2->data().data());
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, rx_writer1.num_already_parsed());
+    UNSIGNED_LONGS_EQUAL(0, rx_writer2.num_already_parsed());
+}
+
+TEST(udp, receiver_batches) {
+    packet::ConcurrentQueue rx_queue;
+    BatchWriter rx_writer(rx_queue);
+
+    packet::Address tx_addr = new_address();
+    packet::Address rx_addr = new_address();
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr);
+    CHECK(tx_sender);
+
+    CHECK(trx.add_udp_receiver(rx_addr, rx_writer));
+
+    for (int i = 0; i < NumIterations; i++) {
+        packet::PacketPtr packets[NumPackets];
+        for (int p = 0; p < NumPackets; p++) {
+            packets[p] = new_packet(tx_addr, rx_addr, p);
+        }
+
+        // Sent in one event loop iteration and received in the next one.
+        tx_sender->write_batch(packets, NumPackets);
+
+        for (int p = 0; p < NumPackets; p++) {
+            check_packet(rx_queue.read(), tx_addr, rx_addr, p);
+        }
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, rx_writer.num_writes());
+    CHECK(rx_writer.max_batch() > 1);
+}
+
+TEST(udp, send_time) {
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr = new_address();
+    packet::Address rx_addr = new_address();
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr);
+    CHECK(tx_sender);
+
+    CHECK(trx.add_udp_receiver(rx_addr, rx_queue));
+
+    for (int i = 0; i < NumIterations / 4; i++) {
+        const core::nanoseconds_t send_time = core::timestamp() + SendDelay;
+
+        for (int p = 0; p < NumPackets; p++) {
+            packet::PacketPtr pp = new_packet(tx_addr, rx_addr, p);
+            pp->udp()->send_time = send_time + p * core::Millisecond;
+            tx_sender->write(pp);
+        }
+
+        // written after delayed packets but sent immediately
+        tx_sender->write(new_packet(tx_addr, rx_addr, NumPackets));
+
+        check_packet(rx_queue.read(), tx_addr, rx_addr, NumPackets);
+        CHECK(core::timestamp() < send_time);
+
+        for (int p = 0; p < NumPackets; p++) {
+            check_packet(rx_queue.read(), tx_addr, rx_addr, p);
+            CHECK(core::timestamp() >= send_time + p * core::Millisecond);
+        }
+    }
+}
+
+TEST(udp, close_after_send_failure) {
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr = new_address();
+    packet::Address rx_addr = new_address();
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr);
+    CHECK(tx_sender);
+
+    CHECK(trx.add_udp_receiver(rx_addr, rx_queue));
+
+    // destination address is not set, so the packet can't be sent
+    tx_sender->write(new_packet(tx_addr, packet::Address(), 0));
+
+    // packets are sent in order, so the failed send is already finished
+    // when the next packet is received
+    tx_sender->write(new_packet(tx_addr, rx_addr, 1));
+    check_packet(rx_queue.read(), tx_addr, rx_addr, 1);
+
+    // should not hang waiting for the failed packet
+    trx.remove_port(tx_addr);
+    UNSIGNED_LONGS_EQUAL(1, trx.num_ports());
+
+    trx.remove_port(rx_addr);
+    UNSIGNED_LONGS_EQUAL(0, trx.num_ports());
+}
+
 } // namespace netio
 } // namespace roc
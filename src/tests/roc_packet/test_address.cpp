@@ -194,5 +194,45 @@ TEST(address, multicast_ipv6) {
     }
 }
 
+TEST(address, miface_ipv4) {
+    Address addr;
+    CHECK(!addr.set_miface("127.0.0.1"));
+
+    CHECK(addr.set_ipv4("224.0.0.1", 123));
+    CHECK(!addr.has_miface());
+
+    char buf[64];
+    CHECK(!addr.get_miface(buf, sizeof(buf)));
+
+    CHECK(!addr.set_miface("::1"));
+    CHECK(!addr.has_miface());
+
+    CHECK(addr.set_miface("127.0.0.1"));
+    CHECK(addr.has_miface());
+
+    CHECK(addr.get_miface(buf, sizeof(buf)));
+    STRCMP_EQUAL("127.0.0.1", buf);
+
+    Address other;
+    CHECK(other.set_ipv4("224.0.0.1", 123));
+    CHECK(addr == other);
+}
+
+TEST(address, miface_ipv6) {
+    Address addr;
+    CHECK(addr.set_ipv6("ff02::1", 123));
+    CHECK(!addr.has_miface());
+
+    CHECK(!addr.set_miface("127.0.0.1"));
+    CHECK(!addr.has_miface());
+
+    CHECK(addr.set_miface("::1"));
+    CHECK(addr.has_miface());
+
+    char buf[64];
+    CHECK(addr.get_miface(buf, sizeof(buf)));
+    STRCMP_EQUAL("::1", buf);
+}
+
 } // namespace packet
 } // namespace roc
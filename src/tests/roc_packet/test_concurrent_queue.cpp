@@ -9,6 +9,7 @@
 #include <CppUTest/TestHarness.h>
 
 #include "roc_core/heap_allocator.h"
+#include "roc_core/helpers.h"
 #include "roc_packet/concurrent_queue.h"
 #include "roc_packet/packet_pool.h"
 
@@ -43,5 +44,21 @@ TEST(concurrent_queue, write_read) {
     CHECK(queue.read() == p2);
 }
 
+TEST(concurrent_queue, write_batch_read) {
+    ConcurrentQueue queue;
+
+    PacketPtr wr_packets[] = { new_packet(), new_packet(), new_packet() };
+
+    queue.write_batch(wr_packets, ROC_ARRAY_SIZE(wr_packets));
+
+    PacketPtr last = new_packet();
+    queue.write(last);
+
+    CHECK(queue.read() == wr_packets[0]);
+    CHECK(queue.read() == wr_packets[1]);
+    CHECK(queue.read() == wr_packets[2]);
+    CHECK(queue.read() == last);
+}
+
 } // namespace packet
 } // namespace roc
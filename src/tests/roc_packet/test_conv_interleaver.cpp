@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/array.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/conv_interleaver.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { NumPackets = 200, MaxDelay = 12 };
+
+core::HeapAllocator allocator;
+PacketPool pool(allocator, true);
+
+PacketPtr new_packet(seqnum_t sn) {
+    PacketPtr packet = new (pool) Packet(pool);
+    CHECK(packet);
+
+    packet->add_flags(Packet::FlagRTP);
+    packet->rtp()->seqnum = sn;
+
+    return packet;
+}
+
+} // namespace
+
+TEST_GROUP(conv_interleaver) {};
+
+TEST(conv_interleaver, branches) {
+    Queue queue;
+
+    {
+        ConvInterleaver intrlvr(queue, allocator, 0);
+        CHECK(intrlvr.valid());
+        UNSIGNED_LONGS_EQUAL(1, intrlvr.num_branches());
+        UNSIGNED_LONGS_EQUAL(0, intrlvr.max_delay());
+    }
+
+    {
+        ConvInterleaver intrlvr(queue, allocator, MaxDelay);
+        CHECK(intrlvr.valid());
+        UNSIGNED_LONGS_EQUAL(4, intrlvr.num_branches());
+        UNSIGNED_LONGS_EQUAL(MaxDelay, intrlvr.max_delay());
+    }
+
+    {
+        ConvInterleaver intrlvr(queue, allocator, MaxDelay + 7);
+        CHECK(intrlvr.valid());
+        UNSIGNED_LONGS_EQUAL(4, intrlvr.num_branches());
+        UNSIGNED_LONGS_EQUAL(MaxDelay, intrlvr.max_delay());
+    }
+}
+
+TEST(conv_interleaver, no_delay) {
+    Queue queue;
+    ConvInterleaver intrlvr(queue, allocator, 1);
+
+    CHECK(intrlvr.valid());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        PacketPtr packet = new_packet(seqnum_t(n));
+        intrlvr.write(packet);
+
+        LONGS_EQUAL(1, queue.size());
+        CHECK(queue.read() == packet);
+    }
+}
+
+TEST(conv_interleaver, bounded_delay) {
+    Queue queue;
+    ConvInterleaver intrlvr(queue, allocator, MaxDelay);
+
+    CHECK(intrlvr.valid());
+
+    core::Array<bool> received(allocator);
+    CHECK(received.resize(NumPackets));
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        received[n] = false;
+    }
+
+    size_t out_pos = 0;
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        intrlvr.write(new_packet(seqnum_t(n)));
+
+        // at most one packet is sent per written packet
+        CHECK(queue.size() <= 1);
+
+        if (PacketPtr packet = queue.read()) {
+            const size_t sn = packet->rtp()->seqnum;
+
+            CHECK(sn <= n);
+            CHECK(n - sn <= MaxDelay);
+
+            CHECK(!received[sn]);
+            received[sn] = true;
+
+            out_pos++;
+        }
+    }
+
+    // packets of the first branch are not delayed
+    CHECK(received[0]);
+
+    intrlvr.flush();
+
+    while (PacketPtr packet = queue.read()) {
+        const size_t sn = packet->rtp()->seqnum;
+
+        CHECK(sn + MaxDelay >= NumPackets);
+        CHECK(!received[sn]);
+        received[sn] = true;
+
+        out_pos++;
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, out_pos);
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        CHECK(received[n]);
+    }
+}
+
+TEST(conv_interleaver, spread_bursts) {
+    Queue queue;
+    ConvInterleaver intrlvr(queue, allocator, MaxDelay);
+
+    CHECK(intrlvr.valid());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        intrlvr.write(new_packet(seqnum_t(n)));
+    }
+
+    // skip warm-up
+    for (size_t n = 0; n < MaxDelay; n++) {
+        CHECK(queue.read());
+    }
+
+    PacketPtr prev = queue.read();
+    CHECK(prev);
+
+    // packets sent one after another are at least B - 1 packets apart
+    while (PacketPtr next = queue.read()) {
+        seqnum_diff_t dist = seqnum_diff(next->rtp()->seqnum, prev->rtp()->seqnum);
+        if (dist < 0) {
+            dist = -dist;
+        }
+
+        CHECK(dist >= (seqnum_diff_t)intrlvr.num_branches() - 1);
+
+        prev = next;
+    }
+}
+
+TEST(conv_interleaver, write_batch) {
+    enum { BatchSize = 7 };
+
+    Queue queue1;
+    ConvInterleaver intrlvr1(queue1, allocator, MaxDelay);
+
+    Queue queue2;
+    ConvInterleaver intrlvr2(queue2, allocator, MaxDelay);
+
+    CHECK(intrlvr1.valid());
+    CHECK(intrlvr2.valid());
+
+    core::Array<PacketPtr> packets(allocator);
+    CHECK(packets.resize(NumPackets));
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        intrlvr1.write(new_packet(seqnum_t(n)));
+        packets[n] = new_packet(seqnum_t(n));
+    }
+
+    for (size_t n = 0; n < NumPackets; n += BatchSize) {
+        size_t n_packets = BatchSize;
+        if (n_packets > NumPackets - n) {
+            n_packets = NumPackets - n;
+        }
+        intrlvr2.write_batch(&packets[n], n_packets);
+    }
+
+    intrlvr1.flush();
+    intrlvr2.flush();
+
+    LONGS_EQUAL(NumPackets, queue1.size());
+    LONGS_EQUAL(NumPackets, queue2.size());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        PacketPtr p1 = queue1.read();
+        PacketPtr p2 = queue2.read();
+
+        CHECK(p1);
+        CHECK(p2);
+
+        UNSIGNED_LONGS_EQUAL(p1->rtp()->seqnum, p2->rtp()->seqnum);
+    }
+}
+
+TEST(conv_interleaver, flush) {
+    Queue queue;
+    ConvInterleaver intrlvr(queue, allocator, MaxDelay);
+
+    CHECK(intrlvr.valid());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        PacketPtr packet = new_packet(seqnum_t(n));
+
+        intrlvr.write(packet);
+        intrlvr.flush();
+        LONGS_EQUAL(1, queue.size());
+
+        CHECK(queue.read() == packet);
+        LONGS_EQUAL(0, queue.size());
+    }
+}
+
+} // namespace packet
+} // namespace roc
@@ -140,5 +140,28 @@ TEST(delayed_reader, late_duplicates) {
     CHECK(!dr.read());
 }
 
+TEST(delayed_reader, ring) {
+    Queue queue;
+    DelayedReader dr(queue, NumSamples * (NumPackets - 1) * NsPerSample, SampleRate,
+                     NumPackets, allocator);
+    CHECK(dr.valid());
+
+    PacketPtr packets[NumPackets];
+
+    // write packets in reverse order
+    for (seqnum_t n = 0; n < NumPackets; n++) {
+        packets[n] = new_packet(n);
+    }
+    for (seqnum_t n = NumPackets; n > 0; n--) {
+        queue.write(packets[n - 1]);
+    }
+
+    for (seqnum_t n = 0; n < NumPackets; n++) {
+        CHECK(dr.read() == packets[n]);
+    }
+
+    CHECK(!dr.read());
+}
+
 } // namespace packet
 } // namespace roc
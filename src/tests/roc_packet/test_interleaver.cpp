@@ -92,6 +92,50 @@ TEST(interleaver, read_write) {
     }
 }
 
+TEST(interleaver, write_batch) {
+    enum { BatchSize = 7 };
+
+    Queue queue;
+    Interleaver intrlvr(queue, allocator, 10);
+
+    CHECK(intrlvr.valid());
+
+    const size_t num_packets = intrlvr.block_size() * 5;
+
+    core::Array<PacketPtr> packets(allocator);
+    CHECK(packets.resize(num_packets));
+
+    core::Array<bool> packets_ctr(allocator);
+    CHECK(packets_ctr.resize(num_packets));
+
+    for (size_t i = 0; i < num_packets; i++) {
+        packets[i] = new_packet(seqnum_t(i));
+        packets_ctr[i] = false;
+    }
+
+    for (size_t i = 0; i < num_packets; i += BatchSize) {
+        size_t n = BatchSize;
+        if (n > num_packets - i) {
+            n = num_packets - i;
+        }
+        intrlvr.write_batch(&packets[i], n);
+    }
+
+    intrlvr.flush();
+
+    LONGS_EQUAL(num_packets, queue.size());
+
+    for (size_t i = 0; i < num_packets; i++) {
+        PacketPtr p = queue.read();
+        CHECK(p);
+        CHECK(p->rtp()->seqnum < num_packets);
+        CHECK(!packets_ctr[p->rtp()->seqnum]);
+        packets_ctr[p->rtp()->seqnum] = true;
+    }
+
+    LONGS_EQUAL(0, queue.size());
+}
+
 TEST(interleaver, flush) {
     Queue queue;
     Interleaver intrlvr(queue, allocator, 10);
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_packet/pacer.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+const core::nanoseconds_t Start = 1000 * core::Second;
+const core::nanoseconds_t Interval = 5 * core::Millisecond;
+const core::nanoseconds_t MaxDelay = 20 * core::Millisecond;
+
+} // namespace
+
+TEST_GROUP(pacer) {};
+
+TEST(pacer, slow) {
+    Pacer pacer(Interval, MaxDelay);
+
+    for (int n = 0; n < 10; n++) {
+        const core::nanoseconds_t now = Start + n * Interval * 2;
+        CHECK(pacer.schedule(now) == now);
+    }
+}
+
+TEST(pacer, burst) {
+    Pacer pacer(Interval, MaxDelay);
+
+    const int BurstSize = int(MaxDelay / Interval) + 1;
+
+    for (int n = 0; n < BurstSize; n++) {
+        CHECK(pacer.schedule(Start) == Start + n * Interval);
+    }
+}
+
+TEST(pacer, bursts) {
+    Pacer pacer(Interval, MaxDelay);
+
+    const int BurstSize = 4;
+    const int NumBursts = 10;
+
+    core::nanoseconds_t prev = 0;
+
+    for (int b = 0; b < NumBursts; b++) {
+        const core::nanoseconds_t now = Start + b * BurstSize * Interval;
+
+        for (int n = 0; n < BurstSize; n++) {
+            const core::nanoseconds_t send_time = pacer.schedule(now);
+
+            CHECK(send_time >= now);
+            CHECK(send_time - now <= MaxDelay);
+
+            if (prev != 0) {
+                CHECK(send_time - prev == Interval);
+            }
+            prev = send_time;
+        }
+    }
+}
+
+TEST(pacer, reset) {
+    Pacer pacer(Interval, MaxDelay);
+
+    const int BurstSize = int(MaxDelay / Interval) + 1;
+
+    for (int n = 0; n < BurstSize; n++) {
+        CHECK(pacer.schedule(Start) == Start + n * Interval);
+    }
+
+    CHECK(pacer.schedule(Start) == Start);
+    CHECK(pacer.schedule(Start) == Start + Interval);
+}
+
+TEST(pacer, no_interval) {
+    Pacer pacer(0, MaxDelay);
+
+    for (int n = 0; n < 10; n++) {
+        CHECK(pacer.schedule(Start) == Start);
+    }
+}
+
+} // namespace packet
+} // namespace roc
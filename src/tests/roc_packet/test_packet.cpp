@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/packet_pool.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { BufferSize = 100 };
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, BufferSize, true);
+PacketPool pool(allocator, true);
+
+} // namespace
+
+TEST_GROUP(packet) {};
+
+TEST(packet, clone) {
+    core::Slice<uint8_t> buffer = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+    CHECK(buffer);
+
+    PacketPtr packet = new (pool) Packet(pool);
+    CHECK(packet);
+
+    packet->add_flags(Packet::FlagUDP | Packet::FlagRTP);
+    packet->set_data(buffer);
+
+    CHECK(packet->udp()->dst_addr.set_ipv4("224.0.0.1", 123));
+    packet->rtp()->seqnum = 10;
+    packet->rtp()->timestamp = 20;
+    packet->rtp()->payload = buffer.range(12, BufferSize);
+
+    PacketPtr copy = packet->clone();
+    CHECK(copy);
+    CHECK(copy != packet);
+
+    UNSIGNED_LONGS_EQUAL(packet->flags(), copy->flags());
+
+    CHECK(copy->udp());
+    CHECK(copy->udp()->dst_addr == packet->udp()->dst_addr);
+
+    CHECK(copy->rtp());
+    LONGS_EQUAL(10, copy->rtp()->seqnum);
+    LONGS_EQUAL(20, copy->rtp()->timestamp);
+
+    CHECK(!copy->fec());
+
+    POINTERS_EQUAL(packet->data().data(), copy->data().data());
+    LONGS_EQUAL(packet->data().size(), copy->data().size());
+
+    POINTERS_EQUAL(packet->rtp()->payload.data(), copy->rtp()->payload.data());
+    LONGS_EQUAL(packet->rtp()->payload.size(), copy->rtp()->payload.size());
+}
+
+} // namespace packet
+} // namespace roc
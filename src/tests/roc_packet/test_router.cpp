@@ -9,6 +9,7 @@
 #include <CppUTest/TestHarness.h>
 
 #include "roc_core/heap_allocator.h"
+#include "roc_core/helpers.h"
 #include "roc_packet/packet_pool.h"
 #include "roc_packet/queue.h"
 #include "roc_packet/router.h"
@@ -116,6 +117,37 @@ TEST(router, two_routes) {
     CHECK(!queue_f.read());
 }
 
+TEST(router, write_batch) {
+    Router router(allocator, MaxRoutes);
+
+    CHECK(router.valid());
+
+    Queue queue_a;
+    CHECK(router.add_route(queue_a, Packet::FlagAudio));
+
+    Queue queue_f;
+    CHECK(router.add_route(queue_f, Packet::FlagFEC));
+
+    PacketPtr packets[] = {
+        new_packet(0, Packet::FlagAudio), new_packet(0, Packet::FlagAudio),
+        new_packet(0, Packet::FlagFEC),   new_packet(0, 0),
+        new_packet(0, Packet::FlagFEC),   new_packet(0, Packet::FlagAudio),
+    };
+
+    router.write_batch(packets, ROC_ARRAY_SIZE(packets));
+
+    LONGS_EQUAL(1, packets[3]->getref());
+
+    CHECK(queue_a.read() == packets[0]);
+    CHECK(queue_a.read() == packets[1]);
+    CHECK(queue_a.read() == packets[5]);
+    CHECK(!queue_a.read());
+
+    CHECK(queue_f.read() == packets[2]);
+    CHECK(queue_f.read() == packets[4]);
+    CHECK(!queue_f.read());
+}
+
 TEST(router, max_routes) {
     Router router(allocator, MaxRoutes);
 
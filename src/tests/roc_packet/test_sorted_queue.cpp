@@ -17,12 +17,25 @@ namespace packet {
 
 namespace {
 
+enum { RingSize = 64 };
+
 core::HeapAllocator allocator;
 PacketPool pool(allocator, true);
 
 } // namespace
 
 TEST_GROUP(sorted_queue) {
+    PacketPtr new_fec_packet(blknum_t sbn, size_t esi) {
+        PacketPtr packet = new(pool) Packet(pool);
+        CHECK(packet);
+
+        packet->add_flags(Packet::FlagFEC);
+        packet->fec()->source_block_number = sbn;
+        packet->fec()->encoding_symbol_id = esi;
+
+        return packet;
+    }
+
     PacketPtr new_packet(seqnum_t sn) {
         PacketPtr packet = new(pool) Packet(pool);
         CHECK(packet);
@@ -353,6 +366,179 @@ TEST(sorted_queue, overflow_out_of_order) {
     CHECK(!queue.read());
 }
 
+TEST(sorted_queue, overflow_many_packets_out_of_order) {
+    enum { NumPackets = 300, Step = 7 };
+
+    const seqnum_t first_sn = seqnum_t(seqnum_t(-1) - NumPackets / 2);
+
+    SortedQueue queue(0, RingSize, allocator);
+    CHECK(queue.valid());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        const size_t pos = (n * Step) % NumPackets;
+        queue.write(new_packet(seqnum_t(first_sn + pos)));
+        queue.write(new_packet(seqnum_t(first_sn + pos)));
+    }
+
+    LONGS_EQUAL(NumPackets, queue.size());
+
+    CHECK(queue.head()->rtp()->seqnum == first_sn);
+    CHECK(queue.tail()->rtp()->seqnum == seqnum_t(first_sn + NumPackets - 1));
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        PacketPtr p = queue.read();
+        CHECK(p);
+        CHECK(p->rtp()->seqnum == seqnum_t(first_sn + n));
+    }
+
+    LONGS_EQUAL(0, queue.size());
+    CHECK(!queue.read());
+}
+
+TEST(sorted_queue, jump_forward_and_back) {
+    enum { NumPackets = 10, Jump = 5000 };
+
+    SortedQueue queue(0, RingSize, allocator);
+    CHECK(queue.valid());
+
+    for (seqnum_t n = 0; n < NumPackets; n++) {
+        queue.write(new_packet(seqnum_t(Jump + n)));
+    }
+
+    for (seqnum_t n = 0; n < NumPackets; n++) {
+        queue.write(new_packet(n));
+        queue.write(new_packet(n));
+    }
+
+    LONGS_EQUAL(NumPackets * 2, queue.size());
+
+    CHECK(queue.head()->rtp()->seqnum == 0);
+    CHECK(queue.tail()->rtp()->seqnum == Jump + NumPackets - 1);
+
+    for (seqnum_t n = 0; n < NumPackets; n++) {
+        CHECK(queue.read()->rtp()->seqnum == n);
+    }
+
+    for (seqnum_t n = NumPackets; n < NumPackets * 2; n++) {
+        queue.write(new_packet(seqnum_t(Jump + n)));
+        queue.write(new_packet(seqnum_t(Jump + n)));
+    }
+
+    LONGS_EQUAL(NumPackets * 2, queue.size());
+
+    for (seqnum_t n = 0; n < NumPackets * 2; n++) {
+        CHECK(queue.head()->rtp()->seqnum == Jump + n);
+        CHECK(queue.read()->rtp()->seqnum == Jump + n);
+    }
+
+    LONGS_EQUAL(0, queue.size());
+    CHECK(!queue.read());
+}
+
+TEST(sorted_queue, max_size_after_jump) {
+    SortedQueue queue(3, RingSize, allocator);
+    CHECK(queue.valid());
+
+    PacketPtr p1 = new_packet(1);
+    PacketPtr p2 = new_packet(5000);
+    PacketPtr p3 = new_packet(2);
+    PacketPtr p4 = new_packet(3);
+
+    queue.write(p1);
+    queue.write(p2);
+    queue.write(p3);
+    queue.write(p4);
+
+    LONGS_EQUAL(3, queue.size());
+
+    CHECK(queue.read() == p1);
+    CHECK(queue.read() == p3);
+    CHECK(queue.read() == p2);
+
+    CHECK(!queue.read());
+}
+
+TEST(sorted_queue, fec_packets) {
+    SortedQueue queue(0, RingSize, allocator);
+    CHECK(queue.valid());
+
+    PacketPtr p1 = new_fec_packet(1, 0);
+    PacketPtr p2 = new_fec_packet(1, 1);
+    PacketPtr p3 = new_fec_packet(2, 0);
+
+    queue.write(p3);
+    queue.write(p1);
+    queue.write(p2);
+    queue.write(new_fec_packet(1, 1));
+
+    LONGS_EQUAL(3, queue.size());
+
+    CHECK(queue.head() == p1);
+    CHECK(queue.tail() == p3);
+
+    CHECK(queue.read() == p1);
+    CHECK(queue.read() == p2);
+    CHECK(queue.read() == p3);
+
+    CHECK(!queue.read());
+}
+
+TEST(sorted_queue, ring_wrap) {
+    enum { NumPackets = RingSize * 3 };
+
+    const seqnum_t first_sn = seqnum_t(seqnum_t(-1) - NumPackets / 2);
+
+    SortedQueue queue(0, RingSize, allocator);
+    CHECK(queue.valid());
+
+    size_t rd = 0;
+
+    // keep half of the ring filled, writing every pair of packets swapped
+    for (size_t n = 0; n < NumPackets; n += 2) {
+        queue.write(new_packet(seqnum_t(first_sn + n + 1)));
+        queue.write(new_packet(seqnum_t(first_sn + n)));
+
+        while (queue.size() > RingSize / 2) {
+            CHECK(queue.head()->rtp()->seqnum == seqnum_t(first_sn + rd));
+            CHECK(queue.read()->rtp()->seqnum == seqnum_t(first_sn + rd));
+            rd++;
+        }
+    }
+
+    LONGS_EQUAL(RingSize / 2, queue.size());
+
+    for (; rd < NumPackets; rd++) {
+        CHECK(queue.read()->rtp()->seqnum == seqnum_t(first_sn + rd));
+    }
+
+    LONGS_EQUAL(0, queue.size());
+    CHECK(!queue.read());
+}
+
+TEST(sorted_queue, ring_size) {
+    {
+        SortedQueue queue(0, 0, allocator);
+        CHECK(!queue.valid());
+    }
+    {
+        // rounded up to a power of two
+        SortedQueue queue(0, RingSize - 1, allocator);
+        CHECK(queue.valid());
+
+        for (seqnum_t n = 0; n < RingSize; n++) {
+            queue.write(new_packet(seqnum_t(RingSize - 1 - n)));
+        }
+
+        LONGS_EQUAL(RingSize, queue.size());
+
+        for (seqnum_t n = 0; n < RingSize; n++) {
+            CHECK(queue.read()->rtp()->seqnum == n);
+        }
+
+        CHECK(!queue.read());
+    }
+}
+
 TEST(sorted_queue, latest) {
     SortedQueue queue(0);
 
@@ -393,5 +579,58 @@ TEST(sorted_queue, latest) {
     CHECK(queue.latest() == p4);
 }
 
+TEST(sorted_queue, duration) {
+    enum { Duration = 10 };
+
+    SortedQueue queue(0);
+
+    PacketPtr packets[5];
+    for (seqnum_t n = 0; n < 5; n++) {
+        packets[n] = new_packet(n);
+        packets[n]->rtp()->timestamp = n * Duration;
+        packets[n]->rtp()->duration = Duration;
+    }
+
+    timestamp_t end = 0;
+    CHECK(!queue.get_latest_end(end));
+    LONGS_EQUAL(0, queue.duration());
+
+    queue.write(packets[2]);
+    LONGS_EQUAL(Duration, queue.duration());
+
+    queue.write(packets[4]);
+    LONGS_EQUAL(3 * Duration, queue.duration());
+
+    queue.write(packets[1]);
+    LONGS_EQUAL(4 * Duration, queue.duration());
+
+    queue.write(packets[4]);
+    LONGS_EQUAL(4 * Duration, queue.duration());
+
+    CHECK(queue.get_latest_end(end));
+    LONGS_EQUAL(5 * Duration, end);
+
+    CHECK(queue.read() == packets[1]);
+    LONGS_EQUAL(3 * Duration, queue.duration());
+
+    queue.write(packets[3]);
+    LONGS_EQUAL(3 * Duration, queue.duration());
+
+    CHECK(queue.read() == packets[2]);
+    LONGS_EQUAL(2 * Duration, queue.duration());
+
+    CHECK(queue.read() == packets[3]);
+    LONGS_EQUAL(Duration, queue.duration());
+
+    CHECK(queue.read() == packets[4]);
+    LONGS_EQUAL(0, queue.duration());
+
+    CHECK(queue.get_latest_end(end));
+    LONGS_EQUAL(5 * Duration, end);
+
+    queue.write(packets[0]);
+    LONGS_EQUAL(Duration, queue.duration());
+}
+
 } // namespace packet
 } // namespace roc
@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// Network simulation benchmark for sender and receiver pipelines.
+//
+// Connects Sender to Receiver via simulated network for several network
+// profiles. Both pipelines and the network run on a virtual clock, so an
+// hour of traffic is replayed as fast as the CPU allows. For every profile,
+// prints per-session RTCP metrics, measured end-to-end latency, and the
+// speedup relative to real time.
+//
+// Usage:
+//  roc-bench-pipeline [profile] [seconds]
+//
+// If profile is specified ("ideal", "lan", "wifi", "lossy", "bad"), only this
+// profile is simulated. The default duration is 60 seconds of audio.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_core/virtual_clock.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_pipeline/receiver.h"
+#include "roc_pipeline/sender.h"
+#include "roc_rtp/format_map.h"
+
+#include "test_network_simulator.h"
+
+namespace roc {
+namespace pipeline {
+namespace {
+
+enum {
+    MaxBufSize = 4096,
+
+    SampleRate = 44100,
+    ChMask = 0x3,
+    NumCh = 2,
+
+    SamplesPerFrame = SampleRate / 100,
+
+    // Output samples encode input position modulo this value.
+    PositionRange = 32768
+};
+
+const core::nanoseconds_t FrameDuration = SamplesPerFrame * core::Second / SampleRate;
+
+const core::nanoseconds_t TargetLatency = 200 * core::Millisecond;
+
+const core::nanoseconds_t DefaultDuration = 60 * core::Second;
+
+struct Profile {
+    const char* name;
+    core::nanoseconds_t delay;
+    core::nanoseconds_t jitter;
+    float loss_rate;
+    float reorder_rate;
+    core::nanoseconds_t reorder_delay;
+};
+
+const Profile Profiles[] = {
+    { "ideal", 0, 0, 0.00f, 0.00f, 0 },
+    { "lan", 1 * core::Millisecond, 1 * core::Millisecond, 0.001f, 0.00f, 0 },
+    { "wifi", 5 * core::Millisecond, 20 * core::Millisecond, 0.01f, 0.01f,
+      5 * core::Millisecond },
+    { "lossy", 20 * core::Millisecond, 10 * core::Millisecond, 0.05f, 0.02f,
+      10 * core::Millisecond },
+    { "bad", 50 * core::Millisecond, 60 * core::Millisecond, 0.10f, 0.05f,
+      30 * core::Millisecond },
+};
+
+core::HeapAllocator allocator;
+core::BufferPool<audio::sample_t> sample_buffer_pool(allocator, MaxBufSize, true);
+core::BufferPool<uint8_t> byte_buffer_pool(allocator, MaxBufSize, true);
+packet::PacketPool packet_pool(allocator, true);
+fec::CodecMap codec_map;
+rtp::FormatMap format_map;
+
+packet::Address new_address(int port) {
+    packet::Address addr;
+    if (!addr.set_ipv4("127.0.0.1", port)) {
+        roc_panic("bench: can't set address");
+    }
+    return addr;
+}
+
+PortConfig new_port(int port, PortProtocol protocol) {
+    PortConfig port_config;
+    port_config.address = new_address(port);
+    port_config.protocol = protocol;
+    return port_config;
+}
+
+SenderConfig sender_config(core::IClock& clock) {
+    SenderConfig config;
+    config.input_channels = ChMask;
+    config.internal_frame_size = MaxBufSize;
+    config.fec_encoder.scheme = packet::FEC_RLC;
+    config.timing = false;
+    config.clock = &clock;
+    return config;
+}
+
+ReceiverConfig receiver_config(core::IClock& clock) {
+    ReceiverConfig config;
+    config.common.output_sample_rate = SampleRate;
+    config.common.output_channels = ChMask;
+    config.common.internal_frame_size = MaxBufSize;
+    config.common.resampling = false;
+    config.common.timing = false;
+    config.common.clock = &clock;
+    config.default_session.channels = ChMask;
+    config.default_session.target_latency = TargetLatency;
+    return config;
+}
+
+NetworkSimulatorConfig network_config(const Profile& profile, unsigned seed) {
+    NetworkSimulatorConfig config;
+    config.delay = profile.delay;
+    config.jitter = profile.jitter;
+    config.loss_rate = profile.loss_rate;
+    config.reorder_rate = profile.reorder_rate;
+    config.reorder_delay = profile.reorder_delay;
+    config.seed = seed;
+    return config;
+}
+
+struct Results {
+    size_t n_frames;
+    size_t n_broken_frames;
+
+    size_t n_latency_samples;
+    double latency_sum;
+    core::nanoseconds_t latency_max;
+
+    double speedup;
+
+    Results()
+        : n_frames(0)
+        , n_broken_frames(0)
+        , n_latency_samples(0)
+        , latency_sum(0)
+        , latency_max(0)
+        , speedup(0) {
+    }
+};
+
+void print_header() {
+    printf("%-6s %8s %8s %8s %8s %8s %8s %8s %8s %10s\n", "prof", "packets", "lost",
+           "jitter", "rtt", "lat_avg", "lat_max", "broken", "sessions", "speedup");
+}
+
+void print_session(void* arg,
+                   const packet::Address&,
+                   const rtcp::ReceiverStats& stats) {
+    const Results& res = *(const Results*)arg;
+
+    printf(" %8lu %8ld %8.2f %8.2f", (unsigned long)stats.num_packets,
+           (long)stats.cumulative_lost, double(stats.jitter) / core::Millisecond,
+           double(stats.rtt) / core::Millisecond);
+
+    const double lat_avg =
+        res.n_latency_samples ? res.latency_sum / res.n_latency_samples : 0;
+
+    printf(" %8.2f %8.2f %7.2f%%", lat_avg / core::Millisecond,
+           double(res.latency_max) / core::Millisecond,
+           res.n_frames ? 100. * res.n_broken_frames / res.n_frames : 0.);
+}
+
+void write_frame(Sender& sender, audio::sample_t* buf, size_t& pos) {
+    for (size_t ns = 0; ns < SamplesPerFrame; ns++) {
+        const audio::sample_t s =
+            audio::sample_t(pos % PositionRange) / audio::sample_t(PositionRange);
+        for (size_t nc = 0; nc < NumCh; nc++) {
+            buf[ns * NumCh + nc] = s;
+        }
+        pos++;
+    }
+
+    audio::Frame frame(buf, SamplesPerFrame * NumCh);
+    sender.write(frame);
+}
+
+void read_frame(Receiver& receiver, audio::sample_t* buf, size_t pos, Results& res) {
+    audio::Frame frame(buf, SamplesPerFrame * NumCh);
+    receiver.read(frame);
+
+    res.n_frames++;
+
+    if (frame.flags() & (audio::Frame::FlagBlank | audio::Frame::FlagIncomplete)) {
+        res.n_broken_frames++;
+        return;
+    }
+
+    const size_t out_pos = size_t(buf[0] * PositionRange + 0.5f) % PositionRange;
+    const size_t lat_samples = (pos + PositionRange - out_pos) % PositionRange;
+
+    const core::nanoseconds_t latency =
+        core::nanoseconds_t(lat_samples) * core::Second / SampleRate;
+
+    res.n_latency_samples++;
+    res.latency_sum += double(latency);
+    if (latency > res.latency_max) {
+        res.latency_max = latency;
+    }
+}
+
+void simulate(const Profile& profile, core::nanoseconds_t duration) {
+    core::VirtualClock clock(core::timestamp_unix());
+
+    Receiver receiver(receiver_config(clock), codec_map, format_map, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
+    if (!receiver.valid()) {
+        roc_panic("bench: can't create receiver");
+    }
+
+    if (!receiver.add_port(new_port(10, Proto_RTP_RLC_Source))
+        || !receiver.add_port(new_port(11, Proto_RLC_Repair))
+        || !receiver.add_port(new_port(12, Proto_RTCP))) {
+        roc_panic("bench: can't add receiver ports");
+    }
+
+    NetworkSimulator forward(packet_pool, receiver, clock, network_config(profile, 1),
+                             allocator);
+    if (!forward.valid()) {
+        roc_panic("bench: can't create network simulator");
+    }
+
+    Sender sender(sender_config(clock), new_port(10, Proto_RTP_RLC_Source), forward,
+                  new_port(11, Proto_RLC_Repair), forward, new_port(12, Proto_RTCP),
+                  forward, codec_map, format_map, packet_pool, byte_buffer_pool,
+                  sample_buffer_pool, allocator);
+    if (!sender.valid()) {
+        roc_panic("bench: can't create sender");
+    }
+
+    NetworkSimulator backward(packet_pool, sender, clock, network_config(profile, 2),
+                              allocator);
+    if (!backward.valid()) {
+        roc_panic("bench: can't create network simulator");
+    }
+
+    receiver.set_control_writer(backward);
+
+    audio::sample_t buf[SamplesPerFrame * NumCh];
+
+    Results res;
+    size_t pos = 0;
+
+    const core::nanoseconds_t start = core::timestamp();
+
+    for (core::nanoseconds_t t = 0; t < duration; t += FrameDuration) {
+        write_frame(sender, buf, pos);
+
+        forward.deliver();
+        backward.deliver();
+
+        read_frame(receiver, buf, pos, res);
+
+        clock.advance(FrameDuration);
+    }
+
+    const core::nanoseconds_t elapsed = core::timestamp() - start;
+
+    res.speedup = elapsed > 0 ? double(duration) / elapsed : 0;
+
+    printf("%-6s", profile.name);
+
+    if (receiver.num_sessions() == 0) {
+        printf(" %8s", "-");
+    } else {
+        receiver.iterate_sessions(print_session, &res);
+    }
+
+    printf(" %8lu %9.1fx\n", (unsigned long)receiver.num_sessions(), res.speedup);
+
+    printf("%-6s network: written=%lu lost=%lu reordered=%lu\n", "",
+           (unsigned long)forward.num_written(), (unsigned long)forward.num_lost(),
+           (unsigned long)forward.num_reordered());
+}
+
+} // namespace
+} // namespace pipeline
+} // namespace roc
+
+int main(int argc, char** argv) {
+    using namespace roc;
+
+    core::Logger::instance().set_level(LogNone);
+
+    const char* filter = argc > 1 ? argv[1] : NULL;
+
+    core::nanoseconds_t duration = pipeline::DefaultDuration;
+    if (argc > 2) {
+        duration = core::nanoseconds_t(atoi(argv[2])) * core::Second;
+    }
+
+    pipeline::print_header();
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(pipeline::Profiles); n++) {
+        const pipeline::Profile& profile = pipeline::Profiles[n];
+
+        if (filter && strcmp(filter, profile.name) != 0) {
+            continue;
+        }
+
+        pipeline::simulate(profile, duration);
+    }
+
+    return 0;
+}
@@ -73,6 +73,33 @@ TEST(port, proto_ldpc_repair) {
     STRCMP_EQUAL("ldpc:1.2.3.4:123", port_to_str(port).c_str());
 }
 
+TEST(port, proto_rlc_source) {
+    PortConfig port;
+    CHECK(parse_port(Port_AudioSource, "rtp+rlc:1.2.3.4:123", port));
+
+    UNSIGNED_LONGS_EQUAL(Proto_RTP_RLC_Source, port.protocol);
+
+    STRCMP_EQUAL("rtp+rlc:1.2.3.4:123", port_to_str(port).c_str());
+}
+
+TEST(port, proto_rlc_repair) {
+    PortConfig port;
+    CHECK(parse_port(Port_AudioRepair, "rlc:1.2.3.4:123", port));
+
+    UNSIGNED_LONGS_EQUAL(Proto_RLC_Repair, port.protocol);
+
+    STRCMP_EQUAL("rlc:1.2.3.4:123", port_to_str(port).c_str());
+}
+
+TEST(port, proto_rtcp_control) {
+    PortConfig port;
+    CHECK(parse_port(Port_AudioControl, "rtcp:1.2.3.4:123", port));
+
+    UNSIGNED_LONGS_EQUAL(Proto_RTCP, port.protocol);
+
+    STRCMP_EQUAL("rtcp:1.2.3.4:123", port_to_str(port).c_str());
+}
+
 TEST(port, addr_zero) {
     PortConfig port;
     CHECK(parse_port(Port_AudioSource, "rtp:0.0.0.0:0", port));
@@ -142,6 +169,17 @@ TEST(port, port_type) {
 
     CHECK(!parse_port(Port_AudioSource, "ldpc:1.2.3.4:123", port));
     CHECK(parse_port(Port_AudioRepair, "ldpc:1.2.3.4:123", port));
+
+    CHECK(parse_port(Port_AudioSource, "rtp+rlc:1.2.3.4:123", port));
+    CHECK(!parse_port(Port_AudioRepair, "rtp+rlc:1.2.3.4:123", port));
+
+    CHECK(!parse_port(Port_AudioSource, "rlc:1.2.3.4:123", port));
+    CHECK(parse_port(Port_AudioRepair, "rlc:1.2.3.4:123", port));
+
+    CHECK(!parse_port(Port_AudioSource, "rtcp:1.2.3.4:123", port));
+    CHECK(!parse_port(Port_AudioRepair, "rtcp:1.2.3.4:123", port));
+    CHECK(parse_port(Port_AudioControl, "rtcp:1.2.3.4:123", port));
+    CHECK(!parse_port(Port_AudioControl, "rtp:1.2.3.4:123", port));
 }
 
 TEST(port, bad_format) {
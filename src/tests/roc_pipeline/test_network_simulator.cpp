@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/virtual_clock.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+
+#include "test_network_simulator.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+enum { NumPackets = 1000, BufferSize = 16 };
+
+const core::nanoseconds_t Interval = core::Millisecond;
+const core::nanoseconds_t Delay = 20 * core::Millisecond;
+
+core::HeapAllocator allocator;
+packet::PacketPool packet_pool(allocator, true);
+core::BufferPool<uint8_t> buffer_pool(allocator, BufferSize, true);
+
+} // namespace
+
+TEST_GROUP(network_simulator) {
+    packet::PacketPtr new_packet(uint8_t id) {
+        packet::PacketPtr packet = new (packet_pool) packet::Packet(packet_pool);
+        CHECK(packet);
+
+        packet->add_flags(packet::Packet::FlagUDP);
+
+        core::Slice<uint8_t> data = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+        CHECK(data);
+        data.resize(1);
+        data.data()[0] = id;
+
+        packet->set_data(data);
+
+        return packet;
+    }
+
+    uint8_t packet_id(const packet::PacketPtr& packet) {
+        CHECK(packet);
+        CHECK(packet->flags() & packet::Packet::FlagUDP);
+        UNSIGNED_LONGS_EQUAL(1, packet->data().size());
+
+        return packet->data().data()[0];
+    }
+
+    void run(NetworkSimulator& sim, core::VirtualClock& clock) {
+        for (size_t n = 0; n < NumPackets; n++) {
+            sim.write(new_packet(uint8_t(n)));
+            sim.deliver();
+            clock.advance(Interval);
+        }
+        while (sim.num_pending() != 0) {
+            sim.deliver();
+            clock.advance(Interval);
+        }
+    }
+};
+
+TEST(network_simulator, delay) {
+    core::VirtualClock clock;
+    packet::Queue queue;
+
+    NetworkSimulatorConfig config;
+    config.delay = Delay;
+
+    NetworkSimulator sim(packet_pool, queue, clock, config, allocator);
+    CHECK(sim.valid());
+
+    packet::PacketPtr packet = new_packet(42);
+    sim.write(packet);
+
+    UNSIGNED_LONGS_EQUAL(1, sim.num_pending());
+
+    clock.advance(Delay - 1);
+    UNSIGNED_LONGS_EQUAL(0, sim.deliver());
+    CHECK(!queue.read());
+
+    clock.advance(1);
+    UNSIGNED_LONGS_EQUAL(1, sim.deliver());
+
+    packet::PacketPtr delivered = queue.read();
+    CHECK(delivered);
+    CHECK(delivered != packet);
+    UNSIGNED_LONGS_EQUAL(42, packet_id(delivered));
+
+    UNSIGNED_LONGS_EQUAL(0, sim.num_pending());
+    UNSIGNED_LONGS_EQUAL(1, sim.num_delivered());
+}
+
+TEST(network_simulator, send_time) {
+    core::VirtualClock clock;
+    packet::Queue queue;
+
+    NetworkSimulatorConfig config;
+    config.delay = Delay;
+
+    NetworkSimulator sim(packet_pool, queue, clock, config, allocator);
+    CHECK(sim.valid());
+
+    packet::PacketPtr packet = new_packet(1);
+    packet->udp()->send_time = Delay;
+    sim.write(packet);
+
+    clock.advance(Delay * 2 - 1);
+    UNSIGNED_LONGS_EQUAL(0, sim.deliver());
+
+    clock.advance(1);
+    UNSIGNED_LONGS_EQUAL(1, sim.deliver());
+
+    packet::PacketPtr delivered = queue.read();
+    CHECK(delivered);
+    LONGS_EQUAL(0, delivered->udp()->send_time);
+}
+
+TEST(network_simulator, in_order) {
+    core::VirtualClock clock;
+    packet::Queue queue;
+
+    NetworkSimulatorConfig config;
+    config.delay = Delay;
+
+    NetworkSimulator sim(packet_pool, queue, clock, config, allocator);
+    CHECK(sim.valid());
+
+    run(sim, clock);
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        UNSIGNED_LONGS_EQUAL(uint8_t(n), packet_id(queue.read()));
+    }
+    CHECK(!queue.read());
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, sim.num_written());
+    UNSIGNED_LONGS_EQUAL(NumPackets, sim.num_delivered());
+    UNSIGNED_LONGS_EQUAL(0, sim.num_lost());
+}
+
+TEST(network_simulator, loss) {
+    core::VirtualClock clock;
+    packet::Queue queue;
+
+    NetworkSimulatorConfig config;
+    config.loss_rate = 0.1f;
+
+    NetworkSimulator sim(packet_pool, queue, clock, config, allocator);
+    CHECK(sim.valid());
+
+    run(sim, clock);
+
+    CHECK(sim.num_lost() > NumPackets / 20);
+    CHECK(sim.num_lost() < NumPackets / 5);
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, sim.num_lost() + sim.num_delivered());
+    UNSIGNED_LONGS_EQUAL(sim.num_delivered(), queue.size());
+}
+
+TEST(network_simulator, reorder) {
+    core::VirtualClock clock;
+    packet::Queue queue;
+
+    NetworkSimulatorConfig config;
+    config.reorder_rate = 0.1f;
+    config.reorder_delay = Interval * 3;
+
+    NetworkSimulator sim(packet_pool, queue, clock, config, allocator);
+    CHECK(sim.valid());
+
+    run(sim, clock);
+
+    CHECK(sim.num_reordered() > 0);
+    UNSIGNED_LONGS_EQUAL(NumPackets, sim.num_delivered());
+
+    size_t n_reordered = 0;
+    uint8_t prev = packet_id(queue.read());
+
+    for (size_t n = 1; n < NumPackets; n++) {
+        const uint8_t cur = packet_id(queue.read());
+        if (uint8_t(cur - prev) > 128) {
+            n_reordered++;
+        }
+        prev = cur;
+    }
+
+    CHECK(n_reordered > 0);
+}
+
+TEST(network_simulator, deterministic) {
+    NetworkSimulatorConfig config;
+    config.delay = Delay;
+    config.jitter = Interval * 5;
+    config.loss_rate = 0.05f;
+    config.reorder_rate = 0.05f;
+    config.reorder_delay = Interval * 10;
+    config.seed = 123;
+
+    core::VirtualClock clock1;
+    packet::Queue queue1;
+    NetworkSimulator sim1(packet_pool, queue1, clock1, config, allocator);
+    CHECK(sim1.valid());
+
+    core::VirtualClock clock2;
+    packet::Queue queue2;
+    NetworkSimulator sim2(packet_pool, queue2, clock2, config, allocator);
+    CHECK(sim2.valid());
+
+    run(sim1, clock1);
+    run(sim2, clock2);
+
+    UNSIGNED_LONGS_EQUAL(sim1.num_lost(), sim2.num_lost());
+    UNSIGNED_LONGS_EQUAL(sim1.num_delivered(), sim2.num_delivered());
+
+    for (size_t n = 0; n < sim1.num_delivered(); n++) {
+        UNSIGNED_LONGS_EQUAL(packet_id(queue1.read()), packet_id(queue2.read()));
+    }
+}
+
+TEST(network_simulator, invalid_config) {
+    core::VirtualClock clock;
+    packet::Queue queue;
+
+    NetworkSimulatorConfig config;
+    config.loss_rate = 2;
+
+    NetworkSimulator sim(packet_pool, queue, clock, config, allocator);
+    CHECK(!sim.valid());
+}
+
+} // namespace pipeline
+} // namespace roc
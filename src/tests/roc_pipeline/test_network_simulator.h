@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ROC_PIPELINE_TEST_NETWORK_SIMULATOR_H_
+#define ROC_PIPELINE_TEST_NETWORK_SIMULATOR_H_
+
+#include "roc_core/array.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/iclock.h"
+#include "roc_core/log.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet_pool.h"
+
+namespace roc {
+namespace pipeline {
+
+struct NetworkSimulatorConfig {
+    // Constant one-way delay.
+    core::nanoseconds_t delay;
+
+    // Maximum random delay added to every packet, uniformly distributed.
+    core::nanoseconds_t jitter;
+
+    // Probability of packet loss, in range [0; 1].
+    float loss_rate;
+
+    // Probability of packet reordering, in range [0; 1].
+    float reorder_rate;
+
+    // Extra delay added to reordered packets.
+    core::nanoseconds_t reorder_delay;
+
+    // Simulations with the same seed and the same input produce the same output.
+    unsigned seed;
+
+    NetworkSimulatorConfig()
+        : delay(0)
+        , jitter(0)
+        , loss_rate(0)
+        , reorder_rate(0)
+        , reorder_delay(0)
+        , seed(1) {
+    }
+};
+
+// Connects a sender writer with a receiver writer in process. Every written
+// packet is either dropped or scheduled for delivery according to the delay,
+// jitter, loss and reorder models. Delivery times are computed using the given
+// clock, typically a core::VirtualClock, so that the simulation runs as fast as
+// possible but remains deterministic.
+//
+// Packets are copied on delivery, so that the receiver parses them as if they
+// were received from network.
+class NetworkSimulator : public packet::IWriter, public core::NonCopyable<> {
+public:
+    NetworkSimulator(packet::PacketPool& pool,
+                     packet::IWriter& writer,
+                     core::IClock& clock,
+                     const NetworkSimulatorConfig& config,
+                     core::IAllocator& allocator)
+        : pool_(pool)
+        , writer_(writer)
+        , clock_(clock)
+        , config_(config)
+        , queue_(allocator)
+        , seed_(config.seed)
+        , num_written_(0)
+        , num_lost_(0)
+        , num_reordered_(0)
+        , num_delivered_(0)
+        , valid_(false) {
+        if (config.delay < 0 || config.jitter < 0 || config.reorder_delay < 0) {
+            roc_log(LogError, "network simulator: delays should not be negative");
+            return;
+        }
+
+        if (config.loss_rate < 0 || config.loss_rate > 1 || config.reorder_rate < 0
+            || config.reorder_rate > 1) {
+            roc_log(LogError, "network simulator: rates should be in range [0; 1]");
+            return;
+        }
+
+        if (!queue_.grow(MinQueueSize)) {
+            return;
+        }
+
+        valid_ = true;
+    }
+
+    bool valid() const {
+        return valid_;
+    }
+
+    virtual void write(const packet::PacketPtr& packet) {
+        roc_panic_if(!valid());
+
+        if (!packet) {
+            roc_panic("network simulator: unexpected null packet");
+        }
+
+        if (!packet->udp()) {
+            roc_panic("network simulator: unexpected packet without udp header");
+        }
+
+        num_written_++;
+
+        if (config_.loss_rate > 0 && random_() < config_.loss_rate) {
+            num_lost_++;
+            return;
+        }
+
+        core::nanoseconds_t time = clock_.now();
+
+        if (packet->udp()->send_time > time) {
+            time = packet->udp()->send_time;
+        }
+
+        time += config_.delay + random_delay_(config_.jitter);
+
+        if (config_.reorder_rate > 0 && random_() < config_.reorder_rate) {
+            time += config_.reorder_delay;
+            num_reordered_++;
+        }
+
+        if (!enqueue_(packet, time)) {
+            num_lost_++;
+        }
+    }
+
+    size_t deliver() {
+        roc_panic_if(!valid());
+
+        const core::nanoseconds_t now = clock_.now();
+
+        size_t n_due = 0;
+        while (n_due < queue_.size() && queue_[n_due].time <= now) {
+            n_due++;
+        }
+
+        if (n_due == 0) {
+            return 0;
+        }
+
+        for (size_t n = 0; n < n_due; n++) {
+            packet::PacketPtr pp = copy_(queue_[n].packet);
+            queue_[n].packet = NULL;
+
+            if (!pp) {
+                num_lost_++;
+                continue;
+            }
+
+            writer_.write(pp);
+            num_delivered_++;
+        }
+
+        for (size_t n = n_due; n < queue_.size(); n++) {
+            queue_[n - n_due] = queue_[n];
+        }
+
+        if (!queue_.resize(queue_.size() - n_due)) {
+            roc_panic("network simulator: can't shrink queue");
+        }
+
+        return n_due;
+    }
+
+    size_t num_pending() const {
+        return queue_.size();
+    }
+
+    size_t num_written() const {
+        return num_written_;
+    }
+
+    size_t num_lost() const {
+        return num_lost_;
+    }
+
+    size_t num_reordered() const {
+        return num_reordered_;
+    }
+
+    size_t num_delivered() const {
+        return num_delivered_;
+    }
+
+private:
+    struct Entry {
+        packet::PacketPtr packet;
+        core::nanoseconds_t time;
+    };
+
+    enum { MinQueueSize = 64 };
+
+    bool enqueue_(const packet::PacketPtr& packet, core::nanoseconds_t time) {
+        if (queue_.size() == queue_.max_size()) {
+            if (!queue_.grow(queue_.max_size() * 2)) {
+                roc_log(LogError,
+                        "network simulator: can't grow queue, dropping packet");
+                return false;
+            }
+        }
+
+        Entry entry;
+        entry.packet = packet;
+        entry.time = time;
+
+        queue_.push_back(entry);
+
+        // keep queue sorted by delivery time; packets with equal delivery
+        // time are delivered in the order they were written
+        size_t pos = queue_.size() - 1;
+        while (pos > 0 && queue_[pos - 1].time > time) {
+            queue_[pos] = queue_[pos - 1];
+            pos--;
+        }
+        queue_[pos] = entry;
+
+        return true;
+    }
+
+    packet::PacketPtr copy_(const packet::PacketPtr& pa) {
+        packet::PacketPtr pb = new (pool_) packet::Packet(pool_);
+        if (!pb) {
+            roc_log(LogError, "network simulator: can't allocate packet");
+            return NULL;
+        }
+
+        pb->add_flags(packet::Packet::FlagUDP);
+        *pb->udp() = *pa->udp();
+        pb->udp()->send_time = 0;
+
+        pb->set_data(pa->data());
+
+        return pb;
+    }
+
+    float random_() {
+        // Numerical Recipes LCG, deterministic across platforms
+        seed_ = seed_ * 1664525u + 1013904223u;
+
+        return float(seed_ >> 8) / float(1u << 24);
+    }
+
+    core::nanoseconds_t random_delay_(core::nanoseconds_t max) {
+        if (max <= 0) {
+            return 0;
+        }
+
+        return core::nanoseconds_t(random_() * float(max));
+    }
+
+    packet::PacketPool& pool_;
+    packet::IWriter& writer_;
+    core::IClock& clock_;
+
+    const NetworkSimulatorConfig config_;
+
+    core::Array<Entry> queue_;
+
+    uint32_t seed_;
+
+    size_t num_written_;
+    size_t num_lost_;
+    size_t num_reordered_;
+    size_t num_delivered_;
+
+    bool valid_;
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_TEST_NETWORK_SIMULATOR_H_
@@ -20,15 +20,29 @@ namespace pipeline {
 
 class PacketSender : public packet::IWriter, core::NonCopyable<> {
 public:
-    PacketSender(packet::PacketPool& pool, packet::IWriter& writer)
+    PacketSender(packet::PacketPool& pool, packet::IWriter& writer, bool copy = true)
         : pool_(pool)
-        , writer_(writer) {
+        , writer_(writer)
+        , copy_(copy) {
     }
 
     virtual void write(const packet::PacketPtr& pp) {
         queue_.write(pp);
     }
 
+    // Lost packet is not delivered, but a lost source packet still takes its
+    // place in time, so that later packets are not delivered earlier.
+    void lose(const packet::PacketPtr& pp) {
+        if (pp->flags() & (packet::Packet::FlagRepair | packet::Packet::FlagControl)) {
+            return;
+        }
+
+        packet::PacketPtr placeholder = new (pool_) packet::Packet(pool_);
+        CHECK(placeholder);
+
+        queue_.write(placeholder);
+    }
+
     void deliver(size_t n_source_packets) {
         for (size_t np = 0; np < n_source_packets;) {
             packet::PacketPtr pp = queue_.read();
@@ -36,11 +50,17 @@ public:
                 break;
             }
 
-            if (!(pp->flags() & packet::Packet::FlagRepair)) {
+            if (!(pp->flags()
+                  & (packet::Packet::FlagRepair | packet::Packet::FlagControl))) {
                 np++;
             }
 
-            writer_.write(copy_packet_(pp));
+            if (!(pp->flags() & packet::Packet::FlagUDP)) {
+                // placeholder of lost packet
+                continue;
+            }
+
+            writer_.write(copy_ ? copy_packet_(pp) : pp);
         }
     }
 
@@ -61,6 +81,7 @@ private:
     packet::PacketPool& pool_;
     packet::IWriter& writer_;
     packet::Queue queue_;
+    bool copy_;
 };
 
 } // namespace pipeline
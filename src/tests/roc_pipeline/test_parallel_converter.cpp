@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/stddefs.h"
+#include "roc_pipeline/converter.h"
+#include "roc_pipeline/parallel_converter.h"
+
+#include "test_frame_checker.h"
+#include "test_frame_writer.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+enum {
+    MaxBufSize = 1000,
+
+    InputRate = 44100,
+    OutputRate = 48000,
+    ChMask = 0x3,
+    NumCh = 2,
+
+    SamplesPerFrame = 20,
+    ManyFrames = 300,
+
+    NumThreads = 3,
+    ChunkSize = 50,
+
+    ResamplerFrameSize = 640,
+    ResamplerNumSamples = 44100,
+    ResamplerNumChunks = 5,
+
+    // Multiple of 147, so that 44100 to 48000 conversion has the same phase
+    // at the beginning of every chunk.
+    ResamplerChunkSize = 147 * 14,
+    ResamplerOutChunkSize = ResamplerChunkSize * OutputRate / InputRate
+};
+
+core::HeapAllocator allocator;
+core::BufferPool<audio::sample_t> sample_buffer_pool(allocator, MaxBufSize, true);
+
+class SampleCollector : public audio::IWriter {
+public:
+    SampleCollector()
+        : samples_(allocator) {
+    }
+
+    virtual void write(audio::Frame& frame) {
+        const size_t pos = samples_.size();
+        CHECK(samples_.resize(pos + frame.size()));
+        memcpy(&samples_[pos], frame.data(), frame.size() * sizeof(audio::sample_t));
+    }
+
+    const core::Array<audio::sample_t>& samples() const {
+        return samples_;
+    }
+
+private:
+    core::Array<audio::sample_t> samples_;
+};
+
+void write_sine(sndio::ISink& sink, size_t offset) {
+    audio::sample_t samples[MaxBufSize];
+
+    for (size_t pos = offset; pos < ResamplerNumSamples; pos += MaxBufSize / NumCh) {
+        const size_t size =
+            std::min((size_t)MaxBufSize / NumCh, ResamplerNumSamples - pos);
+
+        for (size_t n = 0; n < size; n++) {
+            const double t = double(pos + n) / InputRate;
+
+            samples[n * NumCh] = (audio::sample_t)(0.5 * sin(2 * M_PI * 440 * t));
+            samples[n * NumCh + 1] = (audio::sample_t)(0.5 * sin(2 * M_PI * 1000 * t));
+        }
+
+        audio::Frame frame(samples, size * NumCh);
+        sink.write(frame);
+    }
+}
+
+} // namespace
+
+TEST_GROUP(parallel_converter) {
+    ConverterConfig config;
+
+    void setup() {
+        config.input_channels = ChMask;
+        config.output_channels = ChMask;
+
+        config.input_sample_rate = InputRate;
+        config.output_sample_rate = InputRate;
+
+        config.internal_frame_size = MaxBufSize;
+
+        config.resampling = false;
+        config.poisoning = true;
+
+        config.num_threads = NumThreads;
+        config.chunk_size = ChunkSize;
+    }
+};
+
+TEST(parallel_converter, null) {
+    ParallelConverter converter(config, NULL, sample_buffer_pool, allocator);
+    CHECK(converter.valid());
+
+    FrameWriter frame_writer(converter, sample_buffer_pool);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame * NumCh);
+    }
+
+    converter.flush();
+}
+
+TEST(parallel_converter, write) {
+    FrameChecker frame_checker;
+
+    ParallelConverter converter(config, &frame_checker, sample_buffer_pool, allocator);
+    CHECK(converter.valid());
+
+    FrameWriter frame_writer(converter, sample_buffer_pool);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame * NumCh);
+    }
+
+    converter.flush();
+
+    frame_checker.expect_samples(ManyFrames * SamplesPerFrame * NumCh);
+}
+
+TEST(parallel_converter, write_chunk_size_not_multiple) {
+    enum { SamplesPerOddFrame = ChunkSize + 7 };
+
+    FrameChecker frame_checker;
+
+    ParallelConverter converter(config, &frame_checker, sample_buffer_pool, allocator);
+    CHECK(converter.valid());
+
+    FrameWriter frame_writer(converter, sample_buffer_pool);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerOddFrame * NumCh);
+    }
+
+    converter.flush();
+
+    frame_checker.expect_samples(ManyFrames * SamplesPerOddFrame * NumCh);
+}
+
+TEST(parallel_converter, flush_empty) {
+    FrameChecker frame_checker;
+
+    ParallelConverter converter(config, &frame_checker, sample_buffer_pool, allocator);
+    CHECK(converter.valid());
+
+    converter.flush();
+
+    frame_checker.expect_frames(0);
+    frame_checker.expect_samples(0);
+}
+
+TEST(parallel_converter, resampling) {
+    config.output_sample_rate = OutputRate;
+    config.internal_frame_size = ResamplerFrameSize;
+    config.resampling = true;
+    config.chunk_size = ResamplerChunkSize;
+
+    SampleCollector actual;
+    {
+        ParallelConverter converter(config, &actual, sample_buffer_pool, allocator);
+        CHECK(converter.valid());
+
+        write_sine(converter, 0);
+        converter.flush();
+    }
+
+    // Unlike Converter, the tail of the stream is resampled too.
+    const size_t num_output_samples =
+        ((ResamplerNumSamples - ResamplerFrameSize / NumCh) * (size_t)OutputRate
+         + InputRate - 1)
+        / InputRate;
+
+    UNSIGNED_LONGS_EQUAL(num_output_samples * NumCh, actual.samples().size());
+
+    // Every chunk should be the same as the beginning of the output of Converter
+    // started from the first sample of the chunk.
+    for (size_t nc = 0; nc < ResamplerNumChunks; nc++) {
+        SampleCollector expected;
+        {
+            Converter converter(config, &expected, sample_buffer_pool, allocator);
+            CHECK(converter.valid());
+
+            write_sine(converter, nc * ResamplerChunkSize);
+        }
+
+        CHECK(expected.samples().size() >= ResamplerOutChunkSize * NumCh);
+
+        for (size_t n = 0; n < ResamplerOutChunkSize * NumCh; n++) {
+            DOUBLES_EQUAL(expected.samples()[n],
+                          actual.samples()[nc * ResamplerOutChunkSize * NumCh + n],
+                          Epsilon);
+        }
+    }
+}
+
+} // namespace pipeline
+} // namespace roc
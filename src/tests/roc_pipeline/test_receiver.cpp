@@ -11,11 +11,15 @@
 #include "roc_audio/pcm_funcs.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
+#include "roc_core/time.h"
 #include "roc_fec/codec_map.h"
 #include "roc_packet/packet_pool.h"
 #include "roc_pipeline/receiver.h"
+#include "roc_rtcp/composer.h"
+#include "roc_rtcp/ntp.h"
 #include "roc_rtp/composer.h"
 #include "roc_rtp/format_map.h"
+#include "roc_rtp/parser.h"
 
 #include "test_frame_reader.h"
 #include "test_packet_writer.h"
@@ -56,6 +60,54 @@ fec::CodecMap codec_map;
 rtp::FormatMap format_map;
 rtp::Composer rtp_composer(NULL);
 
+packet::PacketPtr new_sender_report(const packet::Address& src_addr,
+                                    const packet::Address& dst_addr,
+                                    packet::timestamp_t rtp_timestamp,
+                                    core::nanoseconds_t capture_time) {
+    rtcp::Report report;
+    report.has_sender_info = true;
+    report.sender_info.ntp_timestamp = rtcp::unix_to_ntp(capture_time);
+    report.sender_info.rtp_timestamp = rtp_timestamp;
+
+    core::Slice<uint8_t> data =
+        new (byte_buffer_pool) core::Buffer<uint8_t>(byte_buffer_pool);
+    CHECK(data);
+
+    rtcp::Composer composer;
+    CHECK(composer.compose(report, data));
+
+    packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+    CHECK(pp);
+
+    pp->add_flags(packet::Packet::FlagUDP);
+    pp->udp()->src_addr = src_addr;
+    pp->udp()->dst_addr = dst_addr;
+    pp->set_data(data);
+
+    return pp;
+}
+
+// Passes packets to receiver with headers already filled, like a loopback
+// port does with packets composed by sender.
+class ComposedPacketWriter : public packet::IWriter {
+public:
+    ComposedPacketWriter(packet::IWriter& writer)
+        : writer_(writer)
+        , parser_(format_map, NULL) {
+    }
+
+    virtual void write(const packet::PacketPtr& pp) {
+        CHECK(parser_.parse(*pp, pp->data()));
+        pp->add_flags(packet::Packet::FlagComposed);
+
+        writer_.write(pp);
+    }
+
+private:
+    packet::IWriter& writer_;
+    rtp::Parser parser_;
+};
+
 } // namespace
 
 TEST_GROUP(receiver) {
@@ -167,6 +219,44 @@ TEST(receiver, one_session) {
     }
 }
 
+TEST(receiver, composed_packets) {
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    port2.protocol = Proto_RTP_RLC_Source;
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+    CHECK(receiver.add_port(port2));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    ComposedPacketWriter composed_writer(receiver);
+
+    // Bare RTP packets match the protocol of the first port, but not the second.
+    PacketWriter packet_writer1(allocator, composed_writer, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src1,
+                                port1.address);
+
+    PacketWriter packet_writer2(allocator, composed_writer, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src2,
+                                port2.address);
+
+    packet_writer1.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+    packet_writer2.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+        packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    }
+}
+
 TEST(receiver, one_session_long_run) {
     enum { NumIterations = 10 };
 
@@ -344,6 +434,168 @@ TEST(receiver, two_sessions_synchronous) {
     }
 }
 
+TEST(receiver, max_sessions) {
+    config.common.max_sessions = 1;
+
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer1(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src1,
+                                port1.address);
+
+    PacketWriter packet_writer2(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src2,
+                                port1.address);
+
+    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+        packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+        packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    }
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+        packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    }
+}
+
+TEST(receiver, session_restart) {
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    for (size_t ns = 0; ns < 3; ns++) {
+        packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+        for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+            for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+                frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+            }
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        while (receiver.num_sessions() != 0) {
+            frame_reader.skip_zeros(SamplesPerFrame * NumCh);
+        }
+    }
+}
+
+TEST(receiver, threading) {
+    enum { NumReads = ManyPackets * FramesPerPacket * 2 };
+
+    config.common.threading = true;
+    config.common.timing = true;
+
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(ManyPackets, SamplesPerPacket, ChMask);
+
+    audio::sample_t samples[SamplesPerFrame * NumCh];
+
+    uint8_t offset = 0;
+    size_t n_nonzero = 0;
+
+    // the pipeline thread runs ahead of read(), so the stream may start with
+    // an arbitrary number of zeros; after that, samples should go in order
+    for (size_t nr = 0; nr < NumReads; nr++) {
+        audio::Frame frame(samples, SamplesPerFrame * NumCh);
+        CHECK(receiver.read(frame));
+
+        for (size_t n = 0; n < frame.size(); n++) {
+            if (frame.data()[n] == 0) {
+                continue;
+            }
+            if (n_nonzero == 0) {
+                // initial packets may be trimmed by the session
+                offset = uint8_t(frame.data()[n] * 1024 + 0.5f);
+            }
+            while (nth_sample(offset) == 0) {
+                offset++;
+            }
+            DOUBLES_EQUAL((double)nth_sample(offset), (double)frame.data()[n], Epsilon);
+            offset++;
+            n_nonzero++;
+        }
+
+        if (n_nonzero >= Latency * NumCh / 2) {
+            break;
+        }
+    }
+
+    CHECK(n_nonzero >= Latency * NumCh / 2);
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+}
+
+TEST(receiver, threading_session_removed) {
+    enum { MaxReads = Timeout / SamplesPerFrame * 10 };
+
+    config.common.threading = true;
+
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    audio::sample_t samples[SamplesPerFrame * NumCh];
+
+    // session is created by the pipeline thread
+    while (receiver.num_sessions() == 0) {
+        audio::Frame frame(samples, SamplesPerFrame * NumCh);
+        CHECK(receiver.read(frame));
+    }
+
+    const size_t n_allocations = allocator.num_allocations();
+
+    // no packets are written after the session times out, so it should be
+    // destroyed by the pipeline thread
+    size_t nr = 0;
+    for (; nr < MaxReads; nr++) {
+        if (receiver.num_sessions() == 0
+            && allocator.num_allocations() < n_allocations) {
+            break;
+        }
+
+        audio::Frame frame(samples, SamplesPerFrame * NumCh);
+        CHECK(receiver.read(frame));
+
+        core::sleep_for(core::Microsecond * 10);
+    }
+
+    CHECK(nr < MaxReads);
+}
+
 TEST(receiver, two_sessions_overlapping) {
     Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
                       sample_buffer_pool, allocator);
@@ -1114,5 +1366,64 @@ TEST(receiver, status) {
     }
 }
 
+TEST(receiver, e2e_latency) {
+    // some arbitrary wall clock time
+    const core::nanoseconds_t CaptureTime = 1500000000 * core::Second;
+
+    config.default_session.latency_monitor.latency_mode = audio::LatencyMode_E2E;
+    config.default_session.latency_monitor.min_latency = 0;
+    config.default_session.latency_monitor.max_latency =
+        Latency * 2 * core::Second / SampleRate;
+
+    PortConfig control_port;
+    control_port.address = new_address(5);
+    control_port.protocol = Proto_RTCP;
+
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+    CHECK(receiver.add_port(control_port));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    // session is created by the first packet, sender report is routed to it
+    frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+    receiver.write(new_sender_report(src1, control_port.address, 0, CaptureTime));
+
+    size_t pos = SamplesPerFrame;
+
+    // every sample is played exactly Latency samples after it was captured
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            receiver.reclock(CaptureTime
+                             + core::nanoseconds_t(pos + Latency) * core::Second
+                                 / SampleRate);
+
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+            pos += SamplesPerFrame;
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+    }
+
+    // playback is delayed, end-to-end latency goes out of bounds
+    receiver.reclock(CaptureTime
+                     + core::nanoseconds_t(pos + Latency * 3) * core::Second
+                         / SampleRate);
+
+    frame_reader.skip_zeros(SamplesPerFrame * NumCh);
+
+    UNSIGNED_LONGS_EQUAL(0, receiver.num_sessions());
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -58,6 +58,7 @@ TEST_GROUP(sender) {
 
     PortConfig source_port;
     PortConfig repair_port;
+    PortConfig control_port;
 
     void setup() {
         source_port.address = new_address(1);
@@ -76,8 +77,9 @@ TEST_GROUP(sender) {
 TEST(sender, write) {
     packet::Queue queue;
 
-    Sender sender(config, source_port, queue, repair_port, queue, codec_map, format_map,
-                  packet_pool, byte_buffer_pool, sample_buffer_pool, allocator);
+    Sender sender(config, source_port, queue, repair_port, queue, control_port, queue,
+                  codec_map, format_map, packet_pool, byte_buffer_pool,
+                  sample_buffer_pool, allocator);
 
     CHECK(sender.valid());
 
@@ -97,6 +99,39 @@ TEST(sender, write) {
     CHECK(!queue.read());
 }
 
+TEST(sender, threading) {
+    config.threading = true;
+    // small enough to make writer wait for the pipeline thread
+    config.thread_buffer_size = MaxBufSize;
+
+    packet::Queue queue;
+
+    {
+        Sender sender(config, source_port, queue, repair_port, queue, control_port,
+                      queue, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+        CHECK(sender.valid());
+
+        FrameWriter frame_writer(sender, sample_buffer_pool);
+
+        for (size_t nf = 0; nf < ManyFrames; nf++) {
+            frame_writer.write_samples(SamplesPerFrame * NumCh);
+        }
+
+        // destructor waits until the pipeline thread processes all samples
+    }
+
+    PacketReader packet_reader(allocator, queue, rtp_parser, format_map, packet_pool,
+                               PayloadType, source_port.address);
+
+    for (size_t np = 0; np < ManyFrames / FramesPerPacket; np++) {
+        packet_reader.read_packet(SamplesPerPacket, ChMask);
+    }
+
+    CHECK(!queue.read());
+}
+
 TEST(sender, frame_size_small) {
     enum {
         SamplesPerSmallFrame = SamplesPerFrame / 2,
@@ -106,8 +141,9 @@ TEST(sender, frame_size_small) {
 
     packet::Queue queue;
 
-    Sender sender(config, source_port, queue, repair_port, queue, codec_map, format_map,
-                  packet_pool, byte_buffer_pool, sample_buffer_pool, allocator);
+    Sender sender(config, source_port, queue, repair_port, queue, control_port, queue,
+                  codec_map, format_map, packet_pool, byte_buffer_pool,
+                  sample_buffer_pool, allocator);
 
     CHECK(sender.valid());
 
@@ -136,8 +172,9 @@ TEST(sender, frame_size_large) {
 
     packet::Queue queue;
 
-    Sender sender(config, source_port, queue, repair_port, queue, codec_map, format_map,
-                  packet_pool, byte_buffer_pool, sample_buffer_pool, allocator);
+    Sender sender(config, source_port, queue, repair_port, queue, control_port, queue,
+                  codec_map, format_map, packet_pool, byte_buffer_pool,
+                  sample_buffer_pool, allocator);
 
     CHECK(sender.valid());
 
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/system_clock.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+#include "roc_pipeline/sender_port.h"
+
+#include "test_helpers.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+enum { MaxBufSize = 100, PayloadSize = 20, NumPackets = 10 };
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBufSize, true);
+packet::PacketPool packet_pool(allocator, true);
+
+// Records batches passed by sender port.
+class BatchWriter : public packet::IWriter {
+public:
+    BatchWriter()
+        : n_writes_(0)
+        , n_batches_(0)
+        , max_batch_(0) {
+    }
+
+    virtual void write(const packet::PacketPtr& pp) {
+        ++n_writes_;
+        queue_.write(pp);
+    }
+
+    virtual void write_batch(const packet::PacketPtr* packets, size_t n_packets) {
+        ++n_batches_;
+        if (max_batch_ < n_packets) {
+            max_batch_ = n_packets;
+        }
+        queue_.write_batch(packets, n_packets);
+    }
+
+    packet::PacketPtr read() {
+        return queue_.read();
+    }
+
+    size_t num_writes() const {
+        return n_writes_;
+    }
+
+    size_t num_batches() const {
+        return n_batches_;
+    }
+
+    size_t max_batch() const {
+        return max_batch_;
+    }
+
+private:
+    packet::Queue queue_;
+    size_t n_writes_;
+    size_t n_batches_;
+    size_t max_batch_;
+};
+
+} // namespace
+
+TEST_GROUP(sender_port) {
+    PortConfig config;
+
+    void setup() {
+        config.address = new_address(1);
+        config.protocol = Proto_RTP;
+    }
+
+    packet::PacketPtr new_packet(SenderPort& port) {
+        packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+        CHECK(pp);
+
+        core::Slice<uint8_t> buf = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+        CHECK(buf);
+
+        CHECK(port.composer().prepare(*pp, buf, PayloadSize));
+        pp->set_data(buf);
+
+        return pp;
+    }
+
+    void check_packet(const packet::PacketPtr& pp) {
+        CHECK(pp);
+
+        CHECK(pp->flags() & packet::Packet::FlagUDP);
+        CHECK(pp->flags() & packet::Packet::FlagComposed);
+
+        CHECK(pp->udp()->dst_addr == config.address);
+
+        // RTP version is set by composer
+        UNSIGNED_LONGS_EQUAL(0x80, pp->data().data()[0] & 0xc0);
+    }
+};
+
+TEST(sender_port, write) {
+    BatchWriter writer;
+
+    SenderPort port(config, writer, NULL, core::SystemClock::instance(), allocator);
+    CHECK(port.valid());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        port.write(new_packet(port));
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, writer.num_writes());
+    UNSIGNED_LONGS_EQUAL(0, writer.num_batches());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        check_packet(writer.read());
+    }
+
+    CHECK(!writer.read());
+}
+
+TEST(sender_port, write_batch) {
+    BatchWriter writer;
+
+    SenderPort port(config, writer, NULL, core::SystemClock::instance(), allocator);
+    CHECK(port.valid());
+
+    packet::PacketPtr packets[NumPackets];
+    for (size_t n = 0; n < NumPackets; n++) {
+        packets[n] = new_packet(port);
+    }
+
+    port.write_batch(packets, NumPackets);
+
+    UNSIGNED_LONGS_EQUAL(0, writer.num_writes());
+    UNSIGNED_LONGS_EQUAL(1, writer.num_batches());
+    UNSIGNED_LONGS_EQUAL(NumPackets, writer.max_batch());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        packet::PacketPtr pp = writer.read();
+        CHECK(pp == packets[n]);
+        check_packet(pp);
+    }
+
+    CHECK(!writer.read());
+}
+
+} // namespace pipeline
+} // namespace roc
@@ -42,6 +42,8 @@ enum {
     Latency = SamplesPerPacket * SourcePackets,
     Timeout = Latency * 20,
 
+    RtcpInterval = Latency * 4,
+
     ManyFrames = Latency / SamplesPerFrame * 10
 };
 
@@ -65,7 +67,16 @@ enum {
     FlagReedSolomon = (1 << 4),
 
     // enable LDPC-Staircase FEC scheme on sender
-    FlagLDPC = (1 << 5)
+    FlagLDPC = (1 << 5),
+
+    // enable sliding window RLC FEC scheme on sender
+    FlagRLC = (1 << 6),
+
+    // enable RTCP reports on sender and receiver
+    FlagControl = (1 << 7),
+
+    // pass sender packets to receiver as is, like loopback port does
+    FlagLoopback = (1 << 8)
 };
 
 core::HeapAllocator allocator;
@@ -80,15 +91,19 @@ rtp::FormatMap format_map;
 TEST_GROUP(sender_receiver) {
     void send_receive(int flags, size_t num_sessions) {
         packet::Queue queue;
+        packet::Queue control_queue;
 
         PortConfig source_port = sender_source_port(flags);
         PortConfig repair_port = sender_repair_port(flags);
+        PortConfig control_port = sender_control_port(flags);
 
         Sender sender(sender_config(flags),
                       source_port,
                       queue,
                       repair_port,
                       queue,
+                      control_port,
+                      queue,
                       codec_map,
                       format_map,
                       packet_pool,
@@ -110,13 +125,17 @@ TEST_GROUP(sender_receiver) {
 
         add_receiver_ports(receiver);
 
+        if (flags & FlagControl) {
+            receiver.set_control_writer(control_queue);
+        }
+
         FrameWriter frame_writer(sender, sample_buffer_pool);
 
         for (size_t nf = 0; nf < ManyFrames; nf++) {
             frame_writer.write_samples(SamplesPerFrame * NumCh);
         }
 
-        PacketSender packet_sender(packet_pool, receiver);
+        PacketSender packet_sender(packet_pool, receiver, !(flags & FlagLoopback));
 
         filter_packets(flags, queue, packet_sender);
 
@@ -133,16 +152,66 @@ TEST_GROUP(sender_receiver) {
 
             packet_sender.deliver(1);
         }
+
+        if (flags & FlagControl) {
+            check_control(sender, receiver, control_queue);
+        }
+    }
+
+    void check_control(Sender& sender, Receiver& receiver, packet::Queue& control_queue) {
+        size_t n_sessions = 0;
+        receiver.iterate_sessions(check_receiver_stats, &n_sessions);
+        UNSIGNED_LONGS_EQUAL(1, n_sessions);
+
+        size_t n_reports = 0;
+        while (packet::PacketPtr pp = control_queue.read()) {
+            CHECK(pp->flags() & packet::Packet::FlagControl);
+            CHECK(pp->flags() & packet::Packet::FlagUDP);
+            sender.write(pp);
+            n_reports++;
+        }
+        CHECK(n_reports > 0);
+
+        FrameWriter frame_writer(sender, sample_buffer_pool);
+        frame_writer.write_samples(SamplesPerFrame * NumCh);
+
+        const rtcp::SenderStats stats = sender.rtcp_stats();
+        UNSIGNED_LONGS_EQUAL(n_reports, stats.num_reports);
+        LONGS_EQUAL(0, stats.cumulative_lost);
+        CHECK(stats.fraction_lost == 0);
+    }
+
+    static void check_receiver_stats(void* arg,
+                                     const packet::Address&,
+                                     const rtcp::ReceiverStats& stats) {
+        (*(size_t*)arg)++;
+
+        CHECK(stats.num_packets > 0);
+        CHECK(stats.num_reports > 0);
+        LONGS_EQUAL(0, stats.cumulative_lost);
     }
 
-    void filter_packets(int flags, packet::IReader& reader, packet::IWriter& writer) {
+    void filter_packets(int flags, packet::IReader& reader, PacketSender& writer) {
         size_t counter = 0;
+        size_t n_source = 0;
 
         while (packet::PacketPtr pp = reader.read()) {
-            if ((flags & FlagLosses) && counter++ % (SourcePackets + RepairPackets) == 1) {
+            const bool is_source = !(
+                pp->flags() & (packet::Packet::FlagRepair | packet::Packet::FlagControl));
+
+            // Receiver starts from the first source packet it gets and waits until
+            // received packets cover the target latency, so a loss in the initial
+            // latency window delays or shifts the beginning of the stream.
+            if ((flags & FlagLosses) && n_source >= Latency / SamplesPerPacket
+                && counter++ % (SourcePackets + RepairPackets) == 1) {
+                writer.lose(pp);
                 continue;
             }
 
+            if (is_source) {
+                n_source++;
+            }
+
             if (pp->flags() & packet::Packet::FlagRepair) {
                 if (flags & FlagDropRepair) {
                     continue;
@@ -165,6 +234,9 @@ TEST_GROUP(sender_receiver) {
         } else if (flags & FlagLDPC) {
             port_config.address = new_address(30);
             port_config.protocol = Proto_RTP_LDPC_Source;
+        } else if (flags & FlagRLC) {
+            port_config.address = new_address(40);
+            port_config.protocol = Proto_RTP_RLC_Source;
         } else {
             port_config.address = new_address(10);
             port_config.protocol = Proto_RTP;
@@ -180,12 +252,24 @@ TEST_GROUP(sender_receiver) {
         } else if (flags & FlagLDPC) {
             port_config.address = new_address(31);
             port_config.protocol = Proto_LDPC_Repair;
+        } else if (flags & FlagRLC) {
+            port_config.address = new_address(41);
+            port_config.protocol = Proto_RLC_Repair;
         } else {
             port_config.protocol = Proto_None;
         }
         return port_config;
     }
 
+    PortConfig sender_control_port(int flags) {
+        PortConfig port_config;
+        if (flags & FlagControl) {
+            port_config.address = new_address(50);
+            port_config.protocol = Proto_RTCP;
+        }
+        return port_config;
+    }
+
     void add_receiver_ports(Receiver& receiver) {
         PortConfig port_config;
 
@@ -208,6 +292,18 @@ TEST_GROUP(sender_receiver) {
         port_config.address = new_address(31);
         port_config.protocol = Proto_LDPC_Repair;
         CHECK(receiver.add_port(port_config));
+
+        port_config.address = new_address(40);
+        port_config.protocol = Proto_RTP_RLC_Source;
+        CHECK(receiver.add_port(port_config));
+
+        port_config.address = new_address(41);
+        port_config.protocol = Proto_RLC_Repair;
+        CHECK(receiver.add_port(port_config));
+
+        port_config.address = new_address(50);
+        port_config.protocol = Proto_RTCP;
+        CHECK(receiver.add_port(port_config));
     }
 
     SenderConfig sender_config(int flags) {
@@ -225,6 +321,10 @@ TEST_GROUP(sender_receiver) {
             config.fec_encoder.scheme = packet::FEC_LDPC_Staircase;
         }
 
+        if (flags & FlagRLC) {
+            config.fec_encoder.scheme = packet::FEC_RLC;
+        }
+
         config.fec_writer.n_source_packets = SourcePackets;
         config.fec_writer.n_repair_packets = RepairPackets;
 
@@ -232,6 +332,8 @@ TEST_GROUP(sender_receiver) {
         config.timing = false;
         config.poisoning = true;
 
+        config.rtcp_interval = RtcpInterval * core::Second / SampleRate;
+
         return config;
     }
 
@@ -252,6 +354,8 @@ TEST_GROUP(sender_receiver) {
         config.default_session.watchdog.no_playback_timeout =
             Timeout * core::Second / SampleRate;
 
+        config.default_session.rtcp_interval = RtcpInterval * core::Second / SampleRate;
+
         return config;
     }
 };
@@ -260,10 +364,50 @@ TEST(sender_receiver, bare) {
     send_receive(FlagNone, 1);
 }
 
+TEST(sender_receiver, control) {
+    send_receive(FlagControl, 1);
+}
+
+TEST(sender_receiver, fec_rlc_control) {
+    send_receive(FlagRLC | FlagControl, 1);
+}
+
 TEST(sender_receiver, interleaving) {
     send_receive(FlagInterleaving, 1);
 }
 
+TEST(sender_receiver, fec_rlc) {
+    send_receive(FlagRLC, 1);
+}
+
+TEST(sender_receiver, fec_rlc_interleaving) {
+    send_receive(FlagRLC | FlagInterleaving, 1);
+}
+
+TEST(sender_receiver, fec_rlc_loss) {
+    send_receive(FlagRLC | FlagLosses, 1);
+}
+
+TEST(sender_receiver, fec_rlc_interleaving_loss) {
+    send_receive(FlagRLC | FlagInterleaving | FlagLosses, 1);
+}
+
+TEST(sender_receiver, fec_rlc_drop_repair) {
+    send_receive(FlagRLC | FlagDropRepair, 1);
+}
+
+TEST(sender_receiver, loopback) {
+    send_receive(FlagLoopback, 1);
+}
+
+TEST(sender_receiver, loopback_fec_rlc_interleaving_loss) {
+    send_receive(FlagLoopback | FlagRLC | FlagInterleaving | FlagLosses, 1);
+}
+
+TEST(sender_receiver, loopback_control) {
+    send_receive(FlagLoopback | FlagControl, 1);
+}
+
 #ifdef ROC_TARGET_OPENFEC
 TEST(sender_receiver, fec_rs) {
     send_receive(FlagReedSolomon, 1);
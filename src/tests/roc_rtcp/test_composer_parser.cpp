@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_rtcp/composer.h"
+#include "roc_rtcp/headers.h"
+#include "roc_rtcp/ntp.h"
+#include "roc_rtcp/parser.h"
+
+namespace roc {
+namespace rtcp {
+
+namespace {
+
+enum { MaxBufSize = 1000 };
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBufSize, true);
+packet::PacketPool packet_pool(allocator, true);
+
+core::Slice<uint8_t> new_buffer() {
+    core::Slice<uint8_t> buf = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+    CHECK(buf);
+    return buf;
+}
+
+Report make_sender_report() {
+    Report report;
+
+    report.ssrc = 0x11223344;
+    report.has_sender_info = true;
+    report.sender_info.ntp_timestamp = 0xaabbccdd11223344ull;
+    report.sender_info.rtp_timestamp = 123456;
+    report.sender_info.packet_count = 100;
+    report.sender_info.byte_count = 20000;
+
+    report.num_dlrr_blocks = 1;
+    report.dlrr_blocks[0].ssrc = 0x55667788;
+    report.dlrr_blocks[0].last_rr = 0xccdd1122;
+    report.dlrr_blocks[0].delay_last_rr = 0x10000;
+
+    return report;
+}
+
+Report make_receiver_report() {
+    Report report;
+
+    report.ssrc = 0x55667788;
+
+    report.num_blocks = 1;
+    report.blocks[0].ssrc = 0x11223344;
+    report.blocks[0].fraction_lost = 25;
+    report.blocks[0].cumulative_lost = -3;
+    report.blocks[0].last_seqnum = 0x10005;
+    report.blocks[0].jitter = 440;
+    report.blocks[0].last_sr = 0xccdd1122;
+    report.blocks[0].delay_last_sr = 0x8000;
+
+    report.has_rrtr = true;
+    report.rrtr_timestamp = 0x1122334455667788ull;
+
+    return report;
+}
+
+} // namespace
+
+TEST_GROUP(composer_parser) {};
+
+TEST(composer_parser, sender_report) {
+    const Report src = make_sender_report();
+
+    Composer composer;
+    core::Slice<uint8_t> buf = new_buffer();
+
+    CHECK(composer.compose(src, buf));
+    UNSIGNED_LONGS_EQUAL(composer.compose_size(src), buf.size());
+    UNSIGNED_LONGS_EQUAL(sizeof(SenderReportPacket) + sizeof(XRPacket)
+                             + sizeof(XRBlockHeader) + sizeof(XRDlrrSubblock),
+                         buf.size());
+
+    const PacketHeader& header = *(const PacketHeader*)buf.data();
+    UNSIGNED_LONGS_EQUAL(V2, header.version());
+    UNSIGNED_LONGS_EQUAL(RTCP_SR, header.type());
+    UNSIGNED_LONGS_EQUAL(0, header.counter());
+    UNSIGNED_LONGS_EQUAL(sizeof(SenderReportPacket), header.size());
+
+    Report dst;
+    CHECK(Parser::parse_report(buf, dst));
+
+    UNSIGNED_LONGS_EQUAL(src.ssrc, dst.ssrc);
+    CHECK(dst.has_sender_info);
+    CHECK(src.sender_info.ntp_timestamp == dst.sender_info.ntp_timestamp);
+    UNSIGNED_LONGS_EQUAL(src.sender_info.rtp_timestamp, dst.sender_info.rtp_timestamp);
+    UNSIGNED_LONGS_EQUAL(src.sender_info.packet_count, dst.sender_info.packet_count);
+    UNSIGNED_LONGS_EQUAL(src.sender_info.byte_count, dst.sender_info.byte_count);
+
+    UNSIGNED_LONGS_EQUAL(0, dst.num_blocks);
+    CHECK(!dst.has_rrtr);
+
+    UNSIGNED_LONGS_EQUAL(1, dst.num_dlrr_blocks);
+    UNSIGNED_LONGS_EQUAL(src.dlrr_blocks[0].ssrc, dst.dlrr_blocks[0].ssrc);
+    UNSIGNED_LONGS_EQUAL(src.dlrr_blocks[0].last_rr, dst.dlrr_blocks[0].last_rr);
+    UNSIGNED_LONGS_EQUAL(src.dlrr_blocks[0].delay_last_rr,
+                         dst.dlrr_blocks[0].delay_last_rr);
+}
+
+TEST(composer_parser, receiver_report) {
+    const Report src = make_receiver_report();
+
+    Composer composer;
+    core::Slice<uint8_t> buf = new_buffer();
+
+    CHECK(composer.compose(src, buf));
+    UNSIGNED_LONGS_EQUAL(sizeof(ReceiverReportPacket) + sizeof(ReportBlock)
+                             + sizeof(XRPacket) + sizeof(XRRrtrBlock),
+                         buf.size());
+
+    const PacketHeader& header = *(const PacketHeader*)buf.data();
+    UNSIGNED_LONGS_EQUAL(RTCP_RR, header.type());
+    UNSIGNED_LONGS_EQUAL(1, header.counter());
+
+    Report dst;
+    CHECK(Parser::parse_report(buf, dst));
+
+    UNSIGNED_LONGS_EQUAL(src.ssrc, dst.ssrc);
+    CHECK(!dst.has_sender_info);
+
+    UNSIGNED_LONGS_EQUAL(1, dst.num_blocks);
+    UNSIGNED_LONGS_EQUAL(src.blocks[0].ssrc, dst.blocks[0].ssrc);
+    UNSIGNED_LONGS_EQUAL(src.blocks[0].fraction_lost, dst.blocks[0].fraction_lost);
+    LONGS_EQUAL(src.blocks[0].cumulative_lost, dst.blocks[0].cumulative_lost);
+    UNSIGNED_LONGS_EQUAL(src.blocks[0].last_seqnum, dst.blocks[0].last_seqnum);
+    UNSIGNED_LONGS_EQUAL(src.blocks[0].jitter, dst.blocks[0].jitter);
+    UNSIGNED_LONGS_EQUAL(src.blocks[0].last_sr, dst.blocks[0].last_sr);
+    UNSIGNED_LONGS_EQUAL(src.blocks[0].delay_last_sr, dst.blocks[0].delay_last_sr);
+
+    CHECK(dst.has_rrtr);
+    CHECK(src.rrtr_timestamp == dst.rrtr_timestamp);
+    UNSIGNED_LONGS_EQUAL(0, dst.num_dlrr_blocks);
+}
+
+TEST(composer_parser, small_buffer) {
+    const Report src = make_receiver_report();
+
+    Composer composer;
+    core::Slice<uint8_t> buf = new_buffer();
+
+    const size_t size = composer.compose_size(src);
+
+    core::Slice<uint8_t> exact = buf.range(MaxBufSize - size, MaxBufSize);
+    CHECK(composer.compose(src, exact));
+    UNSIGNED_LONGS_EQUAL(size, exact.size());
+
+    core::Slice<uint8_t> small = buf.range(MaxBufSize - size + 4, MaxBufSize);
+    CHECK(!composer.compose(src, small));
+}
+
+TEST(composer_parser, parse_packet) {
+    Composer composer;
+    Parser parser;
+
+    core::Slice<uint8_t> buf = new_buffer();
+    CHECK(composer.compose(make_receiver_report(), buf));
+
+    packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+    CHECK(pp);
+
+    CHECK(parser.parse(*pp, buf));
+    CHECK(pp->flags() & packet::Packet::FlagControl);
+    CHECK(!pp->rtp());
+}
+
+TEST(composer_parser, bad_packets) {
+    Composer composer;
+    Parser parser;
+
+    core::Slice<uint8_t> buf = new_buffer();
+    CHECK(composer.compose(make_receiver_report(), buf));
+
+    packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+    CHECK(pp);
+
+    { // truncated
+        CHECK(!parser.parse(*pp, buf.range(0, buf.size() - 4)));
+        CHECK(!parser.parse(*pp, buf.range(0, 2)));
+        CHECK(!parser.parse(*pp, buf.range(0, 0)));
+    }
+    { // bad version
+        core::Slice<uint8_t> bad = new_buffer();
+        bad.resize(buf.size());
+        memcpy(bad.data(), buf.data(), buf.size());
+        bad.data()[0] &= 0x3f;
+        CHECK(!parser.parse(*pp, bad));
+    }
+    { // starts with XR
+        core::Slice<uint8_t> bad = new_buffer();
+        bad.resize(buf.size());
+        memcpy(bad.data(), buf.data(), buf.size());
+        bad.data()[1] = RTCP_XR;
+        CHECK(!parser.parse(*pp, bad));
+    }
+
+    CHECK(!(pp->flags() & packet::Packet::FlagControl));
+}
+
+TEST(composer_parser, skip_unknown_packets) {
+    Composer composer;
+
+    core::Slice<uint8_t> buf = new_buffer();
+    CHECK(composer.compose(make_receiver_report(), buf));
+
+    const size_t rr_size = sizeof(ReceiverReportPacket) + sizeof(ReportBlock);
+    const size_t orig_size = buf.size();
+
+    // insert empty SDES packet after RR
+    enum { SdesSize = 8 };
+    buf.resize(orig_size + SdesSize);
+    memmove(buf.data() + rr_size + SdesSize, buf.data() + rr_size, orig_size - rr_size);
+
+    PacketHeader& sdes = *(PacketHeader*)(buf.data() + rr_size);
+    sdes.clear();
+    sdes.set_version(V2);
+    sdes.set_type(RTCP_SDES);
+    sdes.set_counter(1);
+    sdes.set_size(SdesSize);
+    memset(buf.data() + rr_size + sizeof(PacketHeader), 0,
+           SdesSize - sizeof(PacketHeader));
+
+    Report dst;
+    CHECK(Parser::parse_report(buf, dst));
+
+    UNSIGNED_LONGS_EQUAL(1, dst.num_blocks);
+    CHECK(dst.has_rrtr);
+}
+
+TEST(composer_parser, ntp) {
+    const core::nanoseconds_t unix_time =
+        1500000000 * core::Second + 250 * core::Millisecond;
+
+    const ntp_timestamp_t ntp_time = unix_to_ntp(unix_time);
+
+    UNSIGNED_LONGS_EQUAL(1500000000ull + 2208988800ull, uint32_t(ntp_time >> 32));
+    UNSIGNED_LONGS_EQUAL(0x40000000, uint32_t(ntp_time));
+
+    CHECK(ntp_to_unix(ntp_time) == unix_time);
+
+    UNSIGNED_LONGS_EQUAL(uint32_t(ntp_time >> 16), ntp_middle(ntp_time));
+
+    UNSIGNED_LONGS_EQUAL(0x18000, duration_to_ntp_short(1500 * core::Millisecond));
+    CHECK(ntp_short_to_duration(0x18000) == 1500 * core::Millisecond);
+    UNSIGNED_LONGS_EQUAL(0, duration_to_ntp_short(-core::Second));
+}
+
+} // namespace rtcp
+} // namespace roc
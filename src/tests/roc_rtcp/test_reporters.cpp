@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+#include "roc_rtcp/ntp.h"
+#include "roc_rtcp/receiver_reporter.h"
+#include "roc_rtcp/sender_reporter.h"
+
+namespace roc {
+namespace rtcp {
+
+namespace {
+
+enum {
+    MaxBufSize = 100,
+    SampleRate = 1000,
+    SamplesPerPacket = 10,
+    PayloadSize = 40,
+    SenderSSRC = 111,
+    ReceiverSSRC = 222
+};
+
+const core::nanoseconds_t PacketDuration = SamplesPerPacket * core::Second / SampleRate;
+
+// some arbitrary wall clock time
+const core::nanoseconds_t StartTime = 1500000000 * core::Second;
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBufSize, true);
+packet::PacketPool packet_pool(allocator, true);
+
+packet::PacketPtr new_packet(packet::seqnum_t sn) {
+    packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+    CHECK(pp);
+
+    pp->add_flags(packet::Packet::FlagRTP | packet::Packet::FlagAudio);
+
+    core::Slice<uint8_t> data = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+    CHECK(data);
+
+    pp->rtp()->source = SenderSSRC;
+    pp->rtp()->seqnum = sn;
+    pp->rtp()->timestamp = packet::timestamp_t(sn * SamplesPerPacket);
+    pp->rtp()->duration = SamplesPerPacket;
+    pp->rtp()->payload = data.range(0, PayloadSize);
+
+    return pp;
+}
+
+} // namespace
+
+TEST_GROUP(reporters) {};
+
+TEST(reporters, sender_report) {
+    packet::Queue queue;
+    SenderReporter reporter(queue, SampleRate);
+
+    CHECK(!reporter.has_source());
+
+    for (packet::seqnum_t sn = 0; sn < 10; sn++) {
+        reporter.write(new_packet(sn));
+    }
+
+    UNSIGNED_LONGS_EQUAL(10, queue.size());
+    CHECK(reporter.has_source());
+
+    Report report;
+    reporter.generate(report, StartTime);
+
+    UNSIGNED_LONGS_EQUAL(SenderSSRC, report.ssrc);
+    CHECK(report.has_sender_info);
+    CHECK(report.sender_info.ntp_timestamp == unix_to_ntp(StartTime));
+    UNSIGNED_LONGS_EQUAL(10 * SamplesPerPacket, report.sender_info.rtp_timestamp);
+    UNSIGNED_LONGS_EQUAL(10, report.sender_info.packet_count);
+    UNSIGNED_LONGS_EQUAL(10 * PayloadSize, report.sender_info.byte_count);
+    UNSIGNED_LONGS_EQUAL(0, report.num_blocks);
+    UNSIGNED_LONGS_EQUAL(0, report.num_dlrr_blocks);
+}
+
+TEST(reporters, sender_report_batch) {
+    enum { NumPackets = 10 };
+
+    packet::Queue queue;
+    SenderReporter reporter(queue, SampleRate);
+
+    packet::PacketPtr packets[NumPackets];
+    for (packet::seqnum_t sn = 0; sn < NumPackets; sn++) {
+        packets[sn] = new_packet(sn);
+    }
+
+    reporter.write_batch(packets, NumPackets);
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, queue.size());
+    CHECK(reporter.has_source());
+
+    Report report;
+    reporter.generate(report, StartTime);
+
+    UNSIGNED_LONGS_EQUAL(NumPackets * SamplesPerPacket, report.sender_info.rtp_timestamp);
+    UNSIGNED_LONGS_EQUAL(NumPackets, report.sender_info.packet_count);
+    UNSIGNED_LONGS_EQUAL(NumPackets * PayloadSize, report.sender_info.byte_count);
+}
+
+TEST(reporters, receiver_losses) {
+    ReceiverReporter reporter(ReceiverSSRC, SampleRate);
+
+    CHECK(!reporter.has_source());
+
+    // lose packets 3 and 7
+    for (packet::seqnum_t sn = 0; sn < 10; sn++) {
+        if (sn == 3 || sn == 7) {
+            continue;
+        }
+        reporter.process_packet(*new_packet(sn), StartTime + sn * PacketDuration);
+    }
+
+    CHECK(reporter.has_source());
+
+    const ReceiverStats& stats = reporter.stats();
+    UNSIGNED_LONGS_EQUAL(8, stats.num_packets);
+    LONGS_EQUAL(2, stats.cumulative_lost);
+    UNSIGNED_LONGS_EQUAL(9, stats.last_seqnum);
+    CHECK(stats.jitter == 0);
+
+    Report report;
+    reporter.generate(report, StartTime + 10 * PacketDuration);
+
+    UNSIGNED_LONGS_EQUAL(ReceiverSSRC, report.ssrc);
+    CHECK(!report.has_sender_info);
+    UNSIGNED_LONGS_EQUAL(1, report.num_blocks);
+    UNSIGNED_LONGS_EQUAL(SenderSSRC, report.blocks[0].ssrc);
+    UNSIGNED_LONGS_EQUAL(2 * 256 / 10, report.blocks[0].fraction_lost);
+    LONGS_EQUAL(2, report.blocks[0].cumulative_lost);
+    UNSIGNED_LONGS_EQUAL(9, report.blocks[0].last_seqnum);
+    UNSIGNED_LONGS_EQUAL(0, report.blocks[0].last_sr);
+    CHECK(report.has_rrtr);
+
+    // no new losses since previous report
+    reporter.process_packet(*new_packet(10), StartTime + 10 * PacketDuration);
+    reporter.generate(report, StartTime + 11 * PacketDuration);
+
+    UNSIGNED_LONGS_EQUAL(0, report.blocks[0].fraction_lost);
+    LONGS_EQUAL(2, report.blocks[0].cumulative_lost);
+}
+
+TEST(reporters, receiver_seqnum_wrap) {
+    ReceiverReporter reporter(ReceiverSSRC, SampleRate);
+
+    packet::seqnum_t sn = 65530;
+    for (size_t n = 0; n < 10; n++) {
+        reporter.process_packet(*new_packet(sn), StartTime + n * PacketDuration);
+        sn++;
+    }
+
+    UNSIGNED_LONGS_EQUAL(0x10000 + 3, reporter.stats().last_seqnum);
+    LONGS_EQUAL(0, reporter.stats().cumulative_lost);
+}
+
+TEST(reporters, receiver_jitter) {
+    ReceiverReporter reporter(ReceiverSSRC, SampleRate);
+
+    // every odd packet is delayed by 4 samples
+    for (packet::seqnum_t sn = 0; sn < 1000; sn++) {
+        core::nanoseconds_t arrival = StartTime + sn * PacketDuration;
+        if (sn % 2) {
+            arrival += 4 * core::Second / SampleRate;
+        }
+        reporter.process_packet(*new_packet(sn), arrival);
+    }
+
+    // jitter converges to mean transit difference
+    const core::nanoseconds_t expected = 4 * core::Second / SampleRate;
+    CHECK(reporter.stats().jitter > expected * 9 / 10);
+    CHECK(reporter.stats().jitter <= expected);
+}
+
+TEST(reporters, receiver_mapping) {
+    ReceiverReporter reporter(ReceiverSSRC, SampleRate);
+
+    reporter.process_packet(*new_packet(0), StartTime);
+
+    packet::timestamp_t rtp_timestamp = 0;
+    core::nanoseconds_t capture_time = 0;
+    CHECK(!reporter.get_mapping(rtp_timestamp, capture_time));
+
+    Report report;
+    report.ssrc = SenderSSRC;
+    report.has_sender_info = true;
+    report.sender_info.ntp_timestamp = unix_to_ntp(StartTime);
+    report.sender_info.rtp_timestamp = 12345;
+
+    reporter.process_report(report, StartTime + PacketDuration);
+
+    CHECK(reporter.get_mapping(rtp_timestamp, capture_time));
+    UNSIGNED_LONGS_EQUAL(12345, rtp_timestamp);
+    CHECK(capture_time > StartTime - core::Microsecond);
+    CHECK(capture_time < StartTime + core::Microsecond);
+
+    // reports from other senders are ignored
+    report.ssrc = SenderSSRC + 1;
+    report.sender_info.rtp_timestamp = 54321;
+
+    reporter.process_report(report, StartTime + PacketDuration * 2);
+
+    CHECK(reporter.get_mapping(rtp_timestamp, capture_time));
+    UNSIGNED_LONGS_EQUAL(12345, rtp_timestamp);
+}
+
+TEST(reporters, round_trip) {
+    packet::Queue queue;
+
+    SenderReporter sender(queue, SampleRate);
+    ReceiverReporter receiver(ReceiverSSRC, SampleRate);
+
+    const core::nanoseconds_t OneWay = 30 * core::Millisecond;
+    const core::nanoseconds_t Hold = 200 * core::Millisecond;
+
+    for (packet::seqnum_t sn = 0; sn < 10; sn++) {
+        packet::PacketPtr pp = new_packet(sn);
+        sender.write(pp);
+        receiver.process_packet(*pp, StartTime + OneWay + sn * PacketDuration);
+    }
+
+    core::nanoseconds_t now = StartTime + 10 * PacketDuration;
+
+    // sender -> receiver: SR
+    Report sr;
+    sender.generate(sr, now);
+    now += OneWay;
+    receiver.process_report(sr, now);
+
+    UNSIGNED_LONGS_EQUAL(1, receiver.stats().num_reports);
+
+    // receiver -> sender: RR + RRTR
+    now += Hold;
+    Report rr;
+    receiver.generate(rr, now);
+    now += OneWay;
+    sender.process(rr, now);
+
+    UNSIGNED_LONGS_EQUAL(1, sender.stats().num_reports);
+    LONGS_EQUAL(0, sender.stats().cumulative_lost);
+    UNSIGNED_LONGS_EQUAL(9, sender.stats().last_seqnum);
+
+    // sender rtt excludes time spent on receiver, with 1/65536 s precision
+    CHECK(sender.stats().rtt > 2 * OneWay - core::Millisecond);
+    CHECK(sender.stats().rtt < 2 * OneWay + core::Millisecond);
+
+    // sender -> receiver: SR + DLRR
+    now += Hold;
+    sender.generate(sr, now);
+    UNSIGNED_LONGS_EQUAL(1, sr.num_dlrr_blocks);
+    UNSIGNED_LONGS_EQUAL(ReceiverSSRC, sr.dlrr_blocks[0].ssrc);
+    now += OneWay;
+    receiver.process_report(sr, now);
+
+    CHECK(receiver.stats().rtt > 2 * OneWay - core::Millisecond);
+    CHECK(receiver.stats().rtt < 2 * OneWay + core::Millisecond);
+}
+
+} // namespace rtcp
+} // namespace roc
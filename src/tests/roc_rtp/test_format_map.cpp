@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_rtp/format_map.h"
+#include "roc_rtp/headers.h"
+
+namespace roc {
+namespace rtp {
+
+TEST_GROUP(format_map) {};
+
+TEST(format_map, find_by_pt) {
+    FormatMap fmt_map;
+
+    {
+        const Format* fmt = fmt_map.format(PayloadType_L16_Mono);
+        CHECK(fmt);
+
+        LONGS_EQUAL(PayloadType_L16_Mono, fmt->payload_type);
+        UNSIGNED_LONGS_EQUAL(44100, fmt->sample_rate);
+        UNSIGNED_LONGS_EQUAL(0x1, fmt->channel_mask);
+    }
+
+    {
+        const Format* fmt = fmt_map.format(PayloadType_L16_Stereo);
+        CHECK(fmt);
+
+        LONGS_EQUAL(PayloadType_L16_Stereo, fmt->payload_type);
+        UNSIGNED_LONGS_EQUAL(44100, fmt->sample_rate);
+        UNSIGNED_LONGS_EQUAL(0x3, fmt->channel_mask);
+    }
+}
+
+TEST(format_map, unknown_pt) {
+    FormatMap fmt_map;
+
+    CHECK(!fmt_map.format(0));
+    CHECK(!fmt_map.format(127));
+    CHECK(!fmt_map.format(128));
+    CHECK(!fmt_map.format(1000));
+}
+
+} // namespace rtp
+} // namespace roc
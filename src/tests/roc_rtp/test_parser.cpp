@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/stddefs.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+#include "roc_rtp/format_map.h"
+#include "roc_rtp/headers.h"
+#include "roc_rtp/parser.h"
+#include "roc_rtp/validator.h"
+
+namespace roc {
+namespace rtp {
+
+namespace {
+
+enum {
+    MaxBufSize = 200,
+    HeaderSize = 12,
+    PayloadSize = 40,
+    SampleRate = 44100,
+    MaxSnJump = 10,
+    MaxTsJump = 1000
+};
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBufSize, true);
+packet::PacketPool packet_pool(allocator, true);
+
+} // namespace
+
+TEST_GROUP(parser) {
+    FormatMap format_map;
+
+    // Builds RTP packet with given first byte, payload type, and CSRC/extension
+    // words appended after the fixed header.
+    core::Slice<uint8_t> new_buffer(uint8_t byte0,
+                                    uint8_t byte1,
+                                    packet::seqnum_t sn,
+                                    packet::timestamp_t ts,
+                                    packet::source_t src,
+                                    size_t n_extra_words,
+                                    size_t payload_size,
+                                    uint8_t pad_size) {
+        core::Slice<uint8_t> buf = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+        CHECK(buf);
+
+        const size_t size = HeaderSize + n_extra_words * 4 + payload_size + pad_size;
+        CHECK(size <= MaxBufSize);
+
+        buf.resize(size);
+        memset(buf.data(), 0, size);
+
+        uint8_t* p = buf.data();
+
+        p[0] = byte0;
+        p[1] = byte1;
+        p[2] = uint8_t(sn >> 8);
+        p[3] = uint8_t(sn);
+        p[4] = uint8_t(ts >> 24);
+        p[5] = uint8_t(ts >> 16);
+        p[6] = uint8_t(ts >> 8);
+        p[7] = uint8_t(ts);
+        p[8] = uint8_t(src >> 24);
+        p[9] = uint8_t(src >> 16);
+        p[10] = uint8_t(src >> 8);
+        p[11] = uint8_t(src);
+
+        for (size_t n = 0; n < payload_size; n++) {
+            p[HeaderSize + n_extra_words * 4 + n] = uint8_t(n + 1);
+        }
+
+        if (pad_size) {
+            p[size - 1] = pad_size;
+        }
+
+        return buf;
+    }
+
+    packet::PacketPtr parse(const core::Slice<uint8_t>& buf) {
+        packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+        CHECK(pp);
+
+        pp->set_data(buf);
+
+        Parser parser(format_map, NULL);
+        if (!parser.parse(*pp, pp->data())) {
+            return NULL;
+        }
+
+        return pp;
+    }
+};
+
+TEST(parser, fields) {
+    const packet::seqnum_t sn = 0xfedc;
+    const packet::timestamp_t ts = 0x89abcdef;
+    const packet::source_t src = 0x12345678;
+
+    packet::PacketPtr pp =
+        parse(new_buffer(0x80, 0x80 | PayloadType_L16_Stereo, sn, ts, src, 0,
+                         PayloadSize, 0));
+    CHECK(pp);
+
+    CHECK(pp->flags() & packet::Packet::FlagRTP);
+    CHECK(pp->flags() & packet::Packet::FlagAudio);
+
+    UNSIGNED_LONGS_EQUAL(src, pp->rtp()->source);
+    UNSIGNED_LONGS_EQUAL(sn, pp->rtp()->seqnum);
+    UNSIGNED_LONGS_EQUAL(ts, pp->rtp()->timestamp);
+    UNSIGNED_LONGS_EQUAL(PayloadType_L16_Stereo, pp->rtp()->payload_type);
+    CHECK(pp->rtp()->marker);
+
+    UNSIGNED_LONGS_EQUAL(HeaderSize, pp->rtp()->header.size());
+    UNSIGNED_LONGS_EQUAL(PayloadSize, pp->rtp()->payload.size());
+    UNSIGNED_LONGS_EQUAL(PayloadSize / 4, pp->rtp()->duration);
+}
+
+TEST(parser, csrc_extension_padding) {
+    enum { NumCSRC = 3, ExtWords = 2, PadSize = 5 };
+
+    core::Slice<uint8_t> buf = new_buffer(0x80 | 0x20 | 0x10 | NumCSRC,
+                                          PayloadType_L16_Mono, 1, 2, 3,
+                                          NumCSRC + 1 + ExtWords, PayloadSize, PadSize);
+
+    // extension header: profile and length in 32-bit words
+    uint8_t* ext = buf.data() + HeaderSize + NumCSRC * 4;
+    ext[3] = ExtWords;
+
+    packet::PacketPtr pp = parse(buf);
+    CHECK(pp);
+
+    CHECK(!pp->rtp()->marker);
+    UNSIGNED_LONGS_EQUAL(PayloadType_L16_Mono, pp->rtp()->payload_type);
+
+    UNSIGNED_LONGS_EQUAL(HeaderSize + (NumCSRC + 1 + ExtWords) * 4,
+                         pp->rtp()->header.size());
+    UNSIGNED_LONGS_EQUAL(PayloadSize, pp->rtp()->payload.size());
+    UNSIGNED_LONGS_EQUAL(PadSize, pp->rtp()->padding.size());
+
+    UNSIGNED_LONGS_EQUAL(1, pp->rtp()->payload.data()[0]);
+    UNSIGNED_LONGS_EQUAL(PayloadSize / 2, pp->rtp()->duration);
+}
+
+TEST(parser, unknown_payload_type) {
+    packet::PacketPtr pp = parse(new_buffer(0x80, 0x7f, 1, 2, 3, 0, PayloadSize, 0));
+    CHECK(pp);
+
+    CHECK(pp->flags() & packet::Packet::FlagRTP);
+    CHECK(!(pp->flags() & packet::Packet::FlagAudio));
+
+    UNSIGNED_LONGS_EQUAL(0x7f, pp->rtp()->payload_type);
+    UNSIGNED_LONGS_EQUAL(0, pp->rtp()->duration);
+}
+
+TEST(parser, malformed) {
+    { // too short for fixed header
+        core::Slice<uint8_t> buf = new_buffer(0x80, 0, 1, 2, 3, 0, 0, 0);
+        buf.resize(HeaderSize - 1);
+        CHECK(!parse(buf));
+    }
+    { // bad version
+        CHECK(!parse(new_buffer(0x40, 0, 1, 2, 3, 0, PayloadSize, 0)));
+    }
+    { // CSRC count exceeds packet size
+        CHECK(!parse(new_buffer(0x80 | 0xf, 0, 1, 2, 3, 0, 8, 0)));
+    }
+    { // extension header doesn't fit
+        CHECK(!parse(new_buffer(0x80 | 0x10, 0, 1, 2, 3, 0, 2, 0)));
+    }
+    { // extension data doesn't fit
+        core::Slice<uint8_t> buf = new_buffer(0x80 | 0x10, 0, 1, 2, 3, 1, 4, 0);
+        buf.data()[HeaderSize + 3] = 2;
+        CHECK(!parse(buf));
+    }
+    { // padding flag without payload
+        CHECK(!parse(new_buffer(0x80 | 0x20, 0, 1, 2, 3, 0, 0, 0)));
+    }
+    { // zero padding size
+        core::Slice<uint8_t> buf = new_buffer(0x80 | 0x20, 0, 1, 2, 3, 0, PayloadSize, 0);
+        buf.data()[buf.size() - 1] = 0;
+        CHECK(!parse(buf));
+    }
+    { // padding larger than payload
+        core::Slice<uint8_t> buf = new_buffer(0x80 | 0x20, 0, 1, 2, 3, 0, 3, 1);
+        buf.data()[buf.size() - 1] = 5;
+        CHECK(!parse(buf));
+    }
+}
+
+TEST(parser, parse_and_validate) {
+    ValidatorConfig config;
+    config.max_sn_jump = MaxSnJump;
+    config.max_ts_jump = MaxTsJump * core::Second / SampleRate;
+
+    packet::Queue queue;
+    Validator validator(queue, config, SampleRate);
+
+    const uint8_t pt = PayloadType_L16_Stereo;
+
+    // seqnum and timestamp wrap between the first and the second packet
+    packet::PacketPtr p1 =
+        parse(new_buffer(0x80, pt, 0xffff, 0xffffffff - 10, 7, 0, PayloadSize, 0));
+    packet::PacketPtr p2 = parse(new_buffer(0x80, pt, 0, MaxTsJump - 11, 7, 0,
+                                            PayloadSize, 0));
+    // too long seqnum jump
+    packet::PacketPtr p3 = parse(new_buffer(0x80, pt, MaxSnJump + 1, MaxTsJump - 11, 7,
+                                            0, PayloadSize, 0));
+    // too long timestamp jump
+    packet::PacketPtr p4 = parse(new_buffer(0x80, pt, 1, MaxTsJump * 2, 7, 0,
+                                            PayloadSize, 0));
+    // source jump
+    packet::PacketPtr p5 = parse(new_buffer(0x80, pt, 2, MaxTsJump, 8, 0,
+                                            PayloadSize, 0));
+    // payload type jump
+    packet::PacketPtr p6 = parse(new_buffer(0x80, PayloadType_L16_Mono, 3, MaxTsJump,
+                                            7, 0, PayloadSize, 0));
+
+    CHECK(p1 && p2 && p3 && p4 && p5 && p6);
+
+    queue.write(p1);
+    CHECK(validator.read() == p1);
+
+    queue.write(p2);
+    CHECK(validator.read() == p2);
+
+    queue.write(p3);
+    CHECK(!validator.read());
+
+    queue.write(p4);
+    CHECK(!validator.read());
+
+    queue.write(p5);
+    CHECK(!validator.read());
+
+    queue.write(p6);
+    CHECK(!validator.read());
+}
+
+} // namespace rtp
+} // namespace roc
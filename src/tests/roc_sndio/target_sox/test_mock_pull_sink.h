@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ROC_SNDIO_TARGET_SOX_TEST_MOCK_PULL_SINK_H_
+#define ROC_SNDIO_TARGET_SOX_TEST_MOCK_PULL_SINK_H_
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/atomic.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
+#include "roc_sndio/isink.h"
+
+namespace roc {
+namespace sndio {
+
+class MockPullSink : public ISink, public core::Thread {
+public:
+    MockPullSink(size_t frame_size)
+        : source_(NULL)
+        , frame_size_(frame_size)
+        , samples_(new audio::sample_t[MaxSz])
+        , pos_(0)
+        , n_frames_(0)
+        , n_reclocks_(0)
+        , stop_(0) {
+    }
+
+    ~MockPullSink() {
+        CHECK(!joinable());
+        delete[] samples_;
+    }
+
+    virtual size_t sample_rate() const {
+        return 0;
+    }
+
+    virtual bool has_clock() const {
+        return true;
+    }
+
+    virtual core::nanoseconds_t latency() const {
+        return 0;
+    }
+
+    virtual void write(audio::Frame&) {
+        FAIL("unexpected write() in pull mode");
+    }
+
+    virtual bool start_pull(ISource& source) {
+        CHECK(!source_);
+        source_ = &source;
+        return start();
+    }
+
+    virtual void stop_pull() {
+        stop_ = 1;
+        join();
+        source_ = NULL;
+    }
+
+    size_t num_frames() const {
+        return (size_t)(long)n_frames_;
+    }
+
+    size_t num_reclocks() const {
+        return (size_t)(long)n_reclocks_;
+    }
+
+    void check(size_t offset, size_t size) {
+        UNSIGNED_LONGS_EQUAL(pos_, size);
+
+        for (size_t n = 0; n < size; n++) {
+            DOUBLES_EQUAL((double)samples_[n], (double)nth_sample_(offset + n),
+                          0.0001);
+        }
+    }
+
+private:
+    enum { MaxSz = 256 * 1024 };
+
+    virtual void run() {
+        while (!stop_) {
+            CHECK(pos_ + frame_size_ <= MaxSz);
+
+            audio::Frame frame(samples_ + pos_, frame_size_);
+
+            if (source_->read(frame)) {
+                pos_ += frame_size_;
+                ++n_frames_;
+
+                source_->reclock(core::timestamp_unix());
+                ++n_reclocks_;
+            }
+
+            // Emulate device pace.
+            core::sleep_for(core::Millisecond);
+        }
+    }
+
+    audio::sample_t nth_sample_(size_t n) {
+        return audio::sample_t(uint8_t(n)) / audio::sample_t(1 << 8);
+    }
+
+    ISource* source_;
+
+    const size_t frame_size_;
+
+    audio::sample_t* samples_;
+    size_t pos_;
+
+    core::Atomic n_frames_;
+    core::Atomic n_reclocks_;
+    core::Atomic stop_;
+};
+
+} // namespace sndio
+} // namespace roc
+
+#endif // ROC_SNDIO_TARGET_SOX_TEST_MOCK_PULL_SINK_H_
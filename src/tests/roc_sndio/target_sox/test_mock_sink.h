@@ -30,6 +30,10 @@ public:
         return false;
     }
 
+    virtual core::nanoseconds_t latency() const {
+        return 0;
+    }
+
     virtual void write(audio::Frame& frame) {
         CHECK(pos_ + frame.size() <= MaxSz);
 
@@ -61,6 +61,9 @@ public:
         return true;
     }
 
+    virtual void reclock(core::nanoseconds_t) {
+    }
+
     void add(size_t sz) {
         CHECK(size_ + sz <= MaxSz);
 
@@ -8,6 +8,7 @@
 
 #include <CppUTest/TestHarness.h>
 
+#include "test_mock_pull_sink.h"
 #include "test_mock_sink.h"
 #include "test_mock_source.h"
 
@@ -15,6 +16,8 @@
 #include "roc_core/heap_allocator.h"
 #include "roc_core/stddefs.h"
 #include "roc_core/temp_file.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
 #include "roc_sndio/pump.h"
 #include "roc_sndio/sox_sink.h"
 #include "roc_sndio/sox_source.h"
@@ -29,6 +32,26 @@ enum { MaxBufSize = 8192, FrameSize = 512, SampleRate = 44100, ChMask = 0x3 };
 core::HeapAllocator allocator;
 core::BufferPool<audio::sample_t> buffer_pool(allocator, MaxBufSize, true);
 
+class PumpThread : public core::Thread {
+public:
+    PumpThread(Pump& pump)
+        : pump_(pump)
+        , result_(false) {
+    }
+
+    bool result() const {
+        return result_;
+    }
+
+private:
+    virtual void run() {
+        result_ = pump_.run();
+    }
+
+    Pump& pump_;
+    bool result_;
+};
+
 } // namespace
 
 TEST_GROUP(pump) {
@@ -118,5 +141,67 @@ TEST(pump, write_overwrite_read) {
     mock_writer.check(num_returned1, num_returned2);
 }
 
+TEST(pump, pull_oneshot) {
+    enum { NumSamples = FrameSize * 10 };
+
+    MockSource mock_source;
+    mock_source.add(NumSamples);
+
+    MockPullSink mock_sink(FrameSize);
+
+    Pump pump(buffer_pool, mock_source, mock_sink, FrameSize, Pump::ModeOneshot,
+              Pump::DrivePull);
+    CHECK(pump.valid());
+    CHECK(pump.run());
+
+    UNSIGNED_LONGS_EQUAL(NumSamples, mock_source.num_returned());
+    UNSIGNED_LONGS_EQUAL(NumSamples / FrameSize, mock_sink.num_frames());
+    UNSIGNED_LONGS_EQUAL(NumSamples / FrameSize, mock_sink.num_reclocks());
+
+    mock_sink.check(0, NumSamples);
+}
+
+TEST(pump, pull_stop) {
+    enum { NumSamples = FrameSize * 10, NumFrames = 5 };
+
+    MockSource mock_source;
+    mock_source.add(NumSamples);
+
+    MockPullSink mock_sink(FrameSize);
+
+    Pump pump(buffer_pool, mock_source, mock_sink, FrameSize, Pump::ModePermanent,
+              Pump::DrivePull);
+    CHECK(pump.valid());
+
+    PumpThread thread(pump);
+    CHECK(thread.start());
+
+    while (mock_sink.num_frames() < NumFrames) {
+        core::sleep_for(core::Millisecond);
+    }
+
+    pump.stop();
+    thread.join();
+
+    CHECK(!thread.result());
+    CHECK(mock_sink.num_frames() >= NumFrames);
+}
+
+TEST(pump, pull_not_supported) {
+    enum { NumSamples = FrameSize * 10 };
+
+    MockSource mock_source;
+    mock_source.add(NumSamples);
+
+    MockSink mock_sink;
+
+    Pump pump(buffer_pool, mock_source, mock_sink, FrameSize, Pump::ModeOneshot,
+              Pump::DrivePull);
+    CHECK(pump.valid());
+    CHECK(pump.run());
+
+    mock_sink.check(0, NumSamples);
+}
+
 } // namespace sndio
 } // namespace roc
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_sndio/pull_reader.h"
+
+namespace roc {
+namespace sndio {
+
+namespace {
+
+enum {
+    FrameSize = 100,
+    NumCh = 2,
+    SampleRate = 1000,
+    BufSize = FrameSize * 3 + NumCh * 10,
+    MaxReads = 10
+};
+
+class TestSource : public ISource {
+public:
+    TestSource(size_t max_samples)
+        : max_samples_(max_samples)
+        , pos_(0)
+        , n_reads_(0)
+        , n_reclocks_(0) {
+    }
+
+    virtual size_t sample_rate() const {
+        return SampleRate;
+    }
+
+    virtual bool has_clock() const {
+        return false;
+    }
+
+    virtual State state() const {
+        return Active;
+    }
+
+    virtual void wait_active() const {
+    }
+
+    virtual bool read(audio::Frame& frame) {
+        CHECK(n_reads_ < MaxReads);
+        CHECK(frame.size() <= FrameSize);
+
+        if (pos_ + frame.size() > max_samples_) {
+            return false;
+        }
+
+        for (size_t n = 0; n < frame.size(); n++) {
+            frame.data()[n] = nth_sample(pos_ + n);
+        }
+
+        frame_sizes_[n_reads_++] = frame.size();
+        pos_ += frame.size();
+
+        return true;
+    }
+
+    virtual void reclock(core::nanoseconds_t playback_time) {
+        CHECK(n_reclocks_ < MaxReads);
+
+        reclock_times_[n_reclocks_++] = playback_time;
+    }
+
+    static audio::sample_t nth_sample(size_t n) {
+        return audio::sample_t(n + 1) / audio::sample_t(1 << 16);
+    }
+
+    size_t num_reads() const {
+        return n_reads_;
+    }
+
+    size_t num_reclocks() const {
+        return n_reclocks_;
+    }
+
+    size_t frame_size(size_t n) const {
+        return frame_sizes_[n];
+    }
+
+    core::nanoseconds_t reclock_time(size_t n) const {
+        return reclock_times_[n];
+    }
+
+private:
+    const size_t max_samples_;
+    size_t pos_;
+
+    size_t n_reads_;
+    size_t frame_sizes_[MaxReads];
+
+    size_t n_reclocks_;
+    core::nanoseconds_t reclock_times_[MaxReads];
+};
+
+core::nanoseconds_t samples_to_ns(size_t n_samples) {
+    return core::nanoseconds_t(n_samples / NumCh) * core::Second / SampleRate;
+}
+
+} // namespace
+
+TEST_GROUP(pull_reader) {};
+
+TEST(pull_reader, fill) {
+    const core::nanoseconds_t start_time = 123 * core::Second;
+
+    TestSource source(BufSize);
+    PullReader reader(FrameSize, NumCh);
+
+    audio::sample_t buf[BufSize];
+    CHECK(reader.read(source, buf, BufSize, SampleRate, start_time));
+
+    UNSIGNED_LONGS_EQUAL(4, source.num_reads());
+    UNSIGNED_LONGS_EQUAL(4, source.num_reclocks());
+
+    size_t pos = 0;
+    for (size_t n = 0; n < source.num_reads(); n++) {
+        pos += source.frame_size(n);
+
+        CHECK(source.reclock_time(n) == start_time + samples_to_ns(pos));
+    }
+
+    UNSIGNED_LONGS_EQUAL(FrameSize, source.frame_size(0));
+    UNSIGNED_LONGS_EQUAL(BufSize - FrameSize * 3, source.frame_size(3));
+
+    for (size_t n = 0; n < BufSize; n++) {
+        DOUBLES_EQUAL(TestSource::nth_sample(n), buf[n], 0);
+    }
+}
+
+TEST(pull_reader, source_eof) {
+    const core::nanoseconds_t start_time = 123 * core::Second;
+
+    TestSource source(FrameSize * 2);
+    PullReader reader(FrameSize, NumCh);
+
+    audio::sample_t buf[BufSize];
+    for (size_t n = 0; n < BufSize; n++) {
+        buf[n] = 1;
+    }
+
+    CHECK(!reader.read(source, buf, BufSize, SampleRate, start_time));
+
+    UNSIGNED_LONGS_EQUAL(2, source.num_reads());
+    UNSIGNED_LONGS_EQUAL(2, source.num_reclocks());
+
+    CHECK(source.reclock_time(1) == start_time + samples_to_ns(FrameSize * 2));
+
+    for (size_t n = 0; n < FrameSize * 2; n++) {
+        DOUBLES_EQUAL(TestSource::nth_sample(n), buf[n], 0);
+    }
+
+    for (size_t n = FrameSize * 2; n < BufSize; n++) {
+        DOUBLES_EQUAL(0, buf[n], 0);
+    }
+}
+
+} // namespace sndio
+} // namespace roc
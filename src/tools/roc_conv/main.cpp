@@ -14,6 +14,7 @@
 #include "roc_core/scoped_destructor.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_pipeline/converter.h"
+#include "roc_pipeline/parallel_converter.h"
 #include "roc_sndio/backend_dispatcher.h"
 #include "roc_sndio/print_drivers.h"
 #include "roc_sndio/pump.h"
@@ -133,6 +134,22 @@ int main(int argc, char** argv) {
     config.resampling = !args.no_resampling_flag;
     config.poisoning = args.poisoning_flag;
 
+    if (args.jobs_given) {
+        if (args.jobs_arg <= 0) {
+            roc_log(LogError, "invalid --jobs: should be > 0");
+            return 1;
+        }
+        config.num_threads = (size_t)args.jobs_arg;
+    }
+
+    if (args.chunk_size_given) {
+        if (args.chunk_size_arg <= 0) {
+            roc_log(LogError, "invalid --chunk-size: should be > 0");
+            return 1;
+        }
+        config.chunk_size = (size_t)args.chunk_size_arg;
+    }
+
     audio::IWriter* output_writer = NULL;
 
     sndio::Config sink_config;
@@ -156,13 +173,32 @@ int main(int argc, char** argv) {
         output_writer = sink.get();
     }
 
-    pipeline::Converter converter(config, output_writer, pool, allocator);
-    if (!converter.valid()) {
-        roc_log(LogError, "can't create converter pipeline");
-        return 1;
+    core::UniquePtr<pipeline::Converter> converter;
+    core::UniquePtr<pipeline::ParallelConverter> parallel_converter;
+
+    sndio::ISink* converter_sink = NULL;
+
+    if (config.num_threads > 1) {
+        parallel_converter.reset(new (allocator) pipeline::ParallelConverter(
+                                     config, output_writer, pool, allocator),
+                                 allocator);
+        if (!parallel_converter || !parallel_converter->valid()) {
+            roc_log(LogError, "can't create parallel converter pipeline");
+            return 1;
+        }
+        converter_sink = parallel_converter.get();
+    } else {
+        converter.reset(new (allocator)
+                            pipeline::Converter(config, output_writer, pool, allocator),
+                        allocator);
+        if (!converter || !converter->valid()) {
+            roc_log(LogError, "can't create converter pipeline");
+            return 1;
+        }
+        converter_sink = converter.get();
     }
 
-    sndio::Pump pump(pool, *source, converter, config.internal_frame_size,
+    sndio::Pump pump(pool, *source, *converter_sink, config.internal_frame_size,
                      sndio::Pump::ModePermanent);
     if (!pump.valid()) {
         roc_log(LogError, "can't create audio pump");
@@ -171,5 +207,9 @@ int main(int argc, char** argv) {
 
     const bool ok = pump.run();
 
+    if (parallel_converter) {
+        parallel_converter->flush();
+    }
+
     return ok ? 0 : 1;
 }
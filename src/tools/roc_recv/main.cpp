@@ -14,6 +14,7 @@
 #include "roc_core/log.h"
 #include "roc_core/parse_duration.h"
 #include "roc_core/scoped_destructor.h"
+#include "roc_core/thread_attributes.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_netio/transceiver.h"
 #include "roc_pipeline/parse_port.h"
@@ -121,6 +122,19 @@ int main(int argc, char** argv) {
             config.default_session.target_latency * pipeline::DefaultMaxLatencyFactor;
     }
 
+    switch ((unsigned)args.latency_mode_arg) {
+    case latency_mode_arg_queue:
+        config.default_session.latency_monitor.latency_mode = audio::LatencyMode_Queue;
+        break;
+
+    case latency_mode_arg_e2e:
+        config.default_session.latency_monitor.latency_mode = audio::LatencyMode_E2E;
+        break;
+
+    default:
+        break;
+    }
+
     if (args.np_timeout_given) {
         if (!core::parse_duration(args.np_timeout_arg,
                                   config.default_session.watchdog.no_playback_timeout)) {
@@ -186,6 +200,14 @@ int main(int argc, char** argv) {
         config.default_session.resampler.window_size = (size_t)args.resampler_window_arg;
     }
 
+    if (args.fec_threads_given) {
+        if (args.fec_threads_arg < 0) {
+            roc_log(LogError, "invalid --fec-threads: should be >= 0");
+            return 1;
+        }
+        config.default_session.fec_repair_threads = (size_t)args.fec_threads_arg;
+    }
+
     sndio::Config sink_config;
 
     sink_config.channels = config.common.output_channels;
@@ -210,6 +232,31 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (args.max_sessions_given) {
+        if (args.max_sessions_arg <= 0) {
+            roc_log(LogError, "invalid --max-sessions: should be > 0");
+            return 1;
+        }
+        config.common.max_sessions = (size_t)args.max_sessions_arg;
+    }
+
+    if (args.threading_flag) {
+        config.common.threading = true;
+        config.common.thread_buffer_size = config.common.internal_frame_size * 4;
+    }
+
+    if (args.spin_margin_given) {
+        if (!core::parse_duration(args.spin_margin_arg,
+                                  config.common.timing_spin_margin)) {
+            roc_log(LogError, "invalid --spin-margin");
+            return 1;
+        }
+        if (config.common.timing_spin_margin < 0) {
+            roc_log(LogError, "invalid --spin-margin: should be >= 0");
+            return 1;
+        }
+    }
+
     config.common.poisoning = args.poisoning_flag;
     config.common.beeping = args.beeping_flag;
 
@@ -251,13 +298,41 @@ int main(int argc, char** argv) {
 
     sndio::Pump pump(
         sample_buffer_pool, receiver, *sink, config.common.internal_frame_size,
-        args.oneshot_flag ? sndio::Pump::ModeOneshot : sndio::Pump::ModePermanent);
+        args.oneshot_flag ? sndio::Pump::ModeOneshot : sndio::Pump::ModePermanent,
+        args.pull_flag ? sndio::Pump::DrivePull : sndio::Pump::DrivePush);
     if (!pump.valid()) {
         roc_log(LogError, "can't create pump");
         return 1;
     }
 
-    netio::Transceiver trx(packet_pool, byte_buffer_pool, allocator);
+    core::ThreadAttributes net_attrs;
+
+    switch ((unsigned)args.net_policy_arg) {
+    case net_policy_arg_fifo:
+        net_attrs.sched_policy = core::SchedPolicy_FIFO;
+        break;
+
+    case net_policy_arg_rr:
+        net_attrs.sched_policy = core::SchedPolicy_RR;
+        break;
+
+    default:
+        break;
+    }
+
+    if (args.net_priority_given) {
+        net_attrs.sched_priority = args.net_priority_arg;
+    }
+
+    for (size_t n = 0; n < args.net_cpu_given; n++) {
+        if (args.net_cpu_arg[n] < 0 || args.net_cpu_arg[n] >= 64) {
+            roc_log(LogError, "invalid --net-cpu: should be in range [0; 64)");
+            return 1;
+        }
+        net_attrs.cpu_mask |= uint64_t(1) << args.net_cpu_arg[n];
+    }
+
+    netio::Transceiver trx(packet_pool, byte_buffer_pool, allocator, net_attrs);
     if (!trx.valid()) {
         roc_log(LogError, "can't create network transceiver");
         return 1;
@@ -274,6 +349,11 @@ int main(int argc, char** argv) {
             roc_log(LogError, "can't parse source port: %s", args.source_arg[n]);
             return 1;
         }
+        if (args.miface_given && port.address.multicast()
+            && !port.address.set_miface(args.miface_arg)) {
+            roc_log(LogError, "invalid --miface: should be IP address of same family");
+            return 1;
+        }
         if (!trx.add_udp_receiver(port.address, receiver)) {
             roc_log(LogError, "can't bind source port: %s", args.source_arg[n]);
             return 1;
@@ -290,6 +370,11 @@ int main(int argc, char** argv) {
             roc_log(LogError, "can't parse repair port: %s", args.repair_arg[n]);
             return 1;
         }
+        if (args.miface_given && port.address.multicast()
+            && !port.address.set_miface(args.miface_arg)) {
+            roc_log(LogError, "invalid --miface: should be IP address of same family");
+            return 1;
+        }
         if (!trx.add_udp_receiver(port.address, receiver)) {
             roc_log(LogError, "can't bind repair port: %s", args.repair_arg[n]);
             return 1;
@@ -300,6 +385,28 @@ int main(int argc, char** argv) {
         }
     }
 
+    for (size_t n = 0; n < args.control_given; n++) {
+        pipeline::PortConfig port;
+        if (!pipeline::parse_port(pipeline::Port_AudioControl, args.control_arg[n],
+                                  port)) {
+            roc_log(LogError, "can't parse control port: %s", args.control_arg[n]);
+            return 1;
+        }
+        if (args.miface_given && port.address.multicast()
+            && !port.address.set_miface(args.miface_arg)) {
+            roc_log(LogError, "invalid --miface: should be IP address of same family");
+            return 1;
+        }
+        if (!trx.add_udp_receiver(port.address, receiver)) {
+            roc_log(LogError, "can't bind control port: %s", args.control_arg[n]);
+            return 1;
+        }
+        if (!receiver.add_port(port)) {
+            roc_log(LogError, "can't initialize control port: %s", args.control_arg[n]);
+            return 1;
+        }
+    }
+
     const bool ok = pump.run();
 
     return ok ? 0 : 1;
@@ -14,6 +14,7 @@
 #include "roc_core/log.h"
 #include "roc_core/parse_duration.h"
 #include "roc_core/scoped_destructor.h"
+#include "roc_core/thread_attributes.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_netio/transceiver.h"
 #include "roc_pipeline/parse_port.h"
@@ -116,6 +117,15 @@ int main(int argc, char** argv) {
         }
     }
 
+    pipeline::PortConfig control_port;
+    if (args.control_given) {
+        if (!pipeline::parse_port(pipeline::Port_AudioControl, args.control_arg,
+                                  control_port)) {
+            roc_log(LogError, "can't parse remote control port: %s", args.control_arg);
+            return 1;
+        }
+    }
+
     config.fec_encoder.scheme = pipeline::port_fec_scheme(source_port.protocol);
 
     if (args.nbsrc_given) {
@@ -194,6 +204,32 @@ int main(int argc, char** argv) {
     }
 
     config.interleaving = args.interleaving_flag;
+
+    if (args.interleaving_delay_given) {
+        if (args.interleaving_delay_arg < 0) {
+            roc_log(LogError, "invalid --interleaving-delay: should be >= 0");
+            return 1;
+        }
+        config.interleaving_delay = (size_t)args.interleaving_delay_arg;
+    }
+    config.pacing = args.pacing_flag;
+
+    if (args.threading_flag) {
+        config.threading = true;
+        config.thread_buffer_size = config.internal_frame_size * 4;
+    }
+
+    if (args.spin_margin_given) {
+        if (!core::parse_duration(args.spin_margin_arg, config.timing_spin_margin)) {
+            roc_log(LogError, "invalid --spin-margin");
+            return 1;
+        }
+        if (config.timing_spin_margin < 0) {
+            roc_log(LogError, "invalid --spin-margin: should be >= 0");
+            return 1;
+        }
+    }
+
     config.poisoning = args.poisoning_flag;
 
     core::BufferPool<uint8_t> byte_buffer_pool(allocator, max_packet_size,
@@ -218,7 +254,34 @@ int main(int argc, char** argv) {
     fec::CodecMap codec_map;
     rtp::FormatMap format_map;
 
-    netio::Transceiver trx(packet_pool, byte_buffer_pool, allocator);
+    core::ThreadAttributes net_attrs;
+
+    switch ((unsigned)args.net_policy_arg) {
+    case net_policy_arg_fifo:
+        net_attrs.sched_policy = core::SchedPolicy_FIFO;
+        break;
+
+    case net_policy_arg_rr:
+        net_attrs.sched_policy = core::SchedPolicy_RR;
+        break;
+
+    default:
+        break;
+    }
+
+    if (args.net_priority_given) {
+        net_attrs.sched_priority = args.net_priority_arg;
+    }
+
+    for (size_t n = 0; n < args.net_cpu_given; n++) {
+        if (args.net_cpu_arg[n] < 0 || args.net_cpu_arg[n] >= 64) {
+            roc_log(LogError, "invalid --net-cpu: should be in range [0; 64)");
+            return 1;
+        }
+        net_attrs.cpu_mask |= uint64_t(1) << args.net_cpu_arg[n];
+    }
+
+    netio::Transceiver trx(packet_pool, byte_buffer_pool, allocator, net_attrs);
     if (!trx.valid()) {
         roc_log(LogError, "can't create network transceiver");
         return 1;
@@ -241,8 +304,9 @@ int main(int argc, char** argv) {
     }
 
     pipeline::Sender sender(config, source_port, *udp_sender, repair_port, *udp_sender,
-                            codec_map, format_map, packet_pool, byte_buffer_pool,
-                            sample_buffer_pool, allocator);
+                            control_port, *udp_sender, codec_map, format_map,
+                            packet_pool, byte_buffer_pool, sample_buffer_pool,
+                            allocator);
     if (!sender.valid()) {
         roc_log(LogError, "can't create sender pipeline");
         return 1;